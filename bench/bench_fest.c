@@ -0,0 +1,594 @@
+#include "system_info_dll.h"
+#include "collector_backend.h"
+#include "json_structure.h"
+#include "fest_alloc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_MAX_CASES 32          // Registered benchmark cases
+#define BENCH_MAX_REPETITIONS 100   // Upper bound for --reps
+#define BENCH_TICK_TIMEOUT_MS 60000 // Give up on a stalled engine
+#define BENCH_ARENA_SIZE 65536      // Snapshot arena of the dynamic cases
+
+/**
+ * @brief A single benchmark case
+ *
+ * The harness calls run() with an iteration count and measures
+ * the whole batch, so per-call timer overhead does not distort
+ * fast operations.
+ */
+typedef struct
+{
+    const char *name;               // Case name, "<group>/<subject>"
+    BOOL (*setup)(void);            // Optional, runs before warmup
+    void (*run)(UINT64 iterations); // Executes the operation N times
+    void (*teardown)(void);         // Optional, runs after the last repetition
+    CollectorId collector;          // Collector measured, COLLECTOR_COUNT for none
+} BenchCase;
+
+/**
+ * @brief Measured cost of one case
+ *
+ * Time is the median of all repetitions; allocation figures
+ * are totals over all repetitions divided by operations.
+ */
+typedef struct
+{
+    const char *name;   // Case name
+    double nsPerOp;     // Median time per operation
+    double nsPerOpMin;  // Fastest repetition
+    double allocsPerOp; // Library allocations per operation
+    double bytesPerOp;  // Library bytes requested per operation
+    UINT64 iterations;  // Operations per repetition
+    UINT repetitions;   // Measured repetitions
+} BenchResult;
+
+/**
+ * @brief Command line options
+ */
+static struct
+{
+    UINT64 iterations;        // Operations per repetition
+    UINT64 tickIterations;    // Operations per repetition for tick cases
+    UINT64 warmup;            // Unmeasured operations before repetitions
+    UINT repetitions;         // Measured repetitions
+    const char *filter;       // Substring of case names to run
+    const char *jsonPath;     // Machine-readable output file
+    const char *baselinePath; // Results to compare against
+    double thresholdPct;      // Allowed ns/op regression in percent
+    const char *backend;      // Collector backend, NULL for the native one
+} g_Options = {1000, 100, 100, 5, NULL, NULL, NULL, 10.0, "fixture"};
+
+static const CollectorBackend *g_Backend = NULL;   // Backend under test
+static const CollectorTable *g_Collectors = NULL; // Collectors of g_Backend
+static SnapshotArena g_Arena;                      // Snapshot memory for dynamic collectors
+static JSONBuffer g_JSONBuffer;                    // Reused output of the JSON case
+static StaticInfo g_StaticInfo;                    // Inputs for the JSON case
+static DynamicInfo g_DynamicInfo;                  // Inputs for the JSON case
+static volatile LONG64 g_TicksDelivered = 0;       // Callbacks seen by tick case
+static volatile LONG64 g_TickTarget = 0;           // Callback count that signals g_TickEvent
+static HANDLE g_TickEvent = NULL;                  // Set when g_TickTarget is reached
+
+/**
+ * @brief Defines a case that collects and frees one structure per operation
+ */
+#define BENCH_COLLECTOR(getter, freer)                   \
+    static void bench_##getter(UINT64 iterations)        \
+    {                                                    \
+        for (UINT64 i = 0; i < iterations; i++)          \
+            g_Collectors->freer(g_Collectors->getter()); \
+    }
+
+/**
+ * @brief Defines a case that collects one snapshot per operation
+ *
+ * Mirrors the engine: output goes to a snapshot arena that is
+ * reset before every collection
+ */
+#define BENCH_SNAPSHOT_COLLECTOR(collector)           \
+    static void bench_##collector(UINT64 iterations)  \
+    {                                                 \
+        for (UINT64 i = 0; i < iterations; i++)       \
+        {                                             \
+            resetSnapshotArena(&g_Arena);             \
+            g_Collectors->collector(&g_Arena);        \
+        }                                             \
+    }
+
+BENCH_COLLECTOR(getCPUList, freeCPUList)
+BENCH_COLLECTOR(getGPUList, freeGPUList)
+BENCH_COLLECTOR(getMotherboardInfo, freeMotherboardInfo)
+BENCH_COLLECTOR(getAudioList, freeAudioList)
+BENCH_COLLECTOR(getMonitorList, freeMonitorList)
+BENCH_COLLECTOR(getRAMSlotList, freeRAMSlotList)
+BENCH_SNAPSHOT_COLLECTOR(collectMemoryInfo)
+BENCH_SNAPSHOT_COLLECTOR(collectStorageList)
+BENCH_SNAPSHOT_COLLECTOR(collectBatteryInfo)
+BENCH_SNAPSHOT_COLLECTOR(collectNetworkList)
+BENCH_SNAPSHOT_COLLECTOR(collectCPULoad)
+BENCH_SNAPSHOT_COLLECTOR(collectCPUFrequency)
+BENCH_SNAPSHOT_COLLECTOR(collectDiskIO)
+
+/**
+ * @brief Reserves the snapshot arena of the dynamic collector cases
+ *
+ * @return BOOL TRUE if the arena was allocated
+ */
+static BOOL setupSnapshot(void)
+{
+    return initSnapshotArena(&g_Arena, BENCH_ARENA_SIZE);
+}
+
+/**
+ * @brief Releases the snapshot arena of the dynamic collector cases
+ */
+static void teardownSnapshot(void)
+{
+    releaseSnapshotArena(&g_Arena);
+}
+
+/**
+ * @brief Collects fixture data rendered by the JSON case
+ *
+ * @return BOOL TRUE if all fixture structures were created
+ */
+static BOOL setupJSON(void)
+{
+    const CollectorTable *fixtures = &getFixtureCollectorBackend()->collectors;
+    g_StaticInfo.cpuList = fixtures->getCPUList();
+    g_StaticInfo.gpuList = fixtures->getGPUList();
+    g_StaticInfo.mbInfo = fixtures->getMotherboardInfo();
+    g_StaticInfo.audioList = fixtures->getAudioList();
+    g_StaticInfo.monitorList = fixtures->getMonitorList();
+    g_StaticInfo.ramSlots = fixtures->getRAMSlotList();
+    if (!setupSnapshot())
+        return FALSE;
+    g_DynamicInfo.memInfo = fixtures->collectMemoryInfo(&g_Arena);
+    g_DynamicInfo.storageList = fixtures->collectStorageList(&g_Arena);
+    g_DynamicInfo.diskIO = fixtures->collectDiskIO(&g_Arena);
+    g_DynamicInfo.batteryInfo = fixtures->collectBatteryInfo(&g_Arena);
+    g_DynamicInfo.networkList = fixtures->collectNetworkList(&g_Arena);
+    g_DynamicInfo.cpuLoad = fixtures->collectCPULoad(&g_Arena);
+    g_DynamicInfo.cpuFrequency = fixtures->collectCPUFrequency(&g_Arena);
+
+    return g_StaticInfo.cpuList && g_StaticInfo.gpuList && g_StaticInfo.mbInfo &&
+           g_StaticInfo.audioList && g_StaticInfo.monitorList && g_StaticInfo.ramSlots &&
+           g_DynamicInfo.memInfo && g_DynamicInfo.storageList && g_DynamicInfo.batteryInfo &&
+           g_DynamicInfo.networkList && g_DynamicInfo.cpuLoad && g_DynamicInfo.cpuFrequency &&
+           g_DynamicInfo.diskIO;
+}
+
+/**
+ * @brief Renders the fixture snapshot to JSON
+ *
+ * Reuses one output buffer like the engine does
+ *
+ * @param iterations Number of documents to render
+ */
+static void runJSON(UINT64 iterations)
+{
+    for (UINT64 i = 0; i < iterations; i++)
+    {
+        renderSystemInfoJSON(
+            &g_JSONBuffer,
+            g_StaticInfo.gpuList,
+            g_StaticInfo.mbInfo,
+            g_StaticInfo.cpuList,
+            g_DynamicInfo.cpuLoad,
+            g_DynamicInfo.cpuFrequency,
+            g_DynamicInfo.memInfo,
+            g_StaticInfo.ramSlots,
+            g_DynamicInfo.storageList,
+            g_DynamicInfo.diskIO,
+            g_DynamicInfo.networkList,
+            g_StaticInfo.audioList,
+            g_DynamicInfo.batteryInfo,
+            g_StaticInfo.monitorList,
+            NULL);
+    }
+}
+
+/**
+ * @brief Releases the fixture snapshot of the JSON case
+ */
+static void teardownJSON(void)
+{
+    const CollectorTable *fixtures = &getFixtureCollectorBackend()->collectors;
+    fixtures->freeCPUList(g_StaticInfo.cpuList);
+    fixtures->freeGPUList(g_StaticInfo.gpuList);
+    fixtures->freeMotherboardInfo(g_StaticInfo.mbInfo);
+    fixtures->freeAudioList(g_StaticInfo.audioList);
+    fixtures->freeMonitorList(g_StaticInfo.monitorList);
+    fixtures->freeRAMSlotList(g_StaticInfo.ramSlots);
+    teardownSnapshot();
+    releaseJSONBuffer(&g_JSONBuffer);
+    memset(&g_StaticInfo, 0, sizeof(g_StaticInfo));
+    memset(&g_DynamicInfo, 0, sizeof(g_DynamicInfo));
+}
+
+/**
+ * @brief Counts ticks delivered by the monitoring engine
+ *
+ * @param jsonData JSON-formatted system information string (unused)
+ */
+static void onTick(const char *jsonData)
+{
+    if (InterlockedIncrement64(&g_TicksDelivered) >= g_TickTarget)
+        SetEvent(g_TickEvent);
+}
+
+/**
+ * @brief Starts the monitoring engine on the collectors under test
+ *
+ * The engine runs with a zero interval, so ticks follow each
+ * other back to back. Static information is collected before
+ * setup returns and is not part of the measurement.
+ *
+ * @return BOOL TRUE if the engine delivered its first tick
+ */
+static BOOL setupTick(void)
+{
+    g_TickEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+    g_TicksDelivered = 0;
+    g_TickTarget = 1;
+
+    setCollectorBackend(g_Backend);
+    setSystemInfoCallback(onTick);
+    if (!startSystemMonitoring(0))
+        return FALSE;
+
+    return WaitForSingleObject(g_TickEvent, BENCH_TICK_TIMEOUT_MS) == WAIT_OBJECT_0;
+}
+
+/**
+ * @brief Waits for the engine to complete N more ticks
+ *
+ * @param iterations Number of ticks to wait for
+ */
+static void runTick(UINT64 iterations)
+{
+    LONG64 target = g_TicksDelivered + (LONG64)iterations;
+    InterlockedExchange64(&g_TickTarget, target);
+
+    // The event may have been set by ticks of the previous batch
+    while (g_TicksDelivered < target)
+    {
+        if (WaitForSingleObject(g_TickEvent, BENCH_TICK_TIMEOUT_MS) != WAIT_OBJECT_0)
+            break;
+    }
+}
+
+/**
+ * @brief Stops the engine and restores the native backend
+ */
+static void teardownTick(void)
+{
+    stopSystemMonitoring();
+    setSystemInfoCallback(NULL);
+    setCollectorBackend(NULL);
+    CloseHandle(g_TickEvent);
+    g_TickEvent = NULL;
+}
+
+static const BenchCase g_Cases[] = {
+    {"collector/cpu", NULL, bench_getCPUList, NULL, COLLECTOR_CPU},
+    {"collector/gpu", NULL, bench_getGPUList, NULL, COLLECTOR_GPU},
+    {"collector/motherboard", NULL, bench_getMotherboardInfo, NULL, COLLECTOR_MOTHERBOARD},
+    {"collector/audio", NULL, bench_getAudioList, NULL, COLLECTOR_AUDIO},
+    {"collector/monitors", NULL, bench_getMonitorList, NULL, COLLECTOR_MONITORS},
+    {"collector/ram_slots", NULL, bench_getRAMSlotList, NULL, COLLECTOR_RAM_SLOTS},
+    {"collector/memory", setupSnapshot, bench_collectMemoryInfo, teardownSnapshot, COLLECTOR_MEMORY},
+    {"collector/storage", setupSnapshot, bench_collectStorageList, teardownSnapshot, COLLECTOR_STORAGE},
+    {"collector/battery", setupSnapshot, bench_collectBatteryInfo, teardownSnapshot, COLLECTOR_BATTERY},
+    {"collector/network", setupSnapshot, bench_collectNetworkList, teardownSnapshot, COLLECTOR_NETWORK},
+    {"collector/cpu_load", setupSnapshot, bench_collectCPULoad, teardownSnapshot, COLLECTOR_CPU_LOAD},
+    {"collector/cpu_frequency", setupSnapshot, bench_collectCPUFrequency, teardownSnapshot, COLLECTOR_CPU_FREQUENCY},
+    {"collector/disk_io", setupSnapshot, bench_collectDiskIO, teardownSnapshot, COLLECTOR_DISK_IO},
+    {"json/render", setupJSON, runJSON, teardownJSON, COLLECTOR_COUNT},
+    {"tick/loop", setupTick, runTick, teardownTick, COLLECTOR_COUNT},
+};
+
+/**
+ * @brief Orders doubles ascending for qsort
+ *
+ * @param a First value
+ * @param b Second value
+ * @return int Negative, zero or positive like strcmp
+ */
+static int compareDouble(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Measures one case
+ *
+ * This function:
+ * 1. Runs the optional setup
+ * 2. Executes unmeasured warmup operations
+ * 3. Times each repetition and tracks library allocations
+ * 4. Runs the optional teardown
+ *
+ * @param benchCase Case to measure
+ * @param result Structure to receive the measurement
+ * @return BOOL TRUE if measured, FALSE if setup failed
+ */
+static BOOL runCase(const BenchCase *benchCase, BenchResult *result)
+{
+    double samples[BENCH_MAX_REPETITIONS];
+    LARGE_INTEGER frequency, start, end;
+    AllocStats before, after;
+
+    if (benchCase->setup && !benchCase->setup())
+    {
+        if (benchCase->teardown)
+            benchCase->teardown();
+        return FALSE;
+    }
+
+    // Platform collectors are slow, tick cases include the engine loop
+    BOOL slow = g_Backend != getFixtureCollectorBackend() || strncmp(benchCase->name, "tick/", 5) == 0;
+    UINT64 iterations = slow ? g_Options.tickIterations : g_Options.iterations;
+    UINT64 warmup = slow ? g_Options.warmup / 10 + 1 : g_Options.warmup;
+
+    benchCase->run(warmup);
+
+    QueryPerformanceFrequency(&frequency);
+    getAllocStats(&before);
+    for (UINT rep = 0; rep < g_Options.repetitions; rep++)
+    {
+        QueryPerformanceCounter(&start);
+        benchCase->run(iterations);
+        QueryPerformanceCounter(&end);
+        samples[rep] = (double)(end.QuadPart - start.QuadPart) * 1e9 / (double)frequency.QuadPart / (double)iterations;
+    }
+    getAllocStats(&after);
+
+    if (benchCase->teardown)
+        benchCase->teardown();
+
+    double operations = (double)iterations * g_Options.repetitions;
+    qsort(samples, g_Options.repetitions, sizeof(double), compareDouble);
+    result->name = benchCase->name;
+    result->nsPerOp = samples[g_Options.repetitions / 2];
+    result->nsPerOpMin = samples[0];
+    result->allocsPerOp = (double)(after.allocCount - before.allocCount) / operations;
+    result->bytesPerOp = (double)(after.allocatedBytes - before.allocatedBytes) / operations;
+    result->iterations = iterations;
+    result->repetitions = g_Options.repetitions;
+    return TRUE;
+}
+
+/**
+ * @brief Writes results as JSON, one case object per line
+ *
+ * The one-object-per-line layout keeps the file readable by
+ * --baseline without a JSON parser and diff-friendly in review.
+ *
+ * @param path Output file path
+ * @param results Measured cases
+ * @param count Number of results
+ * @return BOOL TRUE if the file was written
+ */
+static BOOL writeResults(const char *path, const BenchResult *results, UINT count)
+{
+    FILE *file = NULL;
+    if (fopen_s(&file, path, "w") != 0 || !file)
+        return FALSE;
+
+    fprintf(file, "{\n  \"collectors\": \"%s\",\n  \"benchmarks\": [\n", g_Backend->name);
+    for (UINT i = 0; i < count; i++)
+    {
+        fprintf(file,
+                "    {\"name\": \"%s\", \"ns_per_op\": %.1f, \"ns_per_op_min\": %.1f, "
+                "\"allocs_per_op\": %.2f, \"bytes_per_op\": %.1f, \"iterations\": %llu, \"repetitions\": %u}%s\n",
+                results[i].name, results[i].nsPerOp, results[i].nsPerOpMin,
+                results[i].allocsPerOp, results[i].bytesPerOp,
+                (unsigned long long)results[i].iterations, results[i].repetitions,
+                i < count - 1 ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+
+    BOOL ok = !ferror(file);
+    fclose(file);
+    return ok;
+}
+
+/**
+ * @brief Looks up a case in a baseline file written by writeResults()
+ *
+ * @param path Baseline file path
+ * @param name Case name
+ * @param baseline Structure to receive the baseline figures
+ * @return BOOL TRUE if the case was found
+ */
+static BOOL readBaseline(const char *path, const char *name, BenchResult *baseline)
+{
+    char line[512];
+    char key[160];
+    FILE *file = NULL;
+    BOOL found = FALSE;
+
+    if (fopen_s(&file, path, "r") != 0 || !file)
+        return FALSE;
+
+    _snprintf_s(key, sizeof(key), _TRUNCATE, "{\"name\": \"%s\",", name);
+    while (!found && fgets(line, sizeof(line), file))
+    {
+        char *entry = strstr(line, key);
+        if (!entry)
+            continue;
+
+        found = sscanf_s(entry + strlen(key),
+                         " \"ns_per_op\": %lf, \"ns_per_op_min\": %lf, \"allocs_per_op\": %lf, \"bytes_per_op\": %lf",
+                         &baseline->nsPerOp, &baseline->nsPerOpMin,
+                         &baseline->allocsPerOp, &baseline->bytesPerOp) == 4;
+    }
+
+    fclose(file);
+    return found;
+}
+
+/**
+ * @brief Prints command line usage
+ */
+static void printUsage(void)
+{
+    printf("Usage: bench_fest [options]\n"
+           "  --filter <text>      Run only cases whose name contains text\n"
+           "  --iters <n>          Operations per repetition (default 1000)\n"
+           "  --tick-iters <n>     Operations per repetition for tick and platform cases (default 100)\n"
+           "  --warmup <n>         Unmeasured operations before measuring (default 100)\n"
+           "  --reps <n>           Measured repetitions, median is reported (default 5)\n"
+           "  --json <file>        Write machine-readable results\n"
+           "  --baseline <file>    Compare against results written by --json\n"
+           "  --threshold <pct>    Allowed ns/op regression against baseline (default 10)\n"
+           "  --backend <name>     Collector backend: fixture (default), windows, linux\n"
+           "  --live               Benchmark the native backend of the platform\n");
+}
+
+/**
+ * @brief Parses command line options into g_Options
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ * @return BOOL TRUE if all options were valid
+ */
+static BOOL parseOptions(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--live") == 0)
+        {
+            g_Options.backend = NULL;
+            continue;
+        }
+        if (!value)
+            return FALSE;
+
+        if (strcmp(arg, "--backend") == 0)
+            g_Options.backend = value;
+        else if (strcmp(arg, "--filter") == 0)
+            g_Options.filter = value;
+        else if (strcmp(arg, "--iters") == 0)
+            g_Options.iterations = _strtoui64(value, NULL, 10);
+        else if (strcmp(arg, "--tick-iters") == 0)
+            g_Options.tickIterations = _strtoui64(value, NULL, 10);
+        else if (strcmp(arg, "--warmup") == 0)
+            g_Options.warmup = _strtoui64(value, NULL, 10);
+        else if (strcmp(arg, "--reps") == 0)
+            g_Options.repetitions = (UINT)strtoul(value, NULL, 10);
+        else if (strcmp(arg, "--json") == 0)
+            g_Options.jsonPath = value;
+        else if (strcmp(arg, "--baseline") == 0)
+            g_Options.baselinePath = value;
+        else if (strcmp(arg, "--threshold") == 0)
+            g_Options.thresholdPct = atof(value);
+        else
+            return FALSE;
+        i++;
+    }
+
+    return g_Options.iterations > 0 && g_Options.tickIterations > 0 &&
+           g_Options.repetitions > 0 && g_Options.repetitions <= BENCH_MAX_REPETITIONS;
+}
+
+/**
+ * @brief Benchmark entry point
+ *
+ * This function:
+ * 1. Runs every selected case against the fixture (or another) backend
+ *    - collector cases the backend does not provide are skipped
+ * 2. Prints ns/op, allocs/op and bytes/op per case
+ * 3. Optionally writes results as JSON
+ * 4. Optionally compares against a baseline
+ *    - ns/op above threshold is a regression
+ *    - any increase in allocs/op is a regression
+ *
+ * @return int 0 on success, 1 on invalid usage or failure, 2 on regression
+ */
+int main(int argc, char **argv)
+{
+    BenchResult results[BENCH_MAX_CASES];
+    UINT count = 0;
+    int exitCode = 0;
+
+    if (!parseOptions(argc, argv))
+    {
+        printUsage();
+        return 1;
+    }
+
+    g_Backend = g_Options.backend ? findCollectorBackend(g_Options.backend) : getNativeCollectorBackend();
+    if (!g_Backend)
+    {
+        printf("Unknown backend %s\n", g_Options.backend);
+        return 1;
+    }
+    g_Collectors = &g_Backend->collectors;
+
+    printf("%-24s %14s %14s %10s %12s %10s\n", "case", "ns/op", "min ns/op", "allocs/op", "bytes/op", "vs base");
+    for (UINT i = 0; i < sizeof(g_Cases) / sizeof(g_Cases[0]); i++)
+    {
+        const BenchCase *benchCase = &g_Cases[i];
+        if (g_Options.filter && !strstr(benchCase->name, g_Options.filter))
+            continue;
+
+        // Collector cases hold the collector open like the engine does
+        DWORD open = 0;
+        if (benchCase->collector != COLLECTOR_COUNT)
+        {
+            open = openCollectorBackend(g_Backend);
+            if (!(open & COLLECTOR_BIT(benchCase->collector)))
+            {
+                closeCollectorBackend(g_Backend, open);
+                printf("%-24s not provided by %s\n", benchCase->name, g_Backend->name);
+                continue;
+            }
+        }
+
+        BenchResult *result = &results[count];
+        BOOL measured = runCase(benchCase, result);
+        closeCollectorBackend(g_Backend, open);
+        if (!measured)
+        {
+            printf("%-24s setup failed\n", benchCase->name);
+            exitCode = 1;
+            continue;
+        }
+        count++;
+
+        char delta[32] = "-";
+        BenchResult baseline;
+        if (g_Options.baselinePath && readBaseline(g_Options.baselinePath, result->name, &baseline))
+        {
+            double change = baseline.nsPerOp > 0.0 ? (result->nsPerOp / baseline.nsPerOp - 1.0) * 100.0 : 0.0;
+            BOOL slower = change > g_Options.thresholdPct;
+            BOOL allocates = result->allocsPerOp > baseline.allocsPerOp + 0.005;
+            _snprintf_s(delta, sizeof(delta), _TRUNCATE, "%+.1f%%%s", change, (slower || allocates) ? " !" : "");
+            if (slower || allocates)
+                exitCode = 2;
+        }
+
+        printf("%-24s %14.1f %14.1f %10.2f %12.1f %10s\n",
+               result->name, result->nsPerOp, result->nsPerOpMin,
+               result->allocsPerOp, result->bytesPerOp, delta);
+    }
+
+    if (g_Options.jsonPath && !writeResults(g_Options.jsonPath, results, count))
+    {
+        printf("Failed to write %s\n", g_Options.jsonPath);
+        exitCode = 1;
+    }
+
+    if (exitCode == 2)
+        printf("Regression against %s (threshold %.1f%%)\n", g_Options.baselinePath, g_Options.thresholdPct);
+
+    return exitCode;
+}
@@ -0,0 +1,158 @@
+#include "utf8_transcode.h"
+#include <locale.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Command line options
+ */
+static struct
+{
+    UINT iters; // Conversions of the whole string set per case
+} g_Options = {200000};
+
+// Property strings as collectors see them on a typical machine
+static const wchar_t *g_AsciiStrings[] = {
+    L"Samsung SSD 980 PRO 1TB",
+    L"NVMe",
+    L"\\\\.\\PHYSICALDRIVE0",
+    L"Kingston KF3200C16D4/16GX",
+    L"ChannelA-DIMM0",
+    L"ASUSTeK COMPUTER INC.",
+    L"ROG STRIX B550-F GAMING (WI-FI)",
+    L"NVIDIA GeForce RTX 3070 Laptop GPU",
+};
+
+// Vendor and volume names with non-ASCII characters
+static const wchar_t *g_MixedStrings[] = {
+    L"Lenovo Speicherger\x00E4t",
+    L"\x682A\x5F0F\x4F1A\x793E\x30D0\x30C3\x30D5\x30A1\x30ED\x30FC",
+    L"Donn\x00E9" L"es personnelles",
+    L"\x0417\x0430\x043F\x0430\x0441\x043D\x043E\x0439 \x0434\x0438\x0441\x043A",
+    L"Micro-Star International Co., Ltd.",
+    L"Caf\x00E9 Backup \x20AC",
+};
+
+#define STRING_COUNT(strings) (sizeof(strings) / sizeof((strings)[0]))
+
+/**
+ * @brief Reads the monotonic clock in nanoseconds
+ */
+static double nowNs(void)
+{
+    static double ticksPerNs = 0.0;
+    LARGE_INTEGER counter;
+    if (ticksPerNs == 0.0)
+    {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        ticksPerNs = (double)frequency.QuadPart / 1000000000.0;
+    }
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / ticksPerNs;
+}
+
+/**
+ * @brief Parses the command line
+ *
+ * @return BOOL FALSE on an unknown or invalid option
+ */
+static BOOL parseOptions(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (i + 1 < argc && strcmp(argv[i], "--iters") == 0)
+            g_Options.iters = (UINT)strtoul(argv[++i], NULL, 10);
+        else
+            return FALSE;
+    }
+    return g_Options.iters > 0;
+}
+
+/**
+ * @brief Converts with the CRT, as the collectors used to
+ */
+static size_t convertWithCrt(const wchar_t *src, char *dst, size_t dstSize)
+{
+    size_t converted = 0;
+    wcstombs_s(&converted, dst, dstSize, src, _TRUNCATE);
+    return converted ? converted - 1 : 0;
+}
+
+/**
+ * @brief Converts with the library transcoder
+ */
+static size_t convertWithTranscoder(const wchar_t *src, char *dst, size_t dstSize)
+{
+    return wideToUtf8(src, dst, dstSize);
+}
+
+/**
+ * @brief Times one converter over one string set
+ *
+ * @param label Case name printed in the first column
+ * @param convert Converter under test
+ * @param strings String set
+ * @param count Number of strings in the set
+ * @return size_t Output bytes of one pass, to compare converters
+ */
+static size_t runCase(const char *label, size_t (*convert)(const wchar_t *, char *, size_t),
+                      const wchar_t **strings, size_t count)
+{
+    char buffer[256];
+    size_t bytesPerPass = 0;
+    volatile size_t sink = 0;
+
+    for (size_t s = 0; s < count; s++)
+        bytesPerPass += convert(strings[s], buffer, sizeof(buffer));
+
+    double start = nowNs();
+    for (UINT i = 0; i < g_Options.iters; i++)
+    {
+        for (size_t s = 0; s < count; s++)
+            sink += convert(strings[s], buffer, sizeof(buffer));
+    }
+    double elapsed = nowNs() - start;
+    (void)sink;
+
+    double conversions = (double)g_Options.iters * count;
+    printf("%-18s %12.1f %12.1f\n", label, elapsed / conversions,
+           (double)bytesPerPass * g_Options.iters / (elapsed / 1000000000.0) / (1024.0 * 1024.0));
+    return bytesPerPass;
+}
+
+/**
+ * @brief Compares the transcoder with wcstombs on collector strings
+ *
+ * The CRT runs under a UTF-8 locale where one is available, so
+ * both sides produce the same bytes and only speed differs. On
+ * Windows the CRT falls back to the ANSI code page and mangles
+ * the mixed set, which is why the collectors stopped using it.
+ */
+int main(int argc, char **argv)
+{
+    if (!parseOptions(argc, argv))
+    {
+        fprintf(stderr, "usage: bench_utf8 [--iters N]\n");
+        return 1;
+    }
+
+    BOOL utf8Locale = setlocale(LC_CTYPE, ".UTF-8") != NULL || setlocale(LC_CTYPE, "C.UTF-8") != NULL;
+
+    printf("%u iterations, CRT locale %s\n", g_Options.iters, utf8Locale ? "UTF-8" : "default");
+    printf("%-18s %12s %12s\n", "case", "ns/string", "MB/s");
+
+    int result = 0;
+    size_t crtAscii = runCase("crt ascii", convertWithCrt, g_AsciiStrings, STRING_COUNT(g_AsciiStrings));
+    size_t fastAscii = runCase("utf8 ascii", convertWithTranscoder, g_AsciiStrings, STRING_COUNT(g_AsciiStrings));
+    size_t crtMixed = runCase("crt mixed", convertWithCrt, g_MixedStrings, STRING_COUNT(g_MixedStrings));
+    size_t fastMixed = runCase("utf8 mixed", convertWithTranscoder, g_MixedStrings, STRING_COUNT(g_MixedStrings));
+
+    if (crtAscii != fastAscii || (utf8Locale && crtMixed != fastMixed))
+    {
+        fprintf(stderr, "converters disagree on the output length\n");
+        result = 1;
+    }
+    return result;
+}
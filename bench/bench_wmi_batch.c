@@ -0,0 +1,148 @@
+#include "wmi_helper.h"
+#include "fake_wbem.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BATCH_MAX_ROWS 4096 // Upper bound for --rows
+
+/**
+ * @brief Command line options
+ */
+static struct
+{
+    UINT rows;    // Objects returned by every query
+    UINT costNs;  // Simulated cost of one Next call
+    UINT queries; // Measured queries per batch size
+} g_Options = {256, 20000, 50};
+
+static FakeWbemProperty g_Properties[BATCH_MAX_ROWS]; // One Name property per row
+static FakeWbemRow g_Rows[BATCH_MAX_ROWS];            // Rows served by the fake provider
+
+/**
+ * @brief Row decoded by the benchmark
+ */
+typedef struct
+{
+    char name[64]; // Name property of the object
+} BatchRow;
+
+/**
+ * @brief Decodes the Name property of one object
+ */
+static BOOL decodeBatchRow(IWbemClassObject *pclsObj, void *row, void *context)
+{
+    return getWMIPropertyString(pclsObj, L"Name", ((BatchRow *)row)->name, sizeof(((BatchRow *)row)->name));
+}
+
+/**
+ * @brief Reads the monotonic clock in nanoseconds
+ */
+static double nowNs(void)
+{
+    static double ticksPerNs = 0.0;
+    LARGE_INTEGER counter;
+    if (ticksPerNs == 0.0)
+    {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        ticksPerNs = (double)frequency.QuadPart / 1000000000.0;
+    }
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / ticksPerNs;
+}
+
+/**
+ * @brief Parses the command line
+ *
+ * @return BOOL FALSE on an unknown or invalid option
+ */
+static BOOL parseOptions(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (i + 1 < argc && strcmp(argv[i], "--rows") == 0)
+            g_Options.rows = (UINT)strtoul(argv[++i], NULL, 10);
+        else if (i + 1 < argc && strcmp(argv[i], "--cost-ns") == 0)
+            g_Options.costNs = (UINT)strtoul(argv[++i], NULL, 10);
+        else if (i + 1 < argc && strcmp(argv[i], "--queries") == 0)
+            g_Options.queries = (UINT)strtoul(argv[++i], NULL, 10);
+        else
+            return FALSE;
+    }
+    return g_Options.rows > 0 && g_Options.rows <= BATCH_MAX_ROWS && g_Options.queries > 0;
+}
+
+/**
+ * @brief Measures row enumeration against a provider with a fixed per-call cost
+ *
+ * The fake provider busy-waits for --cost-ns on every
+ * IEnumWbemClassObject::Next call, standing in for the
+ * cross-process round trip to the WMI service. Each batch
+ * size runs the same query --queries times and reports the
+ * time per row and the provider calls per query.
+ */
+int main(int argc, char **argv)
+{
+    static const UINT batchSizes[] = {1, 4, 16, WMI_MAX_BATCH_SIZE};
+
+    if (!parseOptions(argc, argv))
+    {
+        fprintf(stderr, "usage: bench_wmi_batch [--rows N] [--cost-ns N] [--queries N]\n");
+        return 1;
+    }
+
+    for (UINT i = 0; i < g_Options.rows; i++)
+    {
+        g_Properties[i].name = L"Name";
+        g_Properties[i].value = L"Win32_BenchObject";
+        g_Rows[i].properties = &g_Properties[i];
+        g_Rows[i].count = 1;
+    }
+    fakeWbemSetRows(g_Rows, g_Options.rows);
+    fakeWbemSetCallCost(g_Options.costNs);
+    setWMIConnector(connectFakeWbem);
+
+    WMISession *session = acquireWMISession();
+    if (!session)
+    {
+        fprintf(stderr, "fake provider connection failed\n");
+        return 1;
+    }
+
+    printf("%u rows, %u ns per call, %u queries\n", g_Options.rows, g_Options.costNs, g_Options.queries);
+    printf("%-8s %12s %14s\n", "batch", "ns/row", "calls/query");
+
+    int result = 0;
+    for (UINT b = 0; b < sizeof(batchSizes) / sizeof(batchSizes[0]); b++)
+    {
+        setWMIBatchSize(batchSizes[b]);
+
+        FakeWbemStats stats;
+        fakeWbemTakeStats(&stats);
+
+        double start = nowNs();
+        for (UINT q = 0; q < g_Options.queries; q++)
+        {
+            WMIRowVector rows;
+            initWMIRowVector(&rows, NULL, sizeof(BatchRow), g_Options.rows);
+            if (!queryWMIRows(session, L"SELECT Name FROM Win32_BenchObject", &rows, decodeBatchRow, NULL) ||
+                rows.count != g_Options.rows)
+                result = 1;
+            releaseWMIRowVector(&rows);
+        }
+        double elapsed = nowNs() - start;
+
+        fakeWbemTakeStats(&stats);
+        printf("%-8u %12.1f %14.1f\n", getWMIBatchSize(),
+               elapsed / ((double)g_Options.queries * g_Options.rows),
+               (double)stats.nextCalls / g_Options.queries);
+    }
+
+    releaseWMISession(session);
+    setWMIBatchSize(WMI_DEFAULT_BATCH_SIZE);
+
+    if (result != 0)
+        fprintf(stderr, "enumeration returned an incomplete result\n");
+    return result;
+}
@@ -1,7 +1,7 @@
 #ifndef AUDIO_INFO_H
 #define AUDIO_INFO_H
 
-#include <windows.h>
+#include "fest_platform.h"
 
 /**
  * @brief Information about a single audio device
@@ -46,6 +46,19 @@ typedef struct
  */
 AudioList *getAudioList(void);
 
+#ifdef __linux__
+/**
+ * @brief Lists ALSA sound cards from /proc/asound/cards
+ *
+ * The card's long name is reported as device name and the
+ * vendor of its PCI function as manufacturer.
+ *
+ * @return AudioList* Pointer to allocated audio device list, NULL if failed
+ * @note Caller is responsible for freeing the returned list using freeAudioList()
+ */
+AudioList *getLinuxAudioList(void);
+#endif
+
 /**
  * @brief Frees memory allocated for audio device list
  *
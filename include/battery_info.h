@@ -1,7 +1,8 @@
 #ifndef BATTERY_INFO_H
 #define BATTERY_INFO_H
 
-#include <windows.h>
+#include "fest_platform.h"
+#include "snapshot_arena.h"
 
 /**
  * @brief System power and battery status information
@@ -36,6 +37,47 @@ typedef struct
  */
 BatteryInfo *getBatteryInfo(void);
 
+/**
+ * @brief Collects battery information into a snapshot arena
+ *
+ * Same data as getBatteryInfo(), used by the monitoring engine
+ * so that a tick's output is released by resetting the arena
+ *
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return BatteryInfo* Pointer to battery information, NULL if failed
+ * @note Heap results (NULL arena) must be freed with freeBatteryInfo()
+ */
+BatteryInfo *collectBatteryInfo(SnapshotArena *arena);
+
+#ifdef __linux__
+/**
+ * @brief Collects battery information from /sys/class/power_supply
+ *
+ * This function:
+ * 1. Averages the capacity of system batteries, skipping peripherals,
+ *    from the directory kept open by openLinuxBattery()
+ * 2. Reports AC power from online mains or USB supplies
+ * 3. Falls back to the battery status without such a supply
+ * 4. Reports a plugged-in desktop at 100% without batteries
+ *
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return BatteryInfo* Pointer to battery information, NULL if failed
+ */
+BatteryInfo *collectLinuxBatteryInfo(SnapshotArena *arena);
+
+/**
+ * @brief Opens /sys/class/power_supply for the monitoring session
+ *
+ * @return BOOL Always TRUE, a missing directory reports a desktop
+ */
+BOOL openLinuxBattery(void);
+
+/**
+ * @brief Closes /sys/class/power_supply
+ */
+void closeLinuxBattery(void);
+#endif
+
 /**
  * @brief Frees memory allocated for battery information
  *
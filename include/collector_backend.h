@@ -0,0 +1,160 @@
+#ifndef COLLECTOR_BACKEND_H
+#define COLLECTOR_BACKEND_H
+
+#include "system_info_internal.h"
+
+#define MAX_COLLECTOR_BACKENDS 8 // Registry capacity, built-in backends included
+
+/**
+ * @brief Collectors of a backend, in engine order
+ */
+typedef enum
+{
+    COLLECTOR_CPU,
+    COLLECTOR_GPU,
+    COLLECTOR_MOTHERBOARD,
+    COLLECTOR_AUDIO,
+    COLLECTOR_MONITORS,
+    COLLECTOR_RAM_SLOTS,
+    COLLECTOR_MEMORY,
+    COLLECTOR_STORAGE,
+    COLLECTOR_BATTERY,
+    COLLECTOR_NETWORK,
+    COLLECTOR_CPU_LOAD,
+    COLLECTOR_CPU_FREQUENCY,
+    COLLECTOR_DISK_IO,
+    COLLECTOR_COUNT
+} CollectorId;
+
+#define COLLECTOR_BIT(id) (1UL << (id)) // Bit of a collector in an open mask
+
+/**
+ * @brief State hooks of one collector
+ *
+ * open() runs on the monitoring thread before the first tick and
+ * acquires whatever the collector keeps across ticks: a pinned
+ * WMI connection, persistent file descriptors, previous counters.
+ * close() runs on the same thread after the last tick. Either may
+ * be NULL for a stateless collector.
+ */
+typedef struct
+{
+    BOOL (*open)(void);  // Acquires collector state, FALSE disables the collector
+    void (*close)(void); // Releases collector state
+} CollectorLifecycle;
+
+/**
+ * @brief A platform implementation of every collector
+ *
+ * A backend pairs the collect/free functions of CollectorTable
+ * with an open/close lifecycle per collector. Collectors a backend
+ * cannot provide are NULL in the table; the engine skips them and
+ * their JSON section is omitted.
+ *
+ * Built-in backends:
+ * - "windows": WMI, DXGI, IP Helper, SetupAPI and power status
+ * - "linux": sysfs and procfs
+ * - "fixture": deterministic lab machine, on every platform
+ */
+typedef struct
+{
+    const char *name;                              // Registry name
+    CollectorTable collectors;                     // Collect and free functions, NULL if not provided
+    CollectorLifecycle lifecycle[COLLECTOR_COUNT]; // Open/close hooks, indexed by CollectorId
+    void (*cancel)(void);                          // Ends a blocking collection from another thread, may be NULL
+} CollectorBackend;
+
+/**
+ * @brief Adds a backend to the registry
+ *
+ * A backend with the name of a registered one replaces it.
+ *
+ * @param backend Backend that must outlive the process
+ * @return BOOL TRUE if registered, FALSE if the registry is full
+ */
+BOOL registerCollectorBackend(const CollectorBackend *backend);
+
+/**
+ * @brief Looks up a registered backend by name
+ *
+ * @param name Backend name, e.g. "linux" or "fixture"
+ * @return const CollectorBackend* Backend, NULL if not registered
+ */
+const CollectorBackend *findCollectorBackend(const char *name);
+
+/**
+ * @brief Returns the backend of the platform the library was built for
+ *
+ * @return const CollectorBackend* "windows" or "linux", "fixture" elsewhere
+ */
+const CollectorBackend *getNativeCollectorBackend(void);
+
+/**
+ * @brief Returns the deterministic fixture backend
+ *
+ * Fixture collectors never touch the machine. They return the
+ * same lab machine on every call, allocated through the library
+ * allocator in the same shape as the platform collectors:
+ * - 1 CPU, 2 GPUs, 1 motherboard
+ * - 4 RAM slots, 4 volumes on 2 busy disks, 4 network adapters
+ * - 3 audio devices, 2 monitors, 1 battery
+ *
+ * @return const CollectorBackend* Fixture backend
+ */
+const CollectorBackend *getFixtureCollectorBackend(void);
+
+#ifdef _WIN32
+/**
+ * @brief Returns the WMI/Win32 backend
+ *
+ * @return const CollectorBackend* Windows backend
+ */
+const CollectorBackend *getWindowsCollectorBackend(void);
+#endif
+
+#ifdef __linux__
+/**
+ * @brief Returns the sysfs/procfs backend
+ *
+ * @return const CollectorBackend* Linux backend
+ */
+const CollectorBackend *getLinuxCollectorBackend(void);
+#endif
+
+/**
+ * @brief Opens every collector the backend provides
+ *
+ * Calls open() of each provided collector. A collector whose
+ * open() fails is left out of the mask and never closed.
+ *
+ * @param backend Backend to open
+ * @return DWORD COLLECTOR_BIT() of every usable collector
+ */
+DWORD openCollectorBackend(const CollectorBackend *backend);
+
+/**
+ * @brief Closes the collectors opened by openCollectorBackend()
+ *
+ * @param backend Backend to close
+ * @param openMask Mask returned by openCollectorBackend()
+ */
+void closeCollectorBackend(const CollectorBackend *backend, DWORD openMask);
+
+/**
+ * @brief Replaces the backend used by the monitoring engine
+ *
+ * The backend is kept across monitoring sessions until replaced.
+ *
+ * @param backend Backend that must outlive its use, NULL restores the native backend
+ * @return BOOL TRUE if replaced, FALSE if monitoring is running
+ */
+BOOL setCollectorBackend(const CollectorBackend *backend);
+
+/**
+ * @brief Returns the backend used by the monitoring engine
+ *
+ * @return const CollectorBackend* Selected backend
+ */
+const CollectorBackend *getCollectorBackend(void);
+
+#endif // COLLECTOR_BACKEND_H
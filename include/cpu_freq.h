@@ -0,0 +1,99 @@
+#ifndef CPU_FREQ_H
+#define CPU_FREQ_H
+
+#include "fest_platform.h"
+#include "snapshot_arena.h"
+
+/**
+ * @brief Current clock of every logical core
+ *
+ * cores is indexed by logical CPU number. Cores that are offline
+ * or expose no frequency report 0 and are left out of min, avg
+ * and max.
+ *
+ * @note Heap results (NULL arena) must be freed with freeCPUFrequencyInfo()
+ */
+typedef struct
+{
+    UINT minMhz;    // Slowest reporting core in MHz
+    UINT avgMhz;    // Average of the reporting cores in MHz
+    UINT maxMhz;    // Fastest reporting core in MHz
+    UINT *cores;    // Per logical core in MHz, 0 if unknown
+    UINT coreCount; // Entries in cores
+} CPUFrequencyInfo;
+
+/**
+ * @brief Allocates a frequency result for a number of cores
+ *
+ * @param coreCount Entries of the per-core array
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return CPUFrequencyInfo* Zeroed result, NULL if allocation failed
+ */
+CPUFrequencyInfo *allocCPUFrequencyInfo(UINT coreCount, SnapshotArena *arena);
+
+/**
+ * @brief Fills min, avg and max from the per-core array
+ *
+ * @param info Result whose cores were filled by the platform
+ */
+void summarizeCPUFrequency(CPUFrequencyInfo *info);
+
+/**
+ * @brief Samples core clocks through CallNtPowerInformation
+ *
+ * This function:
+ * 1. Reads the ProcessorInformation power level of every core
+ * 2. Reports CurrentMhz, capped at MhzLimit when throttled
+ *
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return CPUFrequencyInfo* Pointer to core clocks, NULL if failed or not opened
+ */
+CPUFrequencyInfo *collectCPUFrequency(SnapshotArena *arena);
+
+/**
+ * @brief Sizes the Windows power information buffer
+ *
+ * @return BOOL TRUE if core clocks can be sampled
+ */
+BOOL openCPUFrequencyCollector(void);
+
+/**
+ * @brief Releases the Windows power information buffer
+ */
+void closeCPUFrequencyCollector(void);
+
+#ifdef __linux__
+/**
+ * @brief Samples core clocks from cpufreq
+ *
+ * This function:
+ * 1. Rereads scaling_cur_freq of every core through the descriptors
+ *    kept open by openLinuxCPUFrequency()
+ * 2. Converts kHz to MHz and summarizes min, avg and max
+ *
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return CPUFrequencyInfo* Pointer to core clocks, NULL if failed or not opened
+ */
+CPUFrequencyInfo *collectLinuxCPUFrequency(SnapshotArena *arena);
+
+/**
+ * @brief Opens scaling_cur_freq of every possible core
+ *
+ * @return BOOL TRUE if at least one core exposes its frequency
+ */
+BOOL openLinuxCPUFrequency(void);
+
+/**
+ * @brief Closes the scaling_cur_freq descriptors
+ */
+void closeLinuxCPUFrequency(void);
+#endif
+
+/**
+ * @brief Frees core clocks allocated from the heap
+ *
+ * @param info Pointer to CPUFrequencyInfo structure to be freed
+ */
+void freeCPUFrequencyInfo(CPUFrequencyInfo *info);
+
+#endif // CPU_FREQ_H
@@ -1,7 +1,7 @@
 #ifndef CPU_INFO_H
 #define CPU_INFO_H
 
-#include <windows.h>
+#include "fest_platform.h"
 
 /**
  * @brief Information about a single CPU/processor
@@ -52,6 +52,22 @@ typedef struct
  */
 CPUList *getCPUList(void);
 
+#ifdef __linux__
+/**
+ * @brief Retrieves processor information from /proc/cpuinfo and sysfs
+ *
+ * This function:
+ * 1. Parses the logical CPU blocks of /proc/cpuinfo
+ * 2. Reads package, die and core ids from cpuN/topology
+ * 3. Groups logical CPUs into one CPUInfo per physical package
+ * 4. Reports the cpufreq base clock, or the cpuinfo clock without cpufreq
+ *
+ * @return CPUList* Pointer to allocated processor list, NULL if failed
+ * @note Caller is responsible for freeing the returned list using freeCPUList()
+ */
+CPUList *getLinuxCPUList(void);
+#endif
+
 /**
  * @brief Frees memory allocated for CPU information list
  *
@@ -0,0 +1,159 @@
+#ifndef CPU_LOAD_H
+#define CPU_LOAD_H
+
+#include "fest_platform.h"
+#include "snapshot_arena.h"
+
+/**
+ * @brief Share of CPU time spent in each state since the previous tick
+ *
+ * The four percentages add up to 100:
+ * - user includes nice time
+ * - system includes interrupt, softirq/DPC and steal time
+ * - iowait is always 0 on Windows
+ */
+typedef struct
+{
+    double user;   // User mode time in percent
+    double system; // Kernel mode time in percent
+    double iowait; // Idle time waiting for I/O in percent
+    double idle;   // Idle time in percent
+} CPULoad;
+
+/**
+ * @brief CPU utilization of the whole system and of every logical core
+ *
+ * cores is indexed by logical CPU number. Cores that are offline
+ * or did not run since the previous tick report all zeros, and so
+ * does every entry of the first tick, which has no baseline yet.
+ *
+ * @note Heap results (NULL arena) must be freed with freeCPULoadInfo()
+ */
+typedef struct
+{
+    CPULoad total;   // All logical cores together
+    CPULoad *cores;  // Per logical core
+    UINT coreCount;  // Entries in cores
+} CPULoadInfo;
+
+/**
+ * @brief Cumulative CPU time counters of one core, in platform ticks
+ */
+typedef struct
+{
+    UINT64 user;   // User and nice time
+    UINT64 system; // Kernel, interrupt, softirq/DPC and steal time
+    UINT64 iowait; // Idle time waiting for I/O
+    UINT64 idle;   // Idle time
+} CPUTimes;
+
+/**
+ * @brief Counter state kept between ticks
+ *
+ * Both arrays are flat, sized once for every possible core, and
+ * swap roles after each tick: entry 0 holds the system total and
+ * entry 1 + N core N. A tick costs no allocation besides its
+ * output, which goes to the snapshot arena.
+ */
+typedef struct
+{
+    CPUTimes *previous; // Counters of the previous tick, zero before the first
+    CPUTimes *current;  // Counters being read this tick
+    UINT coreCount;     // Possible logical cores
+    BOOL hasBaseline;   // previous holds counters of an earlier tick
+} CPULoadSampler;
+
+/**
+ * @brief Sizes a sampler for a number of logical cores
+ *
+ * @param sampler Sampler to initialize
+ * @param coreCount Highest possible logical CPU number plus one
+ * @return BOOL TRUE if the counter arrays were allocated
+ */
+BOOL initCPULoadSampler(CPULoadSampler *sampler, UINT coreCount);
+
+/**
+ * @brief Frees the counter arrays of a sampler
+ *
+ * @param sampler Sampler to release, zeroed afterwards
+ */
+void releaseCPULoadSampler(CPULoadSampler *sampler);
+
+/**
+ * @brief Turns the counters of this tick into percentages
+ *
+ * This function:
+ * 1. Subtracts the previous counters from sampler->current
+ * 2. Treats counters that went backwards (core replugged) as restarted
+ * 3. Allocates the result from the arena
+ * 4. Keeps the current counters as the previous ones of the next tick
+ *
+ * The first tick only takes the baseline and reports zeros, like
+ * the disk I/O and network samplers; compared against zero it
+ * would show the average load since boot.
+ *
+ * @param sampler Sampler whose current array was filled by the platform
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return CPULoadInfo* Pointer to CPU utilization, NULL if failed
+ */
+CPULoadInfo *computeCPULoad(CPULoadSampler *sampler, SnapshotArena *arena);
+
+/**
+ * @brief Samples CPU utilization through NtQuerySystemInformation
+ *
+ * This function:
+ * 1. Reads idle, kernel, user, DPC and interrupt time of every core
+ * 2. Computes percentages against the previous tick
+ *
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return CPULoadInfo* Pointer to CPU utilization, NULL if failed or not opened
+ */
+CPULoadInfo *collectCPULoad(SnapshotArena *arena);
+
+/**
+ * @brief Sizes the Windows sampler and resolves NtQuerySystemInformation
+ *
+ * @return BOOL TRUE if CPU load can be sampled
+ */
+BOOL openCPULoadCollector(void);
+
+/**
+ * @brief Releases the Windows sampler
+ */
+void closeCPULoadCollector(void);
+
+#ifdef __linux__
+/**
+ * @brief Samples CPU utilization from /proc/stat
+ *
+ * This function:
+ * 1. Rereads /proc/stat through the descriptor kept open by openLinuxCPULoad()
+ * 2. Parses the "cpu" and "cpuN" lines into the sampler
+ * 3. Computes percentages against the previous tick
+ *
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return CPULoadInfo* Pointer to CPU utilization, NULL if failed or not opened
+ */
+CPULoadInfo *collectLinuxCPULoad(SnapshotArena *arena);
+
+/**
+ * @brief Opens /proc/stat and sizes the sampler for every possible core
+ *
+ * @return BOOL TRUE if /proc/stat could be opened
+ */
+BOOL openLinuxCPULoad(void);
+
+/**
+ * @brief Closes /proc/stat and releases the sampler
+ */
+void closeLinuxCPULoad(void);
+#endif
+
+/**
+ * @brief Frees CPU utilization allocated from the heap
+ *
+ * @param info Pointer to CPULoadInfo structure to be freed
+ */
+void freeCPULoadInfo(CPULoadInfo *info);
+
+#endif // CPU_LOAD_H
@@ -0,0 +1,158 @@
+#ifndef DISK_IO_H
+#define DISK_IO_H
+
+#include "fest_platform.h"
+#include "snapshot_arena.h"
+
+#define DISK_IO_NAME_LENGTH 32  // Longest block device name kept, terminator included
+#define DISK_IO_SECTOR_SIZE 512 // Bytes per sector in I/O counters, whatever the disk's sector size
+
+/**
+ * @brief Activity of one block device since the previous tick
+ *
+ * The service time is the average time a request took to
+ * complete, queueing included, over reads and writes together.
+ * Utilization is the share of the tick the device had requests in
+ * flight; a device serving requests in parallel (NVMe, RAID) can
+ * be at 100% without being saturated.
+ */
+typedef struct
+{
+    char device[DISK_IO_NAME_LENGTH]; // Block device (e.g., "nvme0n1p2")
+    double readIOPS;                  // Reads completed per second
+    double writeIOPS;                 // Writes completed per second
+    double readBytesPerSec;           // Bytes read per second
+    double writeBytesPerSec;          // Bytes written per second
+    double serviceTimeMs;             // Average time per request in milliseconds
+    double utilization;               // Time busy in percent
+} DiskIOStats;
+
+/**
+ * @brief Activity of every block device
+ *
+ * A device that appeared since the previous tick reports zeros
+ * until it has a baseline.
+ *
+ * @note Heap results (NULL arena) must be freed with freeDiskIOList()
+ */
+typedef struct
+{
+    DiskIOStats *devices; // Per block device
+    UINT count;           // Entries in devices
+} DiskIOList;
+
+/**
+ * @brief Cumulative I/O counters of one block device
+ */
+typedef struct
+{
+    char device[DISK_IO_NAME_LENGTH]; // Block device name
+    UINT64 reads;                     // Reads completed
+    UINT64 readSectors;               // Sectors read
+    UINT64 readTime;                  // Milliseconds spent on reads
+    UINT64 writes;                    // Writes completed
+    UINT64 writeSectors;              // Sectors written
+    UINT64 writeTime;                 // Milliseconds spent on writes
+    UINT64 busyTime;                  // Milliseconds with requests in flight
+} DiskIOCounters;
+
+/**
+ * @brief Counter state kept between ticks
+ *
+ * Both arrays hold capacity entries and swap roles after each
+ * tick. They grow only when more devices appear than ever before,
+ * so a steady tick costs no allocation besides its output.
+ */
+typedef struct
+{
+    DiskIOCounters *previous; // Counters of the previous tick
+    DiskIOCounters *current;  // Counters being read this tick
+    UINT previousCount;       // Devices in previous
+    UINT currentCount;        // Devices in current
+    UINT capacity;            // Entries allocated in each array
+    UINT64 previousTime;      // GetTickCount64() of the previous tick, 0 before the first
+    UINT64 currentTime;       // GetTickCount64() of this tick
+} DiskIOSampler;
+
+/**
+ * @brief Makes room for a number of devices in both counter arrays
+ *
+ * @param sampler Sampler to grow, zeroed for the first call
+ * @param count Devices this tick will read
+ * @return BOOL TRUE if both arrays hold at least count entries
+ */
+BOOL reserveDiskIOSampler(DiskIOSampler *sampler, UINT count);
+
+/**
+ * @brief Frees the counter arrays of a sampler
+ *
+ * @param sampler Sampler to release, zeroed afterwards
+ */
+void releaseDiskIOSampler(DiskIOSampler *sampler);
+
+/**
+ * @brief Turns the counters of this tick into rates
+ *
+ * This function:
+ * 1. Pairs each current device with its previous entry by name
+ * 2. Divides the counter deltas by the time between the ticks
+ * 3. Allocates the result from the arena
+ * 4. Keeps the current counters as the previous ones of the next tick
+ *
+ * Time counters that went backwards from the top half of the 32-bit
+ * range wrapped at 2^32, as the kernel keeps time fields in 32 bits.
+ * I/O and sector counts are 64-bit, so a decrease of one of them,
+ * like any other decrease, means the device was replaced under the
+ * same name and restarted from zero.
+ * The first tick and devices new since the previous one report zeros.
+ *
+ * @param sampler Sampler whose current array and time were filled by the platform
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return DiskIOList* Pointer to device activity, NULL if failed
+ */
+DiskIOList *computeDiskIO(DiskIOSampler *sampler, SnapshotArena *arena);
+
+/**
+ * @brief Looks up the activity of a block device
+ *
+ * @param list Device activity, may be NULL
+ * @param device Block device name, e.g. LogicalDiskInfo.device
+ * @return const DiskIOStats* Activity of the device, NULL if not listed
+ */
+const DiskIOStats *findDiskIO(const DiskIOList *list, const char *device);
+
+#ifdef __linux__
+/**
+ * @brief Samples block device activity from /proc/diskstats
+ *
+ * This function:
+ * 1. Rereads /proc/diskstats through the descriptor kept open by openLinuxDiskIO()
+ * 2. Skips loop and RAM disks
+ * 3. Computes rates against the previous tick
+ *
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return DiskIOList* Pointer to device activity, NULL if failed or not opened
+ */
+DiskIOList *collectLinuxDiskIO(SnapshotArena *arena);
+
+/**
+ * @brief Opens /proc/diskstats
+ *
+ * @return BOOL TRUE if /proc/diskstats could be opened
+ */
+BOOL openLinuxDiskIO(void);
+
+/**
+ * @brief Closes /proc/diskstats and releases the sampler
+ */
+void closeLinuxDiskIO(void);
+#endif
+
+/**
+ * @brief Frees device activity allocated from the heap
+ *
+ * @param list Pointer to DiskIOList structure to be freed
+ */
+void freeDiskIOList(DiskIOList *list);
+
+#endif // DISK_IO_H
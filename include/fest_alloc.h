@@ -0,0 +1,86 @@
+#ifndef FEST_ALLOC_H
+#define FEST_ALLOC_H
+
+#include "fest_platform.h"
+
+/**
+ * @brief Heap usage counters for library-owned allocations
+ *
+ * Tracks every allocation made through festMalloc/festRealloc:
+ * - Allocation and free counts
+ * - Total bytes requested
+ * - Live bytes and their high-water mark
+ *
+ * Counters are process-wide and updated atomically, so
+ * they can be read from any thread
+ *
+ * Builds with FEST_ALLOC_HOOK additionally count every heap
+ * request that reaches the library's C runtime, including
+ * plain malloc/realloc calls that bypass festMalloc
+ */
+typedef struct
+{
+    UINT64 allocCount;     // Successful allocations (malloc and growing realloc)
+    UINT64 freeCount;      // Released blocks
+    UINT64 allocatedBytes; // Total bytes requested since startup
+    UINT64 currentBytes;   // Bytes currently live
+    UINT64 peakBytes;      // Highest live byte count since last peak reset
+    UINT64 crtAllocCount;  // C runtime malloc/realloc requests (FEST_ALLOC_HOOK only)
+    BOOL crtCounting;      // TRUE if crtAllocCount is being maintained
+} AllocStats;
+
+/**
+ * @brief Allocates a block and records it in the heap counters
+ *
+ * @param size Number of bytes to allocate
+ * @return void* Pointer to allocated block, NULL if failed
+ * @note Must be released with festFree()
+ */
+void *festMalloc(size_t size);
+
+/**
+ * @brief Resizes a block obtained from festMalloc/festRealloc
+ *
+ * Behaves like realloc(): a NULL pointer allocates a new block,
+ * and on failure the original block is left untouched
+ *
+ * @param ptr Block to resize, may be NULL
+ * @param size New size in bytes
+ * @return void* Pointer to resized block, NULL if failed
+ */
+void *festRealloc(void *ptr, size_t size);
+
+/**
+ * @brief Releases a block obtained from festMalloc/festRealloc
+ *
+ * @param ptr Block to release, NULL is ignored
+ */
+void festFree(void *ptr);
+
+/**
+ * @brief Reads the current heap counters
+ *
+ * @param stats Structure to receive the counters
+ */
+void getAllocStats(AllocStats *stats);
+
+/**
+ * @brief Restarts peak tracking from the current live byte count
+ *
+ * Used by the monitoring engine to measure the heap
+ * high-water mark of a single tick
+ */
+void resetAllocPeak(void);
+
+/**
+ * @brief Starts counting C runtime heap requests of the library
+ *
+ * Installs a debug CRT allocation hook that sees every malloc,
+ * calloc and realloc made inside the library, whether or not it
+ * goes through festMalloc. Only available in debug builds compiled
+ * with FEST_ALLOC_HOOK; otherwise does nothing and crtCounting
+ * stays FALSE.
+ */
+void enableCrtAllocCounting(void);
+
+#endif // FEST_ALLOC_H
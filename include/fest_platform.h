@@ -0,0 +1,371 @@
+#ifndef FEST_PLATFORM_H
+#define FEST_PLATFORM_H
+
+/**
+ * @brief Windows base types for platform-independent modules
+ *
+ * On Windows this is just <windows.h>. Elsewhere it provides the
+ * subset of Windows types, macros and interlocked operations the
+ * platform-independent modules use, so those modules and their
+ * unit tests build unchanged with GCC/Clang:
+ * - Integer and boolean types (BOOL, UINT, DWORD, LONG64, ...)
+ * - HRESULT and SUCCEEDED/FAILED
+ * - Interlocked* operations on top of the __atomic builtins
+ * - QueryPerformanceCounter, GetTickCount64 and Sleep on the monotonic clock
+ * - Exclusive SRW locks on top of pthread mutexes
+ * - Mutex, event and thread HANDLEs for the monitoring engine
+ * - __declspec(thread) and the CRT "_s" string helpers in use
+ *
+ * Everything is inline except the HANDLE objects, which live in
+ * fest_platform.c (built outside Windows only).
+ */
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <wchar.h>
+
+typedef int BOOL;
+typedef uint8_t BYTE;
+typedef uint16_t WORD;
+typedef uint32_t DWORD;
+typedef int16_t SHORT;
+typedef uint16_t USHORT;
+typedef int INT;
+typedef unsigned int UINT;
+typedef int32_t LONG;
+typedef uint32_t ULONG;
+typedef int64_t LONG64;
+typedef int64_t LONGLONG;
+typedef uint64_t UINT64;
+typedef uint64_t ULONGLONG;
+typedef int32_t HRESULT;
+typedef void *PVOID;
+typedef void *LPVOID;
+typedef void *HANDLE;
+typedef wchar_t WCHAR; // 32-bit outside Windows, see transcoding helpers
+
+typedef union
+{
+    struct
+    {
+        DWORD LowPart;
+        LONG HighPart;
+    };
+    LONGLONG QuadPart;
+} LARGE_INTEGER;
+
+#ifndef TRUE
+#define TRUE 1
+#endif
+#ifndef FALSE
+#define FALSE 0
+#endif
+
+#define SUCCEEDED(hr) (((HRESULT)(hr)) >= 0)
+#define FAILED(hr) (((HRESULT)(hr)) < 0)
+
+#define S_OK ((HRESULT)0)
+#define S_FALSE ((HRESULT)1)
+#define E_FAIL ((HRESULT)0x80004005)
+#define E_POINTER ((HRESULT)0x80004003)
+#define E_OUTOFMEMORY ((HRESULT)0x8007000E)
+#define E_INVALIDARG ((HRESULT)0x80070057)
+
+// __declspec(x) maps to __declspec_x
+#define __declspec(x) __declspec_##x
+#define __declspec_thread __thread
+#define __declspec_dllexport __attribute__((visibility("default")))
+#define __declspec_dllimport
+
+#define __stdcall
+
+#define _TRUNCATE ((size_t)-1)
+
+#define INFINITE 0xFFFFFFFF      // Wait without timeout
+#define WAIT_OBJECT_0 0x00000000 // The object was signaled
+#define WAIT_TIMEOUT 0x00000102  // The timeout elapsed first
+#define WAIT_FAILED 0xFFFFFFFF   // Invalid handle
+
+static inline LONG InterlockedIncrement(volatile LONG *target)
+{
+    return __atomic_add_fetch(target, 1, __ATOMIC_SEQ_CST);
+}
+
+static inline LONG InterlockedDecrement(volatile LONG *target)
+{
+    return __atomic_sub_fetch(target, 1, __ATOMIC_SEQ_CST);
+}
+
+static inline LONG InterlockedExchange(volatile LONG *target, LONG value)
+{
+    return __atomic_exchange_n(target, value, __ATOMIC_SEQ_CST);
+}
+
+static inline LONG InterlockedCompareExchange(volatile LONG *target, LONG exchange, LONG comparand)
+{
+    __atomic_compare_exchange_n(target, &comparand, exchange, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return comparand;
+}
+
+static inline LONG64 InterlockedIncrement64(volatile LONG64 *target)
+{
+    return __atomic_add_fetch(target, 1, __ATOMIC_SEQ_CST);
+}
+
+static inline LONG64 InterlockedExchange64(volatile LONG64 *target, LONG64 value)
+{
+    return __atomic_exchange_n(target, value, __ATOMIC_SEQ_CST);
+}
+
+static inline LONG64 InterlockedExchangeAdd64(volatile LONG64 *target, LONG64 value)
+{
+    return __atomic_fetch_add(target, value, __ATOMIC_SEQ_CST);
+}
+
+static inline LONG64 InterlockedCompareExchange64(volatile LONG64 *target, LONG64 exchange, LONG64 comparand)
+{
+    __atomic_compare_exchange_n(target, &comparand, exchange, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return comparand;
+}
+
+static inline PVOID InterlockedCompareExchangePointer(PVOID volatile *target, PVOID exchange, PVOID comparand)
+{
+    __atomic_compare_exchange_n(target, &comparand, exchange, FALSE, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return comparand;
+}
+
+typedef pthread_mutex_t SRWLOCK;
+#define SRWLOCK_INIT PTHREAD_MUTEX_INITIALIZER
+
+static inline void AcquireSRWLockExclusive(SRWLOCK *lock)
+{
+    pthread_mutex_lock(lock);
+}
+
+static inline void ReleaseSRWLockExclusive(SRWLOCK *lock)
+{
+    pthread_mutex_unlock(lock);
+}
+
+/**
+ * @brief Reads the monotonic clock in nanoseconds
+ *
+ * @param counter Receives the clock value
+ * @return BOOL TRUE
+ */
+static inline BOOL QueryPerformanceCounter(LARGE_INTEGER *counter)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    counter->QuadPart = (LONGLONG)now.tv_sec * 1000000000LL + now.tv_nsec;
+    return TRUE;
+}
+
+/**
+ * @brief Returns the resolution of QueryPerformanceCounter()
+ *
+ * @param frequency Receives counts per second
+ * @return BOOL TRUE
+ */
+static inline BOOL QueryPerformanceFrequency(LARGE_INTEGER *frequency)
+{
+    frequency->QuadPart = 1000000000LL;
+    return TRUE;
+}
+
+/**
+ * @brief Milliseconds on the monotonic clock
+ *
+ * @return ULONGLONG Milliseconds since an arbitrary start
+ */
+static inline ULONGLONG GetTickCount64(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (ULONGLONG)now.tv_sec * 1000ULL + (ULONGLONG)now.tv_nsec / 1000000ULL;
+}
+
+/**
+ * @brief Suspends the calling thread
+ *
+ * @param milliseconds Time to sleep
+ */
+static inline void Sleep(DWORD milliseconds)
+{
+    struct timespec delay = {(time_t)(milliseconds / 1000), (long)(milliseconds % 1000) * 1000000L};
+    while (nanosleep(&delay, &delay) != 0 && errno == EINTR)
+        ;
+}
+
+/**
+ * @brief Creates a recursive mutex, unnamed and not owned
+ *
+ * @return HANDLE Mutex handle, NULL if failed
+ */
+HANDLE CreateMutex(void *attributes, BOOL initialOwner, const char *name);
+
+/**
+ * @brief Releases a mutex acquired with WaitForSingleObject()
+ */
+BOOL ReleaseMutex(HANDLE mutex);
+
+/**
+ * @brief Creates an unnamed manual or auto reset event
+ *
+ * @return HANDLE Event handle, NULL if failed
+ */
+HANDLE CreateEvent(void *attributes, BOOL manualReset, BOOL initialState, const char *name);
+
+/**
+ * @brief Signals an event
+ */
+BOOL SetEvent(HANDLE event);
+
+/**
+ * @brief Clears an event
+ */
+BOOL ResetEvent(HANDLE event);
+
+/**
+ * @brief Waits for a mutex, event or thread handle
+ *
+ * Mutexes are acquired, auto reset events are cleared and
+ * threads are signaled once they exited.
+ *
+ * @param handle Object to wait for
+ * @param milliseconds Timeout, INFINITE to wait without one
+ * @return DWORD WAIT_OBJECT_0, WAIT_TIMEOUT or WAIT_FAILED
+ */
+DWORD WaitForSingleObject(HANDLE handle, DWORD milliseconds);
+
+/**
+ * @brief Releases a handle, detaching a thread that is still running
+ */
+BOOL CloseHandle(HANDLE handle);
+
+/**
+ * @brief Starts a thread with the CRT _beginthreadex contract
+ *
+ * Only the start routine and its argument are used.
+ *
+ * @return uintptr_t Thread handle, 0 if failed
+ */
+uintptr_t _beginthreadex(void *security, unsigned stackSize, unsigned (*start)(void *),
+                         void *arg, unsigned initFlag, unsigned *threadId);
+
+/**
+ * @brief Returns the kernel id of the calling thread
+ */
+DWORD GetCurrentThreadId(void);
+
+/**
+ * @brief Returns the id of the calling process
+ */
+DWORD GetCurrentProcessId(void);
+
+/**
+ * @brief Bounded string copy with the MSVC strcpy_s contract
+ *
+ * @return int 0 on success, ERANGE with an empty result if src does not fit
+ */
+static inline int strcpy_s(char *dest, size_t destSize, const char *src)
+{
+    if (!dest || destSize == 0 || !src)
+        return 22; // EINVAL
+
+    size_t length = strlen(src);
+    if (length >= destSize)
+    {
+        dest[0] = '\0';
+        return 34; // ERANGE
+    }
+    memcpy(dest, src, length + 1);
+    return 0;
+}
+
+/**
+ * @brief Bounded string copy with the MSVC strncpy_s contract
+ *
+ * Only the _TRUNCATE mode used by this library is supported
+ *
+ * @return int 0 on success, EINVAL without a buffer
+ */
+static inline int strncpy_s(char *dest, size_t destSize, const char *src, size_t count)
+{
+    if (!dest || destSize == 0 || !src)
+        return 22; // EINVAL
+
+    size_t length = strnlen(src, destSize - 1);
+    if (count != _TRUNCATE && count < length)
+        length = count;
+    memcpy(dest, src, length);
+    dest[length] = '\0';
+    return 0;
+}
+
+/**
+ * @brief Opens a file with the MSVC fopen_s contract
+ *
+ * @return int 0 on success, errno otherwise
+ */
+static inline int fopen_s(FILE **file, const char *path, const char *mode)
+{
+    if (!file)
+        return 22; // EINVAL
+
+    *file = fopen(path, mode);
+    return *file ? 0 : errno;
+}
+
+#define _strtoui64 strtoull
+#define sscanf_s sscanf // Safe without %s, %c and %[ conversions
+
+/**
+ * @brief Formatted output with the MSVC _snprintf_s contract
+ *
+ * Only the _TRUNCATE mode used by this library is supported
+ *
+ * @return int Characters written, -1 if the output was truncated
+ */
+static inline int _snprintf_s(char *buffer, size_t bufferSize, size_t count, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(buffer, bufferSize, format, args);
+    va_end(args);
+    (void)count;
+    return (written < 0 || (size_t)written >= bufferSize) ? -1 : written;
+}
+
+/**
+ * @brief Wide to narrow conversion with the MSVC wcstombs_s contract
+ *
+ * Only the _TRUNCATE mode used by this library is supported:
+ * the result is always terminated and cut to fit the buffer
+ */
+static inline int wcstombs_s(size_t *converted, char *dest, size_t destSize, const wchar_t *src, size_t count)
+{
+    if (!dest || destSize == 0 || !src)
+        return 22; // EINVAL
+
+    size_t length = wcstombs(dest, src, destSize - 1);
+    if (length == (size_t)-1)
+        length = 0;
+    dest[length] = '\0';
+    if (converted)
+        *converted = length + 1;
+    (void)count;
+    return 0;
+}
+#endif
+
+#endif // FEST_PLATFORM_H
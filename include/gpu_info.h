@@ -1,10 +1,13 @@
 #ifndef GPU_INFO_H
 #define GPU_INFO_H
 
-#include <windows.h>
-#include <dxgi.h>
+#include "fest_platform.h"
 #include <stdio.h>
+
+#ifdef _WIN32
+#include <dxgi.h>
 #include <initguid.h>
+#endif
 
 /**
  * @brief Information about a single graphics processing unit
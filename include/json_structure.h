@@ -4,12 +4,30 @@
 #include "gpu_info.h"
 #include "motherboard_info.h"
 #include "cpu_info.h"
+#include "cpu_load.h"
+#include "cpu_freq.h"
 #include "memory_info.h"
 #include "storage_info.h"
+#include "disk_io.h"
 #include "network_info.h"
 #include "audio_info.h"
 #include "battery_info.h"
 #include "monitor_info.h"
+#include "system_info_dll.h"
+
+/**
+ * @brief Output buffer reused across JSON renders
+ *
+ * Grows to the largest document rendered so far and is
+ * kept between ticks, so steady-state rendering does not
+ * allocate
+ */
+typedef struct
+{
+    char *data;    // Rendered document, NULL until first render
+    size_t size;   // Capacity of data in bytes
+    size_t length; // Length of the last document
+} JSONBuffer;
 
 /**
  * @brief Generates a comprehensive JSON string of system information
@@ -21,26 +39,34 @@
  *   "gpu": [ ... ],           // Graphics adapters
  *   "motherboard": { ... },   // Motherboard details
  *   "cpu": [ ... ],           // Processors
+ *   "cpu_load": { ... },      // Utilization since the previous tick
+ *   "cpu_frequency": { ... }, // Current core clocks
  *   "memory": { ... },        // RAM configuration
- *   "storage": [ ... ],       // Storage devices
+ *   "storage": [ ... ],       // Storage volumes and their disk activity
  *   "network": {              // Network adapters
  *     "ethernet": [ ... ],
  *     "wifi": [ ... ]
  *   },
  *   "audio": [ ... ],         // Audio devices
  *   "battery": { ... },       // Power/battery status
- *   "monitors": [ ... ]       // Display devices
+ *   "monitors": [ ... ],      // Display devices
+ *   "overhead": { ... }       // Engine resource usage (optional)
  * }
  *
  * @param gpuList GPU information list
  * @param mbInfo Motherboard information
  * @param cpuList CPU information list
+ * @param cpuLoad CPU utilization
+ * @param cpuFrequency Core clocks
  * @param memInfo Memory information
+ * @param ramSlots Installed RAM modules, rendered inside the memory section
  * @param storageList Storage device list
+ * @param diskIO Block device activity, rendered inside the storage section
  * @param networkList Network adapter list
  * @param audioList Audio device list
  * @param batteryInfo Battery/power information
  * @param monitorList Monitor information list
+ * @param overhead Engine statistics, NULL to omit the section
  * @return char* Allocated JSON string, NULL if failed
  * @note Caller must free the returned string using freeJSONString()
  */
@@ -48,12 +74,65 @@ char *generateSystemInfoJSON(
     GPUList *gpuList,
     MotherboardInfo *mbInfo,
     CPUList *cpuList,
+    CPULoadInfo *cpuLoad,
+    CPUFrequencyInfo *cpuFrequency,
+    MemoryInfo *memInfo,
+    RAMSlotList *ramSlots,
+    StorageList *storageList,
+    DiskIOList *diskIO,
+    NetworkList *networkList,
+    AudioList *audioList,
+    BatteryInfo *batteryInfo,
+    MonitorList *monitorList,
+    const MonitoringStats *overhead);
+
+/**
+ * @brief Renders system information into a reusable buffer
+ *
+ * Produces the same document as generateSystemInfoJSON()
+ * without allocating once the buffer has grown large enough
+ *
+ * @param buffer Output buffer, zero-initialized before first use
+ * @param gpuList GPU information list
+ * @param mbInfo Motherboard information
+ * @param cpuList CPU information list
+ * @param cpuLoad CPU utilization
+ * @param cpuFrequency Core clocks
+ * @param memInfo Memory information
+ * @param ramSlots Installed RAM modules, rendered inside the memory section
+ * @param storageList Storage device list
+ * @param diskIO Block device activity, rendered inside the storage section
+ * @param networkList Network adapter list
+ * @param audioList Audio device list
+ * @param batteryInfo Battery/power information
+ * @param monitorList Monitor information list
+ * @param overhead Engine statistics, NULL to omit the section
+ * @return const char* Rendered document owned by buffer, NULL if failed
+ * @note The document is valid until the next render or releaseJSONBuffer()
+ */
+const char *renderSystemInfoJSON(
+    JSONBuffer *buffer,
+    GPUList *gpuList,
+    MotherboardInfo *mbInfo,
+    CPUList *cpuList,
+    CPULoadInfo *cpuLoad,
+    CPUFrequencyInfo *cpuFrequency,
     MemoryInfo *memInfo,
+    RAMSlotList *ramSlots,
     StorageList *storageList,
+    DiskIOList *diskIO,
     NetworkList *networkList,
     AudioList *audioList,
     BatteryInfo *batteryInfo,
-    MonitorList *monitorList);
+    MonitorList *monitorList,
+    const MonitoringStats *overhead);
+
+/**
+ * @brief Releases the memory of a reusable JSON buffer
+ *
+ * @param buffer Buffer to release, zeroed afterwards
+ */
+void releaseJSONBuffer(JSONBuffer *buffer);
 
 /**
  * @brief Frees memory allocated for JSON string
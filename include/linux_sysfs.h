@@ -0,0 +1,136 @@
+#ifndef LINUX_SYSFS_H
+#define LINUX_SYSFS_H
+
+#include "fest_platform.h"
+#include <dirent.h>
+
+#define SYSFS_PATH_LENGTH 512    // Longest sysfs/procfs path built, root included
+#define SYSFS_READ_INITIAL 16384 // First buffer size of readSysfsFileAlloc()
+
+/**
+ * @brief Redirects every sysfs and procfs read to another root
+ *
+ * Linux collectors address files by their absolute path
+ * ("/proc/meminfo", "/sys/class/power_supply"). Tests point the
+ * root at a captured fixture tree so the collectors parse known
+ * input. Set it before monitoring starts; it is not synchronized.
+ *
+ * @param root Directory prepended to every path, NULL or "" for the real root
+ */
+void setSysfsRoot(const char *root);
+
+/**
+ * @brief Returns the directory prepended to every path
+ *
+ * @return const char* Root set by setSysfsRoot(), "" for the real root
+ */
+const char *getSysfsRoot(void);
+
+/**
+ * @brief Prepends the root to an absolute sysfs or procfs path
+ *
+ * @param relative Absolute path below the root, e.g. "/proc/stat"
+ * @param path Buffer receiving the full path
+ * @param pathSize Size of the buffer in bytes
+ * @return BOOL TRUE if the path fit
+ */
+BOOL buildSysfsPath(const char *relative, char *path, size_t pathSize);
+
+/**
+ * @brief Opens a file below the root for reading
+ *
+ * @param relative Absolute path below the root
+ * @return int File descriptor (close-on-exec), -1 if failed
+ */
+int openSysfsFile(const char *relative);
+
+/**
+ * @brief Opens a directory below the root
+ *
+ * @param relative Absolute path below the root
+ * @return DIR* Directory stream, NULL if failed
+ */
+DIR *openSysfsDir(const char *relative);
+
+/**
+ * @brief Reads a whole file below the root
+ *
+ * @param relative Absolute path below the root
+ * @param buffer Buffer receiving the content, always terminated
+ * @param bufferSize Size of the buffer in bytes
+ * @return size_t Bytes read, 0 if the file is missing or empty
+ */
+size_t readSysfsFile(const char *relative, char *buffer, size_t bufferSize);
+
+/**
+ * @brief Reads a whole file of unknown size below the root
+ *
+ * procfs reports a size of 0 for every file, so the buffer starts
+ * at SYSFS_READ_INITIAL bytes and doubles until the content fits.
+ *
+ * @param relative Absolute path below the root
+ * @param length Receives the content length, may be NULL
+ * @return char* Terminated content, NULL if the file is missing or allocation failed
+ * @note Caller is responsible for freeing the returned buffer using festFree()
+ */
+char *readSysfsFileAlloc(const char *relative, size_t *length);
+
+/**
+ * @brief Rereads a file kept open across ticks
+ *
+ * procfs and sysfs regenerate the content on every read from
+ * offset 0, so one pread() replaces an open/read/close cycle.
+ *
+ * @param fd Descriptor from openSysfsFile()
+ * @param buffer Buffer receiving the content, always terminated
+ * @param bufferSize Size of the buffer in bytes
+ * @return size_t Bytes read, 0 if failed
+ */
+size_t preadSysfsFile(int fd, char *buffer, size_t bufferSize);
+
+/**
+ * @brief Reads the first line of a sysfs attribute
+ *
+ * @param relative Absolute path below the root
+ * @param value Buffer receiving the line without surrounding whitespace
+ * @param valueSize Size of the buffer in bytes
+ * @return BOOL TRUE if the attribute was read and is not empty
+ */
+BOOL readSysfsString(const char *relative, char *value, size_t valueSize);
+
+/**
+ * @brief Reads a decimal sysfs attribute
+ *
+ * @param relative Absolute path below the root
+ * @param value Receives the number
+ * @return BOOL TRUE if the attribute starts with a decimal number
+ */
+BOOL readSysfsUInt64(const char *relative, UINT64 *value);
+
+/**
+ * @brief Reads the target of a sysfs symbolic link
+ *
+ * Links such as /sys/dev/block/8:1 or /sys/block/sda point into
+ * /sys/devices; the path of the target names the bus a device
+ * hangs off.
+ *
+ * @param relative Absolute path of the link below the root
+ * @param target Buffer receiving the terminated link target
+ * @param targetSize Size of the buffer in bytes
+ * @return BOOL TRUE if the link was read and fit
+ */
+BOOL readSysfsLink(const char *relative, char *target, size_t targetSize);
+
+/**
+ * @brief Returns the number of possible logical cores
+ *
+ * The range list of /sys/devices/system/cpu/possible ("0-7",
+ * "0-3,8-11") ends with the highest core number. Per-core samplers
+ * size their arrays from it once, so cores coming online later
+ * already have a slot.
+ *
+ * @return UINT Highest possible core number plus one, 0 if the list is missing
+ */
+UINT readSysfsPossibleCPUs(void);
+
+#endif // LINUX_SYSFS_H
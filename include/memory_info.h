@@ -1,7 +1,8 @@
 #ifndef MEMORY_INFO_H
 #define MEMORY_INFO_H
 
-#include <windows.h>
+#include "fest_platform.h"
+#include "snapshot_arena.h"
 
 /**
  * @brief Information about a single RAM module/slot
@@ -32,7 +33,8 @@ typedef struct
  * - Array of RAMSlotInfo structures
  * - Number of populated slots
  *
- * @note Part of MemoryInfo structure
+ * Installed modules do not change at runtime, so the list is
+ * static information collected once per monitoring session.
  */
 typedef struct
 {
@@ -41,38 +43,81 @@ typedef struct
 } RAMSlotList;
 
 /**
- * @brief Comprehensive system memory information
+ * @brief System-wide memory counters
  *
- * Contains both system-wide memory metrics and
- * detailed information about individual RAM modules:
+ * Contains the memory metrics sampled every tick:
  * - Total/available/used physical memory
  * - Memory usage percentage
- * - RAM slot configuration
+ * - Swap, page cache and huge page usage
  *
- * All sizes are reported in bytes for maximum precision
+ * All sizes are reported in bytes for maximum precision.
+ * Windows has no buffer, dirty or huge page counters and
+ * reports them as 0; its swap is the page file headroom of
+ * the commit limit.
  */
 typedef struct
 {
-    UINT64 totalPhys;     // Total physical memory
-    UINT64 availPhys;     // Available physical memory
-    UINT64 usedPhys;      // Used physical memory
-    DWORD memoryLoad;     // Memory usage (0-100%)
-    RAMSlotList slotList; // Detailed RAM configuration
+    UINT64 totalPhys;      // Total physical memory
+    UINT64 availPhys;      // Available physical memory
+    UINT64 usedPhys;       // Used physical memory
+    DWORD memoryLoad;      // Memory usage (0-100%)
+    UINT64 totalSwap;      // Swap space
+    UINT64 freeSwap;       // Unused swap space
+    UINT64 cached;         // Page cache
+    UINT64 buffers;        // Block device buffers
+    UINT64 dirty;          // Page cache waiting for writeback
+    UINT64 hugePagesTotal; // Huge pages in the pool
+    UINT64 hugePagesFree;  // Huge pages not allocated
+    UINT64 hugePageSize;   // Size of one huge page in bytes
 } MemoryInfo;
 
 /**
- * @brief Retrieves comprehensive memory information
- *
- * This function:
- * 1. Collects system memory metrics
- * 2. Enumerates RAM modules
- * 3. Gathers detailed module specifications
+ * @brief Retrieves system memory counters
  *
  * @return MemoryInfo* Pointer to allocated memory information, NULL if failed
  * @note Caller is responsible for freeing the returned structure using freeMemoryInfo()
  */
 MemoryInfo *getMemoryInfo(void);
 
+/**
+ * @brief Collects memory information into a snapshot arena
+ *
+ * Same data as getMemoryInfo(), used by the monitoring engine
+ * so that a tick's output is released by resetting the arena
+ *
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return MemoryInfo* Pointer to memory information, NULL if failed
+ * @note Heap results (NULL arena) must be freed with freeMemoryInfo()
+ */
+MemoryInfo *collectMemoryInfo(SnapshotArena *arena);
+
+#ifdef __linux__
+/**
+ * @brief Collects memory counters from /proc/meminfo
+ *
+ * This function:
+ * 1. Rereads /proc/meminfo through the descriptor kept open by openLinuxMemory()
+ * 2. Parses every counter in a single pass over the buffer
+ * 3. Derives available memory on kernels without MemAvailable
+ *
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return MemoryInfo* Pointer to memory information, NULL if failed or not opened
+ */
+MemoryInfo *collectLinuxMemoryInfo(SnapshotArena *arena);
+
+/**
+ * @brief Opens /proc/meminfo for the monitoring session
+ *
+ * @return BOOL TRUE if /proc/meminfo could be opened
+ */
+BOOL openLinuxMemory(void);
+
+/**
+ * @brief Closes /proc/meminfo
+ */
+void closeLinuxMemory(void);
+#endif
+
 /**
  * @brief Frees memory allocated for memory information
  *
@@ -80,6 +125,25 @@ MemoryInfo *getMemoryInfo(void);
  */
 void freeMemoryInfo(MemoryInfo *info);
 
+/**
+ * @brief Retrieves the installed RAM modules
+ *
+ * This function:
+ * 1. Enumerates RAM modules
+ * 2. Gathers detailed module specifications
+ *
+ * @return RAMSlotList* Pointer to allocated list of RAM modules, NULL if failed
+ * @note Caller is responsible for freeing the returned list using freeRAMSlotList()
+ */
+RAMSlotList *getRAMSlotList(void);
+
+/**
+ * @brief Frees memory allocated for the RAM module list
+ *
+ * @param list Pointer to RAMSlotList structure to be freed
+ */
+void freeRAMSlotList(RAMSlotList *list);
+
 /**
  * @brief Converts bytes to gigabytes
  *
@@ -1,8 +1,11 @@
 #ifndef MONITOR_INFO_H
 #define MONITOR_INFO_H
 
-#include <windows.h>
+#include "fest_platform.h"
+
+#ifdef _WIN32
 #include <setupapi.h>
+#endif
 
 /**
  * @brief Comprehensive monitor/display information
@@ -45,6 +48,7 @@ typedef struct
 {
     MonitorInfo *monitors; // Array of monitor information
     UINT count;            // Number of connected displays
+    UINT capacity;         // Allocated entries in monitors
 } MonitorList;
 
 /**
@@ -1,7 +1,7 @@
 #ifndef MOTHERBOARD_INFO_H
 #define MOTHERBOARD_INFO_H
 
-#include <windows.h>
+#include "fest_platform.h"
 
 /**
  * @brief Comprehensive motherboard and BIOS information
@@ -38,6 +38,20 @@ typedef struct
  */
 MotherboardInfo *getMotherboardInfo(void);
 
+#ifdef __linux__
+/**
+ * @brief Reads board, BIOS and SKU strings from /sys/class/dmi/id
+ *
+ * Serial numbers are readable by root only and stay empty otherwise.
+ * The system serial stands in for the BIOS serial, as it does in
+ * Win32_BIOS.
+ *
+ * @return MotherboardInfo* Pointer to allocated information, NULL if failed
+ * @note Caller is responsible for freeing the returned structure using freeMotherboardInfo()
+ */
+MotherboardInfo *getLinuxMotherboardInfo(void);
+#endif
+
 /**
  * @brief Frees memory allocated for motherboard information
  *
@@ -1,8 +1,31 @@
 #ifndef NETWORK_INFO_H
 #define NETWORK_INFO_H
 
-#include <windows.h>
+#include "fest_platform.h"
+#include "snapshot_arena.h"
+
+#ifdef _WIN32
 #include <iphlpapi.h>
+#else
+#define MIB_IF_TYPE_ETHERNET 6  // IANA ifType ethernetCsmacd
+#define MIB_IF_TYPE_LOOPBACK 24 // IANA ifType softwareLoopback
+#define IF_TYPE_IEEE80211 71    // IANA ifType ieee80211
+#define IF_TYPE_OTHER 1         // IANA ifType other
+#endif
+
+#define NETWORK_ADDRESS_LENGTH 46 // Longest IPv6 text form (INET6_ADDRSTRLEN), terminator included
+#define NETWORK_MAC_LENGTH 64     // Longest hardware address text, terminator included
+#define NETWORK_INITIAL_SLOTS 16  // Interfaces the first counter array holds, a power of two
+
+/**
+ * @brief An IPv4 or IPv6 address assigned to an adapter
+ */
+typedef struct
+{
+    char address[NETWORK_ADDRESS_LENGTH]; // Address in text form (e.g., "fe80::1")
+    UINT prefixLength;                    // Network prefix in bits
+    BOOL ipv6;                            // TRUE for IPv6, FALSE for IPv4
+} NetworkAddress;
 
 /**
  * @brief Information about a single network adapter
@@ -13,18 +36,36 @@
  * - Connection status
  * - Interface type
  *
- * Supports both Ethernet and WiFi adapters
- * IP addresses are in IPv4 format
+ * Supports both Ethernet and WiFi adapters. ipAddress is the
+ * first IPv4 address; every IPv4 and IPv6 address of the adapter
+ * is listed in NetworkList.addresses, starting at firstAddress.
+ * GetAdaptersInfo only knows IPv4, so Windows lists no IPv6.
+ *
+ * Rates and error counts cover the time since the previous tick;
+ * they are zero on the first tick, for an adapter that appeared
+ * since, and for results of getNetworkList().
  *
  * @note Maximum adapter name length is 255 characters
  */
 typedef struct
 {
-    char name[256];      // Adapter friendly name
-    char macAddress[64]; // Physical (MAC) address
-    char ipAddress[16];  // IPv4 address
-    char status[32];     // Connection status
-    UINT type;           // Interface type (Ethernet/WiFi)
+    char name[256];                      // Adapter friendly name
+    char macAddress[NETWORK_MAC_LENGTH]; // Physical (MAC) address
+    char ipAddress[16];                  // IPv4 address
+    char status[32];                     // Connection status
+    char operState[16];                  // RFC 2863 operational state ("up", "down", "dormant", ...)
+    UINT type;                           // Interface type (Ethernet/WiFi)
+    UINT index;                          // Interface index
+    UINT firstAddress;                   // First entry in NetworkList.addresses
+    UINT addressCount;                   // Entries in NetworkList.addresses
+    double rxBytesPerSec;                // Bytes received per second
+    double txBytesPerSec;                // Bytes sent per second
+    double rxPacketsPerSec;              // Packets received per second
+    double txPacketsPerSec;              // Packets sent per second
+    UINT64 rxErrors;                     // Receive errors since the previous tick
+    UINT64 txErrors;                     // Send errors since the previous tick
+    UINT64 rxDropped;                    // Received packets dropped since the previous tick
+    UINT64 txDropped;                    // Outgoing packets dropped since the previous tick
 } NetworkAdapterInfo;
 
 /**
@@ -42,8 +83,56 @@ typedef struct
 {
     NetworkAdapterInfo *adapters; // Array of adapter information
     UINT count;                   // Number of adapters
+    NetworkAddress *addresses;    // Addresses of all adapters, grouped by adapter
+    UINT addressCount;            // Number of addresses
 } NetworkList;
 
+/**
+ * @brief Cumulative 64-bit traffic counters of one interface
+ */
+typedef struct
+{
+    UINT64 rxBytes;   // Bytes received
+    UINT64 txBytes;   // Bytes sent
+    UINT64 rxPackets; // Packets received
+    UINT64 txPackets; // Packets sent
+    UINT64 rxErrors;  // Receive errors
+    UINT64 txErrors;  // Send errors
+    UINT64 rxDropped; // Received packets dropped
+    UINT64 txDropped; // Outgoing packets dropped
+} NetworkCounters;
+
+/**
+ * @brief Counters of one interface index as of a tick
+ */
+typedef struct
+{
+    NetworkCounters counters; // Counters read at time
+    UINT64 time;              // GetTickCount64() of the tick that read them
+    UINT index;               // Interface index the counters belong to
+} NetworkCounterSlot;
+
+/**
+ * @brief Counter state kept between ticks
+ *
+ * Interface indexes only grow on Linux as links come and go, so
+ * the counters are not indexed by them. The slots of the
+ * interfaces read recently are kept dense, and an open-addressed
+ * map with twice as many entries finds the slot of an index.
+ * Slots the previous tick did not read are reclaimed when the next
+ * one begins. Both arrays grow only when more interfaces than ever
+ * before are up at once, so a steady tick costs no allocation.
+ */
+typedef struct
+{
+    NetworkCounterSlot *slots; // Counters of the interfaces read recently, count used
+    UINT *map;                 // Slot number + 1 per hashed index, 0 if empty
+    UINT count;                // Entries used in slots
+    UINT capacity;             // Entries allocated in slots, a power of two; map has twice as many
+    UINT64 previousTime;       // GetTickCount64() of the previous tick, 0 before the first
+    UINT64 currentTime;        // GetTickCount64() of this tick
+} NetworkSampler;
+
 /**
  * @brief Retrieves information about network adapters
  *
@@ -58,6 +147,120 @@ typedef struct
  */
 NetworkList *getNetworkList(void);
 
+/**
+ * @brief Collects adapter list into a snapshot arena
+ *
+ * Same data as getNetworkList() plus traffic rates, used by the
+ * monitoring engine so that a tick's output is released by
+ * resetting the arena
+ *
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return NetworkList* Pointer to adapter list, NULL if failed
+ * @note Heap results (NULL arena) must be freed with freeNetworkList()
+ */
+NetworkList *collectNetworkList(SnapshotArena *arena);
+
+/**
+ * @brief Releases the Windows traffic sampler
+ */
+void closeNetworkCollector(void);
+
+/**
+ * @brief Starts a tick of a traffic sampler
+ *
+ * Reclaims the slots of interfaces the previous tick did not read;
+ * their counters are no baseline for this tick.
+ *
+ * @param sampler Sampler, zeroed before the first tick
+ * @param now GetTickCount64() of this tick
+ */
+void beginNetworkSample(NetworkSampler *sampler, UINT64 now);
+
+/**
+ * @brief Turns the counters of an adapter into rates
+ *
+ * This function:
+ * 1. Finds the slot of adapter->index, taking a free one for a new index
+ * 2. Divides their deltas by the time between the ticks into the adapter
+ * 3. Stores this tick's counters in their place
+ *
+ * A counter that went backwards was reset, e.g. by a driver reload
+ * or an index reused for a new interface, and counts from zero.
+ *
+ * @param sampler Sampler started with beginNetworkSample()
+ * @param adapter Adapter whose index is set, receives the rates
+ * @param counters Cumulative counters read this tick
+ */
+void computeNetworkRates(NetworkSampler *sampler, NetworkAdapterInfo *adapter, const NetworkCounters *counters);
+
+/**
+ * @brief Frees the counter arrays of a sampler
+ *
+ * @param sampler Sampler to release, zeroed afterwards
+ */
+void releaseNetworkSampler(NetworkSampler *sampler);
+
+#ifdef __linux__
+/**
+ * @brief Collects network adapters through rtnetlink
+ *
+ * This function:
+ * 1. Dumps RTM_GETLINK and RTM_GETADDR once each on the socket
+ *    kept open by openLinuxNetwork()
+ * 2. Builds the adapter list and its traffic rates with parseLinuxNetworkDump()
+ *
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return NetworkList* Pointer to adapter list, NULL if failed or not opened
+ */
+NetworkList *collectLinuxNetworkList(SnapshotArena *arena);
+
+/**
+ * @brief Builds the adapter list from rtnetlink dumps
+ *
+ * This function:
+ * 1. Adds one adapter per RTM_NEWLINK message, with its name,
+ *    permanent MAC address (the current one if unknown) and operstate
+ * 2. Types it from the ARPHRD of the link: loopback, Wi-Fi when
+ *    /sys/class/net/<name> has wireless or phy80211, Ethernet when
+ *    it has a device entry, other for virtual links
+ * 3. Attaches every RTM_NEWADDR address to its adapter
+ * 4. Computes traffic rates from IFLA_STATS64 when a sampler is given
+ *
+ * @param links RTM_NEWLINK messages as received
+ * @param linksLength Size of links in bytes
+ * @param addresses RTM_NEWADDR messages as received
+ * @param addressesLength Size of addresses in bytes
+ * @param sampler Sampler started with beginNetworkSample(), NULL for no rates
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return NetworkList* Pointer to adapter list, NULL if failed
+ */
+NetworkList *parseLinuxNetworkDump(const BYTE *links, size_t linksLength,
+                                   const BYTE *addresses, size_t addressesLength,
+                                   NetworkSampler *sampler, SnapshotArena *arena);
+
+/**
+ * @brief Opens the rtnetlink socket
+ *
+ * @return BOOL TRUE if the socket could be opened
+ */
+BOOL openLinuxNetwork(void);
+
+/**
+ * @brief Closes the rtnetlink socket and releases the dump buffers and sampler
+ */
+void closeLinuxNetwork(void);
+#endif
+
+/**
+ * @brief Formats a hardware address as dash-separated hex bytes
+ *
+ * @param address Address bytes
+ * @param length Number of bytes
+ * @param buffer Receives the text (e.g., "00-1A-2B-3C-4D-5E")
+ * @param bufferSize Size of buffer in bytes
+ */
+void formatMacAddress(const BYTE *address, UINT length, char *buffer, size_t bufferSize);
+
 /**
  * @brief Frees memory allocated for network adapter list
  *
@@ -97,6 +300,14 @@ const char *getAdapterIPAddress(const NetworkAdapterInfo *adapter);
  */
 const char *getAdapterStatus(const NetworkAdapterInfo *adapter);
 
+/**
+ * @brief Gets the operational state of a network adapter
+ *
+ * @param adapter Pointer to NetworkAdapterInfo structure
+ * @return const char* Operational state or empty string if adapter is NULL
+ */
+const char *getAdapterOperState(const NetworkAdapterInfo *adapter);
+
 /**
  * @brief Checks if the adapter is an Ethernet interface
  *
@@ -0,0 +1,47 @@
+#ifndef OVERHEAD_STATS_H
+#define OVERHEAD_STATS_H
+
+#include "fest_platform.h"
+
+/**
+ * @brief Point-in-time resource counters of the calling thread
+ *
+ * Captures what the monitoring thread has consumed so far:
+ * - Wall clock timestamp
+ * - Thread CPU time (user + kernel)
+ * - Context switches
+ * - Library heap allocations
+ *
+ * Two samples taken around a tick give its cost
+ */
+typedef struct
+{
+    UINT64 wallTimeUs;      // Monotonic timestamp in microseconds
+    UINT64 cpuTimeUs;       // Thread user + kernel time in microseconds
+    UINT64 contextSwitches; // Thread context switches since creation
+    UINT64 allocCount;      // Library allocations since startup
+    UINT64 allocatedBytes;  // Library bytes requested since startup
+} OverheadSample;
+
+/**
+ * @brief Samples resource counters of the calling thread
+ *
+ * This function:
+ * 1. Reads the monotonic clock
+ * 2. Reads thread CPU times
+ * 3. Looks up the thread's context switch counter
+ * 4. Reads library heap counters
+ *
+ * @param sample Structure to receive the counters
+ * @return BOOL TRUE if all counters were read, FALSE if any is unavailable
+ */
+BOOL takeOverheadSample(OverheadSample *sample);
+
+/**
+ * @brief Releases buffers cached by the sampler
+ *
+ * Call once the monitoring thread has exited
+ */
+void releaseOverheadSampler(void);
+
+#endif // OVERHEAD_STATS_H
@@ -0,0 +1,102 @@
+#ifndef SMBIOS_H
+#define SMBIOS_H
+
+#include "fest_platform.h"
+#include "motherboard_info.h"
+#include "memory_info.h"
+
+#define SMBIOS_TYPE_BIOS 0           // BIOS Information
+#define SMBIOS_TYPE_SYSTEM 1         // System Information
+#define SMBIOS_TYPE_BASEBOARD 2      // Baseboard (motherboard) Information
+#define SMBIOS_TYPE_MEMORY_DEVICE 17 // Memory Device, one per slot
+#define SMBIOS_TYPE_END 127          // End-of-Table marker
+#define SMBIOS_HEADER_LENGTH 4       // Type, length and handle of every structure
+
+/**
+ * @brief Decodes a raw SMBIOS structure table
+ *
+ * This function:
+ * 1. Walks the structures once, from the first to End-of-Table
+ * 2. Fills board, BIOS and SKU strings from types 0, 1 and 2
+ * 3. Appends one RAMSlotInfo per populated type 17 memory device
+ *
+ * Fields newer than the table's SMBIOS version are recognized by
+ * the structure length and left empty. Strings are trimmed of the
+ * padding firmware often leaves around them.
+ *
+ * @param table Structure table, without the entry point
+ * @param length Size of the table in bytes
+ * @param board Receives board, BIOS and SKU strings, may be NULL
+ * @param slots Receives the populated slots, may be NULL
+ * @return BOOL TRUE if at least one structure was decoded
+ * @note The slot array is allocated with festMalloc() and released by freeRAMSlotList()
+ */
+BOOL parseSMBIOSTable(const BYTE *table, size_t length, MotherboardInfo *board, RAMSlotList *slots);
+
+/**
+ * @brief Reads the SMBIOS structure table of the running machine
+ *
+ * Linux exposes it as /sys/firmware/dmi/tables/DMI, readable by
+ * root only; Windows returns it from GetSystemFirmwareTable('RSMB')
+ * to any user.
+ *
+ * @param length Receives the size of the table in bytes
+ * @return BYTE* Structure table, NULL if unavailable
+ * @note Caller is responsible for freeing the returned table using festFree()
+ */
+BYTE *readSMBIOSTable(size_t *length);
+
+/**
+ * @brief Decodes board strings and RAM modules from one table read
+ *
+ * This function:
+ * 1. Reads the structure table once with readSMBIOSTable()
+ * 2. Decodes both results in a single parseSMBIOSTable() pass
+ *
+ * @param board Receives the board, BIOS and SKU strings, may be NULL
+ * @param slots Receives the installed RAM modules, may be NULL
+ * @return BOOL TRUE if the table was read and decoded, FALSE if unavailable
+ * @note Release the results with freeMotherboardInfo() and freeRAMSlotList()
+ */
+BOOL getSMBIOSInfo(MotherboardInfo **board, RAMSlotList **slots);
+
+/**
+ * @brief Decodes the table for the static collectors of a session
+ *
+ * Lifecycle hook of the motherboard and RAM slot collectors. Opens
+ * are counted: the first one decodes board strings and RAM modules
+ * with getSMBIOSInfo(), and the getters below take them instead of
+ * reading the table again. The last close frees what was not taken.
+ *
+ * @return BOOL Always TRUE, collectors fall back to other sources without a table
+ */
+BOOL openSMBIOSCollector(void);
+
+/**
+ * @brief Drops an open taken by openSMBIOSCollector()
+ */
+void closeSMBIOSCollector(void);
+
+/**
+ * @brief Retrieves board, BIOS and SKU strings from SMBIOS
+ *
+ * Takes the strings decoded by openSMBIOSCollector() while they
+ * are held, and reads the table otherwise.
+ *
+ * @return MotherboardInfo* Pointer to allocated information, NULL if the table is unavailable
+ * @note Caller is responsible for freeing the returned structure using freeMotherboardInfo()
+ */
+MotherboardInfo *getSMBIOSMotherboardInfo(void);
+
+/**
+ * @brief Retrieves the installed RAM modules from SMBIOS
+ *
+ * Takes the modules decoded by openSMBIOSCollector() while they
+ * are held, and reads the table otherwise.
+ *
+ * @return RAMSlotList* Pointer to allocated list of RAM modules, NULL if the table is unavailable
+ * @note Caller is responsible for freeing the returned list using freeRAMSlotList()
+ */
+RAMSlotList *getSMBIOSRAMSlotList(void);
+
+#endif // SMBIOS_H
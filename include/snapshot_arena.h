@@ -0,0 +1,88 @@
+#ifndef SNAPSHOT_ARENA_H
+#define SNAPSHOT_ARENA_H
+
+#include "fest_platform.h"
+
+typedef struct ArenaChunk ArenaChunk;
+
+/**
+ * @brief Bump allocator for the data of one monitoring snapshot
+ *
+ * Collector output of a tick is carved out of one or more chunks
+ * and released all at once by resetting the arena:
+ * - Allocation is a pointer bump, blocks are never freed individually
+ * - Reset keeps the memory, so steady-state ticks do not touch the heap
+ * - An arena that overflowed is consolidated into a single chunk
+ *   sized to its high-water mark on the next reset
+ *
+ * @note An arena is not thread-safe, each snapshot owns its own
+ */
+typedef struct
+{
+    ArenaChunk *chunks;  // First chunk, reused after reset
+    ArenaChunk *current; // Chunk serving allocations
+    size_t used;         // Bytes used in all chunks before and including current
+    size_t highWater;    // Largest used since the arena was created
+} SnapshotArena;
+
+/**
+ * @brief Prepares an arena with one chunk of the given size
+ *
+ * @param arena Arena to initialize
+ * @param initialSize Capacity of the first chunk in bytes
+ * @return BOOL TRUE if the first chunk was allocated, FALSE if failed
+ */
+BOOL initSnapshotArena(SnapshotArena *arena, size_t initialSize);
+
+/**
+ * @brief Allocates a block from the arena
+ *
+ * Blocks are 16-byte aligned. When the current chunk is full a
+ * new chunk of at least twice its size is chained behind it.
+ *
+ * @param arena Arena to allocate from
+ * @param size Number of bytes to allocate
+ * @return void* Pointer to the block, NULL if failed
+ * @note The block stays valid until the arena is reset or released
+ */
+void *arenaAlloc(SnapshotArena *arena, size_t size);
+
+/**
+ * @brief Invalidates all blocks and makes the memory reusable
+ *
+ * @param arena Arena to reset
+ */
+void resetSnapshotArena(SnapshotArena *arena);
+
+/**
+ * @brief Releases all memory owned by the arena
+ *
+ * @param arena Arena to release, may be reinitialized afterwards
+ */
+void releaseSnapshotArena(SnapshotArena *arena);
+
+/**
+ * @brief Allocates collector output from an arena or the heap
+ *
+ * Collectors take an optional arena: the monitoring engine passes
+ * its snapshot arena, while the public get* functions pass NULL
+ * and return heap blocks released by the matching free* function.
+ *
+ * @param arena Snapshot arena, NULL to use festMalloc()
+ * @param size Number of bytes to allocate
+ * @return void* Pointer to the block, NULL if failed
+ */
+void *snapshotAlloc(SnapshotArena *arena, size_t size);
+
+/**
+ * @brief Releases a block obtained from snapshotAlloc()
+ *
+ * Used on collector error paths. Arena blocks are left to the
+ * next reset, heap blocks are released with festFree().
+ *
+ * @param arena Arena the block came from, NULL for heap blocks
+ * @param ptr Block to release, NULL is ignored
+ */
+void snapshotFree(SnapshotArena *arena, void *ptr);
+
+#endif // SNAPSHOT_ARENA_H
@@ -1,7 +1,10 @@
 #ifndef STORAGE_INFO_H
 #define STORAGE_INFO_H
 
-#include <windows.h>
+#include "fest_platform.h"
+#include "snapshot_arena.h"
+
+#define STORAGE_MOUNT_PATH_LENGTH 260 // Longest mount point kept, terminator included
 
 /**
  * @brief Information about a physical storage device
@@ -26,21 +29,28 @@ typedef struct
  * @brief Information about a logical storage volume
  *
  * Contains volume-level disk information:
- * - Drive letter and type
+ * - Drive letter or mount point and type
  * - Volume identification
  * - Storage capacity
- * - Connection details
+ * - Connection details of the disk holding it
  *
- * All sizes are reported in gigabytes (GB)
+ * All sizes are reported in gigabytes (GB). Linux volumes have
+ * no drive letter and report "N/A"; Windows does not report the
+ * block device or whether the disk is rotational.
  */
 typedef struct
 {
-    char drive[4];          // Volume letter (e.g., "C:")
-    char type[32];          // Volume type (Fixed/Removable)
-    char model[256];        // Volume label or disk model
-    char interfaceType[64]; // Connection interface type
-    double totalSize;       // Total capacity in GB
-    double freeSpace;       // Available space in GB
+    char drive[4];                              // Volume letter (e.g., "C:")
+    char mountPoint[STORAGE_MOUNT_PATH_LENGTH]; // Volume root (e.g., "C:\\" or "/home")
+    char device[32];                            // Block device of the volume (e.g., "nvme0n1p2")
+    char fileSystem[16];                        // Filesystem type (NTFS, ext4, ...)
+    char type[32];                              // Volume type (Fixed/Removable)
+    char model[256];                            // Volume label or disk model
+    char interfaceType[64];                     // Connection interface type
+    BOOL rotational;                            // Disk has spinning platters
+    double diskSize;                            // Capacity of the whole disk in GB
+    double totalSize;                           // Total capacity in GB
+    double freeSpace;                           // Available space in GB
 } LogicalDiskInfo;
 
 /**
@@ -74,6 +84,50 @@ typedef struct
  */
 StorageList *getStorageList(void);
 
+/**
+ * @brief Collects volume list into a snapshot arena
+ *
+ * Same data as getStorageList(), used by the monitoring engine
+ * so that a tick's output is released by resetting the arena
+ *
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return StorageList* Pointer to volume list, NULL if failed
+ * @note Heap results (NULL arena) must be freed with freeStorageList()
+ */
+StorageList *collectStorageList(SnapshotArena *arena);
+
+#ifdef __linux__
+/**
+ * @brief Collects mounted block device volumes
+ *
+ * This function:
+ * 1. Parses /proc/self/mountinfo, skipping pseudo filesystems
+ * 2. Keeps one volume per block device, however often it is mounted
+ * 3. Describes each disk once from /sys/block/<disk>
+ * 4. Refreshes size and free space with statvfs
+ *
+ * Steps 1 to 3 run only when the mount table changes.
+ *
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return StorageList* Pointer to volume list, NULL if failed
+ */
+StorageList *collectLinuxStorageList(SnapshotArena *arena);
+
+/**
+ * @brief Drops the cached Linux storage topology
+ */
+void releaseLinuxStorageTopology(void);
+#endif
+
+/**
+ * @brief Drops the cached storage topology
+ *
+ * Disks, volumes and their mapping are discovered once and
+ * reused until the set of mounted volumes changes. This
+ * releases that cache; the next collection rediscovers it.
+ */
+void releaseStorageTopology(void);
+
 /**
  * @brief Frees memory allocated for storage information list
  *
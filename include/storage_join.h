@@ -0,0 +1,97 @@
+#ifndef STORAGE_JOIN_H
+#define STORAGE_JOIN_H
+
+#include "fest_platform.h"
+#include "snapshot_arena.h"
+
+#include <stddef.h>
+
+#define STORAGE_KEY_LENGTH 128 // Longest DeviceID key kept by the join, terminator included
+
+/**
+ * @brief Keys of one association object
+ *
+ * Win32_DiskDriveToDiskPartition and Win32_LogicalDiskToPartition
+ * reference both ends by object path; only the DeviceID key of
+ * each path is kept
+ */
+typedef struct
+{
+    char antecedent[STORAGE_KEY_LENGTH]; // DeviceID of the Antecedent reference
+    char dependent[STORAGE_KEY_LENGTH];  // DeviceID of the Dependent reference
+} StorageLinkRow;
+
+/**
+ * @brief Rows of one side of the join
+ *
+ * The rows belong to the caller; the join only reads the
+ * NUL-terminated key found at keyOffset in every row
+ */
+typedef struct
+{
+    const void *rows; // First row
+    UINT count;       // Number of rows
+    size_t rowSize;   // Size of one row in bytes
+    size_t keyOffset; // Offset of the DeviceID string in a row
+} StorageJoinTable;
+
+/**
+ * @brief The four result sets joined into the storage list
+ */
+typedef struct
+{
+    StorageJoinTable disks;                   // Win32_DiskDrive rows
+    const StorageLinkRow *diskPartitions;     // Win32_DiskDriveToDiskPartition links
+    UINT diskPartitionCount;                  // Number of disk to partition links
+    const StorageLinkRow *partitionVolumes;   // Win32_LogicalDiskToPartition links
+    UINT partitionVolumeCount;                // Number of partition to volume links
+    StorageJoinTable volumes;                 // Win32_LogicalDisk rows
+} StorageJoinInput;
+
+/**
+ * @brief One disk and one of its volumes
+ */
+typedef struct
+{
+    UINT disk;   // Index into the disk rows
+    UINT volume; // Index into the volume rows
+} StorageJoinMatch;
+
+/**
+ * @brief Extracts the DeviceID key from a WMI object path
+ *
+ * Accepts paths such as
+ * \\HOST\root\cimv2:Win32_DiskDrive.DeviceID="\\\\.\\PHYSICALDRIVE0"
+ * and removes the backslash escaping of the quoted value.
+ *
+ * @param path Object path of an association reference
+ * @param key Buffer receiving the unescaped key
+ * @param keySize Size of the buffer in bytes
+ * @return BOOL TRUE if a complete quoted key was found and fit
+ */
+BOOL parseStorageObjectKey(const char *path, char *key, size_t keySize);
+
+/**
+ * @brief Joins disks to volumes through their partitions
+ *
+ * This function:
+ * 1. Hashes the volume rows on DeviceID
+ * 2. Hashes both link tables on their Antecedent key
+ * 3. Walks every disk's partitions and their volumes
+ * 4. Emits the matches grouped by disk, in link order
+ *
+ * Keys compare case-insensitively like WMI keys. Links to disks,
+ * partitions or volumes that are not in the input are skipped.
+ * Cost is linear in the total number of rows.
+ *
+ * @param input Rows and links to join
+ * @param arena Arena for the scratch tables and result, NULL for the heap
+ * @param matches Receives the matches, NULL when there are none
+ * @param matchCount Receives the number of matches
+ * @return BOOL TRUE on success, FALSE if allocation failed
+ * @note Release *matches with snapshotFree(arena, *matches)
+ */
+BOOL joinStorageTables(const StorageJoinInput *input, SnapshotArena *arena,
+                       StorageJoinMatch **matches, UINT *matchCount);
+
+#endif // STORAGE_JOIN_H
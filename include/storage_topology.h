@@ -0,0 +1,145 @@
+#ifndef STORAGE_TOPOLOGY_H
+#define STORAGE_TOPOLOGY_H
+
+#include "fest_platform.h"
+#include "storage_info.h"
+#include "snapshot_arena.h"
+
+/**
+ * @brief One reported disk with the volume its space is read from
+ */
+typedef struct
+{
+    LogicalDiskInfo info;                       // Static fields, space is refreshed on collection
+    char mountPoint[STORAGE_MOUNT_PATH_LENGTH]; // Root of the joined volume, empty if none
+} StorageVolumeEntry;
+
+/**
+ * @brief Disks, volumes and their mapping
+ *
+ * Expensive to discover and almost never changes, so it is
+ * built once and reused until the set of mounts changes
+ */
+typedef struct
+{
+    StorageVolumeEntry *entries; // Heap array owned by the cache
+    UINT count;                  // Number of entries
+} StorageTopology;
+
+/**
+ * @brief Discovers the storage topology
+ *
+ * @param topology Receives entries allocated with festMalloc()
+ * @return BOOL TRUE on success, FALSE if discovery failed
+ */
+typedef BOOL (*StorageTopologyBuilder)(StorageTopology *topology);
+
+/**
+ * @brief Returns a value that changes whenever a volume is mounted or unmounted
+ */
+typedef UINT64 (*MountSignatureSource)(void);
+
+/**
+ * @brief Activity counters of a topology cache
+ */
+typedef struct
+{
+    UINT64 builds;        // Topology discoveries
+    UINT64 invalidations; // Topologies dropped after a mount change
+    UINT64 refreshes;     // Free-space passes
+    UINT64 spaceFailures; // Volumes whose space could not be read
+} StorageTopologyStats;
+
+/**
+ * @brief Cached topology of one storage backend
+ *
+ * Declare with STORAGE_TOPOLOGY_CACHE_INIT. Access is serialized
+ * by the cache's lock, so collectors may run on several threads.
+ */
+typedef struct
+{
+    SRWLOCK lock;                   // Guards every other member
+    StorageTopologyBuilder builder; // Discovers the topology
+    StorageTopology topology;       // Current topology, valid when valid is TRUE
+    UINT64 signature;               // Mount signature the topology was built under
+    BOOL valid;                     // Topology was built and not invalidated
+    StorageTopologyStats stats;     // Activity counters
+} StorageTopologyCache;
+
+#define STORAGE_TOPOLOGY_CACHE_INIT(builder) {SRWLOCK_INIT, builder, {NULL, 0}, 0, FALSE, {0}}
+
+/**
+ * @brief Collects the storage list from the cached topology
+ *
+ * This function:
+ * 1. Drops the topology if the mount signature changed
+ * 2. Builds the topology when there is none
+ * 3. Copies the entries into the output list
+ * 4. Refreshes total and free space of every mounted volume
+ *
+ * In steady state this costs one filesystem call per volume.
+ * Entries without a volume, or whose space cannot be read,
+ * keep the values discovered with the topology.
+ *
+ * @param cache Topology cache
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return StorageList* Storage list, NULL if the topology could not be built
+ * @note Heap results (NULL arena) must be freed with freeStorageList()
+ */
+StorageList *collectStorageSpace(StorageTopologyCache *cache, SnapshotArena *arena);
+
+/**
+ * @brief Forces the next collection to rediscover the topology
+ *
+ * @param cache Topology cache
+ */
+void invalidateStorageTopologyCache(StorageTopologyCache *cache);
+
+/**
+ * @brief Releases the cached topology
+ *
+ * @param cache Topology cache, reusable afterwards
+ */
+void releaseStorageTopologyCache(StorageTopologyCache *cache);
+
+/**
+ * @brief Reads the activity counters of a cache
+ *
+ * @param cache Topology cache
+ * @param stats Structure to receive the counters
+ */
+void getStorageTopologyCacheStats(StorageTopologyCache *cache, StorageTopologyStats *stats);
+
+/**
+ * @brief Reads the size and free space of a mounted volume
+ *
+ * Uses GetDiskFreeSpaceEx on Windows and statvfs elsewhere.
+ *
+ * @param mountPoint Root of the volume (e.g. "C:\\" or "/home")
+ * @param totalBytes Receives the volume size in bytes
+ * @param freeBytes Receives the free space in bytes
+ * @return BOOL TRUE if the volume could be queried
+ */
+BOOL queryVolumeSpace(const char *mountPoint, UINT64 *totalBytes, UINT64 *freeBytes);
+
+/**
+ * @brief Returns the current mount signature
+ *
+ * On Windows this is the GetLogicalDrives() mask. Elsewhere it is
+ * a generation counter advanced whenever /proc/self/mountinfo
+ * reports a change, without reading the mount table.
+ *
+ * @return UINT64 Value that changes with the set of mounts
+ */
+UINT64 getMountSignature(void);
+
+/**
+ * @brief Replaces the mount signature source
+ *
+ * Used by tests to simulate mount events.
+ *
+ * @param source Signature function, NULL restores getMountSignature()
+ */
+void setMountSignatureSource(MountSignatureSource source);
+
+#endif // STORAGE_TOPOLOGY_H
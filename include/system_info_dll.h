@@ -1,7 +1,7 @@
 #ifndef SYSTEM_INFO_DLL_H
 #define SYSTEM_INFO_DLL_H
 
-#include <windows.h>
+#include "fest_platform.h"
 
 #ifdef SYSTEM_INFO_EXPORTS
 #define SYSTEM_INFO_API __declspec(dllexport)
@@ -72,6 +72,89 @@ extern "C"
      */
     SYSTEM_INFO_API void setSystemInfoCallback(SystemInfoCallback callback);
 
+    /**
+     * @brief Resource usage of the monitoring engine itself
+     *
+     * Reports what the monitoring thread costs the machine:
+     * - Tick timing
+     * - Thread CPU time
+     * - Context switches
+     * - Library heap allocations and peak usage
+     *
+     * "Tick" figures cover collection and JSON generation of the
+     * most recent completed tick; time spent inside the callback
+     * belongs to the application and is excluded
+     */
+    typedef struct
+    {
+        UINT64 tickCount;               // Completed monitoring ticks
+        double lastTickMs;              // Wall time of the last tick in milliseconds
+        double lastTickCpuMs;           // Thread CPU time of the last tick in milliseconds
+        double totalCpuMs;              // Thread CPU time of all ticks in milliseconds
+        UINT64 lastTickContextSwitches; // Context switches during the last tick
+        UINT64 totalContextSwitches;    // Context switches during all ticks
+        UINT64 lastTickAllocations;     // Heap allocations made by the last tick
+        UINT64 lastTickAllocatedBytes;  // Heap bytes requested by the last tick
+        UINT64 lastTickPeakHeapBytes;   // Live heap high-water mark during the last tick
+        UINT64 peakHeapBytes;           // Live heap high-water mark since start
+    } MonitoringStats;
+
+    /**
+     * @brief Retrieves resource usage of the monitoring engine
+     *
+     * Statistics are reset each time monitoring is started
+     *
+     * @param stats Structure to receive the statistics
+     * @return BOOL TRUE if monitoring is running and stats were copied, FALSE otherwise
+     */
+    SYSTEM_INFO_API BOOL getMonitoringStats(MonitoringStats *stats);
+
+    /**
+     * @brief Enables the "overhead" section in the JSON output
+     *
+     * When enabled, every JSON update carries the engine's own
+     * resource usage (see MonitoringStats) for the previous tick
+     *
+     * @param enabled TRUE to include the section, FALSE to omit it
+     */
+    SYSTEM_INFO_API void setOverheadReporting(BOOL enabled);
+
+    /**
+     * @brief Starts or stops recording of tick trace events
+     *
+     * While enabled, the monitoring thread records begin/end spans
+     * for every collector, the JSON generation and the callback
+     * delivery. Enabling starts a new capture. When disabled the
+     * instrumentation costs a single flag check per span.
+     *
+     * @param enabled TRUE to record spans, FALSE to stop
+     */
+    SYSTEM_INFO_API void setTracingEnabled(BOOL enabled);
+
+    /**
+     * @brief Writes recorded spans as Chrome trace-event JSON
+     *
+     * The file can be opened in Perfetto (ui.perfetto.dev) or
+     * about:tracing. Can be called while monitoring is running.
+     *
+     * @param path Output file path
+     * @return BOOL TRUE if the file was written, FALSE if failed
+     */
+    SYSTEM_INFO_API BOOL writeTraceFile(const char *path);
+
+    /**
+     * @brief Selects the platform backend the collectors run on
+     *
+     * Built-in backends are "windows", "linux" and "fixture"; the
+     * fixture backend reports a deterministic lab machine and is
+     * meant for benchmarks and regression tests. The selection is
+     * kept across monitoring sessions.
+     *
+     * @param name Registered backend name, NULL for the native backend
+     * @return BOOL TRUE if selected, FALSE if unknown or monitoring is running
+     */
+    SYSTEM_INFO_API BOOL selectCollectorBackend(const char *name);
+
 #ifdef __cplusplus
 }
 #endif
@@ -4,8 +4,11 @@
 #include "gpu_info.h"
 #include "motherboard_info.h"
 #include "cpu_info.h"
+#include "cpu_load.h"
+#include "cpu_freq.h"
 #include "memory_info.h"
 #include "storage_info.h"
+#include "disk_io.h"
 #include "network_info.h"
 #include "audio_info.h"
 #include "battery_info.h"
@@ -20,6 +23,7 @@
  * - CPU specifications
  * - Audio devices
  * - Display setup
+ * - Installed RAM modules
  *
  * This information is typically collected once at startup
  * or when hardware configuration changes are detected
@@ -33,28 +37,73 @@ typedef struct
     CPUList *cpuList;         // Processors
     AudioList *audioList;     // Audio devices
     MonitorList *monitorList; // Display devices
+    RAMSlotList *ramSlots;    // Installed RAM modules
 } StaticInfo;
 
 /**
  * @brief Container for frequently updated system information
  *
  * Holds system metrics that change regularly:
+ * - CPU utilization
+ * - Core clocks
  * - Memory usage
  * - Storage space
+ * - Disk activity
  * - Battery status
  * - Network status
  *
  * This information is collected at each monitoring interval
  * to provide current system status
  *
- * @note All pointers must be freed individually
+ * @note The monitoring engine allocates all members from a
+ *       SnapshotArena and releases them by resetting it
  */
 typedef struct
 {
-    MemoryInfo *memInfo;      // Memory metrics
-    StorageList *storageList; // Storage volumes
-    BatteryInfo *batteryInfo; // Power status
-    NetworkList *networkList; // Network adapters
+    CPULoadInfo *cpuLoad;           // CPU utilization
+    CPUFrequencyInfo *cpuFrequency; // Core clocks
+    MemoryInfo *memInfo;            // Memory metrics
+    StorageList *storageList;       // Storage volumes
+    DiskIOList *diskIO;             // Block device activity
+    BatteryInfo *batteryInfo;       // Power status
+    NetworkList *networkList;       // Network adapters
 } DynamicInfo;
 
+/**
+ * @brief Set of collector functions used by the monitoring engine
+ *
+ * Every static getter returns a structure that the matching free
+ * function releases. Dynamic collectors allocate from the arena
+ * they are given (the heap when NULL), and their output is
+ * released by resetting that arena. The engine calls collectors only through
+ * the table of the selected CollectorBackend (see collector_backend.h),
+ * so benchmarks and tests can replace the platform collectors with
+ * deterministic fixture data.
+ */
+typedef struct
+{
+    // Static collectors (called once per session)
+    CPUList *(*getCPUList)(void);
+    void (*freeCPUList)(CPUList *list);
+    GPUList *(*getGPUList)(void);
+    void (*freeGPUList)(GPUList *list);
+    MotherboardInfo *(*getMotherboardInfo)(void);
+    void (*freeMotherboardInfo)(MotherboardInfo *info);
+    AudioList *(*getAudioList)(void);
+    void (*freeAudioList)(AudioList *list);
+    MonitorList *(*getMonitorList)(void);
+    void (*freeMonitorList)(MonitorList *list);
+    RAMSlotList *(*getRAMSlotList)(void);
+    void (*freeRAMSlotList)(RAMSlotList *list);
+
+    // Dynamic collectors (called every tick, output lives in the snapshot arena)
+    MemoryInfo *(*collectMemoryInfo)(SnapshotArena *arena);
+    StorageList *(*collectStorageList)(SnapshotArena *arena);
+    BatteryInfo *(*collectBatteryInfo)(SnapshotArena *arena);
+    NetworkList *(*collectNetworkList)(SnapshotArena *arena);
+    CPULoadInfo *(*collectCPULoad)(SnapshotArena *arena);
+    CPUFrequencyInfo *(*collectCPUFrequency)(SnapshotArena *arena);
+    DiskIOList *(*collectDiskIO)(SnapshotArena *arena);
+} CollectorTable;
+
 #endif // SYSTEM_INFO_INTERNAL_H
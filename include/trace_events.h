@@ -0,0 +1,90 @@
+#ifndef TRACE_EVENTS_H
+#define TRACE_EVENTS_H
+
+#include "fest_platform.h"
+
+/**
+ * @brief Global tracing switch
+ *
+ * Read by the TRACE_BEGIN/TRACE_END macros before doing any
+ * work, so a disabled tracer costs a single load and branch
+ *
+ * @note Change only through setTracingEnabled()
+ */
+extern volatile LONG g_traceEnabled;
+
+/**
+ * @brief Opens a span on the calling thread
+ *
+ * @param name Span name, must be a string literal or otherwise outlive the trace
+ */
+#define TRACE_BEGIN(name)                \
+    do                                   \
+    {                                    \
+        if (g_traceEnabled)              \
+            recordTraceEvent(name, 'B'); \
+    } while (0)
+
+/**
+ * @brief Closes the span opened by the matching TRACE_BEGIN
+ *
+ * @param name Span name, must match the TRACE_BEGIN name
+ */
+#define TRACE_END(name)                  \
+    do                                   \
+    {                                    \
+        if (g_traceEnabled)              \
+            recordTraceEvent(name, 'E'); \
+    } while (0)
+
+/**
+ * @brief Records a trace event into the calling thread's buffer
+ *
+ * Each thread owns a fixed-size event buffer that only it writes,
+ * so recording takes no locks. Events are dropped once the buffer
+ * is full.
+ *
+ * @param name Event name, must outlive the trace
+ * @param phase Chrome trace phase ('B' begin, 'E' end)
+ * @note Prefer the TRACE_BEGIN/TRACE_END macros, which skip the call when tracing is off
+ */
+void recordTraceEvent(const char *name, char phase);
+
+/**
+ * @brief Labels the calling thread in exported traces
+ *
+ * @param name Thread name shown by the trace viewer, must outlive the trace
+ */
+void setTraceThreadName(const char *name);
+
+/**
+ * @brief Releases the calling thread's buffer before it exits
+ *
+ * Threads that record events must call this on exit so their
+ * buffer is reused by later threads instead of leaking. The
+ * events already recorded stay exportable until then.
+ */
+void releaseTraceThread(void);
+
+/**
+ * @brief Starts or stops event capture
+ *
+ * Enabling starts a new capture and discards previously
+ * recorded events
+ *
+ * @param enabled TRUE to record events, FALSE to stop
+ */
+void enableTraceEvents(BOOL enabled);
+
+/**
+ * @brief Writes captured events as Chrome trace-event JSON
+ *
+ * The output opens in Perfetto (ui.perfetto.dev) and about:tracing.
+ * Timestamps are microseconds since capture start.
+ *
+ * @param path Output file path
+ * @return BOOL TRUE if the file was written, FALSE if failed
+ */
+BOOL exportTraceEvents(const char *path);
+
+#endif // TRACE_EVENTS_H
@@ -0,0 +1,43 @@
+#ifndef UTF8_TRANSCODE_H
+#define UTF8_TRANSCODE_H
+
+#include "fest_platform.h"
+
+#define UTF8_REPLACEMENT_CHARACTER 0xFFFD // Written for unpaired surrogates and invalid code points
+
+/**
+ * @brief Converts UTF-16LE text to UTF-8
+ *
+ * This function:
+ * 1. Copies runs of ASCII 16 code units at a time (SSE2 where available)
+ * 2. Encodes other code points one by one, combining surrogate pairs
+ * 3. Replaces unpaired surrogates with U+FFFD
+ * 4. Stops at the last code point that fits, never splitting a sequence
+ * 5. Always terminates the output when dstSize is not zero
+ *
+ * Unlike wcstombs() the result does not depend on the locale
+ * or the ANSI code page.
+ *
+ * @param src UTF-16LE code units
+ * @param srcLength Number of code units to convert, no terminator needed
+ * @param dst Buffer receiving the UTF-8 text
+ * @param dstSize Size of the buffer in bytes, terminator included
+ * @return size_t Bytes written, terminator excluded
+ */
+size_t utf16ToUtf8(const WORD *src, size_t srcLength, char *dst, size_t dstSize);
+
+/**
+ * @brief Converts a terminated wide string to UTF-8
+ *
+ * wchar_t holds UTF-16 on Windows and UTF-32 elsewhere; both
+ * take the same ASCII fast path and validating slow path.
+ * Out of range UTF-32 values are replaced with U+FFFD.
+ *
+ * @param src Wide string, NULL converts as an empty string
+ * @param dst Buffer receiving the UTF-8 text
+ * @param dstSize Size of the buffer in bytes, terminator included
+ * @return size_t Bytes written, terminator excluded
+ */
+size_t wideToUtf8(const wchar_t *src, char *dst, size_t dstSize);
+
+#endif // UTF8_TRANSCODE_H
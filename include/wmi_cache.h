@@ -0,0 +1,129 @@
+#ifndef WMI_CACHE_H
+#define WMI_CACHE_H
+
+#include "wmi_helper.h"
+
+#define WMI_CACHE_MAX_ENTRIES 32             // Hard upper bound for cached results
+#define WMI_CACHE_DEFAULT_MAX_BYTES 262144   // Row bytes kept by default
+
+/**
+ * @brief Activity counters of the query result cache
+ */
+typedef struct
+{
+    UINT64 hits;        // Lookups answered from the cache
+    UINT64 misses;      // Lookups that ran the query, expired ones included
+    UINT64 expirations; // Entries found past their TTL
+    UINT64 evictions;   // Entries dropped to respect the limits
+    UINT64 insertions;  // Results stored
+    UINT entries;       // Entries currently cached
+    size_t bytes;       // Row bytes currently cached
+} WMICacheStats;
+
+/**
+ * @brief Returns the current time in milliseconds
+ */
+typedef UINT64 (*WMICacheClock)(void);
+
+/**
+ * @brief Normalizes WQL text into a cache key
+ *
+ * This function:
+ * 1. Drops leading and trailing whitespace
+ * 2. Collapses whitespace runs into one space
+ * 3. Upper-cases ASCII letters outside quoted literals
+ *
+ * So "select  Name from win32_bios" and "SELECT Name FROM Win32_BIOS"
+ * share one entry, while 'Disk #0' and 'disk #0' literals do not.
+ *
+ * @param query WQL statement
+ * @param normalized Buffer receiving the key
+ * @param normalizedSize Size of the buffer in characters
+ * @return BOOL TRUE if the key fits, FALSE otherwise
+ */
+BOOL normalizeWMIQuery(const wchar_t *query, wchar_t *normalized, size_t normalizedSize);
+
+/**
+ * @brief Runs a query, or returns its rows from the cache
+ *
+ * A result is shared by calls with the same normalized text,
+ * decoder and row size. Rows are copied in both directions,
+ * so they must not point into the session, the context or
+ * other rows.
+ *
+ * @param session Active WMI session, used on a miss
+ * @param query WQL statement
+ * @param vector Vector receiving the rows
+ * @param decoder Row decoder of the collector
+ * @param context Collector data passed to the decoder on a miss
+ * @param ttlMs Lifetime of a stored result, 0 bypasses the cache
+ * @return BOOL TRUE if the rows were delivered, FALSE if the query failed
+ */
+BOOL queryWMIRowsCached(WMISession *session, const wchar_t *query, WMIRowVector *vector,
+                        WMIRowDecoder decoder, void *context, UINT ttlMs);
+
+/**
+ * @brief Cached variant of queryWMIProjected()
+ *
+ * @param session Active WMI session, used on a miss
+ * @param spec Query specification, part of the cache key
+ * @param vector Vector receiving the rows
+ * @param decoder Optional decoder completing each row, NULL if none
+ * @param context Collector data passed to the decoder on a miss
+ * @param ttlMs Lifetime of a stored result, 0 bypasses the cache
+ * @return BOOL TRUE if the rows were delivered, FALSE if the query failed
+ */
+BOOL queryWMIProjectedCached(WMISession *session, const WMIQuerySpec *spec, WMIRowVector *vector,
+                             WMIRowDecoder decoder, void *context, UINT ttlMs);
+
+/**
+ * @brief Cached variant of queryWMIObject()
+ *
+ * A hit writes only the fields the specification declares. A
+ * missing object is cached as an empty result, a query that
+ * failed, timed out or was cancelled is not cached at all.
+ *
+ * @param session Active WMI session, used on a miss
+ * @param spec Query specification, part of the cache key
+ * @param row Row to fill, left untouched if no object was returned
+ * @param rowSize Size of the row in bytes
+ * @param ttlMs Lifetime of a stored result, 0 bypasses the cache
+ * @return BOOL TRUE if an object was decoded, FALSE otherwise
+ */
+BOOL queryWMIObjectCached(WMISession *session, const WMIQuerySpec *spec, void *row, size_t rowSize, UINT ttlMs);
+
+/**
+ * @brief Sets the size limits of the cache
+ *
+ * Least recently used entries are evicted to respect both limits.
+ * A result larger than maxBytes is never stored.
+ *
+ * @param maxEntries Entries kept, clamped to 1..WMI_CACHE_MAX_ENTRIES
+ * @param maxBytes Row bytes kept over all entries
+ */
+void setWMICacheLimits(UINT maxEntries, size_t maxBytes);
+
+/**
+ * @brief Drops every cached result
+ *
+ * Counters are kept, see getWMICacheStats()
+ */
+void clearWMICache(void);
+
+/**
+ * @brief Reads the cache counters
+ *
+ * @param stats Structure to receive the counters
+ */
+void getWMICacheStats(WMICacheStats *stats);
+
+/**
+ * @brief Replaces the clock used for TTLs
+ *
+ * Used by tests to expire entries without waiting.
+ *
+ * @param clock Clock function, NULL restores GetTickCount64()
+ */
+void setWMICacheClock(WMICacheClock clock);
+
+#endif // WMI_CACHE_H
@@ -0,0 +1,204 @@
+#ifndef WMI_COMPAT_H
+#define WMI_COMPAT_H
+
+#include "fest_platform.h"
+
+/**
+ * @brief COM/WMI declarations for platform-independent builds
+ *
+ * On Windows this is <wbemidl.h> and <oleauto.h>. Elsewhere it
+ * declares the C vtables of the WMI interfaces the library calls,
+ * with every method slot kept in its Windows position so an
+ * in-process provider (see tests/fake_wbem.h) can stand in for
+ * the real one. Slots the library never calls are typed void*.
+ */
+#ifdef _WIN32
+#include <wbemidl.h>
+#include <oleauto.h>
+#else
+
+#define STDMETHODCALLTYPE
+
+typedef WCHAR *BSTR;
+typedef unsigned short VARTYPE;
+typedef short VARIANT_BOOL;
+typedef LONG CIMTYPE;
+
+#define VARIANT_TRUE ((VARIANT_BOOL)-1)
+#define VARIANT_FALSE ((VARIANT_BOOL)0)
+
+// VARIANT types returned by WMI properties
+enum
+{
+    VT_EMPTY = 0,
+    VT_NULL = 1,
+    VT_I2 = 2,
+    VT_I4 = 3,
+    VT_BSTR = 8,
+    VT_BOOL = 11,
+    VT_UI1 = 17,
+    VT_UI2 = 18,
+    VT_UI4 = 19,
+    VT_I8 = 20,
+    VT_UI8 = 21,
+    VT_INT = 22,
+    VT_UINT = 23
+};
+
+/**
+ * @brief Tagged value as returned by IWbemClassObject::Get
+ */
+typedef struct
+{
+    VARTYPE vt; // Type of the active member
+    WORD wReserved1;
+    WORD wReserved2;
+    WORD wReserved3;
+    union
+    {
+        LONGLONG llVal;
+        ULONGLONG ullVal;
+        LONG lVal;
+        ULONG ulVal;
+        INT intVal;
+        UINT uintVal;
+        SHORT iVal;
+        USHORT uiVal;
+        BYTE bVal;
+        VARIANT_BOOL boolVal;
+        BSTR bstrVal;
+        PVOID byref;
+    };
+} VARIANT;
+
+BSTR SysAllocString(const WCHAR *source);
+void SysFreeString(BSTR value);
+void VariantInit(VARIANT *value);
+HRESULT VariantClear(VARIANT *value);
+
+// WMI status codes and flags
+#define WBEM_S_NO_ERROR ((HRESULT)0)
+#define WBEM_S_FALSE ((HRESULT)1)
+#define WBEM_S_TIMEDOUT ((HRESULT)0x40004)
+#define WBEM_E_FAILED ((HRESULT)0x80041001)
+#define WBEM_E_NOT_FOUND ((HRESULT)0x80041002)
+#define WBEM_E_INVALID_QUERY ((HRESULT)0x80041017)
+#define WBEM_E_TRANSPORT_FAILURE ((HRESULT)0x80041015)
+#define WBEM_E_CALL_CANCELLED ((HRESULT)0x80041032)
+#define WBEM_INFINITE ((LONG)0xFFFFFFFF)
+#define WBEM_NO_WAIT 0
+#define WBEM_FLAG_RETURN_IMMEDIATELY 0x10
+#define WBEM_FLAG_FORWARD_ONLY 0x20
+
+// COM transport errors
+#define RPC_E_DISCONNECTED ((HRESULT)0x80010108)
+#define RPC_E_TOO_LATE ((HRESULT)0x80010119)
+#define RPC_E_CHANGED_MODE ((HRESULT)0x80010106)
+#define RPC_E_SERVER_DIED ((HRESULT)0x80010007)
+#define RPC_E_SERVER_DIED_DNE ((HRESULT)0x80010012)
+
+typedef struct IWbemContext IWbemContext;
+typedef struct IWbemObjectSink IWbemObjectSink;
+typedef struct IWbemClassObject IWbemClassObject;
+typedef struct IEnumWbemClassObject IEnumWbemClassObject;
+typedef struct IWbemServices IWbemServices;
+typedef struct IWbemLocator IWbemLocator;
+
+typedef struct IWbemClassObjectVtbl
+{
+    HRESULT (STDMETHODCALLTYPE *QueryInterface)(IWbemClassObject *This, const void *riid, void **ppvObject);
+    ULONG (STDMETHODCALLTYPE *AddRef)(IWbemClassObject *This);
+    ULONG (STDMETHODCALLTYPE *Release)(IWbemClassObject *This);
+    void *GetQualifierSet;
+    HRESULT (STDMETHODCALLTYPE *Get)(IWbemClassObject *This, const WCHAR *wszName, LONG lFlags,
+                   VARIANT *pVal, CIMTYPE *pType, LONG *plFlavor);
+} IWbemClassObjectVtbl;
+
+struct IWbemClassObject
+{
+    IWbemClassObjectVtbl *lpVtbl;
+};
+
+typedef struct IWbemObjectSinkVtbl
+{
+    HRESULT (STDMETHODCALLTYPE *QueryInterface)(IWbemObjectSink *This, const void *riid, void **ppvObject);
+    ULONG (STDMETHODCALLTYPE *AddRef)(IWbemObjectSink *This);
+    ULONG (STDMETHODCALLTYPE *Release)(IWbemObjectSink *This);
+    HRESULT (STDMETHODCALLTYPE *Indicate)(IWbemObjectSink *This, LONG lObjectCount, IWbemClassObject **apObjArray);
+    HRESULT (STDMETHODCALLTYPE *SetStatus)(IWbemObjectSink *This, LONG lFlags, HRESULT hResult,
+                         BSTR strParam, IWbemClassObject *pObjParam);
+} IWbemObjectSinkVtbl;
+
+struct IWbemObjectSink
+{
+    IWbemObjectSinkVtbl *lpVtbl;
+};
+
+typedef struct IEnumWbemClassObjectVtbl
+{
+    HRESULT (STDMETHODCALLTYPE *QueryInterface)(IEnumWbemClassObject *This, const void *riid, void **ppvObject);
+    ULONG (STDMETHODCALLTYPE *AddRef)(IEnumWbemClassObject *This);
+    ULONG (STDMETHODCALLTYPE *Release)(IEnumWbemClassObject *This);
+    HRESULT (STDMETHODCALLTYPE *Reset)(IEnumWbemClassObject *This);
+    HRESULT (STDMETHODCALLTYPE *Next)(IEnumWbemClassObject *This, LONG lTimeout, ULONG uCount,
+                    IWbemClassObject **apObjects, ULONG *puReturned);
+    void *NextAsync;
+    void *Clone;
+    HRESULT (STDMETHODCALLTYPE *Skip)(IEnumWbemClassObject *This, LONG lTimeout, ULONG nCount);
+} IEnumWbemClassObjectVtbl;
+
+struct IEnumWbemClassObject
+{
+    IEnumWbemClassObjectVtbl *lpVtbl;
+};
+
+typedef struct IWbemServicesVtbl
+{
+    HRESULT (STDMETHODCALLTYPE *QueryInterface)(IWbemServices *This, const void *riid, void **ppvObject);
+    ULONG (STDMETHODCALLTYPE *AddRef)(IWbemServices *This);
+    ULONG (STDMETHODCALLTYPE *Release)(IWbemServices *This);
+    void *OpenNamespace;
+    HRESULT (STDMETHODCALLTYPE *CancelAsyncCall)(IWbemServices *This, IWbemObjectSink *pSink);
+    void *QueryObjectSink;
+    void *GetObject;
+    void *GetObjectAsync;
+    void *PutClass;
+    void *PutClassAsync;
+    void *DeleteClass;
+    void *DeleteClassAsync;
+    void *CreateClassEnum;
+    void *CreateClassEnumAsync;
+    void *PutInstance;
+    void *PutInstanceAsync;
+    void *DeleteInstance;
+    void *DeleteInstanceAsync;
+    void *CreateInstanceEnum;
+    void *CreateInstanceEnumAsync;
+    HRESULT (STDMETHODCALLTYPE *ExecQuery)(IWbemServices *This, const BSTR strQueryLanguage, const BSTR strQuery,
+                         LONG lFlags, IWbemContext *pCtx, IEnumWbemClassObject **ppEnum);
+    HRESULT (STDMETHODCALLTYPE *ExecQueryAsync)(IWbemServices *This, const BSTR strQueryLanguage, const BSTR strQuery,
+                              LONG lFlags, IWbemContext *pCtx, IWbemObjectSink *pResponseHandler);
+} IWbemServicesVtbl;
+
+struct IWbemServices
+{
+    IWbemServicesVtbl *lpVtbl;
+};
+
+typedef struct IWbemLocatorVtbl
+{
+    HRESULT (STDMETHODCALLTYPE *QueryInterface)(IWbemLocator *This, const void *riid, void **ppvObject);
+    ULONG (STDMETHODCALLTYPE *AddRef)(IWbemLocator *This);
+    ULONG (STDMETHODCALLTYPE *Release)(IWbemLocator *This);
+    HRESULT (STDMETHODCALLTYPE *ConnectServer)(IWbemLocator *This, const BSTR strNetworkResource, const BSTR strUser,
+                             const BSTR strPassword, const BSTR strLocale, LONG lSecurityFlags,
+                             const BSTR strAuthority, IWbemContext *pCtx, IWbemServices **ppNamespace);
+} IWbemLocatorVtbl;
+
+struct IWbemLocator
+{
+    IWbemLocatorVtbl *lpVtbl;
+};
+#endif
+
+#endif // WMI_COMPAT_H
@@ -1,9 +1,66 @@
 #ifndef WMI_HELPER_H
 #define WMI_HELPER_H
 
-#include <windows.h>
-#include <wbemidl.h>
-#include <oleauto.h>
+#include "fest_platform.h"
+#include "wmi_compat.h"
+#include "snapshot_arena.h"
+
+#include <stddef.h>
+
+#define WMI_ROWS_INITIAL_CAPACITY 8        // Rows reserved when a collector gives no hint
+#define WMI_QUERY_MAX_LENGTH 512           // Longest generated WQL statement in characters
+#define WMI_DEFAULT_BATCH_SIZE 16          // Objects fetched per enumerator call by default
+#define WMI_MAX_BATCH_SIZE 64              // Upper bound for setWMIBatchSize()
+#define WMI_DEFAULT_QUERY_TIMEOUT_MS 30000 // Deadline of queries that give none
+#define WMI_POLL_SLICE_MS 20               // Longest single wait on one enumerator
+
+/**
+ * @brief How a projected property is stored in a collector row
+ */
+typedef enum
+{
+    WMI_PROPERTY_COLUMN, // Selected only, read by the row decoder
+    WMI_PROPERTY_STRING, // UTF-8 string in a char array
+    WMI_PROPERTY_UINT32, // UINT
+    WMI_PROPERTY_UINT64  // UINT64, CIM uint64 values arrive as strings
+} WMIPropertyType;
+
+/**
+ * @brief One property a collector reads from a WMI class
+ *
+ * Declared with the WMI_*_PROPERTY macros, which record where
+ * the value lives in the collector's row structure
+ */
+typedef struct
+{
+    const wchar_t *name;  // WMI property name
+    WMIPropertyType type; // Storage type in the row
+    size_t offset;        // Offset of the field in the row
+    size_t size;          // Size of the field in bytes
+} WMIPropertySpec;
+
+#define WMI_COLUMN(name) {name, WMI_PROPERTY_COLUMN, 0, 0}
+#define WMI_STRING_PROPERTY(name, rowType, field) \
+    {name, WMI_PROPERTY_STRING, offsetof(rowType, field), sizeof(((rowType *)0)->field)}
+#define WMI_UINT32_PROPERTY(name, rowType, field) \
+    {name, WMI_PROPERTY_UINT32, offsetof(rowType, field), sizeof(UINT)}
+#define WMI_UINT64_PROPERTY(name, rowType, field) \
+    {name, WMI_PROPERTY_UINT64, offsetof(rowType, field), sizeof(UINT64)}
+#define WMI_PROPERTY_COUNT(properties) ((UINT)(sizeof(properties) / sizeof((properties)[0])))
+
+/**
+ * @brief Projected query over one WMI class
+ *
+ * Only the listed properties are selected, so the provider
+ * marshals just the columns the collector reads
+ */
+typedef struct
+{
+    const wchar_t *className;           // WMI class to query
+    const WMIPropertySpec *properties;  // Properties to select and decode
+    UINT propertyCount;                 // Number of properties
+    const wchar_t *where;               // Condition without WHERE, NULL for none
+} WMIQuerySpec;
 
 /**
  * @brief Container for WMI connection resources
@@ -12,29 +69,210 @@
  * - Service connection
  * - COM locator
  * - Connection state
+ * - Lease bookkeeping of the session pool
  *
- * Used for querying system hardware information
- * through the Windows WMI interface
+ * Every thread owns one pooled session. It is handed out by
+ * acquireWMISession() and stays connected while leased or
+ * while the thread has pinned it with pinWMISession()
  *
- * @note Must be initialized before use and cleaned up after
+ * @note Sessions are thread-local, never pass one to another thread
  */
 typedef struct
 {
     IWbemServices *pSvc; // WMI service connection
     IWbemLocator *pLoc;  // COM service locator
     BOOL initialized;    // Connection state flag
+    LONG leases;         // Outstanding leases on this thread
+    LONG pins;           // Pins keeping the connection open without leases
+    BOOL comInitialized; // COM was initialized by the pool on this thread
 } WMISession;
 
 /**
- * @brief Initializes WMI connection
+ * @brief Growable array of decoded WMI rows
+ *
+ * Filled by a single enumeration pass: capacity doubles when
+ * full, so the rows of a query are decoded without counting
+ * them first. The array is handed to the collector as-is.
+ */
+typedef struct
+{
+    void *rows;           // Row array, NULL until the first row
+    UINT count;           // Rows kept
+    UINT capacity;        // Rows allocated
+    size_t rowSize;       // Size of one row in bytes
+    SnapshotArena *arena; // Arena backing the array, NULL for the heap
+} WMIRowVector;
+
+/**
+ * @brief Progress of a query started with startWMIQuery()
+ */
+typedef enum
+{
+    WMI_QUERY_IDLE,      // Not started
+    WMI_QUERY_PENDING,   // Started, objects may still arrive
+    WMI_QUERY_COMPLETE,  // Enumeration ended, see result for an enumeration error
+    WMI_QUERY_FAILED,    // Query rejected or rows could not be stored
+    WMI_QUERY_TIMED_OUT, // Deadline passed before the enumeration ended
+    WMI_QUERY_CANCELLED  // Cancelled before the enumeration ended
+} WMIQueryState;
+
+/**
+ * @brief Decodes one WMI object into a collector row
+ *
+ * The row is zeroed before the call
+ *
+ * @param pclsObj WMI class object of the current result
+ * @param row Row to fill
+ * @param context Collector data passed through the enumeration
+ * @return BOOL TRUE to keep the row, FALSE to discard it
+ */
+typedef BOOL (*WMIRowDecoder)(IWbemClassObject *pclsObj, void *row, void *context);
+
+/**
+ * @brief Query in flight, owned by the caller
+ *
+ * Started by startWMIQuery() and driven by waitWMIQueries().
+ * The provider keeps producing objects between polls, so
+ * several queries started back to back run concurrently on
+ * one thread. Rows arrive in the vector as they are polled.
+ */
+typedef struct
+{
+    IEnumWbemClassObject *pEnumerator; // Semisynchronous enumerator, NULL once finished
+    WMIRowVector *vector;              // Vector receiving the rows
+    const WMIQuerySpec *spec;          // Declared properties decoded first, NULL for raw queries
+    WMIRowDecoder decoder;             // Row decoder, NULL if spec covers the row
+    void *context;                     // Collector data passed to the decoder
+    UINT64 deadline;                   // GetTickCount64() value past which the query times out
+    LONG cancelGeneration;             // Cancel generation when the query started
+    WMIQueryState state;               // Progress of the query
+    HRESULT result;                    // Failure or enumeration error, S_OK otherwise
+} WMIAsyncQuery;
+
+/**
+ * @brief Opens the WMI connection of a pooled session
+ *
+ * Called on the owning thread after COM is initialized.
+ * Must return a connected service and its locator, each
+ * holding one reference that the pool releases later.
+ *
+ * @param ppLoc Receives the locator
+ * @param ppSvc Receives the service connection
+ * @return HRESULT S_OK if connected, failure code otherwise
+ */
+typedef HRESULT (*WMIConnector)(IWbemLocator **ppLoc, IWbemServices **ppSvc);
+
+/**
+ * @brief Counters of the WMI session pool
+ */
+typedef struct
+{
+    UINT64 connects;    // Connections opened
+    UINT64 disconnects; // Connections closed
+    UINT64 reconnects;  // Connections replaced after a transport failure
+    UINT64 leases;      // Leases handed out
+    UINT64 failures;    // Failed connection attempts
+} WMIPoolStats;
+
+/**
+ * @brief Leases the calling thread's WMI session
  *
  * This function:
- * 1. Initializes COM library
- * 2. Creates WMI locator
- * 3. Connects to WMI service
- * 4. Sets up security
+ * 1. Returns the thread's pooled session
+ * 2. Connects it first if it is not connected
+ * 3. Counts one outstanding lease
+ *
+ * Leases nest; the connection is reused by every lease
+ * taken on the same thread
+ *
+ * @return WMISession* Leased session, NULL if connecting failed
+ * @note Every lease must be returned using releaseWMISession()
+ */
+WMISession *acquireWMISession(void);
+
+/**
+ * @brief Returns a lease taken with acquireWMISession()
+ *
+ * The connection is closed when the last lease is returned
+ * and the thread holds no pin, otherwise it is kept for reuse
+ *
+ * @param session Leased session, NULL is ignored
+ */
+void releaseWMISession(WMISession *session);
+
+/**
+ * @brief Keeps the calling thread's session connected between leases
+ *
+ * The monitoring thread pins its session for its lifetime so
+ * every tick reuses one connection. Pins nest.
+ */
+void pinWMISession(void);
+
+/**
+ * @brief Drops a pin taken with pinWMISession()
+ *
+ * Closes the connection if no pins or leases remain
+ */
+void unpinWMISession(void);
+
+/**
+ * @brief Sets how many objects one enumerator call fetches
+ *
+ * Each IEnumWbemClassObject::Next call is a round trip to the
+ * WMI provider; larger batches trade a little stack for fewer
+ * calls. Applies to every enumeration started afterwards.
+ *
+ * @param batchSize Objects per call, clamped to 1..WMI_MAX_BATCH_SIZE
+ */
+void setWMIBatchSize(UINT batchSize);
+
+/**
+ * @brief Returns how many objects one enumerator call fetches
+ *
+ * @return UINT Objects per call
+ */
+UINT getWMIBatchSize(void);
+
+/**
+ * @brief Sets the deadline of the synchronous query functions
+ *
+ * queryWMIRows(), queryWMIProjected() and queryWMIObject() give
+ * up on a provider that has not finished within this time.
+ *
+ * @param timeoutMs Deadline in milliseconds, 0 restores WMI_DEFAULT_QUERY_TIMEOUT_MS
+ */
+void setWMIQueryTimeout(UINT timeoutMs);
+
+/**
+ * @brief Returns the deadline of the synchronous query functions
+ *
+ * @return UINT Deadline in milliseconds
+ */
+UINT getWMIQueryTimeout(void);
+
+/**
+ * @brief Replaces the function used to open connections
+ *
+ * Lets tests and non-Windows builds supply an in-process
+ * provider. Existing connections are not affected.
+ *
+ * @param connector Connection function, NULL restores the default
+ */
+void setWMIConnector(WMIConnector connector);
+
+/**
+ * @brief Reads the counters of the WMI session pool
+ *
+ * @param stats Structure to receive the counters
+ */
+void getWMIPoolStats(WMIPoolStats *stats);
+
+/**
+ * @brief Initializes WMI connection
  *
- * @return WMISession* Pointer to initialized session, NULL if failed
+ * Kept for existing callers, equivalent to acquireWMISession()
+ *
+ * @return WMISession* Pointer to leased session, NULL if failed
  * @note Caller must clean up using cleanupWMI()
  */
 WMISession *initializeWMI(void);
@@ -42,10 +280,7 @@ WMISession *initializeWMI(void);
 /**
  * @brief Cleans up WMI session resources
  *
- * This function:
- * 1. Releases WMI interfaces
- * 2. Uninitializes COM
- * 3. Frees session structure
+ * Kept for existing callers, equivalent to releaseWMISession()
  *
  * @param session Pointer to WMISession to clean up
  */
@@ -57,6 +292,7 @@ void cleanupWMI(WMISession *session);
  * Performs a synchronous query using Windows Query Language:
  * - Validates session and query
  * - Executes query
+ * - Reconnects and retries once if the connection was lost
  * - Returns result enumerator
  *
  * @param session Active WMI session
@@ -66,6 +302,181 @@ void cleanupWMI(WMISession *session);
  */
 BOOL executeWQLQuery(WMISession *session, const wchar_t *query, IEnumWbemClassObject **ppEnumerator);
 
+/**
+ * @brief Prepares an empty row vector
+ *
+ * @param vector Vector to prepare
+ * @param arena Arena to allocate rows from, NULL to use the heap
+ * @param rowSize Size of one row in bytes
+ * @param initialCapacity Rows to reserve on the first row, 0 for the default
+ */
+void initWMIRowVector(WMIRowVector *vector, SnapshotArena *arena, size_t rowSize, UINT initialCapacity);
+
+/**
+ * @brief Makes room for more rows
+ *
+ * Capacity grows by doubling, from the initial capacity on first use
+ *
+ * @param vector Vector to grow
+ * @param count Number of rows about to be appended
+ * @return BOOL TRUE if the rows fit, FALSE if allocation failed
+ */
+BOOL reserveWMIRows(WMIRowVector *vector, UINT count);
+
+/**
+ * @brief Runs a WQL query and decodes its result in a single pass
+ *
+ * Gives up after getWMIQueryTimeout() or when cancelWMIQueries()
+ * is called, keeping the rows received so far
+ *
+ * @param session Active WMI session
+ * @param query WQL query string (wide character)
+ * @param vector Vector receiving the rows
+ * @param decoder Row decoder of the collector
+ * @param context Collector data passed to the decoder
+ * @return BOOL TRUE if the query ran to its end and its rows were stored, FALSE if failed
+ */
+BOOL queryWMIRows(WMISession *session, const wchar_t *query, WMIRowVector *vector, WMIRowDecoder decoder, void *context);
+
+/**
+ * @brief Generates the WQL statement of a projected query
+ *
+ * Produces "SELECT p1, p2 FROM Class [WHERE condition]"
+ *
+ * @param spec Query specification
+ * @param query Buffer to receive the statement
+ * @param querySize Size of the buffer in characters
+ * @return BOOL TRUE if the statement fits, FALSE otherwise
+ */
+BOOL buildWMIQuery(const WMIQuerySpec *spec, wchar_t *query, size_t querySize);
+
+/**
+ * @brief Decodes the declared properties of an object into a row
+ *
+ * Missing and NULL properties leave their fields untouched;
+ * WMI_PROPERTY_COLUMN entries are skipped
+ *
+ * @param pclsObj WMI class object
+ * @param properties Property declarations
+ * @param count Number of declarations
+ * @param row Row to fill
+ * @return UINT Number of fields stored
+ */
+UINT decodeWMIProperties(IWbemClassObject *pclsObj, const WMIPropertySpec *properties, UINT count, void *row);
+
+/**
+ * @brief Runs a projected query and decodes its rows in a single pass
+ *
+ * Declared properties are stored first, then the optional
+ * decoder fills derived fields and may discard the row
+ *
+ * @param session Active WMI session
+ * @param spec Query specification
+ * @param vector Vector receiving the rows
+ * @param decoder Additional row decoder, NULL for none
+ * @param context Collector data passed to the decoder
+ * @return BOOL TRUE if the query ran and its rows were stored, FALSE if failed
+ */
+BOOL queryWMIProjected(WMISession *session, const WMIQuerySpec *spec, WMIRowVector *vector, WMIRowDecoder decoder, void *context);
+
+/**
+ * @brief Runs a projected query and decodes its first object
+ *
+ * For singleton classes such as Win32_BIOS. FALSE means either
+ * that the class has no object or that the query did not run to
+ * its end; state tells them apart.
+ *
+ * @param session Active WMI session
+ * @param spec Query specification
+ * @param row Row to fill, left untouched if no object was returned
+ * @param state Receives how the query ended, NULL if not needed: WMI_QUERY_COMPLETE
+ *              if it ran to its end, WMI_QUERY_FAILED if it was rejected or the
+ *              enumeration failed, WMI_QUERY_TIMED_OUT or WMI_QUERY_CANCELLED
+ * @return BOOL TRUE if an object was decoded, FALSE otherwise
+ */
+BOOL queryWMIObject(WMISession *session, const WMIQuerySpec *spec, void *row, WMIQueryState *state);
+
+/**
+ * @brief Starts a WQL query without waiting for its objects
+ *
+ * This function:
+ * 1. Issues the query in semisynchronous mode
+ * 2. Records the deadline and the current cancel generation
+ * 3. Returns while the provider is still producing objects
+ *
+ * @param session Active WMI session
+ * @param query WQL query string (wide character)
+ * @param vector Vector receiving the rows
+ * @param decoder Row decoder of the collector
+ * @param context Collector data passed to the decoder
+ * @param timeoutMs Time allowed for the whole query, 0 for getWMIQueryTimeout()
+ * @param async Query to start, left WMI_QUERY_FAILED if the query was rejected
+ * @return BOOL TRUE if the query is pending, FALSE if failed
+ * @note A pending query must be finished by waitWMIQueries() or cancelWMIQuery()
+ */
+BOOL startWMIQuery(WMISession *session, const wchar_t *query, WMIRowVector *vector,
+                   WMIRowDecoder decoder, void *context, UINT timeoutMs, WMIAsyncQuery *async);
+
+/**
+ * @brief Starts a projected query without waiting for its objects
+ *
+ * @param session Active WMI session
+ * @param spec Query specification, must outlive the query
+ * @param vector Vector receiving the rows
+ * @param decoder Additional row decoder, NULL for none
+ * @param context Collector data passed to the decoder
+ * @param timeoutMs Time allowed for the whole query, 0 for getWMIQueryTimeout()
+ * @param async Query to start
+ * @return BOOL TRUE if the query is pending, FALSE if failed
+ */
+BOOL startWMIProjectedQuery(WMISession *session, const WMIQuerySpec *spec, WMIRowVector *vector,
+                            WMIRowDecoder decoder, void *context, UINT timeoutMs, WMIAsyncQuery *async);
+
+/**
+ * @brief Drives pending queries until each one has finished
+ *
+ * This function:
+ * 1. Polls every pending query without blocking and stores its objects
+ * 2. Waits at most WMI_POLL_SLICE_MS on one query when none made progress
+ * 3. Ends queries whose deadline passed or that were cancelled
+ *
+ * Queries that are not pending are skipped, so a group can mix
+ * started and failed queries.
+ *
+ * @param queries Queries to drive
+ * @param count Number of queries
+ * @return UINT Number of queries that are WMI_QUERY_COMPLETE
+ */
+UINT waitWMIQueries(WMIAsyncQuery *queries, UINT count);
+
+/**
+ * @brief Cancels one pending query
+ *
+ * Releasing a semisynchronous enumerator cancels the call in
+ * the provider. Rows received so far stay in the vector.
+ *
+ * @param async Query to cancel, ignored unless pending
+ */
+void cancelWMIQuery(WMIAsyncQuery *async);
+
+/**
+ * @brief Cancels every query started so far, on any thread
+ *
+ * Pending queries end as WMI_QUERY_CANCELLED at their next
+ * poll, within WMI_POLL_SLICE_MS. Queries started afterwards
+ * are not affected. Called when monitoring stops.
+ */
+void cancelWMIQueries(void);
+
+/**
+ * @brief Releases the rows of a heap-backed vector
+ *
+ * Arena-backed rows are left to the arena
+ *
+ * @param vector Vector to release, left empty
+ */
+void releaseWMIRowVector(WMIRowVector *vector);
+
 /**
  * @brief Retrieves string property from WMI object
  *
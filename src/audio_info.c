@@ -1,7 +1,46 @@
 #include "audio_info.h"
+#include "fest_alloc.h"
 #include "wmi_helper.h"
 #include <stdio.h>
 
+#ifdef _WIN32
+/**
+ * @brief Win32_SoundDevice properties read into AudioDeviceInfo
+ */
+static const WMIPropertySpec g_SoundDeviceProperties[] = {
+    WMI_STRING_PROPERTY(L"Name", AudioDeviceInfo, name),
+    WMI_STRING_PROPERTY(L"Manufacturer", AudioDeviceInfo, manufacturer)};
+
+static const WMIQuerySpec g_SoundDeviceQuery = {
+    L"Win32_SoundDevice", g_SoundDeviceProperties, WMI_PROPERTY_COUNT(g_SoundDeviceProperties), NULL};
+
+/**
+ * @brief Fills defaults for properties the device did not report
+ *
+ * @param pclsObj Win32_SoundDevice object
+ * @param row AudioDeviceInfo with projected properties stored
+ * @param context Unused
+ * @return BOOL TRUE, every device is kept
+ */
+static BOOL completeSoundDevice(IWbemClassObject *pclsObj, void *row, void *context)
+{
+    AudioDeviceInfo *device = (AudioDeviceInfo *)row;
+
+    // Fallback for unknown devices
+    if (device->name[0] == '\0')
+    {
+        strcpy_s(device->name, sizeof(device->name), "Unknown Audio Device");
+    }
+
+    // N/A fallback for manufacturer
+    if (device->manufacturer[0] == '\0')
+    {
+        strcpy_s(device->manufacturer, sizeof(device->manufacturer), "N/A");
+    }
+
+    return TRUE;
+}
+
 /**
  * @brief Retrieves information about all audio devices in the system
  *
@@ -15,79 +54,36 @@
  */
 AudioList *getAudioList(void)
 {
-    AudioList *list = (AudioList *)malloc(sizeof(AudioList));
+    AudioList *list = (AudioList *)festMalloc(sizeof(AudioList));
     if (!list)
         return NULL;
 
     list->devices = NULL;
     list->count = 0;
 
-    // Initialize WMI connection
-    WMISession *session = initializeWMI();
+    // Lease the thread's pooled WMI connection
+    WMISession *session = acquireWMISession();
     if (!session)
     {
-        free(list);
+        festFree(list);
         return NULL;
     }
 
-    // Query Win32_SoundDevice class for audio device information
-    IEnumWbemClassObject *pEnumerator = NULL;
-    if (executeWQLQuery(session, L"SELECT * FROM Win32_SoundDevice", &pEnumerator))
-    {
-        IWbemClassObject *pclsObj = NULL;
-        ULONG uReturn = 0;
-
-        // First pass: Count total number of audio devices
-        while (SUCCEEDED(pEnumerator->lpVtbl->Next(pEnumerator, WBEM_INFINITE, 1, &pclsObj, &uReturn)) && uReturn != 0)
-        {
-            list->count++;
-            pclsObj->lpVtbl->Release(pclsObj);
-        }
-        pEnumerator->lpVtbl->Release(pEnumerator);
-
-        if (list->count > 0)
-        {
-            // Allocate memory for the device array
-            list->devices = (AudioDeviceInfo *)malloc(sizeof(AudioDeviceInfo) * list->count);
-            if (!list->devices)
-            {
-                cleanupWMI(session);
-                free(list);
-                return NULL;
-            }
-
-            // Second pass: Collect detailed information for each device
-            if (executeWQLQuery(session, L"SELECT * FROM Win32_SoundDevice", &pEnumerator))
-            {
-                UINT i = 0;
-                while (SUCCEEDED(pEnumerator->lpVtbl->Next(pEnumerator, WBEM_INFINITE, 1, &pclsObj, &uReturn)) && uReturn != 0)
-                {
-                    AudioDeviceInfo *device = &list->devices[i];
-
-                    // Get device name with fallback for unknown devices
-                    if (!getWMIPropertyString(pclsObj, L"Name", device->name, sizeof(device->name)))
-                    {
-                        strcpy_s(device->name, sizeof(device->name), "Unknown Audio Device");
-                    }
-
-                    // Get manufacturer with N/A fallback
-                    if (!getWMIPropertyString(pclsObj, L"Manufacturer", device->manufacturer, sizeof(device->manufacturer)))
-                    {
-                        strcpy_s(device->manufacturer, sizeof(device->manufacturer), "N/A");
-                    }
-
-                    pclsObj->lpVtbl->Release(pclsObj);
-                    i++;
-                }
-                pEnumerator->lpVtbl->Release(pEnumerator);
-            }
-        }
-    }
+    // Query the Win32_SoundDevice properties we report, in one pass
+    WMIRowVector rows;
+    initWMIRowVector(&rows, NULL, sizeof(AudioDeviceInfo), 4);
+    if (!queryWMIProjected(session, &g_SoundDeviceQuery, &rows, completeSoundDevice, NULL))
+        releaseWMIRowVector(&rows);
 
-    cleanupWMI(session);
+    list->devices = (AudioDeviceInfo *)rows.rows;
+    list->count = rows.count;
+
+    releaseWMISession(session);
     return list;
 }
 
+#endif // _WIN32
+
 /**
  * @brief Frees memory allocated for AudioList structure
  *
@@ -98,8 +94,8 @@ void freeAudioList(AudioList *list)
     if (list)
     {
         if (list->devices)
-            free(list->devices);
-        free(list);
+            festFree(list->devices);
+        festFree(list);
     }
 }
 
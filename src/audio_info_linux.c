@@ -0,0 +1,114 @@
+#include "audio_info.h"
+#include "fest_alloc.h"
+#include "linux_sysfs.h"
+#include <stdio.h>
+
+#define ASOUND_CARDS_PATH "/proc/asound/cards" // Two lines per card
+#define ASOUND_CARDS_SIZE 8192                 // Room for 32 cards
+#define MAX_SOUND_CARDS 32                     // ALSA card index limit
+
+/**
+ * @brief PCI vendors of common audio functions
+ */
+static const struct
+{
+    UINT vendorId;     // PCI vendor id
+    const char *name;  // Reported manufacturer
+} g_AudioVendors[] = {
+    {0x8086, "Intel(R) Corporation"},
+    {0x10de, "NVIDIA"},
+    {0x1002, "Advanced Micro Devices, Inc."},
+    {0x1022, "Advanced Micro Devices, Inc."},
+    {0x10ec, "Realtek"},
+    {0x1102, "Creative Labs"},
+};
+
+/**
+ * @brief Looks up the manufacturer of a card's PCI function
+ *
+ * @param card ALSA card index
+ * @param manufacturer Buffer receiving the name, "N/A" if unknown
+ * @param size Size of the buffer in bytes
+ */
+static void getCardManufacturer(UINT card, char *manufacturer, size_t size)
+{
+    char path[SYSFS_PATH_LENGTH];
+    char value[16];
+
+    strcpy_s(manufacturer, size, "N/A");
+    _snprintf_s(path, sizeof(path), _TRUNCATE, "/sys/class/sound/card%u/device/vendor", card);
+    if (!readSysfsString(path, value, sizeof(value)))
+        return;
+
+    UINT vendorId = (UINT)strtoul(value, NULL, 16);
+    for (size_t i = 0; i < sizeof(g_AudioVendors) / sizeof(g_AudioVendors[0]); i++)
+    {
+        if (g_AudioVendors[i].vendorId == vendorId)
+        {
+            strcpy_s(manufacturer, size, g_AudioVendors[i].name);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Lists ALSA sound cards from /proc/asound/cards
+ *
+ * Card lines look like " 0 [PCH            ]: HDA-Intel - HDA Intel PCH";
+ * the text after " - " is the card's name. The indented line that
+ * follows each card is skipped.
+ *
+ * @return AudioList* Pointer to allocated audio device list, NULL if failed
+ * @note Caller is responsible for freeing the returned list using freeAudioList()
+ */
+AudioList *getLinuxAudioList(void)
+{
+    AudioList *list = (AudioList *)festMalloc(sizeof(AudioList));
+    if (!list)
+        return NULL;
+
+    list->devices = NULL;
+    list->count = 0;
+
+    char *cards = (char *)festMalloc(ASOUND_CARDS_SIZE);
+    if (!cards)
+        return list;
+
+    if (readSysfsFile(ASOUND_CARDS_PATH, cards, ASOUND_CARDS_SIZE) > 0)
+    {
+        list->devices = (AudioDeviceInfo *)festMalloc(MAX_SOUND_CARDS * sizeof(AudioDeviceInfo));
+        for (char *line = cards; list->devices && *line && list->count < MAX_SOUND_CARDS;)
+        {
+            char *next = strchr(line, '\n');
+            if (next)
+                *next++ = '\0';
+            else
+                next = line + strlen(line);
+
+            // Card lines start with the right-aligned index
+            const char *cursor = line;
+            while (*cursor == ' ')
+                cursor++;
+            const char *name = strstr(cursor, " - ");
+            if (*cursor >= '0' && *cursor <= '9' && name)
+            {
+                UINT card = 0;
+                while (*cursor >= '0' && *cursor <= '9')
+                    card = card * 10 + (UINT)(*cursor++ - '0');
+
+                AudioDeviceInfo *device = &list->devices[list->count++];
+                strcpy_s(device->name, sizeof(device->name), name[3] ? name + 3 : "Unknown Audio Device");
+                getCardManufacturer(card, device->manufacturer, sizeof(device->manufacturer));
+            }
+            line = next;
+        }
+    }
+
+    festFree(cards);
+    if (list->devices && list->count == 0)
+    {
+        festFree(list->devices);
+        list->devices = NULL;
+    }
+    return list;
+}
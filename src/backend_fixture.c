@@ -0,0 +1,469 @@
+#include "collector_backend.h"
+#include "fest_alloc.h"
+#include <string.h>
+
+#define FIXTURE_RAM_SLOTS 4     // Populated memory slots
+#define FIXTURE_VOLUMES 4       // Logical volumes
+#define FIXTURE_ADAPTERS 4      // Network adapters
+#define FIXTURE_CONNECTED 2     // Connected adapters, each with one IPv4 and one IPv6 address
+#define FIXTURE_AUDIO_DEVICES 3 // Audio endpoints
+#define FIXTURE_MONITORS 2      // Connected displays
+#define FIXTURE_GPUS 2          // Graphics adapters
+#define FIXTURE_LOAD_CORES 8    // Logical cores with CPU load and frequency
+#define FIXTURE_BLOCK_DEVICES 6 // Disks and partitions with I/O activity
+
+/**
+ * @brief Builds the fixture processor list
+ *
+ * @return CPUList* Single 8-core processor, NULL if allocation failed
+ */
+static CPUList *getFixtureCPUList(void)
+{
+    CPUList *list = (CPUList *)festMalloc(sizeof(CPUList));
+    if (!list)
+        return NULL;
+
+    list->count = 1;
+    list->cpus = (CPUInfo *)festMalloc(sizeof(CPUInfo));
+    if (!list->cpus)
+    {
+        festFree(list);
+        return NULL;
+    }
+
+    memset(list->cpus, 0, sizeof(CPUInfo));
+    strcpy_s(list->cpus[0].name, sizeof(list->cpus[0].name), "Intel(R) Core(TM) i7-12700H CPU @ 2.30GHz");
+    list->cpus[0].cores = 8;
+    list->cpus[0].threads = 16;
+    list->cpus[0].clockSpeed = 2300;
+    return list;
+}
+
+/**
+ * @brief Builds the fixture graphics adapter list
+ *
+ * @return GPUList* One integrated and one discrete GPU, NULL if allocation failed
+ */
+static GPUList *getFixtureGPUList(void)
+{
+    static const char *names[FIXTURE_GPUS] = {"Intel(R) Iris(R) Xe Graphics", "NVIDIA GeForce RTX 3050 Laptop GPU"};
+
+    GPUList *list = (GPUList *)festMalloc(sizeof(GPUList));
+    if (!list)
+        return NULL;
+
+    list->count = FIXTURE_GPUS;
+    list->gpus = (GPUInfo *)festMalloc(FIXTURE_GPUS * sizeof(GPUInfo));
+    if (!list->gpus)
+    {
+        festFree(list);
+        return NULL;
+    }
+
+    memset(list->gpus, 0, FIXTURE_GPUS * sizeof(GPUInfo));
+    for (UINT i = 0; i < FIXTURE_GPUS; i++)
+    {
+        strcpy_s(list->gpus[i].name, sizeof(list->gpus[i].name), names[i]);
+        list->gpus[i].isIntegrated = (i == 0);
+        list->gpus[i].dedicatedMemory = (i == 0) ? 0.13 : 3.86;
+        list->gpus[i].sharedMemory = 7.85;
+        list->gpus[i].adapterIndex = i;
+    }
+    return list;
+}
+
+/**
+ * @brief Builds the fixture motherboard information
+ *
+ * @return MotherboardInfo* Board details, NULL if allocation failed
+ */
+static MotherboardInfo *getFixtureMotherboardInfo(void)
+{
+    MotherboardInfo *info = (MotherboardInfo *)festMalloc(sizeof(MotherboardInfo));
+    if (!info)
+        return NULL;
+
+    memset(info, 0, sizeof(MotherboardInfo));
+    strcpy_s(info->productName, sizeof(info->productName), "PEGASUS-P2");
+    strcpy_s(info->manufacturer, sizeof(info->manufacturer), "Axioo");
+    strcpy_s(info->serialNumber, sizeof(info->serialNumber), "AX0000000001");
+    strcpy_s(info->biosVersion, sizeof(info->biosVersion), "1.07.09");
+    strcpy_s(info->biosSerial, sizeof(info->biosSerial), "BS0000000001");
+    strcpy_s(info->systemSKU, sizeof(info->systemSKU), "PEGASUS-P2-SKU");
+    return info;
+}
+
+/**
+ * @brief Builds the fixture audio device list
+ *
+ * @return AudioList* Audio endpoints, NULL if allocation failed
+ */
+static AudioList *getFixtureAudioList(void)
+{
+    static const char *names[FIXTURE_AUDIO_DEVICES] = {"Realtek(R) Audio", "Intel(R) Display Audio", "NVIDIA Virtual Audio Device (Wave Extensible) (WDM)"};
+    static const char *vendors[FIXTURE_AUDIO_DEVICES] = {"Realtek", "Intel(R) Corporation", "NVIDIA"};
+
+    AudioList *list = (AudioList *)festMalloc(sizeof(AudioList));
+    if (!list)
+        return NULL;
+
+    list->count = FIXTURE_AUDIO_DEVICES;
+    list->devices = (AudioDeviceInfo *)festMalloc(FIXTURE_AUDIO_DEVICES * sizeof(AudioDeviceInfo));
+    if (!list->devices)
+    {
+        festFree(list);
+        return NULL;
+    }
+
+    for (UINT i = 0; i < FIXTURE_AUDIO_DEVICES; i++)
+    {
+        strcpy_s(list->devices[i].name, sizeof(list->devices[i].name), names[i]);
+        strcpy_s(list->devices[i].manufacturer, sizeof(list->devices[i].manufacturer), vendors[i]);
+    }
+    return list;
+}
+
+/**
+ * @brief Builds the fixture display list
+ *
+ * @return MonitorList* Internal panel and external monitor, NULL if allocation failed
+ */
+static MonitorList *getFixtureMonitorList(void)
+{
+    MonitorList *list = (MonitorList *)festMalloc(sizeof(MonitorList));
+    if (!list)
+        return NULL;
+
+    list->count = FIXTURE_MONITORS;
+    list->capacity = FIXTURE_MONITORS;
+    list->monitors = (MonitorInfo *)festMalloc(FIXTURE_MONITORS * sizeof(MonitorInfo));
+    if (!list->monitors)
+    {
+        festFree(list);
+        return NULL;
+    }
+
+    memset(list->monitors, 0, FIXTURE_MONITORS * sizeof(MonitorInfo));
+    for (UINT i = 0; i < FIXTURE_MONITORS; i++)
+    {
+        MonitorInfo *monitor = &list->monitors[i];
+        monitor->width = 1920;
+        monitor->height = 1080;
+        monitor->isPrimary = (i == 0);
+        monitor->refreshRate = (i == 0) ? 144 : 60;
+        monitor->physicalWidthMm = (i == 0) ? 344 : 527;
+        monitor->physicalHeightMm = (i == 0) ? 194 : 296;
+        strcpy_s(monitor->deviceId, sizeof(monitor->deviceId), (i == 0) ? "\\\\?\\DISPLAY#BOE0A81#4&1b1f4f&0&UID8388688" : "\\\\?\\DISPLAY#DELA1C4#5&2c3a1e&0&UID4353");
+        strcpy_s(monitor->manufacturer, sizeof(monitor->manufacturer), (i == 0) ? "BOE" : "Dell");
+        strcpy_s(monitor->aspectRatio, sizeof(monitor->aspectRatio), "16:9");
+        strcpy_s(monitor->nativeResolution, sizeof(monitor->nativeResolution), "1920x1080");
+        strcpy_s(monitor->currentResolution, sizeof(monitor->currentResolution), (i == 0) ? "1920x1080 @ 144Hz" : "1920x1080 @ 60Hz");
+        strcpy_s(monitor->screenSize, sizeof(monitor->screenSize), (i == 0) ? "15.6" : "23.8");
+    }
+    return list;
+}
+
+/**
+ * @brief Builds the fixture memory information
+ *
+ * @param arena Snapshot arena to allocate from, NULL for the heap
+ * @return MemoryInfo* 16 GB in four slots, NULL if allocation failed
+ */
+static MemoryInfo *collectFixtureMemoryInfo(SnapshotArena *arena)
+{
+    MemoryInfo *info = (MemoryInfo *)snapshotAlloc(arena, sizeof(MemoryInfo));
+    if (!info)
+        return NULL;
+
+    info->totalPhys = 17045651456ULL;
+    info->availPhys = 7340032000ULL;
+    info->usedPhys = info->totalPhys - info->availPhys;
+    info->memoryLoad = 56;
+    info->totalSwap = 4294967296ULL;
+    info->freeSwap = 3758096384ULL;
+    info->cached = 5368709120ULL;
+    info->buffers = 268435456ULL;
+    info->dirty = 2097152ULL;
+    info->hugePagesTotal = 0;
+    info->hugePagesFree = 0;
+    info->hugePageSize = 2097152ULL;
+    return info;
+}
+
+/**
+ * @brief Builds the fixture RAM module list
+ *
+ * @return RAMSlotList* Four 4 GB DDR4-3200 modules, NULL if allocation failed
+ */
+static RAMSlotList *getFixtureRAMSlotList(void)
+{
+    RAMSlotList *list = (RAMSlotList *)festMalloc(sizeof(RAMSlotList));
+    if (!list)
+        return NULL;
+
+    list->count = FIXTURE_RAM_SLOTS;
+    list->slots = (RAMSlotInfo *)festMalloc(FIXTURE_RAM_SLOTS * sizeof(RAMSlotInfo));
+    if (!list->slots)
+    {
+        festFree(list);
+        return NULL;
+    }
+
+    memset(list->slots, 0, FIXTURE_RAM_SLOTS * sizeof(RAMSlotInfo));
+    for (UINT i = 0; i < FIXTURE_RAM_SLOTS; i++)
+    {
+        RAMSlotInfo *slot = &list->slots[i];
+        slot->capacity = 4294967296ULL;
+        slot->speed = 3200;
+        slot->configuredSpeed = 3200;
+        _snprintf_s(slot->slot, sizeof(slot->slot), _TRUNCATE, "Controller%u-DIMM%u", i / 2, i % 2);
+        strcpy_s(slot->manufacturer, sizeof(slot->manufacturer), "Samsung");
+    }
+    return list;
+}
+
+/**
+ * @brief Builds the fixture storage volume list
+ *
+ * @param arena Snapshot arena to allocate from, NULL for the heap
+ * @return StorageList* System, data and removable volumes, NULL if allocation failed
+ */
+static StorageList *collectFixtureStorageList(SnapshotArena *arena)
+{
+    StorageList *list = (StorageList *)snapshotAlloc(arena, sizeof(StorageList));
+    if (!list)
+        return NULL;
+
+    list->count = FIXTURE_VOLUMES;
+    list->disks = (LogicalDiskInfo *)snapshotAlloc(arena, FIXTURE_VOLUMES * sizeof(LogicalDiskInfo));
+    if (!list->disks)
+    {
+        snapshotFree(arena, list);
+        return NULL;
+    }
+
+    for (UINT i = 0; i < FIXTURE_VOLUMES; i++)
+    {
+        LogicalDiskInfo *disk = &list->disks[i];
+        BOOL removable = (i == FIXTURE_VOLUMES - 1);
+        memset(disk, 0, sizeof(LogicalDiskInfo));
+        _snprintf_s(disk->drive, sizeof(disk->drive), _TRUNCATE, "%c:", 'C' + i);
+        _snprintf_s(disk->mountPoint, sizeof(disk->mountPoint), _TRUNCATE, "%c:\\", 'C' + i);
+        if (removable)
+            strcpy_s(disk->device, sizeof(disk->device), "sda1");
+        else
+            _snprintf_s(disk->device, sizeof(disk->device), _TRUNCATE, "nvme0n1p%u", i + 1);
+        strcpy_s(disk->fileSystem, sizeof(disk->fileSystem), removable ? "FAT32" : "NTFS");
+        strcpy_s(disk->type, sizeof(disk->type), removable ? "Removable" : "Fixed");
+        strcpy_s(disk->model, sizeof(disk->model), removable ? "SanDisk Ultra USB 3.0" : "SAMSUNG MZVL2512HCJQ-00B00");
+        strcpy_s(disk->interfaceType, sizeof(disk->interfaceType), removable ? "USB" : "NVMe");
+        disk->diskSize = removable ? 28.64 : 476.94;
+        disk->totalSize = removable ? 28.64 : 158.12;
+        disk->freeSpace = removable ? 20.01 : 61.48 + i;
+    }
+    return list;
+}
+
+/**
+ * @brief Builds the fixture block device activity
+ *
+ * @param arena Snapshot arena to allocate from, NULL for the heap
+ * @return DiskIOList* NVMe disk busy with a copy to a USB stick, NULL if allocation failed
+ */
+static DiskIOList *collectFixtureDiskIO(SnapshotArena *arena)
+{
+    static const DiskIOStats devices[FIXTURE_BLOCK_DEVICES] = {
+        {"nvme0n1", 1650.0, 120.0, 216268800.0, 1966080.0, 0.12, 21.5},
+        {"nvme0n1p1", 1650.0, 80.0, 216268800.0, 1310720.0, 0.12, 21.5},
+        {"nvme0n1p2", 0.0, 40.0, 0.0, 655360.0, 0.05, 0.2},
+        {"nvme0n1p3", 0.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+        {"sda", 0.0, 220.0, 0.0, 28835840.0, 4.38, 96.4},
+        {"sda1", 0.0, 220.0, 0.0, 28835840.0, 4.38, 96.4}};
+
+    DiskIOList *list = (DiskIOList *)snapshotAlloc(arena, sizeof(DiskIOList));
+    if (!list)
+        return NULL;
+
+    list->count = FIXTURE_BLOCK_DEVICES;
+    list->devices = (DiskIOStats *)snapshotAlloc(arena, sizeof(devices));
+    if (!list->devices)
+    {
+        snapshotFree(arena, list);
+        return NULL;
+    }
+    memcpy(list->devices, devices, sizeof(devices));
+    return list;
+}
+
+/**
+ * @brief Builds the fixture battery information
+ *
+ * @param arena Snapshot arena to allocate from, NULL for the heap
+ * @return BatteryInfo* Notebook on AC power, NULL if allocation failed
+ */
+static BatteryInfo *collectFixtureBatteryInfo(SnapshotArena *arena)
+{
+    BatteryInfo *info = (BatteryInfo *)snapshotAlloc(arena, sizeof(BatteryInfo));
+    if (!info)
+        return NULL;
+
+    info->percent = 87;
+    info->powerPlugged = TRUE;
+    info->isDesktop = FALSE;
+    return info;
+}
+
+/**
+ * @brief Builds the fixture CPU utilization
+ *
+ * @param arena Snapshot arena to allocate from, NULL for the heap
+ * @return CPULoadInfo* Eight cores with increasing load, NULL if allocation failed
+ */
+static CPULoadInfo *collectFixtureCPULoad(SnapshotArena *arena)
+{
+    CPULoadInfo *info = (CPULoadInfo *)snapshotAlloc(arena, sizeof(CPULoadInfo));
+    if (!info)
+        return NULL;
+
+    info->coreCount = FIXTURE_LOAD_CORES;
+    info->cores = (CPULoad *)snapshotAlloc(arena, FIXTURE_LOAD_CORES * sizeof(CPULoad));
+    if (!info->cores)
+    {
+        snapshotFree(arena, info);
+        return NULL;
+    }
+
+    memset(&info->total, 0, sizeof(CPULoad));
+    for (UINT i = 0; i < FIXTURE_LOAD_CORES; i++)
+    {
+        CPULoad *core = &info->cores[i];
+        core->user = 5.0 * (i + 1);
+        core->system = 2.5;
+        core->iowait = i == 0 ? 1.5 : 0.0;
+        core->idle = 100.0 - core->user - core->system - core->iowait;
+
+        info->total.user += core->user / FIXTURE_LOAD_CORES;
+        info->total.system += core->system / FIXTURE_LOAD_CORES;
+        info->total.iowait += core->iowait / FIXTURE_LOAD_CORES;
+        info->total.idle += core->idle / FIXTURE_LOAD_CORES;
+    }
+    return info;
+}
+
+/**
+ * @brief Builds the fixture core clocks
+ *
+ * @param arena Snapshot arena to allocate from, NULL for the heap
+ * @return CPUFrequencyInfo* Eight boosting and idling cores, NULL if allocation failed
+ */
+static CPUFrequencyInfo *collectFixtureCPUFrequency(SnapshotArena *arena)
+{
+    static const UINT clocks[FIXTURE_LOAD_CORES] = {4100, 3900, 2300, 2300, 1400, 1400, 800, 800};
+
+    CPUFrequencyInfo *info = allocCPUFrequencyInfo(FIXTURE_LOAD_CORES, arena);
+    if (!info)
+        return NULL;
+
+    memcpy(info->cores, clocks, sizeof(clocks));
+    summarizeCPUFrequency(info);
+    return info;
+}
+
+/**
+ * @brief Builds the fixture network adapter list
+ *
+ * @param arena Snapshot arena to allocate from, NULL for the heap
+ * @return NetworkList* Ethernet, Wi-Fi and virtual adapters, NULL if allocation failed
+ */
+static NetworkList *collectFixtureNetworkList(SnapshotArena *arena)
+{
+    static const char *names[FIXTURE_ADAPTERS] = {"Ethernet", "Wi-Fi", "Bluetooth Network Connection", "vEthernet (Default Switch)"};
+    static const UINT types[FIXTURE_ADAPTERS] = {MIB_IF_TYPE_ETHERNET, IF_TYPE_IEEE80211, MIB_IF_TYPE_ETHERNET, MIB_IF_TYPE_ETHERNET};
+
+    NetworkList *list = (NetworkList *)snapshotAlloc(arena, sizeof(NetworkList));
+    if (!list)
+        return NULL;
+
+    list->count = FIXTURE_ADAPTERS;
+    list->addressCount = 2 * FIXTURE_CONNECTED;
+    list->adapters = (NetworkAdapterInfo *)snapshotAlloc(arena, FIXTURE_ADAPTERS * sizeof(NetworkAdapterInfo));
+    list->addresses = (NetworkAddress *)snapshotAlloc(arena, list->addressCount * sizeof(NetworkAddress));
+    if (!list->adapters || !list->addresses)
+    {
+        snapshotFree(arena, list->addresses);
+        snapshotFree(arena, list->adapters);
+        snapshotFree(arena, list);
+        return NULL;
+    }
+
+    for (UINT i = 0; i < FIXTURE_ADAPTERS; i++)
+    {
+        NetworkAdapterInfo *adapter = &list->adapters[i];
+        BOOL connected = i < FIXTURE_CONNECTED;
+        memset(adapter, 0, sizeof(NetworkAdapterInfo));
+        strcpy_s(adapter->name, sizeof(adapter->name), names[i]);
+        _snprintf_s(adapter->macAddress, sizeof(adapter->macAddress), _TRUNCATE, "00-1A-2B-3C-4D-%02X", 0x50 + i);
+        _snprintf_s(adapter->ipAddress, sizeof(adapter->ipAddress), _TRUNCATE, "192.168.%u.%u", i, 10 + i);
+        strcpy_s(adapter->status, sizeof(adapter->status), connected ? "Connected" : "Not Connected");
+        strcpy_s(adapter->operState, sizeof(adapter->operState), connected ? "up" : "down");
+        adapter->type = types[i];
+        adapter->index = 2 + i;
+        if (!connected)
+            continue;
+
+        NetworkAddress *ipv4 = &list->addresses[2 * i];
+        NetworkAddress *ipv6 = &list->addresses[2 * i + 1];
+        strcpy_s(ipv4->address, sizeof(ipv4->address), adapter->ipAddress);
+        ipv4->prefixLength = 24;
+        ipv4->ipv6 = FALSE;
+        _snprintf_s(ipv6->address, sizeof(ipv6->address), _TRUNCATE, "fe80::21a:2bff:fe3c:4d%02x", 0x50 + i);
+        ipv6->prefixLength = 64;
+        ipv6->ipv6 = TRUE;
+        adapter->firstAddress = 2 * i;
+        adapter->addressCount = 2;
+
+        // A download on the wired adapter, light traffic with a few drops on Wi-Fi
+        adapter->rxBytesPerSec = 11750000.0 / (1 + 9 * i);
+        adapter->txBytesPerSec = 420000.0 / (1 + 9 * i);
+        adapter->rxPacketsPerSec = 8120.0 / (1 + 9 * i);
+        adapter->txPacketsPerSec = 3960.0 / (1 + 9 * i);
+        adapter->rxDropped = 3 * i;
+    }
+    return list;
+}
+
+/**
+ * @brief Fixture collectors paired with the library free functions
+ *
+ * Static results are released with the regular free functions and
+ * dynamic fixtures allocate from the snapshot arena like the
+ * platform collectors do, so the engine and JSON renderer exercise
+ * exactly their live code paths. No collector keeps state.
+ */
+static const CollectorBackend g_FixtureBackend = {
+    "fixture",
+    {getFixtureCPUList, freeCPUList,
+     getFixtureGPUList, freeGPUList,
+     getFixtureMotherboardInfo, freeMotherboardInfo,
+     getFixtureAudioList, freeAudioList,
+     getFixtureMonitorList, freeMonitorList,
+     getFixtureRAMSlotList, freeRAMSlotList,
+     collectFixtureMemoryInfo,
+     collectFixtureStorageList,
+     collectFixtureBatteryInfo,
+     collectFixtureNetworkList,
+     collectFixtureCPULoad,
+     collectFixtureCPUFrequency,
+     collectFixtureDiskIO},
+    {{NULL, NULL}},
+    NULL};
+
+/**
+ * @brief Returns the deterministic fixture backend
+ *
+ * @return const CollectorBackend* Fixture backend
+ */
+const CollectorBackend *getFixtureCollectorBackend(void)
+{
+    return &g_FixtureBackend;
+}
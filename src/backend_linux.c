@@ -0,0 +1,58 @@
+#include "collector_backend.h"
+#include "smbios.h"
+
+/**
+ * @brief sysfs and procfs collectors
+ *
+ * Every file is read below the root set by setSysfsRoot(), so the
+ * backend runs unchanged against a captured fixture tree. GPU
+ * and monitor collectors have no Linux counterpart yet and are
+ * omitted; RAM slots need the root-only SMBIOS table, which is
+ * read once for both the motherboard and the RAM slots.
+ * Memory keeps /proc/meminfo open across ticks, CPU load
+ * /proc/stat and CPU frequency the scaling_cur_freq file of every
+ * core, disk I/O /proc/diskstats and battery the power_supply
+ * directory. Network keeps an rtnetlink socket. Storage rereads
+ * mountinfo only after a mount table change.
+ */
+static const CollectorBackend g_LinuxBackend = {
+    "linux",
+    {getLinuxCPUList, freeCPUList,
+     NULL, NULL,                                    // GPU
+     getLinuxMotherboardInfo, freeMotherboardInfo,
+     getLinuxAudioList, freeAudioList,
+     NULL, NULL,                                    // Monitors
+     getSMBIOSRAMSlotList, freeRAMSlotList,
+     collectLinuxMemoryInfo,
+     collectLinuxStorageList,
+     collectLinuxBatteryInfo,
+     collectLinuxNetworkList,
+     collectLinuxCPULoad,
+     collectLinuxCPUFrequency,
+     collectLinuxDiskIO},
+    {
+        {NULL, NULL},                                    // CPU
+        {NULL, NULL},                                    // GPU
+        {openSMBIOSCollector, closeSMBIOSCollector},     // Motherboard
+        {NULL, NULL},                                    // Audio
+        {NULL, NULL},                                    // Monitors
+        {openSMBIOSCollector, closeSMBIOSCollector},     // RAM slots
+        {openLinuxMemory, closeLinuxMemory},             // Memory
+        {NULL, releaseLinuxStorageTopology},             // Storage
+        {openLinuxBattery, closeLinuxBattery},           // Battery
+        {openLinuxNetwork, closeLinuxNetwork},           // Network
+        {openLinuxCPULoad, closeLinuxCPULoad},           // CPU load
+        {openLinuxCPUFrequency, closeLinuxCPUFrequency}, // CPU frequency
+        {openLinuxDiskIO, closeLinuxDiskIO},             // Disk I/O
+    },
+    NULL};
+
+/**
+ * @brief Returns the sysfs/procfs backend
+ *
+ * @return const CollectorBackend* Linux backend
+ */
+const CollectorBackend *getLinuxCollectorBackend(void)
+{
+    return &g_LinuxBackend;
+}
@@ -0,0 +1,112 @@
+#include "collector_backend.h"
+#include "wmi_helper.h"
+#include "smbios.h"
+
+/**
+ * @brief Pins the thread's pooled WMI session for a WMI collector
+ *
+ * Pins are counted, so the session opens with the first WMI
+ * collector and every collector on every tick reuses it.
+ *
+ * @return BOOL TRUE
+ */
+static BOOL openWMICollector(void)
+{
+    pinWMISession();
+    return TRUE;
+}
+
+/**
+ * @brief Drops the pin taken by openWMICollector()
+ */
+static void closeWMICollector(void)
+{
+    unpinWMISession();
+}
+
+/**
+ * @brief Decodes the SMBIOS table and pins the WMI session
+ *
+ * The motherboard and RAM slot collectors share one read of the
+ * firmware table and only query WMI when it is unavailable.
+ *
+ * @return BOOL TRUE
+ */
+static BOOL openFirmwareCollector(void)
+{
+    openSMBIOSCollector();
+    pinWMISession();
+    return TRUE;
+}
+
+/**
+ * @brief Drops the table and the pin taken by openFirmwareCollector()
+ */
+static void closeFirmwareCollector(void)
+{
+    closeSMBIOSCollector();
+    unpinWMISession();
+}
+
+/**
+ * @brief Releases the storage topology and the WMI pin
+ *
+ * The topology is rediscovered by the next session.
+ */
+static void closeStorageCollector(void)
+{
+    releaseStorageTopology();
+    unpinWMISession();
+}
+
+/**
+ * @brief WMI, DXGI, IP Helper, SetupAPI and power status collectors
+ *
+ * DXGI, SetupAPI, GetSystemPowerStatus and the memory counters of
+ * GlobalMemoryStatusEx and GetPerformanceInfo keep no state
+ * between ticks; CPU load and network keep the counters of the
+ * previous tick and CPU frequency its power information buffer.
+ * Blocking WMI queries are ended by cancelWMIQueries(). Disk I/O
+ * has no Windows collector yet.
+ */
+static const CollectorBackend g_WindowsBackend = {
+    "windows",
+    {getCPUList, freeCPUList,
+     getGPUList, freeGPUList,
+     getMotherboardInfo, freeMotherboardInfo,
+     getAudioList, freeAudioList,
+     getMonitorList, freeMonitorList,
+     getRAMSlotList, freeRAMSlotList,
+     collectMemoryInfo,
+     collectStorageList,
+     collectBatteryInfo,
+     collectNetworkList,
+     collectCPULoad,
+     collectCPUFrequency,
+     NULL}, // Disk I/O
+    {
+        {openWMICollector, closeWMICollector},                   // CPU
+        {NULL, NULL},                                            // GPU
+        {openFirmwareCollector, closeFirmwareCollector},         // Motherboard
+        {openWMICollector, closeWMICollector},                   // Audio
+        {NULL, NULL},                                            // Monitors
+        {openFirmwareCollector, closeFirmwareCollector},         // RAM slots
+        {NULL, NULL},                                            // Memory
+        {openWMICollector, closeStorageCollector},               // Storage
+        {NULL, NULL},                                            // Battery
+        {NULL, closeNetworkCollector},                           // Network
+        {openCPULoadCollector, closeCPULoadCollector},           // CPU load
+        {openCPUFrequencyCollector, closeCPUFrequencyCollector}, // CPU frequency
+        {NULL, NULL},                                            // Disk I/O
+    },
+    cancelWMIQueries};
+
+/**
+ * @brief Returns the WMI/Win32 backend
+ *
+ * @return const CollectorBackend* Windows backend
+ */
+const CollectorBackend *getWindowsCollectorBackend(void)
+{
+    return &g_WindowsBackend;
+}
@@ -1,6 +1,8 @@
 #include "battery_info.h"
+#include "fest_alloc.h"
 #include <stdio.h>
 
+#ifdef _WIN32
 /**
  * @brief Retrieves battery information and power status from the system
  *
@@ -12,12 +14,13 @@
  * The function uses Windows GetSystemPowerStatus API and includes logic to
  * detect desktop systems based on battery flags and status.
  *
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
  * @return BatteryInfo* Pointer to allocated battery information structure, NULL if failed
- * @note Caller is responsible for freeing the returned structure using freeBatteryInfo()
+ * @note Without an arena, caller is responsible for freeing the returned structure using freeBatteryInfo()
  */
-BatteryInfo *getBatteryInfo(void)
+BatteryInfo *collectBatteryInfo(SnapshotArena *arena)
 {
-    BatteryInfo *info = (BatteryInfo *)malloc(sizeof(BatteryInfo));
+    BatteryInfo *info = (BatteryInfo *)snapshotAlloc(arena, sizeof(BatteryInfo));
     if (!info)
         return NULL;
 
@@ -57,6 +60,19 @@ BatteryInfo *getBatteryInfo(void)
     return info;
 }
 
+/**
+ * @brief Retrieves battery information from the heap
+ *
+ * @return BatteryInfo* Pointer to allocated battery information, NULL if failed
+ * @note Caller is responsible for freeing the returned structure using freeBatteryInfo()
+ */
+BatteryInfo *getBatteryInfo(void)
+{
+    return collectBatteryInfo(NULL);
+}
+
+#endif // _WIN32
+
 /**
  * @brief Frees memory allocated for BatteryInfo structure
  *
@@ -66,7 +82,7 @@ void freeBatteryInfo(BatteryInfo *info)
 {
     if (info)
     {
-        free(info);
+        festFree(info);
     }
 }
 
@@ -0,0 +1,125 @@
+#include "battery_info.h"
+#include "linux_sysfs.h"
+#include <stdio.h>
+
+#define POWER_SUPPLY_DIR "/sys/class/power_supply" // One directory per supply
+
+/**
+ * @brief Reader state of the Linux collector, owned by the monitoring thread
+ */
+static struct
+{
+    DIR *dir; // /sys/class/power_supply, kept open across ticks
+} g_LinuxBattery = {NULL};
+
+/**
+ * @brief Opens /sys/class/power_supply for the monitoring session
+ *
+ * opendir() allocates the stream buffer, so the engine keeps one
+ * stream and rewinds it every tick. A machine without the
+ * directory is still reported, as a desktop on AC power.
+ *
+ * @return BOOL Always TRUE
+ */
+BOOL openLinuxBattery(void)
+{
+    g_LinuxBattery.dir = openSysfsDir(POWER_SUPPLY_DIR);
+    return TRUE;
+}
+
+/**
+ * @brief Closes /sys/class/power_supply
+ */
+void closeLinuxBattery(void)
+{
+    if (g_LinuxBattery.dir)
+        closedir(g_LinuxBattery.dir);
+    g_LinuxBattery.dir = NULL;
+}
+
+/**
+ * @brief Collects battery information from /sys/class/power_supply
+ *
+ * Batteries with scope "Device" power peripherals such as mice and
+ * are skipped. Without a system battery the machine is reported as
+ * a desktop on AC power, like the Windows collector does. Without
+ * the stream of openLinuxBattery() the directory is opened per call.
+ *
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return BatteryInfo* Pointer to battery information, NULL if failed
+ */
+BatteryInfo *collectLinuxBatteryInfo(SnapshotArena *arena)
+{
+    BatteryInfo *info = (BatteryInfo *)snapshotAlloc(arena, sizeof(BatteryInfo));
+    if (!info)
+        return NULL;
+
+    info->percent = 100;
+    info->powerPlugged = TRUE;
+    info->isDesktop = TRUE;
+
+    // Rewinding rereads the directory, so supplies plugged in later are seen
+    DIR *dir = g_LinuxBattery.dir;
+    if (dir)
+        rewinddir(dir);
+    else
+        dir = openSysfsDir(POWER_SUPPLY_DIR);
+    if (!dir)
+        return info;
+
+    UINT batteries = 0;
+    UINT64 capacitySum = 0;
+    BOOL supplySeen = FALSE;   // A mains or USB supply exists
+    BOOL supplyOnline = FALSE; // One of them is online
+    BOOL discharging = FALSE;  // A battery reports "Discharging"
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        if (entry->d_name[0] == '.')
+            continue;
+
+        char path[SYSFS_PATH_LENGTH];
+        char value[32];
+        _snprintf_s(path, sizeof(path), _TRUNCATE, POWER_SUPPLY_DIR "/%s/type", entry->d_name);
+        if (!readSysfsString(path, value, sizeof(value)))
+            continue;
+
+        if (strcmp(value, "Battery") == 0)
+        {
+            _snprintf_s(path, sizeof(path), _TRUNCATE, POWER_SUPPLY_DIR "/%s/scope", entry->d_name);
+            if (readSysfsString(path, value, sizeof(value)) && strcmp(value, "Device") == 0)
+                continue;
+
+            UINT64 capacity;
+            _snprintf_s(path, sizeof(path), _TRUNCATE, POWER_SUPPLY_DIR "/%s/capacity", entry->d_name);
+            if (!readSysfsUInt64(path, &capacity))
+                continue;
+
+            batteries++;
+            capacitySum += (capacity > 100) ? 100 : capacity;
+
+            _snprintf_s(path, sizeof(path), _TRUNCATE, POWER_SUPPLY_DIR "/%s/status", entry->d_name);
+            if (readSysfsString(path, value, sizeof(value)) && strcmp(value, "Discharging") == 0)
+                discharging = TRUE;
+        }
+        else if (strcmp(value, "Mains") == 0 || strcmp(value, "USB") == 0)
+        {
+            UINT64 online;
+            _snprintf_s(path, sizeof(path), _TRUNCATE, POWER_SUPPLY_DIR "/%s/online", entry->d_name);
+            supplySeen = TRUE;
+            if (readSysfsUInt64(path, &online) && online)
+                supplyOnline = TRUE;
+        }
+    }
+    if (dir != g_LinuxBattery.dir)
+        closedir(dir);
+
+    if (batteries > 0)
+    {
+        info->isDesktop = FALSE;
+        info->percent = (int)(capacitySum / batteries);
+        info->powerPlugged = supplySeen ? supplyOnline : !discharging;
+    }
+    return info;
+}
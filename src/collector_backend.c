@@ -0,0 +1,167 @@
+#include "collector_backend.h"
+#include <string.h>
+
+/**
+ * @brief Registered backends
+ *
+ * Built-in backends are added on first use, so the registry
+ * needs no initialization call.
+ */
+static struct
+{
+    SRWLOCK lock;                                             // Guards the fields below
+    BOOL initialized;                                         // Built-in backends registered
+    const CollectorBackend *backends[MAX_COLLECTOR_BACKENDS]; // Registered backends
+    UINT count;                                               // Entries in backends
+} g_Registry = {SRWLOCK_INIT, FALSE, {NULL}, 0};
+
+/**
+ * @brief Adds or replaces a backend, registry lock held
+ *
+ * @param backend Backend to add
+ * @return BOOL TRUE if registered, FALSE if the registry is full
+ */
+static BOOL addBackend(const CollectorBackend *backend)
+{
+    for (UINT i = 0; i < g_Registry.count; i++)
+    {
+        if (strcmp(g_Registry.backends[i]->name, backend->name) == 0)
+        {
+            g_Registry.backends[i] = backend;
+            return TRUE;
+        }
+    }
+
+    if (g_Registry.count >= MAX_COLLECTOR_BACKENDS)
+        return FALSE;
+    g_Registry.backends[g_Registry.count++] = backend;
+    return TRUE;
+}
+
+/**
+ * @brief Registers the built-in backends once, registry lock held
+ */
+static void registerBuiltinBackends(void)
+{
+    if (g_Registry.initialized)
+        return;
+
+#ifdef _WIN32
+    addBackend(getWindowsCollectorBackend());
+#endif
+#ifdef __linux__
+    addBackend(getLinuxCollectorBackend());
+#endif
+    addBackend(getFixtureCollectorBackend());
+    g_Registry.initialized = TRUE;
+}
+
+/**
+ * @brief Adds a backend to the registry
+ *
+ * @param backend Backend that must outlive the process
+ * @return BOOL TRUE if registered, FALSE if the registry is full
+ */
+BOOL registerCollectorBackend(const CollectorBackend *backend)
+{
+    if (!backend || !backend->name)
+        return FALSE;
+
+    AcquireSRWLockExclusive(&g_Registry.lock);
+    registerBuiltinBackends();
+    BOOL registered = addBackend(backend);
+    ReleaseSRWLockExclusive(&g_Registry.lock);
+    return registered;
+}
+
+/**
+ * @brief Looks up a registered backend by name
+ *
+ * @param name Backend name
+ * @return const CollectorBackend* Backend, NULL if not registered
+ */
+const CollectorBackend *findCollectorBackend(const char *name)
+{
+    const CollectorBackend *found = NULL;
+    if (!name)
+        return NULL;
+
+    AcquireSRWLockExclusive(&g_Registry.lock);
+    registerBuiltinBackends();
+    for (UINT i = 0; i < g_Registry.count && !found; i++)
+    {
+        if (strcmp(g_Registry.backends[i]->name, name) == 0)
+            found = g_Registry.backends[i];
+    }
+    ReleaseSRWLockExclusive(&g_Registry.lock);
+    return found;
+}
+
+/**
+ * @brief Returns the backend of the platform the library was built for
+ *
+ * @return const CollectorBackend* Platform backend
+ */
+const CollectorBackend *getNativeCollectorBackend(void)
+{
+#if defined(_WIN32)
+    return getWindowsCollectorBackend();
+#elif defined(__linux__)
+    return getLinuxCollectorBackend();
+#else
+    return getFixtureCollectorBackend();
+#endif
+}
+
+/**
+ * @brief Opens every collector the backend provides
+ *
+ * @param backend Backend to open
+ * @return DWORD COLLECTOR_BIT() of every usable collector
+ */
+DWORD openCollectorBackend(const CollectorBackend *backend)
+{
+    // Collect functions in CollectorId order, static getters first
+    const void *provided[COLLECTOR_COUNT] = {
+        (const void *)backend->collectors.getCPUList,
+        (const void *)backend->collectors.getGPUList,
+        (const void *)backend->collectors.getMotherboardInfo,
+        (const void *)backend->collectors.getAudioList,
+        (const void *)backend->collectors.getMonitorList,
+        (const void *)backend->collectors.getRAMSlotList,
+        (const void *)backend->collectors.collectMemoryInfo,
+        (const void *)backend->collectors.collectStorageList,
+        (const void *)backend->collectors.collectBatteryInfo,
+        (const void *)backend->collectors.collectNetworkList,
+        (const void *)backend->collectors.collectCPULoad,
+        (const void *)backend->collectors.collectCPUFrequency,
+        (const void *)backend->collectors.collectDiskIO};
+
+    DWORD openMask = 0;
+    for (UINT id = 0; id < COLLECTOR_COUNT; id++)
+    {
+        if (!provided[id])
+            continue;
+        if (backend->lifecycle[id].open && !backend->lifecycle[id].open())
+            continue;
+        openMask |= COLLECTOR_BIT(id);
+    }
+    return openMask;
+}
+
+/**
+ * @brief Closes the collectors opened by openCollectorBackend()
+ *
+ * Collectors are closed in reverse order of opening.
+ *
+ * @param backend Backend to close
+ * @param openMask Mask returned by openCollectorBackend()
+ */
+void closeCollectorBackend(const CollectorBackend *backend, DWORD openMask)
+{
+    for (UINT id = COLLECTOR_COUNT; id-- > 0;)
+    {
+        if ((openMask & COLLECTOR_BIT(id)) && backend->lifecycle[id].close)
+            backend->lifecycle[id].close();
+    }
+}
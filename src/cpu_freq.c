@@ -0,0 +1,172 @@
+#include "cpu_freq.h"
+#include "fest_alloc.h"
+
+#ifdef _WIN32
+#include <powrprof.h>
+#endif
+
+/**
+ * @brief Allocates a frequency result for a number of cores
+ *
+ * @param coreCount Entries of the per-core array
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return CPUFrequencyInfo* Zeroed result, NULL if allocation failed
+ */
+CPUFrequencyInfo *allocCPUFrequencyInfo(UINT coreCount, SnapshotArena *arena)
+{
+    CPUFrequencyInfo *info = (CPUFrequencyInfo *)snapshotAlloc(arena, sizeof(CPUFrequencyInfo));
+    if (!info)
+        return NULL;
+
+    memset(info, 0, sizeof(CPUFrequencyInfo));
+    info->coreCount = coreCount;
+    info->cores = (UINT *)snapshotAlloc(arena, coreCount * sizeof(UINT));
+    if (!info->cores)
+    {
+        snapshotFree(arena, info);
+        return NULL;
+    }
+    memset(info->cores, 0, coreCount * sizeof(UINT));
+    return info;
+}
+
+/**
+ * @brief Fills min, avg and max from the per-core array
+ *
+ * @param info Result whose cores were filled by the platform
+ */
+void summarizeCPUFrequency(CPUFrequencyInfo *info)
+{
+    UINT64 sum = 0;
+    UINT reporting = 0;
+
+    info->minMhz = 0;
+    info->maxMhz = 0;
+    for (UINT i = 0; i < info->coreCount; i++)
+    {
+        UINT mhz = info->cores[i];
+        if (mhz == 0)
+            continue;
+
+        if (reporting == 0 || mhz < info->minMhz)
+            info->minMhz = mhz;
+        if (mhz > info->maxMhz)
+            info->maxMhz = mhz;
+        sum += mhz;
+        reporting++;
+    }
+    info->avgMhz = reporting ? (UINT)(sum / reporting) : 0;
+}
+
+#ifdef _WIN32
+/**
+ * @brief Power level of one processor returned by CallNtPowerInformation
+ *
+ * The SDK documents the layout but only declares it in the
+ * driver headers.
+ */
+typedef struct
+{
+    ULONG Number;           // Processor number
+    ULONG MaxMhz;           // Maximum specified clock
+    ULONG CurrentMhz;       // Current clock
+    ULONG MhzLimit;         // Clock limit set by thermal or power policy
+    ULONG MaxIdleState;     // Deepest idle state
+    ULONG CurrentIdleState; // Current idle state
+} ProcessorPowerInfo;
+
+/**
+ * @brief Sampler state of the Windows collector, owned by the monitoring thread
+ */
+static struct
+{
+    ProcessorPowerInfo *processors; // One entry per logical core
+    UINT coreCount;                 // Entries in processors
+} g_CPUFrequency = {0};
+
+/**
+ * @brief Sizes the Windows power information buffer
+ *
+ * Only the processor group of the calling thread is reported, up
+ * to 64 logical cores.
+ *
+ * @return BOOL TRUE if core clocks can be sampled
+ */
+BOOL openCPUFrequencyCollector(void)
+{
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    g_CPUFrequency.coreCount = systemInfo.dwNumberOfProcessors;
+
+    g_CPUFrequency.processors = (ProcessorPowerInfo *)festMalloc(g_CPUFrequency.coreCount * sizeof(ProcessorPowerInfo));
+    if (!g_CPUFrequency.processors)
+    {
+        closeCPUFrequencyCollector();
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief Releases the Windows power information buffer
+ */
+void closeCPUFrequencyCollector(void)
+{
+    if (g_CPUFrequency.processors)
+        festFree(g_CPUFrequency.processors);
+    memset(&g_CPUFrequency, 0, sizeof(g_CPUFrequency));
+}
+
+/**
+ * @brief Samples core clocks through CallNtPowerInformation
+ *
+ * CurrentMhz is not capped by the thermal limit on every platform,
+ * so the lower of both is reported.
+ *
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return CPUFrequencyInfo* Pointer to core clocks, NULL if failed or not opened
+ */
+CPUFrequencyInfo *collectCPUFrequency(SnapshotArena *arena)
+{
+    if (!g_CPUFrequency.processors)
+        return NULL;
+
+    ULONG size = (ULONG)(g_CPUFrequency.coreCount * sizeof(ProcessorPowerInfo));
+    if (CallNtPowerInformation(ProcessorInformation, NULL, 0, g_CPUFrequency.processors, size) != 0)
+        return NULL;
+
+    CPUFrequencyInfo *info = allocCPUFrequencyInfo(g_CPUFrequency.coreCount, arena);
+    if (!info)
+        return NULL;
+
+    for (UINT i = 0; i < g_CPUFrequency.coreCount; i++)
+    {
+        const ProcessorPowerInfo *processor = &g_CPUFrequency.processors[i];
+        if (processor->Number >= g_CPUFrequency.coreCount)
+            continue;
+
+        ULONG mhz = processor->CurrentMhz;
+        if (processor->MhzLimit > 0 && processor->MhzLimit < mhz)
+            mhz = processor->MhzLimit;
+        info->cores[processor->Number] = (UINT)mhz;
+    }
+
+    summarizeCPUFrequency(info);
+    return info;
+}
+#endif // _WIN32
+
+/**
+ * @brief Frees core clocks allocated from the heap
+ *
+ * @param info Pointer to CPUFrequencyInfo structure to be freed
+ */
+void freeCPUFrequencyInfo(CPUFrequencyInfo *info)
+{
+    if (info)
+    {
+        if (info->cores)
+            festFree(info->cores);
+        festFree(info);
+    }
+}
@@ -0,0 +1,140 @@
+#include "cpu_freq.h"
+#include "fest_alloc.h"
+#include "linux_sysfs.h"
+#include <stdlib.h>
+#include <unistd.h>
+
+#define CPU_SYSFS_PATH "/sys/devices/system/cpu" // Directory of the cpuN entries
+#define CPU_FREQ_VALUE_LENGTH 32                 // scaling_cur_freq in kHz with newline
+
+/**
+ * @brief Sampler state of the Linux collector, owned by the monitoring thread
+ */
+static struct
+{
+    int *fds;       // scaling_cur_freq per possible core, -1 without cpufreq
+    UINT coreCount; // Entries in fds
+} g_LinuxCPUFrequency = {NULL, 0};
+
+/**
+ * @brief Returns the number of possible logical cores
+ *
+ * Without the possible list, the cpuN directories are counted up
+ * to the highest number.
+ *
+ * @return UINT Highest possible core number plus one, 0 if unknown
+ */
+static UINT countPossibleCores(void)
+{
+    UINT possible = readSysfsPossibleCPUs();
+    if (possible > 0)
+        return possible;
+
+    DIR *dir = openSysfsDir(CPU_SYSFS_PATH);
+    if (!dir)
+        return 0;
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        const char *name = entry->d_name;
+        if (strncmp(name, "cpu", 3) != 0 || name[3] < '0' || name[3] > '9')
+            continue;
+
+        UINT core = (UINT)strtoul(name + 3, NULL, 10);
+        if (core + 1 > possible)
+            possible = core + 1;
+    }
+    closedir(dir);
+    return possible;
+}
+
+/**
+ * @brief Opens scaling_cur_freq of every possible core
+ *
+ * Cores without cpufreq (offline at open, or a VM without a
+ * frequency driver) keep -1 and report 0 MHz.
+ *
+ * @return BOOL TRUE if at least one core exposes its frequency
+ */
+BOOL openLinuxCPUFrequency(void)
+{
+    UINT coreCount = countPossibleCores();
+    if (coreCount == 0)
+        return FALSE;
+
+    g_LinuxCPUFrequency.fds = (int *)festMalloc(coreCount * sizeof(int));
+    if (!g_LinuxCPUFrequency.fds)
+        return FALSE;
+    g_LinuxCPUFrequency.coreCount = coreCount;
+
+    BOOL opened = FALSE;
+    for (UINT i = 0; i < coreCount; i++)
+    {
+        char relative[SYSFS_PATH_LENGTH];
+        _snprintf_s(relative, sizeof(relative), _TRUNCATE, CPU_SYSFS_PATH "/cpu%u/cpufreq/scaling_cur_freq", i);
+        g_LinuxCPUFrequency.fds[i] = openSysfsFile(relative);
+        if (g_LinuxCPUFrequency.fds[i] >= 0)
+            opened = TRUE;
+    }
+
+    if (!opened)
+    {
+        closeLinuxCPUFrequency();
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief Closes the scaling_cur_freq descriptors
+ */
+void closeLinuxCPUFrequency(void)
+{
+    if (g_LinuxCPUFrequency.fds)
+    {
+        for (UINT i = 0; i < g_LinuxCPUFrequency.coreCount; i++)
+        {
+            if (g_LinuxCPUFrequency.fds[i] >= 0)
+                close(g_LinuxCPUFrequency.fds[i]);
+        }
+        festFree(g_LinuxCPUFrequency.fds);
+    }
+    g_LinuxCPUFrequency.fds = NULL;
+    g_LinuxCPUFrequency.coreCount = 0;
+}
+
+/**
+ * @brief Samples core clocks from cpufreq
+ *
+ * A core taken offline after open fails its read and reports 0
+ * until it is back.
+ *
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return CPUFrequencyInfo* Pointer to core clocks, NULL if failed or not opened
+ */
+CPUFrequencyInfo *collectLinuxCPUFrequency(SnapshotArena *arena)
+{
+    if (!g_LinuxCPUFrequency.fds)
+        return NULL;
+
+    CPUFrequencyInfo *info = allocCPUFrequencyInfo(g_LinuxCPUFrequency.coreCount, arena);
+    if (!info)
+        return NULL;
+
+    for (UINT i = 0; i < g_LinuxCPUFrequency.coreCount; i++)
+    {
+        char value[CPU_FREQ_VALUE_LENGTH];
+        if (g_LinuxCPUFrequency.fds[i] < 0 ||
+            preadSysfsFile(g_LinuxCPUFrequency.fds[i], value, sizeof(value)) == 0)
+            continue;
+
+        UINT64 khz = 0;
+        for (const char *cursor = value; *cursor >= '0' && *cursor <= '9'; cursor++)
+            khz = khz * 10 + (UINT64)(*cursor - '0');
+        info->cores[i] = (UINT)((khz + 500) / 1000);
+    }
+
+    summarizeCPUFrequency(info);
+    return info;
+}
@@ -1,9 +1,23 @@
 #include "cpu_info.h"
+#include "fest_alloc.h"
 #include "wmi_helper.h"
 #include <stdio.h>
 
+#ifdef _WIN32
 #pragma comment(lib, "pdh.lib")
 
+/**
+ * @brief Win32_Processor properties read into CPUInfo
+ */
+static const WMIPropertySpec g_ProcessorProperties[] = {
+    WMI_STRING_PROPERTY(L"Name", CPUInfo, name),
+    WMI_UINT32_PROPERTY(L"NumberOfCores", CPUInfo, cores),
+    WMI_UINT32_PROPERTY(L"NumberOfLogicalProcessors", CPUInfo, threads),
+    WMI_UINT32_PROPERTY(L"MaxClockSpeed", CPUInfo, clockSpeed)};
+
+static const WMIQuerySpec g_ProcessorQuery = {
+    L"Win32_Processor", g_ProcessorProperties, WMI_PROPERTY_COUNT(g_ProcessorProperties), NULL};
+
 /**
  * @brief Retrieves detailed information about CPU(s) installed in the system
  *
@@ -21,92 +35,36 @@
  */
 CPUList *getCPUList(void)
 {
-    CPUList *list = (CPUList *)malloc(sizeof(CPUList));
+    CPUList *list = (CPUList *)festMalloc(sizeof(CPUList));
     if (!list)
         return NULL;
 
     list->cpus = NULL;
     list->count = 0;
 
-    // Initialize WMI connection
-    WMISession *session = initializeWMI();
+    // Lease the thread's pooled WMI connection
+    WMISession *session = acquireWMISession();
     if (!session)
     {
-        free(list);
+        festFree(list);
         return NULL;
     }
 
-    // Query Win32_Processor class for CPU information
-    IEnumWbemClassObject *pEnumerator = NULL;
-    if (executeWQLQuery(session, L"SELECT * FROM Win32_Processor", &pEnumerator))
-    {
-        IWbemClassObject *pclsObj = NULL;
-        ULONG uReturn = 0;
-
-        // First pass: Count total number of processors
-        while (SUCCEEDED(pEnumerator->lpVtbl->Next(pEnumerator, WBEM_INFINITE, 1, &pclsObj, &uReturn)) && uReturn != 0)
-        {
-            list->count++;
-            pclsObj->lpVtbl->Release(pclsObj);
-        }
-        pEnumerator->lpVtbl->Release(pEnumerator);
-
-        if (list->count > 0)
-        {
-            // Allocate memory for CPU array
-            list->cpus = (CPUInfo *)malloc(sizeof(CPUInfo) * list->count);
-            if (!list->cpus)
-            {
-                cleanupWMI(session);
-                free(list);
-                return NULL;
-            }
+    // Query the Win32_Processor properties we report, in one pass
+    WMIRowVector rows;
+    initWMIRowVector(&rows, NULL, sizeof(CPUInfo), 2);
+    if (!queryWMIProjected(session, &g_ProcessorQuery, &rows, NULL, NULL))
+        releaseWMIRowVector(&rows);
 
-            // Second pass: Collect detailed CPU information
-            if (executeWQLQuery(session, L"SELECT * FROM Win32_Processor", &pEnumerator))
-            {
-                UINT i = 0;
-                while (SUCCEEDED(pEnumerator->lpVtbl->Next(pEnumerator, WBEM_INFINITE, 1, &pclsObj, &uReturn)) && uReturn != 0)
-                {
-                    CPUInfo *cpu = &list->cpus[i];
+    list->cpus = (CPUInfo *)rows.rows;
+    list->count = rows.count;
 
-                    // Get processor name and model
-                    getWMIPropertyString(pclsObj, L"Name", cpu->name, sizeof(cpu->name));
-
-                    // Get number of physical cores
-                    VARIANT vtProp;
-                    if (SUCCEEDED(pclsObj->lpVtbl->Get(pclsObj, L"NumberOfCores", 0, &vtProp, 0, 0)) && vtProp.vt != VT_NULL)
-                    {
-                        cpu->cores = vtProp.uintVal;
-                    }
-                    VariantClear(&vtProp);
-
-                    // Get number of logical processors (threads)
-                    if (SUCCEEDED(pclsObj->lpVtbl->Get(pclsObj, L"NumberOfLogicalProcessors", 0, &vtProp, 0, 0)) && vtProp.vt != VT_NULL)
-                    {
-                        cpu->threads = vtProp.uintVal;
-                    }
-                    VariantClear(&vtProp);
-
-                    // Get maximum clock speed in MHz
-                    if (SUCCEEDED(pclsObj->lpVtbl->Get(pclsObj, L"MaxClockSpeed", 0, &vtProp, 0, 0)) && vtProp.vt != VT_NULL)
-                    {
-                        cpu->clockSpeed = vtProp.uintVal;
-                    }
-                    VariantClear(&vtProp);
-
-                    pclsObj->lpVtbl->Release(pclsObj);
-                    i++;
-                }
-                pEnumerator->lpVtbl->Release(pEnumerator);
-            }
-        }
-    }
-
-    cleanupWMI(session);
+    releaseWMISession(session);
     return list;
 }
 
+#endif // _WIN32
+
 /**
  * @brief Frees memory allocated for CPUList structure
  *
@@ -117,8 +75,8 @@ void freeCPUList(CPUList *list)
     if (list)
     {
         if (list->cpus)
-            free(list->cpus);
-        free(list);
+            festFree(list->cpus);
+        festFree(list);
     }
 }
 
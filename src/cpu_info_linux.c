@@ -0,0 +1,299 @@
+#include "cpu_info.h"
+#include "fest_alloc.h"
+#include "linux_sysfs.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CPUINFO_PATH "/proc/cpuinfo"             // One block per online logical CPU
+#define CPU_SYSFS_DIR "/sys/devices/system/cpu" // Topology and cpufreq per logical CPU
+#define CPU_UNKNOWN_ID 0xFFFFFFFFu              // Topology id not reported
+
+/**
+ * @brief One online logical CPU as reported by cpuinfo and sysfs
+ */
+typedef struct
+{
+    UINT processor;    // Logical CPU number
+    UINT package;      // Physical package (socket)
+    UINT die;          // Die within the package
+    UINT core;         // Core within the die
+    UINT cpuinfoMHz;   // "cpu MHz" of cpuinfo, 0 if missing
+    const char *name;  // Model name inside the cpuinfo buffer
+    size_t nameLength; // Length of the model name
+} LogicalCPU;
+
+/**
+ * @brief Compares a cpuinfo key with a literal
+ *
+ * @param key Key text, not terminated
+ * @param keyLength Length of the key
+ * @param literal Terminated key to match
+ * @return BOOL TRUE if equal
+ */
+static BOOL isCpuinfoKey(const char *key, size_t keyLength, const char *literal)
+{
+    return strlen(literal) == keyLength && memcmp(key, literal, keyLength) == 0;
+}
+
+/**
+ * @brief Parses the integer part of a decimal number
+ *
+ * Accepts "3400" and "3400.000"; the fraction is dropped.
+ *
+ * @param text Number text, not terminated
+ * @param length Length of the text
+ * @param value Receives the number
+ * @return BOOL TRUE if the text starts with a digit
+ */
+static BOOL parseCpuinfoNumber(const char *text, size_t length, UINT *value)
+{
+    if (length == 0 || *text < '0' || *text > '9')
+        return FALSE;
+
+    UINT number = 0;
+    for (size_t i = 0; i < length && text[i] >= '0' && text[i] <= '9'; i++)
+        number = number * 10 + (UINT)(text[i] - '0');
+    *value = number;
+    return TRUE;
+}
+
+/**
+ * @brief Counts the logical CPU blocks of cpuinfo
+ *
+ * @param cpuinfo Terminated cpuinfo content
+ * @return UINT Number of "processor" lines
+ */
+static UINT countCpuinfoBlocks(const char *cpuinfo)
+{
+    UINT count = 0;
+    for (const char *line = cpuinfo; line; line = strchr(line, '\n'))
+    {
+        if (*line == '\n')
+            line++;
+        if (strncmp(line, "processor", 9) == 0 && (line[9] == ' ' || line[9] == '\t' || line[9] == ':'))
+            count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Splits cpuinfo into logical CPUs
+ *
+ * Every "processor" line starts a new block. Keys and values are
+ * separated by a colon with tabs and spaces around it. Names point
+ * into the cpuinfo buffer.
+ *
+ * @param cpuinfo Terminated cpuinfo content
+ * @param cpus Array receiving the logical CPUs
+ * @param capacity Entries available in cpus
+ * @return UINT Number of logical CPUs parsed
+ */
+static UINT parseCpuinfo(const char *cpuinfo, LogicalCPU *cpus, UINT capacity)
+{
+    LogicalCPU *cpu = NULL;
+    const char *fallbackName = NULL; // ARM "Processor" line, shared by all blocks
+    size_t fallbackLength = 0;
+    UINT count = 0;
+
+    const char *line = cpuinfo;
+    while (*line)
+    {
+        const char *end = strchr(line, '\n');
+        if (!end)
+            end = line + strlen(line);
+
+        const char *colon = memchr(line, ':', (size_t)(end - line));
+        if (colon)
+        {
+            const char *keyEnd = colon;
+            while (keyEnd > line && (keyEnd[-1] == ' ' || keyEnd[-1] == '\t'))
+                keyEnd--;
+            const char *value = colon + 1;
+            while (value < end && (*value == ' ' || *value == '\t'))
+                value++;
+            const char *valueEnd = end;
+            while (valueEnd > value && (valueEnd[-1] == ' ' || valueEnd[-1] == '\t' || valueEnd[-1] == '\r'))
+                valueEnd--;
+
+            size_t keyLength = (size_t)(keyEnd - line);
+            size_t valueLength = (size_t)(valueEnd - value);
+            UINT number;
+
+            if (isCpuinfoKey(line, keyLength, "processor") && count < capacity &&
+                parseCpuinfoNumber(value, valueLength, &number))
+            {
+                cpu = &cpus[count++];
+                cpu->processor = number;
+                cpu->package = CPU_UNKNOWN_ID;
+                cpu->die = 0;
+                cpu->core = CPU_UNKNOWN_ID;
+                cpu->cpuinfoMHz = 0;
+                cpu->name = NULL;
+                cpu->nameLength = 0;
+            }
+            else if (isCpuinfoKey(line, keyLength, "Processor"))
+            {
+                fallbackName = value;
+                fallbackLength = valueLength;
+            }
+            else if (cpu && isCpuinfoKey(line, keyLength, "model name"))
+            {
+                cpu->name = value;
+                cpu->nameLength = valueLength;
+            }
+            else if (cpu && isCpuinfoKey(line, keyLength, "physical id"))
+                parseCpuinfoNumber(value, valueLength, &cpu->package);
+            else if (cpu && isCpuinfoKey(line, keyLength, "core id"))
+                parseCpuinfoNumber(value, valueLength, &cpu->core);
+            else if (cpu && isCpuinfoKey(line, keyLength, "cpu MHz"))
+                parseCpuinfoNumber(value, valueLength, &cpu->cpuinfoMHz);
+        }
+        line = *end ? end + 1 : end;
+    }
+
+    for (UINT i = 0; i < count; i++)
+    {
+        if (!cpus[i].name && fallbackName)
+        {
+            cpus[i].name = fallbackName;
+            cpus[i].nameLength = fallbackLength;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Reads one topology id of a logical CPU
+ *
+ * @param processor Logical CPU number
+ * @param attribute Attribute below cpuN/topology
+ * @param value Receives the id, unchanged if the attribute is missing
+ */
+static void readTopologyId(UINT processor, const char *attribute, UINT *value)
+{
+    char path[SYSFS_PATH_LENGTH];
+    UINT64 id;
+
+    _snprintf_s(path, sizeof(path), _TRUNCATE, CPU_SYSFS_DIR "/cpu%u/topology/%s", processor, attribute);
+    if (readSysfsUInt64(path, &id) && id < CPU_UNKNOWN_ID)
+        *value = (UINT)id;
+}
+
+/**
+ * @brief Reads the base clock of a logical CPU
+ *
+ * Prefers the base frequency of intel_pstate and amd-pstate,
+ * the closest match of Win32_Processor.MaxClockSpeed, then the
+ * highest cpufreq frequency, then the cpuinfo clock.
+ *
+ * @param cpu Logical CPU
+ * @return UINT Clock speed in MHz, 0 if unknown
+ */
+static UINT readBaseClock(const LogicalCPU *cpu)
+{
+    static const char *const attributes[] = {"base_frequency", "cpuinfo_max_freq"};
+    char path[SYSFS_PATH_LENGTH];
+    UINT64 kHz;
+
+    for (size_t i = 0; i < sizeof(attributes) / sizeof(attributes[0]); i++)
+    {
+        _snprintf_s(path, sizeof(path), _TRUNCATE, CPU_SYSFS_DIR "/cpu%u/cpufreq/%s", cpu->processor, attributes[i]);
+        if (readSysfsUInt64(path, &kHz) && kHz > 0)
+            return (UINT)(kHz / 1000);
+    }
+    return cpu->cpuinfoMHz;
+}
+
+/**
+ * @brief Orders logical CPUs by package, die, core and number
+ *
+ * @param a First logical CPU
+ * @param b Second logical CPU
+ * @return int Negative, zero or positive like strcmp
+ */
+static int compareLogicalCPU(const void *a, const void *b)
+{
+    const LogicalCPU *x = (const LogicalCPU *)a;
+    const LogicalCPU *y = (const LogicalCPU *)b;
+
+    if (x->package != y->package)
+        return x->package < y->package ? -1 : 1;
+    if (x->die != y->die)
+        return x->die < y->die ? -1 : 1;
+    if (x->core != y->core)
+        return x->core < y->core ? -1 : 1;
+    return (x->processor > y->processor) - (x->processor < y->processor);
+}
+
+/**
+ * @brief Retrieves processor information from /proc/cpuinfo and sysfs
+ *
+ * Logical CPUs are grouped into one CPUInfo per physical package.
+ * sysfs topology ids take precedence over the cpuinfo ones, which
+ * are missing on most ARM systems; without either every logical
+ * CPU counts as its own core of package 0.
+ *
+ * @return CPUList* Pointer to allocated processor list, NULL if failed
+ * @note Caller is responsible for freeing the returned list using freeCPUList()
+ */
+CPUList *getLinuxCPUList(void)
+{
+    CPUList *list = (CPUList *)festMalloc(sizeof(CPUList));
+    if (!list)
+        return NULL;
+
+    list->cpus = NULL;
+    list->count = 0;
+
+    char *cpuinfo = readSysfsFileAlloc(CPUINFO_PATH, NULL);
+    if (!cpuinfo)
+        return list;
+
+    UINT capacity = countCpuinfoBlocks(cpuinfo);
+    LogicalCPU *logical = capacity ? (LogicalCPU *)festMalloc(capacity * sizeof(LogicalCPU)) : NULL;
+    UINT count = logical ? parseCpuinfo(cpuinfo, logical, capacity) : 0;
+
+    for (UINT i = 0; i < count; i++)
+    {
+        readTopologyId(logical[i].processor, "physical_package_id", &logical[i].package);
+        readTopologyId(logical[i].processor, "die_id", &logical[i].die);
+        readTopologyId(logical[i].processor, "core_id", &logical[i].core);
+        if (logical[i].package == CPU_UNKNOWN_ID)
+            logical[i].package = 0;
+        if (logical[i].core == CPU_UNKNOWN_ID)
+            logical[i].core = logical[i].processor;
+    }
+    qsort(logical, count, sizeof(LogicalCPU), compareLogicalCPU);
+
+    // One entry per package, at most one per logical CPU
+    if (count > 0)
+        list->cpus = (CPUInfo *)festMalloc(count * sizeof(CPUInfo));
+
+    for (UINT i = 0; list->cpus && i < count; i++)
+    {
+        const LogicalCPU *cpu = &logical[i];
+        BOOL newPackage = i == 0 || cpu->package != logical[i - 1].package;
+        if (newPackage)
+        {
+            CPUInfo *info = &list->cpus[list->count++];
+            memset(info, 0, sizeof(CPUInfo));
+            if (cpu->name && cpu->nameLength > 0)
+            {
+                size_t length = cpu->nameLength < sizeof(info->name) ? cpu->nameLength : sizeof(info->name) - 1;
+                memcpy(info->name, cpu->name, length);
+            }
+            else
+                strcpy_s(info->name, sizeof(info->name), "Unknown Processor");
+            info->clockSpeed = readBaseClock(cpu);
+        }
+
+        CPUInfo *info = &list->cpus[list->count - 1];
+        if (newPackage || cpu->die != logical[i - 1].die || cpu->core != logical[i - 1].core)
+            info->cores++;
+        info->threads++;
+    }
+
+    festFree(logical);
+    festFree(cpuinfo);
+    return list;
+}
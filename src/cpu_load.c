@@ -0,0 +1,251 @@
+#include "cpu_load.h"
+#include "fest_alloc.h"
+
+/**
+ * @brief Sizes a sampler for a number of logical cores
+ *
+ * @param sampler Sampler to initialize
+ * @param coreCount Highest possible logical CPU number plus one
+ * @return BOOL TRUE if the counter arrays were allocated
+ */
+BOOL initCPULoadSampler(CPULoadSampler *sampler, UINT coreCount)
+{
+    size_t size = (coreCount + 1) * sizeof(CPUTimes);
+
+    sampler->previous = (CPUTimes *)festMalloc(size);
+    sampler->current = (CPUTimes *)festMalloc(size);
+    sampler->coreCount = coreCount;
+    sampler->hasBaseline = FALSE;
+    if (!sampler->previous || !sampler->current)
+    {
+        releaseCPULoadSampler(sampler);
+        return FALSE;
+    }
+
+    memset(sampler->previous, 0, size);
+    memset(sampler->current, 0, size);
+    return TRUE;
+}
+
+/**
+ * @brief Frees the counter arrays of a sampler
+ *
+ * @param sampler Sampler to release, zeroed afterwards
+ */
+void releaseCPULoadSampler(CPULoadSampler *sampler)
+{
+    if (sampler->previous)
+        festFree(sampler->previous);
+    if (sampler->current)
+        festFree(sampler->current);
+    memset(sampler, 0, sizeof(CPULoadSampler));
+}
+
+/**
+ * @brief Difference of a cumulative counter between two ticks
+ *
+ * A counter below its previous value restarted, e.g. after the
+ * core was taken offline and back online.
+ *
+ * @param now Counter of this tick
+ * @param before Counter of the previous tick
+ * @return UINT64 Ticks elapsed
+ */
+static UINT64 counterDelta(UINT64 now, UINT64 before)
+{
+    return now >= before ? now - before : now;
+}
+
+/**
+ * @brief Converts two counter samples into percentages
+ *
+ * @param now Counters of this tick
+ * @param before Counters of the previous tick
+ * @param load Receives the percentages, all zero if no time elapsed
+ */
+static void computeShare(const CPUTimes *now, const CPUTimes *before, CPULoad *load)
+{
+    UINT64 user = counterDelta(now->user, before->user);
+    UINT64 system = counterDelta(now->system, before->system);
+    UINT64 iowait = counterDelta(now->iowait, before->iowait);
+    UINT64 idle = counterDelta(now->idle, before->idle);
+    UINT64 total = user + system + iowait + idle;
+
+    if (total == 0)
+    {
+        memset(load, 0, sizeof(CPULoad));
+        return;
+    }
+
+    load->user = 100.0 * (double)user / (double)total;
+    load->system = 100.0 * (double)system / (double)total;
+    load->iowait = 100.0 * (double)iowait / (double)total;
+    load->idle = 100.0 * (double)idle / (double)total;
+}
+
+/**
+ * @brief Turns the counters of this tick into percentages
+ *
+ * @param sampler Sampler whose current array was filled by the platform
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return CPULoadInfo* Pointer to CPU utilization, NULL if failed
+ */
+CPULoadInfo *computeCPULoad(CPULoadSampler *sampler, SnapshotArena *arena)
+{
+    CPULoadInfo *info = (CPULoadInfo *)snapshotAlloc(arena, sizeof(CPULoadInfo));
+    if (!info)
+        return NULL;
+
+    info->coreCount = sampler->coreCount;
+    info->cores = (CPULoad *)snapshotAlloc(arena, sampler->coreCount * sizeof(CPULoad));
+    if (!info->cores)
+    {
+        snapshotFree(arena, info);
+        return NULL;
+    }
+
+    // Without a baseline the counters only tell the load since boot
+    if (sampler->hasBaseline)
+    {
+        computeShare(&sampler->current[0], &sampler->previous[0], &info->total);
+        for (UINT i = 0; i < sampler->coreCount; i++)
+            computeShare(&sampler->current[i + 1], &sampler->previous[i + 1], &info->cores[i]);
+    }
+    else
+    {
+        memset(&info->total, 0, sizeof(CPULoad));
+        memset(info->cores, 0, sampler->coreCount * sizeof(CPULoad));
+    }
+
+    // This tick's counters are the baseline of the next one
+    CPUTimes *previous = sampler->previous;
+    sampler->previous = sampler->current;
+    sampler->current = previous;
+    sampler->hasBaseline = TRUE;
+    return info;
+}
+
+#ifdef _WIN32
+#define PROCESSOR_PERFORMANCE_CLASS 8 // SystemProcessorPerformanceInformation
+
+/**
+ * @brief Per-processor times returned by NtQuerySystemInformation, in 100 ns units
+ */
+typedef struct
+{
+    LARGE_INTEGER IdleTime;      // Idle time
+    LARGE_INTEGER KernelTime;    // Kernel time, idle, DPC and interrupt time included
+    LARGE_INTEGER UserTime;      // User mode time
+    LARGE_INTEGER DpcTime;       // Deferred procedure call time
+    LARGE_INTEGER InterruptTime; // Interrupt service time
+    ULONG InterruptCount;        // Interrupts serviced
+} ProcessorPerformanceInfo;
+
+typedef LONG(WINAPI *NtQuerySystemInformationFn)(int, PVOID, ULONG, PULONG);
+
+/**
+ * @brief Sampler state of the Windows collector, owned by the monitoring thread
+ */
+static struct
+{
+    NtQuerySystemInformationFn query;    // Resolved from ntdll.dll
+    ProcessorPerformanceInfo *processors; // One entry per logical core
+    CPULoadSampler sampler;               // Counters of the last two ticks
+} g_CPULoad = {0};
+
+/**
+ * @brief Sizes the Windows sampler and resolves NtQuerySystemInformation
+ *
+ * Only the processor group of the calling thread is reported, up
+ * to 64 logical cores.
+ *
+ * @return BOOL TRUE if CPU load can be sampled
+ */
+BOOL openCPULoadCollector(void)
+{
+    HMODULE ntdll = GetModuleHandleW(L"ntdll.dll");
+    if (!ntdll)
+        return FALSE;
+
+    g_CPULoad.query = (NtQuerySystemInformationFn)(void *)GetProcAddress(ntdll, "NtQuerySystemInformation");
+    if (!g_CPULoad.query)
+        return FALSE;
+
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    UINT coreCount = systemInfo.dwNumberOfProcessors;
+
+    g_CPULoad.processors = (ProcessorPerformanceInfo *)festMalloc(coreCount * sizeof(ProcessorPerformanceInfo));
+    if (!g_CPULoad.processors || !initCPULoadSampler(&g_CPULoad.sampler, coreCount))
+    {
+        closeCPULoadCollector();
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief Releases the Windows sampler
+ */
+void closeCPULoadCollector(void)
+{
+    if (g_CPULoad.processors)
+        festFree(g_CPULoad.processors);
+    releaseCPULoadSampler(&g_CPULoad.sampler);
+    memset(&g_CPULoad, 0, sizeof(g_CPULoad));
+}
+
+/**
+ * @brief Samples CPU utilization through NtQuerySystemInformation
+ *
+ * Kernel time includes idle, DPC and interrupt time, so system
+ * time is kernel minus idle. Windows has no iowait state.
+ *
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return CPULoadInfo* Pointer to CPU utilization, NULL if failed or not opened
+ */
+CPULoadInfo *collectCPULoad(SnapshotArena *arena)
+{
+    CPULoadSampler *sampler = &g_CPULoad.sampler;
+    if (!g_CPULoad.query || !sampler->current)
+        return NULL;
+
+    ULONG size = (ULONG)(sampler->coreCount * sizeof(ProcessorPerformanceInfo));
+    ULONG returned = 0;
+    if (g_CPULoad.query(PROCESSOR_PERFORMANCE_CLASS, g_CPULoad.processors, size, &returned) < 0)
+        return NULL;
+
+    UINT count = returned / sizeof(ProcessorPerformanceInfo);
+    CPUTimes *total = &sampler->current[0];
+    memset(sampler->current, 0, (sampler->coreCount + 1) * sizeof(CPUTimes));
+    for (UINT i = 0; i < count && i < sampler->coreCount; i++)
+    {
+        const ProcessorPerformanceInfo *processor = &g_CPULoad.processors[i];
+        CPUTimes *core = &sampler->current[i + 1];
+        core->user = (UINT64)processor->UserTime.QuadPart;
+        core->idle = (UINT64)processor->IdleTime.QuadPart;
+        core->system = (UINT64)(processor->KernelTime.QuadPart - processor->IdleTime.QuadPart);
+
+        total->user += core->user;
+        total->system += core->system;
+        total->idle += core->idle;
+    }
+
+    return computeCPULoad(sampler, arena);
+}
+#endif // _WIN32
+
+/**
+ * @brief Frees CPU utilization allocated from the heap
+ *
+ * @param info Pointer to CPULoadInfo structure to be freed
+ */
+void freeCPULoadInfo(CPULoadInfo *info)
+{
+    if (info)
+    {
+        if (info->cores)
+            festFree(info->cores);
+        festFree(info);
+    }
+}
@@ -0,0 +1,158 @@
+#include "cpu_load.h"
+#include "fest_alloc.h"
+#include "linux_sysfs.h"
+#include <unistd.h>
+
+#define PROC_STAT_PATH "/proc/stat" // Per-core time counters
+#define PROC_STAT_LINE_LENGTH 224   // Longest "cpuN" line, ten 20-digit fields
+#define PROC_STAT_FIELDS 8          // user nice system idle iowait irq softirq steal
+
+/**
+ * @brief Sampler state of the Linux collector, owned by the monitoring thread
+ */
+static struct
+{
+    int fd;                 // /proc/stat, kept open across ticks
+    char *buffer;           // Room for the "cpu" lines, read with one pread
+    size_t bufferSize;      // Size of buffer in bytes
+    CPULoadSampler sampler; // Counters of the last two ticks
+} g_LinuxCPULoad = {-1, NULL, 0, {NULL, NULL, 0}};
+
+/**
+ * @brief Returns the number of possible logical cores
+ *
+ * Without the possible list, the "cpuN" lines of /proc/stat are
+ * counted.
+ *
+ * @return UINT Highest possible core number plus one, 0 if unknown
+ */
+static UINT countPossibleCores(void)
+{
+    UINT possible = readSysfsPossibleCPUs();
+    if (possible > 0)
+        return possible;
+
+    char *stat = readSysfsFileAlloc(PROC_STAT_PATH, NULL);
+    UINT count = 0;
+    for (const char *line = stat; line && strncmp(line, "cpu", 3) == 0;)
+    {
+        if (line[3] >= '0' && line[3] <= '9')
+            count++;
+        line = strchr(line, '\n');
+        if (line)
+            line++;
+    }
+    if (stat)
+        festFree(stat);
+    return count;
+}
+
+/**
+ * @brief Parses one "cpu" or "cpuN" line into counters
+ *
+ * Guest time is already part of user time and is not read.
+ *
+ * @param fields Text after the "cpu"/"cpuN" label
+ * @param times Receives the counters
+ * @return const char* Start of the next line
+ */
+static const char *parseStatLine(const char *fields, CPUTimes *times)
+{
+    UINT64 values[PROC_STAT_FIELDS] = {0};
+    const char *cursor = fields;
+
+    for (UINT field = 0; field < PROC_STAT_FIELDS && *cursor && *cursor != '\n'; field++)
+    {
+        while (*cursor == ' ')
+            cursor++;
+        while (*cursor >= '0' && *cursor <= '9')
+            values[field] = values[field] * 10 + (UINT64)(*cursor++ - '0');
+    }
+
+    times->user = values[0] + values[1];
+    times->system = values[2] + values[5] + values[6] + values[7];
+    times->idle = values[3];
+    times->iowait = values[4];
+
+    const char *next = strchr(cursor, '\n');
+    return next ? next + 1 : cursor + strlen(cursor);
+}
+
+/**
+ * @brief Opens /proc/stat and sizes the sampler for every possible core
+ *
+ * @return BOOL TRUE if /proc/stat could be opened
+ */
+BOOL openLinuxCPULoad(void)
+{
+    UINT coreCount = countPossibleCores();
+    if (coreCount == 0)
+        return FALSE;
+
+    g_LinuxCPULoad.fd = openSysfsFile(PROC_STAT_PATH);
+    g_LinuxCPULoad.bufferSize = (coreCount + 1) * PROC_STAT_LINE_LENGTH;
+    g_LinuxCPULoad.buffer = (char *)festMalloc(g_LinuxCPULoad.bufferSize);
+    if (g_LinuxCPULoad.fd < 0 || !g_LinuxCPULoad.buffer ||
+        !initCPULoadSampler(&g_LinuxCPULoad.sampler, coreCount))
+    {
+        closeLinuxCPULoad();
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief Closes /proc/stat and releases the sampler
+ */
+void closeLinuxCPULoad(void)
+{
+    if (g_LinuxCPULoad.fd >= 0)
+        close(g_LinuxCPULoad.fd);
+    if (g_LinuxCPULoad.buffer)
+        festFree(g_LinuxCPULoad.buffer);
+    releaseCPULoadSampler(&g_LinuxCPULoad.sampler);
+    g_LinuxCPULoad.fd = -1;
+    g_LinuxCPULoad.buffer = NULL;
+    g_LinuxCPULoad.bufferSize = 0;
+}
+
+/**
+ * @brief Samples CPU utilization from /proc/stat
+ *
+ * The "cpu" lines come first in /proc/stat, so the buffer only
+ * needs room for them; the interrupt counters that follow are cut
+ * off by the pread. Offline cores have no line and read as zero.
+ *
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return CPULoadInfo* Pointer to CPU utilization, NULL if failed or not opened
+ */
+CPULoadInfo *collectLinuxCPULoad(SnapshotArena *arena)
+{
+    CPULoadSampler *sampler = &g_LinuxCPULoad.sampler;
+    if (g_LinuxCPULoad.fd < 0 || !sampler->current)
+        return NULL;
+
+    if (preadSysfsFile(g_LinuxCPULoad.fd, g_LinuxCPULoad.buffer, g_LinuxCPULoad.bufferSize) == 0)
+        return NULL;
+
+    memset(sampler->current, 0, (sampler->coreCount + 1) * sizeof(CPUTimes));
+    const char *line = g_LinuxCPULoad.buffer;
+    while (strncmp(line, "cpu", 3) == 0)
+    {
+        const char *cursor = line + 3;
+        if (*cursor == ' ')
+        {
+            line = parseStatLine(cursor, &sampler->current[0]);
+            continue;
+        }
+
+        UINT core = 0;
+        while (*cursor >= '0' && *cursor <= '9')
+            core = core * 10 + (UINT)(*cursor++ - '0');
+
+        CPUTimes ignored;
+        line = parseStatLine(cursor, core < sampler->coreCount ? &sampler->current[core + 1] : &ignored);
+    }
+
+    return computeCPULoad(sampler, arena);
+}
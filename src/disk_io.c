@@ -0,0 +1,217 @@
+#include "disk_io.h"
+#include "fest_alloc.h"
+
+#define DISK_IO_WRAP_THRESHOLD 0x80000000ULL // A 32-bit time counter at or above this can wrap before the next tick
+#define DISK_IO_WRAP_LIMIT 0xFFFFFFFFULL     // Largest value of a 32-bit time counter
+
+/**
+ * @brief Makes room for a number of devices in both counter arrays
+ *
+ * @param sampler Sampler to grow, zeroed for the first call
+ * @param count Devices this tick will read
+ * @return BOOL TRUE if both arrays hold at least count entries
+ */
+BOOL reserveDiskIOSampler(DiskIOSampler *sampler, UINT count)
+{
+    if (count <= sampler->capacity)
+        return TRUE;
+
+    size_t size = count * sizeof(DiskIOCounters);
+    DiskIOCounters *previous = (DiskIOCounters *)festRealloc(sampler->previous, size);
+    if (!previous)
+        return FALSE;
+    sampler->previous = previous;
+
+    DiskIOCounters *current = (DiskIOCounters *)festRealloc(sampler->current, size);
+    if (!current)
+        return FALSE;
+    sampler->current = current;
+    sampler->capacity = count;
+    return TRUE;
+}
+
+/**
+ * @brief Frees the counter arrays of a sampler
+ *
+ * @param sampler Sampler to release, zeroed afterwards
+ */
+void releaseDiskIOSampler(DiskIOSampler *sampler)
+{
+    if (sampler->previous)
+        festFree(sampler->previous);
+    if (sampler->current)
+        festFree(sampler->current);
+    memset(sampler, 0, sizeof(DiskIOSampler));
+}
+
+/**
+ * @brief Difference of a cumulative count between two ticks
+ *
+ * I/O and sector counts are 64-bit on 64-bit kernels, so a decrease
+ * means the counter restarted.
+ *
+ * @param now Counter of this tick
+ * @param before Counter of the previous tick
+ * @return UINT64 Increase since the previous tick
+ */
+static UINT64 counterDelta(UINT64 now, UINT64 before)
+{
+    return now >= before ? now - before : now;
+}
+
+/**
+ * @brief Difference of a cumulative time counter between two ticks
+ *
+ * Time fields are kept in 32 bits, so a counter close to its limit
+ * wraps around to a small value; any other decrease restarted it.
+ *
+ * @param now Counter of this tick
+ * @param before Counter of the previous tick
+ * @return UINT64 Increase since the previous tick
+ */
+static UINT64 timeDelta(UINT64 now, UINT64 before)
+{
+    if (now >= before)
+        return now - before;
+    if (before >= DISK_IO_WRAP_THRESHOLD && before <= DISK_IO_WRAP_LIMIT)
+        return DISK_IO_WRAP_LIMIT - before + now + 1;
+    return now;
+}
+
+/**
+ * @brief Finds the previous counters of a device
+ *
+ * Devices keep their /proc/diskstats order between ticks, so the
+ * entry after the last match is tried first; the whole array is
+ * searched only after a device appeared or disappeared.
+ *
+ * @param sampler Sampler holding the previous counters
+ * @param device Block device name
+ * @param hint Index to try first
+ * @return int Index in previous, -1 if the device is new
+ */
+static int findPreviousCounters(const DiskIOSampler *sampler, const char *device, UINT hint)
+{
+    if (hint < sampler->previousCount && strcmp(sampler->previous[hint].device, device) == 0)
+        return (int)hint;
+
+    for (UINT i = 0; i < sampler->previousCount; i++)
+    {
+        if (strcmp(sampler->previous[i].device, device) == 0)
+            return (int)i;
+    }
+    return -1;
+}
+
+/**
+ * @brief Converts two counter samples into rates
+ *
+ * @param now Counters of this tick
+ * @param before Counters of the previous tick
+ * @param elapsedMs Milliseconds between the two ticks, not 0
+ * @param stats Receives the rates
+ */
+static void computeRates(const DiskIOCounters *now, const DiskIOCounters *before, UINT64 elapsedMs, DiskIOStats *stats)
+{
+    UINT64 reads = counterDelta(now->reads, before->reads);
+    UINT64 writes = counterDelta(now->writes, before->writes);
+    UINT64 ioTime = timeDelta(now->readTime, before->readTime) + timeDelta(now->writeTime, before->writeTime);
+    double seconds = (double)elapsedMs / 1000.0;
+
+    stats->readIOPS = (double)reads / seconds;
+    stats->writeIOPS = (double)writes / seconds;
+    stats->readBytesPerSec = (double)(counterDelta(now->readSectors, before->readSectors) * DISK_IO_SECTOR_SIZE) / seconds;
+    stats->writeBytesPerSec = (double)(counterDelta(now->writeSectors, before->writeSectors) * DISK_IO_SECTOR_SIZE) / seconds;
+    stats->serviceTimeMs = reads + writes > 0 ? (double)ioTime / (double)(reads + writes) : 0.0;
+    stats->utilization = 100.0 * (double)timeDelta(now->busyTime, before->busyTime) / (double)elapsedMs;
+    if (stats->utilization > 100.0)
+        stats->utilization = 100.0;
+}
+
+/**
+ * @brief Turns the counters of this tick into rates
+ *
+ * @param sampler Sampler whose current array and time were filled by the platform
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return DiskIOList* Pointer to device activity, NULL if failed
+ */
+DiskIOList *computeDiskIO(DiskIOSampler *sampler, SnapshotArena *arena)
+{
+    DiskIOList *list = (DiskIOList *)snapshotAlloc(arena, sizeof(DiskIOList));
+    if (!list)
+        return NULL;
+
+    list->count = sampler->currentCount;
+    list->devices = NULL;
+    if (list->count > 0)
+    {
+        list->devices = (DiskIOStats *)snapshotAlloc(arena, list->count * sizeof(DiskIOStats));
+        if (!list->devices)
+        {
+            snapshotFree(arena, list);
+            return NULL;
+        }
+    }
+
+    UINT64 elapsedMs = sampler->previousTime && sampler->currentTime > sampler->previousTime
+                           ? sampler->currentTime - sampler->previousTime
+                           : 0;
+    UINT hint = 0;
+    for (UINT i = 0; i < sampler->currentCount; i++)
+    {
+        const DiskIOCounters *now = &sampler->current[i];
+        DiskIOStats *stats = &list->devices[i];
+        memset(stats, 0, sizeof(DiskIOStats));
+        strcpy_s(stats->device, sizeof(stats->device), now->device);
+
+        int before = elapsedMs ? findPreviousCounters(sampler, now->device, hint) : -1;
+        if (before < 0)
+            continue;
+        computeRates(now, &sampler->previous[before], elapsedMs, stats);
+        hint = (UINT)before + 1;
+    }
+
+    // This tick's counters are the baseline of the next one
+    DiskIOCounters *previous = sampler->previous;
+    sampler->previous = sampler->current;
+    sampler->current = previous;
+    sampler->previousCount = sampler->currentCount;
+    sampler->currentCount = 0;
+    sampler->previousTime = sampler->currentTime;
+    return list;
+}
+
+/**
+ * @brief Looks up the activity of a block device
+ *
+ * @param list Device activity, may be NULL
+ * @param device Block device name, e.g. LogicalDiskInfo.device
+ * @return const DiskIOStats* Activity of the device, NULL if not listed
+ */
+const DiskIOStats *findDiskIO(const DiskIOList *list, const char *device)
+{
+    if (!list || !device || !device[0])
+        return NULL;
+
+    for (UINT i = 0; i < list->count; i++)
+    {
+        if (strcmp(list->devices[i].device, device) == 0)
+            return &list->devices[i];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Frees device activity allocated from the heap
+ *
+ * @param list Pointer to DiskIOList structure to be freed
+ */
+void freeDiskIOList(DiskIOList *list)
+{
+    if (list)
+    {
+        if (list->devices)
+            festFree(list->devices);
+        festFree(list);
+    }
+}
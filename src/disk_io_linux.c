@@ -0,0 +1,193 @@
+#include "disk_io.h"
+#include "fest_alloc.h"
+#include "linux_sysfs.h"
+#include <unistd.h>
+
+#define PROC_DISKSTATS_PATH "/proc/diskstats" // Cumulative I/O counters per block device
+#define DISKSTATS_BUFFER_SIZE 8192            // Initial read buffer, about 60 devices
+#define DISKSTATS_FIELDS 10                   // reads to io_ticks, the fields after the name that are read
+
+/**
+ * @brief Sampler state of the Linux collector, owned by the monitoring thread
+ */
+static struct
+{
+    int fd;                // /proc/diskstats, kept open across ticks
+    char *buffer;          // Room for the whole file, read with one pread
+    size_t bufferSize;     // Size of buffer in bytes
+    DiskIOSampler sampler; // Counters of the last two ticks
+} g_LinuxDiskIO = {-1, NULL, 0, {NULL, NULL, 0, 0, 0, 0, 0}};
+
+/**
+ * @brief Tells whether a block device is a loop or RAM disk
+ *
+ * Loop devices back snap packages and disk images and RAM disks
+ * never reach a disk, so neither says whether a disk is busy.
+ *
+ * @param name Block device name
+ * @return BOOL TRUE if the device is left out
+ */
+static BOOL isVirtualDevice(const char *name)
+{
+    return strncmp(name, "loop", 4) == 0 || (strncmp(name, "ram", 3) == 0 && name[3] >= '0' && name[3] <= '9');
+}
+
+/**
+ * @brief Reads the next unsigned number of a line
+ *
+ * @param cursor Position in the line, moved past the number
+ * @return UINT64 The number, 0 at the end of the line
+ */
+static UINT64 parseField(const char **cursor)
+{
+    const char *p = *cursor;
+    UINT64 value = 0;
+    while (*p == ' ' || *p == '\t')
+        p++;
+    while (*p >= '0' && *p <= '9')
+        value = value * 10 + (UINT64)(*p++ - '0');
+    *cursor = p;
+    return value;
+}
+
+/**
+ * @brief Parses one /proc/diskstats line into counters
+ *
+ * Fields after io_ticks (weighted time, discards and flushes on
+ * newer kernels) are not read.
+ *
+ * @param line Start of the line
+ * @param counters Receives the device name and counters
+ * @return BOOL TRUE if the line names a device that is reported
+ */
+static BOOL parseDiskStatsLine(const char *line, DiskIOCounters *counters)
+{
+    const char *cursor = line;
+    parseField(&cursor); // major
+    parseField(&cursor); // minor
+    while (*cursor == ' ' || *cursor == '\t')
+        cursor++;
+
+    size_t nameLength = 0;
+    while (cursor[nameLength] && cursor[nameLength] != ' ' && cursor[nameLength] != '\n')
+        nameLength++;
+    if (nameLength == 0 || nameLength >= DISK_IO_NAME_LENGTH)
+        return FALSE;
+    memcpy(counters->device, cursor, nameLength);
+    counters->device[nameLength] = '\0';
+    if (isVirtualDevice(counters->device))
+        return FALSE;
+    cursor += nameLength;
+
+    UINT64 fields[DISKSTATS_FIELDS];
+    for (UINT i = 0; i < DISKSTATS_FIELDS; i++)
+        fields[i] = parseField(&cursor);
+
+    counters->reads = fields[0];
+    counters->readSectors = fields[2];
+    counters->readTime = fields[3];
+    counters->writes = fields[4];
+    counters->writeSectors = fields[6];
+    counters->writeTime = fields[7];
+    counters->busyTime = fields[9];
+    return TRUE;
+}
+
+/**
+ * @brief Rereads /proc/diskstats into the buffer
+ *
+ * A read that fills the buffer may have been cut short, so the
+ * buffer is doubled and the file reread. The buffer keeps its size
+ * afterwards; it only grows again when more devices appear.
+ *
+ * @return size_t Bytes read, 0 if the file could not be read
+ */
+static size_t readDiskStats(void)
+{
+    for (;;)
+    {
+        size_t length = preadSysfsFile(g_LinuxDiskIO.fd, g_LinuxDiskIO.buffer, g_LinuxDiskIO.bufferSize);
+        if (length < g_LinuxDiskIO.bufferSize - 1)
+            return length;
+
+        char *larger = (char *)festRealloc(g_LinuxDiskIO.buffer, g_LinuxDiskIO.bufferSize * 2);
+        if (!larger)
+            return length;
+        g_LinuxDiskIO.buffer = larger;
+        g_LinuxDiskIO.bufferSize *= 2;
+    }
+}
+
+/**
+ * @brief Opens /proc/diskstats
+ *
+ * @return BOOL TRUE if /proc/diskstats could be opened
+ */
+BOOL openLinuxDiskIO(void)
+{
+    g_LinuxDiskIO.fd = openSysfsFile(PROC_DISKSTATS_PATH);
+    g_LinuxDiskIO.bufferSize = DISKSTATS_BUFFER_SIZE;
+    g_LinuxDiskIO.buffer = (char *)festMalloc(g_LinuxDiskIO.bufferSize);
+    if (g_LinuxDiskIO.fd < 0 || !g_LinuxDiskIO.buffer)
+    {
+        closeLinuxDiskIO();
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief Closes /proc/diskstats and releases the sampler
+ */
+void closeLinuxDiskIO(void)
+{
+    if (g_LinuxDiskIO.fd >= 0)
+        close(g_LinuxDiskIO.fd);
+    if (g_LinuxDiskIO.buffer)
+        festFree(g_LinuxDiskIO.buffer);
+    releaseDiskIOSampler(&g_LinuxDiskIO.sampler);
+    g_LinuxDiskIO.fd = -1;
+    g_LinuxDiskIO.buffer = NULL;
+    g_LinuxDiskIO.bufferSize = 0;
+}
+
+/**
+ * @brief Samples block device activity from /proc/diskstats
+ *
+ * Devices plugged in or removed between ticks simply appear in or
+ * vanish from the file; the sampler pairs the rest by name.
+ *
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return DiskIOList* Pointer to device activity, NULL if failed or not opened
+ */
+DiskIOList *collectLinuxDiskIO(SnapshotArena *arena)
+{
+    DiskIOSampler *sampler = &g_LinuxDiskIO.sampler;
+    if (g_LinuxDiskIO.fd < 0)
+        return NULL;
+
+    UINT64 now = GetTickCount64();
+    if (readDiskStats() == 0)
+        return NULL;
+
+    UINT lines = 0;
+    for (const char *p = strchr(g_LinuxDiskIO.buffer, '\n'); p; p = strchr(p + 1, '\n'))
+        lines++;
+    if (!reserveDiskIOSampler(sampler, lines))
+        return NULL;
+
+    sampler->currentCount = 0;
+    for (const char *line = g_LinuxDiskIO.buffer; *line && sampler->currentCount < lines;)
+    {
+        if (parseDiskStatsLine(line, &sampler->current[sampler->currentCount]))
+            sampler->currentCount++;
+
+        const char *next = strchr(line, '\n');
+        if (!next)
+            break;
+        line = next + 1;
+    }
+
+    sampler->currentTime = now;
+    return computeDiskIO(sampler, arena);
+}
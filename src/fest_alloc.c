@@ -0,0 +1,201 @@
+#include "fest_alloc.h"
+#include <stdlib.h>
+
+#if defined(FEST_ALLOC_HOOK) && defined(_DEBUG)
+#include <crtdbg.h>
+#define FEST_CRT_HOOK_AVAILABLE
+#endif
+
+/**
+ * @brief Bookkeeping header stored in front of every block
+ *
+ * Sized to 16 bytes so the returned pointer keeps
+ * the alignment guaranteed by malloc()
+ */
+typedef union
+{
+    size_t size;    // Requested size of the block
+    UINT64 pad[2];  // Keeps user data 16-byte aligned
+} AllocHeader;
+
+/**
+ * @brief Process-wide heap counters
+ *
+ * Updated with interlocked operations because collectors
+ * may be called from the monitoring thread and from
+ * application threads at the same time
+ */
+static volatile LONG64 g_allocCount = 0;
+static volatile LONG64 g_freeCount = 0;
+static volatile LONG64 g_allocatedBytes = 0;
+static volatile LONG64 g_currentBytes = 0;
+static volatile LONG64 g_peakBytes = 0;
+static volatile LONG64 g_crtAllocCount = 0;
+static volatile LONG g_crtCounting = 0;
+
+/**
+ * @brief Raises the peak counter if the live byte count exceeds it
+ *
+ * @param current Live byte count after an allocation
+ */
+static void updatePeak(LONG64 current)
+{
+    LONG64 peak = g_peakBytes;
+    while (current > peak)
+    {
+        LONG64 previous = InterlockedCompareExchange64(&g_peakBytes, current, peak);
+        if (previous == peak)
+            break;
+        peak = previous;
+    }
+}
+
+/**
+ * @brief Records a new block of the given size
+ *
+ * @param size Size of the new block in bytes
+ */
+static void recordAlloc(size_t size)
+{
+    InterlockedIncrement64(&g_allocCount);
+    InterlockedExchangeAdd64(&g_allocatedBytes, (LONG64)size);
+    updatePeak(InterlockedExchangeAdd64(&g_currentBytes, (LONG64)size) + (LONG64)size);
+}
+
+/**
+ * @brief Allocates a tracked block
+ *
+ * @param size Number of bytes to allocate
+ * @return void* Pointer to allocated block, NULL if failed
+ */
+void *festMalloc(size_t size)
+{
+    AllocHeader *header = (AllocHeader *)malloc(sizeof(AllocHeader) + size);
+    if (!header)
+        return NULL;
+
+    header->size = size;
+    recordAlloc(size);
+    return header + 1;
+}
+
+/**
+ * @brief Resizes a tracked block
+ *
+ * Shrinking or growing in place is not counted as a new
+ * allocation, only the change in live bytes is recorded.
+ *
+ * @param ptr Block to resize, may be NULL
+ * @param size New size in bytes
+ * @return void* Pointer to resized block, NULL if failed
+ */
+void *festRealloc(void *ptr, size_t size)
+{
+    if (!ptr)
+        return festMalloc(size);
+
+    AllocHeader *header = (AllocHeader *)ptr - 1;
+    size_t oldSize = header->size;
+
+    AllocHeader *resized = (AllocHeader *)realloc(header, sizeof(AllocHeader) + size);
+    if (!resized)
+        return NULL;
+
+    resized->size = size;
+    if (size > oldSize)
+    {
+        LONG64 delta = (LONG64)(size - oldSize);
+        InterlockedIncrement64(&g_allocCount);
+        InterlockedExchangeAdd64(&g_allocatedBytes, delta);
+        updatePeak(InterlockedExchangeAdd64(&g_currentBytes, delta) + delta);
+    }
+    else
+    {
+        InterlockedExchangeAdd64(&g_currentBytes, -(LONG64)(oldSize - size));
+    }
+
+    return resized + 1;
+}
+
+/**
+ * @brief Releases a tracked block
+ *
+ * @param ptr Block to release, NULL is ignored
+ */
+void festFree(void *ptr)
+{
+    if (!ptr)
+        return;
+
+    AllocHeader *header = (AllocHeader *)ptr - 1;
+    InterlockedIncrement64(&g_freeCount);
+    InterlockedExchangeAdd64(&g_currentBytes, -(LONG64)header->size);
+    free(header);
+}
+
+/**
+ * @brief Reads the current heap counters
+ *
+ * @param stats Structure to receive the counters
+ */
+void getAllocStats(AllocStats *stats)
+{
+    if (!stats)
+        return;
+
+    stats->allocCount = (UINT64)g_allocCount;
+    stats->freeCount = (UINT64)g_freeCount;
+    stats->allocatedBytes = (UINT64)g_allocatedBytes;
+    stats->currentBytes = (UINT64)g_currentBytes;
+    stats->peakBytes = (UINT64)g_peakBytes;
+    stats->crtAllocCount = (UINT64)g_crtAllocCount;
+    stats->crtCounting = g_crtCounting != 0;
+}
+
+/**
+ * @brief Restarts peak tracking from the current live byte count
+ */
+void resetAllocPeak(void)
+{
+    InterlockedExchange64(&g_peakBytes, g_currentBytes);
+}
+
+#ifdef FEST_CRT_HOOK_AVAILABLE
+/**
+ * @brief Debug CRT hook counting heap requests
+ *
+ * Runs inside the CRT allocator, so it must not allocate
+ * or call back into the heap. CRT-internal blocks (stdio
+ * buffers, locale data) are not counted.
+ *
+ * @param allocType _HOOK_ALLOC, _HOOK_REALLOC or _HOOK_FREE
+ * @param userData Block being freed or reallocated (unused)
+ * @param size Requested size (unused)
+ * @param blockType CRT block type
+ * @param requestNumber CRT request number (unused)
+ * @param filename Source file of the request (unused)
+ * @param lineNumber Source line of the request (unused)
+ * @return int TRUE to let the request proceed
+ */
+static int countCrtAlloc(int allocType, void *userData, size_t size, int blockType,
+                         long requestNumber, const unsigned char *filename, int lineNumber)
+{
+    if (blockType != _CRT_BLOCK && (allocType == _HOOK_ALLOC || allocType == _HOOK_REALLOC))
+        InterlockedIncrement64(&g_crtAllocCount);
+    return TRUE;
+}
+#endif
+
+/**
+ * @brief Starts counting C runtime heap requests of the library
+ *
+ * The library links the C runtime statically, so the hook only
+ * sees requests made by library code.
+ */
+void enableCrtAllocCounting(void)
+{
+#ifdef FEST_CRT_HOOK_AVAILABLE
+    if (InterlockedCompareExchange(&g_crtCounting, 1, 0) == 0)
+        _CrtSetAllocHook(countCrtAlloc);
+#endif
+}
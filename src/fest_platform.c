@@ -0,0 +1,322 @@
+#include "fest_platform.h"
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/**
+ * @brief Kind of object behind a HANDLE
+ */
+typedef enum
+{
+    PLATFORM_MUTEX,
+    PLATFORM_EVENT,
+    PLATFORM_THREAD
+} PlatformObjectType;
+
+/**
+ * @brief Object behind a mutex, event or thread HANDLE
+ *
+ * Events and threads share the signaled state: a thread is
+ * a manual reset event set when its start routine returns.
+ * A thread object is referenced by its handle and by the
+ * running thread, whichever lets go last frees it.
+ */
+typedef struct
+{
+    PlatformObjectType type;   // Kind of object
+    pthread_mutex_t lock;      // Guards the fields below, or the mutex itself
+    pthread_cond_t changed;    // Broadcast when signaled becomes TRUE
+    BOOL signaled;             // Event state or thread exited
+    BOOL manualReset;          // Event stays signaled after a wait
+    volatile LONG references;  // Handle plus running thread
+    pthread_t thread;          // Thread running start
+    unsigned (*start)(void *); // Thread start routine
+    void *arg;                 // Start routine argument
+} PlatformObject;
+
+/**
+ * @brief Allocates a platform object with its condition on the monotonic clock
+ *
+ * @param type Kind of object
+ * @param recursive Make the lock recursive, for mutex objects
+ * @return PlatformObject* New object, NULL if failed
+ */
+static PlatformObject *createObject(PlatformObjectType type, BOOL recursive)
+{
+    PlatformObject *object = (PlatformObject *)calloc(1, sizeof(PlatformObject));
+    if (!object)
+        return NULL;
+
+    pthread_mutexattr_t mutexAttributes;
+    pthread_mutexattr_init(&mutexAttributes);
+    if (recursive)
+        pthread_mutexattr_settype(&mutexAttributes, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&object->lock, &mutexAttributes);
+    pthread_mutexattr_destroy(&mutexAttributes);
+
+    pthread_condattr_t condAttributes;
+    pthread_condattr_init(&condAttributes);
+    pthread_condattr_setclock(&condAttributes, CLOCK_MONOTONIC);
+    pthread_cond_init(&object->changed, &condAttributes);
+    pthread_condattr_destroy(&condAttributes);
+
+    object->type = type;
+    object->references = 1;
+    return object;
+}
+
+/**
+ * @brief Drops one reference, freeing the object with the last one
+ */
+static void releaseObject(PlatformObject *object)
+{
+    if (InterlockedDecrement(&object->references) != 0)
+        return;
+
+    pthread_cond_destroy(&object->changed);
+    pthread_mutex_destroy(&object->lock);
+    free(object);
+}
+
+/**
+ * @brief Converts a relative timeout into an absolute monotonic deadline
+ */
+static struct timespec getDeadline(DWORD milliseconds, clockid_t clock)
+{
+    struct timespec deadline;
+    clock_gettime(clock, &deadline);
+    deadline.tv_sec += milliseconds / 1000;
+    deadline.tv_nsec += (long)(milliseconds % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    return deadline;
+}
+
+/**
+ * @brief Creates a recursive mutex, unnamed and not owned
+ *
+ * @param attributes Unused
+ * @param initialOwner Acquire the mutex for the calling thread
+ * @param name Unused, named mutexes are not supported
+ * @return HANDLE Mutex handle, NULL if failed
+ */
+HANDLE CreateMutex(void *attributes, BOOL initialOwner, const char *name)
+{
+    PlatformObject *object = createObject(PLATFORM_MUTEX, TRUE);
+    if (object && initialOwner)
+        pthread_mutex_lock(&object->lock);
+    return object;
+}
+
+/**
+ * @brief Releases a mutex acquired with WaitForSingleObject()
+ *
+ * @param mutex Mutex handle
+ * @return BOOL TRUE if released
+ */
+BOOL ReleaseMutex(HANDLE mutex)
+{
+    PlatformObject *object = (PlatformObject *)mutex;
+    if (!object || object->type != PLATFORM_MUTEX)
+        return FALSE;
+    return pthread_mutex_unlock(&object->lock) == 0;
+}
+
+/**
+ * @brief Creates an unnamed manual or auto reset event
+ *
+ * @param attributes Unused
+ * @param manualReset TRUE to stay signaled until ResetEvent()
+ * @param initialState TRUE to start signaled
+ * @param name Unused, named events are not supported
+ * @return HANDLE Event handle, NULL if failed
+ */
+HANDLE CreateEvent(void *attributes, BOOL manualReset, BOOL initialState, const char *name)
+{
+    PlatformObject *object = createObject(PLATFORM_EVENT, FALSE);
+    if (object)
+    {
+        object->manualReset = manualReset;
+        object->signaled = initialState;
+    }
+    return object;
+}
+
+/**
+ * @brief Signals an event
+ *
+ * @param event Event handle
+ * @return BOOL TRUE if signaled
+ */
+BOOL SetEvent(HANDLE event)
+{
+    PlatformObject *object = (PlatformObject *)event;
+    if (!object || object->type != PLATFORM_EVENT)
+        return FALSE;
+
+    pthread_mutex_lock(&object->lock);
+    object->signaled = TRUE;
+    pthread_cond_broadcast(&object->changed);
+    pthread_mutex_unlock(&object->lock);
+    return TRUE;
+}
+
+/**
+ * @brief Clears an event
+ *
+ * @param event Event handle
+ * @return BOOL TRUE if cleared
+ */
+BOOL ResetEvent(HANDLE event)
+{
+    PlatformObject *object = (PlatformObject *)event;
+    if (!object || object->type != PLATFORM_EVENT)
+        return FALSE;
+
+    pthread_mutex_lock(&object->lock);
+    object->signaled = FALSE;
+    pthread_mutex_unlock(&object->lock);
+    return TRUE;
+}
+
+/**
+ * @brief Waits for a mutex, event or thread handle
+ *
+ * @param handle Object to wait for
+ * @param milliseconds Timeout, INFINITE to wait without one
+ * @return DWORD WAIT_OBJECT_0, WAIT_TIMEOUT or WAIT_FAILED
+ */
+DWORD WaitForSingleObject(HANDLE handle, DWORD milliseconds)
+{
+    PlatformObject *object = (PlatformObject *)handle;
+    if (!object)
+        return WAIT_FAILED;
+
+    if (object->type == PLATFORM_MUTEX)
+    {
+        int status;
+        if (milliseconds == INFINITE)
+            status = pthread_mutex_lock(&object->lock);
+        else if (milliseconds == 0)
+            status = pthread_mutex_trylock(&object->lock);
+        else
+        {
+            // Timed mutex waits only take the realtime clock
+            struct timespec deadline = getDeadline(milliseconds, CLOCK_REALTIME);
+            status = pthread_mutex_timedlock(&object->lock, &deadline);
+        }
+        if (status == 0)
+            return WAIT_OBJECT_0;
+        return (status == EBUSY || status == ETIMEDOUT) ? WAIT_TIMEOUT : WAIT_FAILED;
+    }
+
+    struct timespec deadline = getDeadline(milliseconds == INFINITE ? 0 : milliseconds, CLOCK_MONOTONIC);
+    DWORD result = WAIT_OBJECT_0;
+
+    pthread_mutex_lock(&object->lock);
+    while (!object->signaled)
+    {
+        if (milliseconds == INFINITE)
+            pthread_cond_wait(&object->changed, &object->lock);
+        else if (pthread_cond_timedwait(&object->changed, &object->lock, &deadline) == ETIMEDOUT)
+        {
+            result = object->signaled ? WAIT_OBJECT_0 : WAIT_TIMEOUT;
+            break;
+        }
+    }
+    if (result == WAIT_OBJECT_0 && object->type == PLATFORM_EVENT && !object->manualReset)
+        object->signaled = FALSE;
+    pthread_mutex_unlock(&object->lock);
+    return result;
+}
+
+/**
+ * @brief Releases a handle, detaching a thread that is still running
+ *
+ * @param handle Handle to close
+ * @return BOOL TRUE if closed
+ */
+BOOL CloseHandle(HANDLE handle)
+{
+    PlatformObject *object = (PlatformObject *)handle;
+    if (!object)
+        return FALSE;
+
+    if (object->type == PLATFORM_THREAD)
+        pthread_detach(object->thread);
+    releaseObject(object);
+    return TRUE;
+}
+
+/**
+ * @brief Runs a thread start routine and signals its handle
+ *
+ * @param arg Thread object
+ * @return void* NULL
+ */
+static void *runThread(void *arg)
+{
+    PlatformObject *object = (PlatformObject *)arg;
+    object->start(object->arg);
+
+    pthread_mutex_lock(&object->lock);
+    object->signaled = TRUE;
+    pthread_cond_broadcast(&object->changed);
+    pthread_mutex_unlock(&object->lock);
+
+    releaseObject(object);
+    return NULL;
+}
+
+/**
+ * @brief Starts a thread with the CRT _beginthreadex contract
+ *
+ * @param security Unused
+ * @param stackSize Unused, the default stack is used
+ * @param start Start routine, its exit code is discarded
+ * @param arg Start routine argument
+ * @param initFlag Unused, threads always start running
+ * @param threadId Unused
+ * @return uintptr_t Thread handle, 0 if failed
+ */
+uintptr_t _beginthreadex(void *security, unsigned stackSize, unsigned (*start)(void *),
+                         void *arg, unsigned initFlag, unsigned *threadId)
+{
+    PlatformObject *object = createObject(PLATFORM_THREAD, FALSE);
+    if (!object)
+        return 0;
+
+    object->manualReset = TRUE;
+    object->start = start;
+    object->arg = arg;
+    object->references = 2;
+    if (pthread_create(&object->thread, NULL, runThread, object) != 0)
+    {
+        object->references = 1;
+        releaseObject(object);
+        return 0;
+    }
+    return (uintptr_t)object;
+}
+
+/**
+ * @brief Returns the kernel id of the calling thread
+ *
+ * @return DWORD Thread id, as shown by trace viewers and top
+ */
+DWORD GetCurrentThreadId(void)
+{
+    return (DWORD)syscall(SYS_gettid);
+}
+
+/**
+ * @brief Returns the id of the calling process
+ *
+ * @return DWORD Process id
+ */
+DWORD GetCurrentProcessId(void)
+{
+    return (DWORD)getpid();
+}
@@ -1,5 +1,8 @@
 #include "gpu_info.h"
+#include "fest_alloc.h"
+#include "utf8_transcode.h"
 
+#ifdef _WIN32
 // DXGI Factory interface GUID
 DEFINE_GUID(IID_IDXGIFactory, 0x7b7166ec, 0x21c7, 0x44ae, 0xb2, 0x1a, 0xc9, 0xae, 0x32, 0x1a, 0xe3, 0x69);
 
@@ -35,7 +38,7 @@ GPUList *getGPUList(void)
     HRESULT hr;
     UINT i = 0;
 
-    GPUList *list = (GPUList *)malloc(sizeof(GPUList));
+    GPUList *list = (GPUList *)festMalloc(sizeof(GPUList));
     list->count = 0;
     list->gpus = NULL;
 
@@ -43,7 +46,7 @@ GPUList *getGPUList(void)
     hr = CreateDXGIFactory(&IID_IDXGIFactory, (void **)&factory);
     if (FAILED(hr))
     {
-        free(list);
+        festFree(list);
         return NULL;
     }
 
@@ -55,7 +58,7 @@ GPUList *getGPUList(void)
     }
 
     list->count = i;
-    list->gpus = (GPUInfo *)malloc(sizeof(GPUInfo) * list->count);
+    list->gpus = (GPUInfo *)festMalloc(sizeof(GPUInfo) * list->count);
 
     // Second pass: Collect detailed adapter information
     for (UINT i = 0; i < list->count; i++)
@@ -67,11 +70,9 @@ GPUList *getGPUList(void)
             if (SUCCEEDED(hr))
             {
                 GPUInfo *gpu = &list->gpus[i];
-                size_t convertedChars = 0;
 
-                // Convert wide string description to narrow string
-                wcstombs_s(&convertedChars, gpu->name, sizeof(gpu->name),
-                           adapterDesc.Description, sizeof(gpu->name));
+                // Convert the UTF-16 description to UTF-8
+                wideToUtf8(adapterDesc.Description, gpu->name, sizeof(gpu->name));
 
                 // Store adapter memory information in GB
                 gpu->dedicatedMemory = bytesToGB(adapterDesc.DedicatedVideoMemory);
@@ -90,6 +91,8 @@ GPUList *getGPUList(void)
     return list;
 }
 
+#endif // _WIN32
+
 /**
  * @brief Frees memory allocated for GPUList structure
  *
@@ -101,9 +104,9 @@ void freeGPUList(GPUList *list)
     {
         if (list->gpus)
         {
-            free(list->gpus);
+            festFree(list->gpus);
         }
-        free(list);
+        festFree(list);
     }
 }
 
@@ -1,4 +1,6 @@
 #include "json_structure.h"
+#include "fest_alloc.h"
+#include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -24,7 +26,7 @@ static void appendString(char **buffer, size_t *bufferSize, size_t *position, co
     while (*position + len + 1 >= *bufferSize)
     {
         *bufferSize *= 2;
-        *buffer = (char *)realloc(*buffer, *bufferSize);
+        *buffer = (char *)festRealloc(*buffer, *bufferSize);
     }
     strcpy_s(*buffer + *position, *bufferSize - *position, str);
     *position += len;
@@ -137,6 +139,38 @@ static void trimString(char *str)
     }
 }
 
+/**
+ * @brief Escapes a string for use inside JSON quotes
+ *
+ * Backslashes and quotes are escaped, control characters are
+ * written as \u00XX. Windows volume roots ("C:\\") and Linux
+ * mount points can contain both.
+ *
+ * @param value String to escape
+ * @param escaped Buffer receiving the escaped string, truncated if too small
+ * @param escapedSize Size of the buffer in bytes
+ */
+static void escapeJSONString(const char *value, char *escaped, size_t escapedSize)
+{
+    size_t length = 0;
+    for (; *value; value++)
+    {
+        unsigned char c = (unsigned char)*value;
+        char sequence[8] = {(char)c, '\0'};
+        if (c == '"' || c == '\\')
+            _snprintf_s(sequence, sizeof(sequence), _TRUNCATE, "\\%c", c);
+        else if (c < 0x20)
+            _snprintf_s(sequence, sizeof(sequence), _TRUNCATE, "\\u%04x", c);
+
+        size_t sequenceLength = strlen(sequence);
+        if (length + sequenceLength >= escapedSize)
+            break;
+        memcpy(escaped + length, sequence, sequenceLength);
+        length += sequenceLength;
+    }
+    escaped[length] = '\0';
+}
+
 /**
  * @brief Formats CPU information into JSON
  *
@@ -180,11 +214,91 @@ static void appendCPUInfo(char **buffer, size_t *bufferSize, size_t *position, C
     appendString(buffer, bufferSize, position, "  ],\n");
 }
 
+/**
+ * @brief Formats one CPU utilization entry into JSON
+ *
+ * @param buffer Output buffer
+ * @param bufferSize Buffer size
+ * @param position Current position
+ * @param load Utilization percentages
+ * @param indent Leading text of the object, including its key if any
+ * @param trailer Text after the closing brace
+ */
+static void appendCPULoad(char **buffer, size_t *bufferSize, size_t *position,
+                          const CPULoad *load, const char *indent, const char *trailer)
+{
+    char temp[256];
+    _snprintf_s(temp, sizeof(temp), _TRUNCATE,
+                "%s{\"user\": %.1f, \"system\": %.1f, \"iowait\": %.1f, \"idle\": %.1f}%s",
+                indent, load->user, load->system, load->iowait, load->idle, trailer);
+    appendString(buffer, bufferSize, position, temp);
+}
+
+/**
+ * @brief Formats CPU utilization into JSON
+ *
+ * Creates a JSON object containing:
+ * - Utilization of all cores together
+ * - Utilization of each logical core, indexed by CPU number
+ *
+ * @param buffer Output buffer
+ * @param bufferSize Buffer size
+ * @param position Current position
+ * @param cpuLoad CPU utilization
+ */
+static void appendCPULoadInfo(char **buffer, size_t *bufferSize, size_t *position, CPULoadInfo *cpuLoad)
+{
+    appendString(buffer, bufferSize, position, "  \"cpu_load\": {\n");
+    appendCPULoad(buffer, bufferSize, position, &cpuLoad->total, "    \"total\": ", ",\n");
+    appendString(buffer, bufferSize, position, "    \"cores\": [\n");
+    for (UINT i = 0; i < cpuLoad->coreCount; i++)
+        appendCPULoad(buffer, bufferSize, position, &cpuLoad->cores[i], "      ",
+                      i < cpuLoad->coreCount - 1 ? ",\n" : "\n");
+    appendString(buffer, bufferSize, position, "    ]\n");
+    appendString(buffer, bufferSize, position, "  },\n");
+}
+
+/**
+ * @brief Formats core clocks into JSON
+ *
+ * Creates a JSON object containing:
+ * - Slowest, average and fastest core in MHz
+ * - Clock of each logical core, indexed by CPU number
+ *
+ * @param buffer Output buffer
+ * @param bufferSize Buffer size
+ * @param position Current position
+ * @param cpuFrequency Core clocks
+ */
+static void appendCPUFrequencyInfo(char **buffer, size_t *bufferSize, size_t *position, CPUFrequencyInfo *cpuFrequency)
+{
+    char temp[128];
+    _snprintf_s(temp, sizeof(temp), _TRUNCATE,
+                "  \"cpu_frequency\": {\n"
+                "    \"min\": %u,\n"
+                "    \"avg\": %u,\n"
+                "    \"max\": %u,\n"
+                "    \"cores\": [",
+                cpuFrequency->minMhz,
+                cpuFrequency->avgMhz,
+                cpuFrequency->maxMhz);
+    appendString(buffer, bufferSize, position, temp);
+
+    for (UINT i = 0; i < cpuFrequency->coreCount; i++)
+    {
+        _snprintf_s(temp, sizeof(temp), _TRUNCATE, "%s%u", i > 0 ? ", " : "", cpuFrequency->cores[i]);
+        appendString(buffer, bufferSize, position, temp);
+    }
+    appendString(buffer, bufferSize, position, "]\n");
+    appendString(buffer, bufferSize, position, "  },\n");
+}
+
 /**
  * @brief Formats memory information into JSON
  *
  * Creates a JSON object containing:
  * - System memory statistics
+ * - Swap, page cache and huge page usage
  * - RAM slot information
  * - Memory usage metrics
  *
@@ -192,8 +306,10 @@ static void appendCPUInfo(char **buffer, size_t *bufferSize, size_t *position, C
  * @param bufferSize Buffer size
  * @param position Current position
  * @param memInfo Memory information
+ * @param ramSlots Installed RAM modules, NULL for an empty list
  */
-static void appendMemoryInfo(char **buffer, size_t *bufferSize, size_t *position, MemoryInfo *memInfo)
+static void appendMemoryInfo(char **buffer, size_t *bufferSize, size_t *position, MemoryInfo *memInfo,
+                             RAMSlotList *ramSlots)
 {
     appendString(buffer, bufferSize, position, "  \"memory\": {\n");
 
@@ -202,18 +318,33 @@ static void appendMemoryInfo(char **buffer, size_t *bufferSize, size_t *position
                 "    \"total\": %.2f,\n"
                 "    \"available\": %.2f,\n"
                 "    \"used\": %.2f,\n"
-                "    \"usage_percent\": %lu,\n",
+                "    \"usage_percent\": %lu,\n"
+                "    \"swap_total\": %.2f,\n"
+                "    \"swap_used\": %.2f,\n"
+                "    \"cached\": %.2f,\n"
+                "    \"buffers\": %.2f,\n"
+                "    \"dirty\": %.2f,\n"
+                "    \"hugepages\": {\"total\": %llu, \"free\": %llu, \"size_kb\": %llu},\n",
                 bytesToGB(memInfo->totalPhys),
                 bytesToGB(memInfo->availPhys),
                 bytesToGB(memInfo->usedPhys),
-                memInfo->memoryLoad);
+                (unsigned long)memInfo->memoryLoad,
+                bytesToGB(memInfo->totalSwap),
+                bytesToGB(memInfo->totalSwap - memInfo->freeSwap),
+                bytesToGB(memInfo->cached),
+                bytesToGB(memInfo->buffers),
+                bytesToGB(memInfo->dirty),
+                (unsigned long long)memInfo->hugePagesTotal,
+                (unsigned long long)memInfo->hugePagesFree,
+                (unsigned long long)(memInfo->hugePageSize / 1024));
     appendString(buffer, bufferSize, position, temp);
 
     // RAM slots
     appendString(buffer, bufferSize, position, "    \"ram_slots\": [\n");
-    for (UINT i = 0; i < memInfo->slotList.count; i++)
+    UINT slotCount = ramSlots ? ramSlots->count : 0;
+    for (UINT i = 0; i < slotCount; i++)
     {
-        RAMSlotInfo *slot = &memInfo->slotList.slots[i];
+        RAMSlotInfo *slot = &ramSlots->slots[i];
         _snprintf_s(temp, sizeof(temp), _TRUNCATE,
                     "      {\n"
                     "        \"location\": \"%s\",\n"
@@ -227,7 +358,7 @@ static void appendMemoryInfo(char **buffer, size_t *bufferSize, size_t *position
                     getRAMSpeed(slot),
                     getRAMConfiguredSpeed(slot),
                     getRAMManufacturer(slot),
-                    i < memInfo->slotList.count - 1 ? ",\n" : "\n");
+                    i < slotCount - 1 ? ",\n" : "\n");
         appendString(buffer, bufferSize, position, temp);
     }
     appendString(buffer, bufferSize, position, "    ]\n");
@@ -238,45 +369,147 @@ static void appendMemoryInfo(char **buffer, size_t *bufferSize, size_t *position
  * @brief Formats storage information into JSON
  *
  * Creates a JSON array of storage devices containing:
- * - Drive letters and types
- * - Model and interface information
- * - Capacity and space usage
+ * - Drive letters, mount points and types
+ * - Block device and filesystem
+ * - Model, interface and rotational information
+ * - Disk capacity, volume capacity and space usage
+ * - Throughput, service time and utilization of the volume's
+ *   block device, when its activity was sampled
  *
  * @param buffer Output buffer
  * @param bufferSize Buffer size
  * @param position Current position
  * @param storageList List of storage devices
+ * @param diskIO Block device activity, NULL to omit it
  */
-static void appendStorageInfo(char **buffer, size_t *bufferSize, size_t *position, StorageList *storageList)
+static void appendStorageInfo(char **buffer, size_t *bufferSize, size_t *position, StorageList *storageList,
+                              DiskIOList *diskIO)
 {
     appendString(buffer, bufferSize, position, "  \"storage\": [\n");
     for (UINT i = 0; i < storageList->count; i++)
     {
-        char temp[1024];
+        char temp[2048];
+        char mountPoint[2 * STORAGE_MOUNT_PATH_LENGTH];
         LogicalDiskInfo *disk = &storageList->disks[i];
+        escapeJSONString(disk->mountPoint, mountPoint, sizeof(mountPoint));
         _snprintf_s(temp, sizeof(temp), _TRUNCATE,
                     "    {\n"
                     "      \"drive\": \"%s\",\n"
+                    "      \"mount_point\": \"%s\",\n"
+                    "      \"device\": \"%s\",\n"
+                    "      \"file_system\": \"%s\",\n"
                     "      \"type\": \"%s\",\n"
                     "      \"model\": \"%s\",\n"
                     "      \"interface\": \"%s\",\n"
+                    "      \"rotational\": %s,\n"
+                    "      \"disk_size\": %.2f,\n"
                     "      \"total_size\": %.2f,\n"
                     "      \"free_space\": %.2f,\n"
-                    "      \"used_space\": %.2f\n"
-                    "    }%s",
+                    "      \"used_space\": %.2f",
                     getDiskDrive(disk),
+                    mountPoint,
+                    disk->device,
+                    disk->fileSystem,
                     getDiskType(disk),
                     getDiskModel(disk),
                     getDiskInterface(disk),
+                    disk->rotational ? "true" : "false",
+                    disk->diskSize,
                     getDiskTotalSize(disk),
                     getDiskFreeSpace(disk),
-                    getDiskTotalSize(disk) - getDiskFreeSpace(disk),
-                    i < storageList->count - 1 ? ",\n" : "\n");
+                    getDiskTotalSize(disk) - getDiskFreeSpace(disk));
         appendString(buffer, bufferSize, position, temp);
+
+        const DiskIOStats *io = findDiskIO(diskIO, disk->device);
+        if (io)
+        {
+            _snprintf_s(temp, sizeof(temp), _TRUNCATE,
+                        ",\n"
+                        "      \"io\": {\n"
+                        "        \"read_iops\": %.1f,\n"
+                        "        \"write_iops\": %.1f,\n"
+                        "        \"read_bytes_per_sec\": %.0f,\n"
+                        "        \"write_bytes_per_sec\": %.0f,\n"
+                        "        \"service_time_ms\": %.2f,\n"
+                        "        \"utilization\": %.1f\n"
+                        "      }",
+                        io->readIOPS,
+                        io->writeIOPS,
+                        io->readBytesPerSec,
+                        io->writeBytesPerSec,
+                        io->serviceTimeMs,
+                        io->utilization);
+            appendString(buffer, bufferSize, position, temp);
+        }
+        appendString(buffer, bufferSize, position, i < storageList->count - 1 ? "\n    },\n" : "\n    }\n");
     }
     appendString(buffer, bufferSize, position, "  ],\n");
 }
 
+/**
+ * @brief Formats one network adapter into JSON
+ *
+ * Creates a JSON object containing:
+ * - Name, MAC address and first IPv4 address
+ * - Connection status and operational state
+ * - Every IPv4 and IPv6 address with its prefix length
+ * - Traffic rates, errors and drops since the previous tick
+ *
+ * @param buffer Output buffer
+ * @param bufferSize Buffer size
+ * @param position Current position
+ * @param networkList List holding the adapter's addresses
+ * @param adapter Adapter to format
+ */
+static void appendNetworkAdapter(char **buffer, size_t *bufferSize, size_t *position, NetworkList *networkList,
+                                 NetworkAdapterInfo *adapter)
+{
+    char temp[1024];
+    _snprintf_s(temp, sizeof(temp), _TRUNCATE,
+                "      {\n"
+                "        \"name\": \"%s\",\n"
+                "        \"mac_address\": \"%s\",\n"
+                "        \"ip_address\": \"%s\",\n"
+                "        \"status\": \"%s\",\n"
+                "        \"oper_state\": \"%s\",\n"
+                "        \"addresses\": [",
+                getAdapterName(adapter),
+                getAdapterMacAddress(adapter),
+                getAdapterIPAddress(adapter),
+                getAdapterStatus(adapter),
+                getAdapterOperState(adapter));
+    appendString(buffer, bufferSize, position, temp);
+
+    for (UINT i = 0; i < adapter->addressCount && networkList->addresses; i++)
+    {
+        NetworkAddress *address = &networkList->addresses[adapter->firstAddress + i];
+        _snprintf_s(temp, sizeof(temp), _TRUNCATE, "%s\"%s/%u\"", i > 0 ? ", " : "",
+                    address->address, address->prefixLength);
+        appendString(buffer, bufferSize, position, temp);
+    }
+
+    _snprintf_s(temp, sizeof(temp), _TRUNCATE,
+                "],\n"
+                "        \"rx_bytes_per_sec\": %.0f,\n"
+                "        \"tx_bytes_per_sec\": %.0f,\n"
+                "        \"rx_packets_per_sec\": %.1f,\n"
+                "        \"tx_packets_per_sec\": %.1f,\n"
+                "        \"rx_errors\": %llu,\n"
+                "        \"tx_errors\": %llu,\n"
+                "        \"rx_dropped\": %llu,\n"
+                "        \"tx_dropped\": %llu\n"
+                "      }",
+                adapter->rxBytesPerSec,
+                adapter->txBytesPerSec,
+                adapter->rxPacketsPerSec,
+                adapter->txPacketsPerSec,
+                adapter->rxErrors,
+                adapter->txErrors,
+                adapter->rxDropped,
+                adapter->txDropped);
+    appendString(buffer, bufferSize, position, temp);
+}
+
 /**
  * @brief Formats network adapter information into JSON
  *
@@ -304,19 +537,7 @@ static void appendNetworkInfo(char **buffer, size_t *bufferSize, size_t *positio
         {
             if (!firstEthernet)
                 appendString(buffer, bufferSize, position, ",\n");
-            char temp[1024];
-            _snprintf_s(temp, sizeof(temp), _TRUNCATE,
-                        "      {\n"
-                        "        \"name\": \"%s\",\n"
-                        "        \"mac_address\": \"%s\",\n"
-                        "        \"ip_address\": \"%s\",\n"
-                        "        \"status\": \"%s\"\n"
-                        "      }",
-                        getAdapterName(adapter),
-                        getAdapterMacAddress(adapter),
-                        getAdapterIPAddress(adapter),
-                        getAdapterStatus(adapter));
-            appendString(buffer, bufferSize, position, temp);
+            appendNetworkAdapter(buffer, bufferSize, position, networkList, adapter);
             firstEthernet = FALSE;
         }
     }
@@ -332,19 +553,7 @@ static void appendNetworkInfo(char **buffer, size_t *bufferSize, size_t *positio
         {
             if (!firstWiFi)
                 appendString(buffer, bufferSize, position, ",\n");
-            char temp[1024];
-            _snprintf_s(temp, sizeof(temp), _TRUNCATE,
-                        "      {\n"
-                        "        \"name\": \"%s\",\n"
-                        "        \"mac_address\": \"%s\",\n"
-                        "        \"ip_address\": \"%s\",\n"
-                        "        \"status\": \"%s\"\n"
-                        "      }",
-                        getAdapterName(adapter),
-                        getAdapterMacAddress(adapter),
-                        getAdapterIPAddress(adapter),
-                        getAdapterStatus(adapter));
-            appendString(buffer, bufferSize, position, temp);
+            appendNetworkAdapter(buffer, bufferSize, position, networkList, adapter);
             firstWiFi = FALSE;
         }
     }
@@ -464,83 +673,223 @@ static void appendMonitorInfo(char **buffer, size_t *bufferSize, size_t *positio
                     i < monitorList->count - 1 ? ",\n" : "\n");
         appendString(buffer, bufferSize, position, temp);
     }
-    appendString(buffer, bufferSize, position, "  ]\n");
+    appendString(buffer, bufferSize, position, "  ],\n");
 }
 
 /**
- * @brief Generates a complete system information JSON string
+ * @brief Formats engine resource usage into JSON
  *
- * This function combines all hardware information into a single JSON object.
- * It handles:
- * 1. Dynamic buffer allocation and growth
- * 2. JSON structure formatting
- * 3. NULL parameter handling
- * 4. Memory cleanup on error
+ * Creates a JSON object containing:
+ * - Tick counter and duration
+ * - Monitoring thread CPU time and context switches
+ * - Heap allocations and peak usage
+ *
+ * @param buffer Output buffer
+ * @param bufferSize Buffer size
+ * @param position Current position
+ * @param overhead Engine statistics
+ */
+static void appendOverheadInfo(char **buffer, size_t *bufferSize, size_t *position, const MonitoringStats *overhead)
+{
+    char temp[1024];
+    _snprintf_s(temp, sizeof(temp), _TRUNCATE,
+                "  \"overhead\": {\n"
+                "    \"tick\": %llu,\n"
+                "    \"tick_ms\": %.3f,\n"
+                "    \"cpu_ms\": %.3f,\n"
+                "    \"total_cpu_ms\": %.3f,\n"
+                "    \"context_switches\": %llu,\n"
+                "    \"total_context_switches\": %llu,\n"
+                "    \"allocations\": %llu,\n"
+                "    \"allocated_bytes\": %llu,\n"
+                "    \"tick_peak_heap_bytes\": %llu,\n"
+                "    \"peak_heap_bytes\": %llu\n"
+                "  },\n",
+                overhead->tickCount,
+                overhead->lastTickMs,
+                overhead->lastTickCpuMs,
+                overhead->totalCpuMs,
+                overhead->lastTickContextSwitches,
+                overhead->totalContextSwitches,
+                overhead->lastTickAllocations,
+                overhead->lastTickAllocatedBytes,
+                overhead->lastTickPeakHeapBytes,
+                overhead->peakHeapBytes);
+    appendString(buffer, bufferSize, position, temp);
+}
+
+/**
+ * @brief Renders system information into a reusable buffer
  *
+ * This function:
+ * 1. Allocates the buffer on first use
+ * 2. Formats each component into JSON
+ * 3. Handles NULL components by omitting them
+ * 4. Keeps the grown buffer for the next render
+ *
+ * @param buffer Output buffer, zero-initialized before first use
  * @param gpuList GPU information
  * @param mbInfo Motherboard information
  * @param cpuList CPU information
+ * @param cpuLoad CPU utilization
+ * @param cpuFrequency Core clocks
  * @param memInfo Memory information
+ * @param ramSlots Installed RAM modules, rendered inside the memory section
  * @param storageList Storage information
+ * @param diskIO Block device activity, rendered inside the storage section
  * @param networkList Network information
  * @param audioList Audio device information
  * @param batteryInfo Battery information
  * @param monitorList Monitor information
- * @return char* Allocated JSON string, NULL if failed
- * @note Caller must free the returned string using freeJSONString()
+ * @param overhead Engine statistics, NULL to omit the section
+ * @return const char* Rendered document owned by buffer, NULL if failed
  */
-char *generateSystemInfoJSON(
+const char *renderSystemInfoJSON(
+    JSONBuffer *buffer,
     GPUList *gpuList,
     MotherboardInfo *mbInfo,
     CPUList *cpuList,
+    CPULoadInfo *cpuLoad,
+    CPUFrequencyInfo *cpuFrequency,
     MemoryInfo *memInfo,
+    RAMSlotList *ramSlots,
     StorageList *storageList,
+    DiskIOList *diskIO,
     NetworkList *networkList,
     AudioList *audioList,
     BatteryInfo *batteryInfo,
-    MonitorList *monitorList)
+    MonitorList *monitorList,
+    const MonitoringStats *overhead)
 {
-    size_t bufferSize = JSON_BUFFER_SIZE;
-    size_t position = 0;
-    char *jsonBuffer = (char *)malloc(bufferSize);
-    if (!jsonBuffer)
+    if (!buffer)
         return NULL;
 
+    if (!buffer->data)
+    {
+        buffer->data = (char *)festMalloc(JSON_BUFFER_SIZE);
+        if (!buffer->data)
+            return NULL;
+        buffer->size = JSON_BUFFER_SIZE;
+    }
+
+    char **jsonBuffer = &buffer->data;
+    size_t *bufferSize = &buffer->size;
+    size_t position = 0;
+
     // Start JSON object
-    appendString(&jsonBuffer, &bufferSize, &position, "{\n");
+    appendString(jsonBuffer, bufferSize, &position, "{\n");
 
     // Add information for each component
     if (gpuList)
-        appendGPUInfo(&jsonBuffer, &bufferSize, &position, gpuList);
+        appendGPUInfo(jsonBuffer, bufferSize, &position, gpuList);
     if (mbInfo)
-        appendMotherboardInfo(&jsonBuffer, &bufferSize, &position, mbInfo);
+        appendMotherboardInfo(jsonBuffer, bufferSize, &position, mbInfo);
     if (cpuList)
-        appendCPUInfo(&jsonBuffer, &bufferSize, &position, cpuList);
+        appendCPUInfo(jsonBuffer, bufferSize, &position, cpuList);
+    if (cpuLoad)
+        appendCPULoadInfo(jsonBuffer, bufferSize, &position, cpuLoad);
+    if (cpuFrequency)
+        appendCPUFrequencyInfo(jsonBuffer, bufferSize, &position, cpuFrequency);
     if (memInfo)
-        appendMemoryInfo(&jsonBuffer, &bufferSize, &position, memInfo);
+        appendMemoryInfo(jsonBuffer, bufferSize, &position, memInfo, ramSlots);
     if (storageList)
-        appendStorageInfo(&jsonBuffer, &bufferSize, &position, storageList);
+        appendStorageInfo(jsonBuffer, bufferSize, &position, storageList, diskIO);
     if (networkList)
-        appendNetworkInfo(&jsonBuffer, &bufferSize, &position, networkList);
+        appendNetworkInfo(jsonBuffer, bufferSize, &position, networkList);
     if (audioList)
-        appendAudioInfo(&jsonBuffer, &bufferSize, &position, audioList);
+        appendAudioInfo(jsonBuffer, bufferSize, &position, audioList);
     if (batteryInfo)
-        appendBatteryInfo(&jsonBuffer, &bufferSize, &position, batteryInfo);
+        appendBatteryInfo(jsonBuffer, bufferSize, &position, batteryInfo);
     if (monitorList)
-        appendMonitorInfo(&jsonBuffer, &bufferSize, &position, monitorList);
+        appendMonitorInfo(jsonBuffer, bufferSize, &position, monitorList);
+    if (overhead)
+        appendOverheadInfo(jsonBuffer, bufferSize, &position, overhead);
 
     // Remove trailing comma if exists
-    if (position > 2 && jsonBuffer[position - 2] == ',')
+    if (position > 2 && (*jsonBuffer)[position - 2] == ',')
     {
         position -= 2;
-        jsonBuffer[position] = '\n';
-        jsonBuffer[position + 1] = '\0';
+        (*jsonBuffer)[position] = '\n';
+        (*jsonBuffer)[position + 1] = '\0';
     }
 
     // Close JSON object
-    appendString(&jsonBuffer, &bufferSize, &position, "}\n");
+    appendString(jsonBuffer, bufferSize, &position, "}\n");
+
+    buffer->length = position;
+    return buffer->data;
+}
+
+/**
+ * @brief Releases the memory of a reusable JSON buffer
+ *
+ * @param buffer Buffer to release, zeroed afterwards
+ */
+void releaseJSONBuffer(JSONBuffer *buffer)
+{
+    if (!buffer)
+        return;
+
+    if (buffer->data)
+        festFree(buffer->data);
+    buffer->data = NULL;
+    buffer->size = 0;
+    buffer->length = 0;
+}
+
+/**
+ * @brief Generates a complete system information JSON string
+ *
+ * This function combines all hardware information into a single JSON object.
+ * It handles:
+ * 1. Dynamic buffer allocation and growth
+ * 2. JSON structure formatting
+ * 3. NULL parameter handling
+ * 4. Memory cleanup on error
+ *
+ * @param gpuList GPU information
+ * @param mbInfo Motherboard information
+ * @param cpuList CPU information
+ * @param cpuLoad CPU utilization
+ * @param cpuFrequency Core clocks
+ * @param memInfo Memory information
+ * @param ramSlots Installed RAM modules, rendered inside the memory section
+ * @param storageList Storage information
+ * @param diskIO Block device activity, rendered inside the storage section
+ * @param networkList Network information
+ * @param audioList Audio device information
+ * @param batteryInfo Battery information
+ * @param monitorList Monitor information
+ * @param overhead Engine statistics, NULL to omit the section
+ * @return char* Allocated JSON string, NULL if failed
+ * @note Caller must free the returned string using freeJSONString()
+ */
+char *generateSystemInfoJSON(
+    GPUList *gpuList,
+    MotherboardInfo *mbInfo,
+    CPUList *cpuList,
+    CPULoadInfo *cpuLoad,
+    CPUFrequencyInfo *cpuFrequency,
+    MemoryInfo *memInfo,
+    RAMSlotList *ramSlots,
+    StorageList *storageList,
+    DiskIOList *diskIO,
+    NetworkList *networkList,
+    AudioList *audioList,
+    BatteryInfo *batteryInfo,
+    MonitorList *monitorList,
+    const MonitoringStats *overhead)
+{
+    JSONBuffer buffer = {0};
+    if (!renderSystemInfoJSON(&buffer, gpuList, mbInfo, cpuList, cpuLoad, cpuFrequency, memInfo, ramSlots, storageList,
+                              diskIO, networkList, audioList, batteryInfo, monitorList, overhead))
+    {
+        releaseJSONBuffer(&buffer);
+        return NULL;
+    }
 
-    return jsonBuffer;
+    // Ownership of the document passes to the caller
+    return buffer.data;
 }
 
 /**
@@ -551,5 +900,5 @@ char *generateSystemInfoJSON(
 void freeJSONString(char *jsonStr)
 {
     if (jsonStr)
-        free(jsonStr);
+        festFree(jsonStr);
 }
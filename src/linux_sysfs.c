@@ -0,0 +1,279 @@
+#include "linux_sysfs.h"
+#include "fest_alloc.h"
+#include <fcntl.h>
+#include <unistd.h>
+
+static char g_sysfsRoot[SYSFS_PATH_LENGTH] = ""; // Prepended to every path
+
+/**
+ * @brief Redirects every sysfs and procfs read to another root
+ *
+ * @param root Directory prepended to every path, NULL or "" for the real root
+ */
+void setSysfsRoot(const char *root)
+{
+    if (!root || strcpy_s(g_sysfsRoot, sizeof(g_sysfsRoot), root) != 0)
+        g_sysfsRoot[0] = '\0';
+
+    // "fixtures/host/" and "fixtures/host" name the same root
+    size_t length = strlen(g_sysfsRoot);
+    while (length > 0 && g_sysfsRoot[length - 1] == '/')
+        g_sysfsRoot[--length] = '\0';
+}
+
+/**
+ * @brief Returns the directory prepended to every path
+ *
+ * @return const char* Root, "" for the real root
+ */
+const char *getSysfsRoot(void)
+{
+    return g_sysfsRoot;
+}
+
+/**
+ * @brief Prepends the root to an absolute sysfs or procfs path
+ *
+ * @param relative Absolute path below the root
+ * @param path Buffer receiving the full path
+ * @param pathSize Size of the buffer in bytes
+ * @return BOOL TRUE if the path fit
+ */
+BOOL buildSysfsPath(const char *relative, char *path, size_t pathSize)
+{
+    return _snprintf_s(path, pathSize, _TRUNCATE, "%s%s", g_sysfsRoot, relative) >= 0;
+}
+
+/**
+ * @brief Opens a file below the root for reading
+ *
+ * @param relative Absolute path below the root
+ * @return int File descriptor, -1 if failed
+ */
+int openSysfsFile(const char *relative)
+{
+    char path[SYSFS_PATH_LENGTH];
+    if (!buildSysfsPath(relative, path, sizeof(path)))
+        return -1;
+    return open(path, O_RDONLY | O_CLOEXEC);
+}
+
+/**
+ * @brief Opens a directory below the root
+ *
+ * @param relative Absolute path below the root
+ * @return DIR* Directory stream, NULL if failed
+ */
+DIR *openSysfsDir(const char *relative)
+{
+    char path[SYSFS_PATH_LENGTH];
+    if (!buildSysfsPath(relative, path, sizeof(path)))
+        return NULL;
+    return opendir(path);
+}
+
+/**
+ * @brief Rereads a file kept open across ticks
+ *
+ * Short reads are continued, procfs hands out large files
+ * one page at a time.
+ *
+ * @param fd Descriptor from openSysfsFile()
+ * @param buffer Buffer receiving the content, always terminated
+ * @param bufferSize Size of the buffer in bytes
+ * @return size_t Bytes read, 0 if failed
+ */
+size_t preadSysfsFile(int fd, char *buffer, size_t bufferSize)
+{
+    if (fd < 0 || !buffer || bufferSize == 0)
+        return 0;
+
+    size_t length = 0;
+    while (length < bufferSize - 1)
+    {
+        ssize_t got = pread(fd, buffer + length, bufferSize - 1 - length, (off_t)length);
+        if (got < 0 && errno == EINTR)
+            continue;
+        if (got <= 0)
+            break;
+        length += (size_t)got;
+    }
+    buffer[length] = '\0';
+    return length;
+}
+
+/**
+ * @brief Reads a whole file below the root
+ *
+ * @param relative Absolute path below the root
+ * @param buffer Buffer receiving the content, always terminated
+ * @param bufferSize Size of the buffer in bytes
+ * @return size_t Bytes read, 0 if the file is missing or empty
+ */
+size_t readSysfsFile(const char *relative, char *buffer, size_t bufferSize)
+{
+    if (buffer && bufferSize > 0)
+        buffer[0] = '\0';
+
+    int fd = openSysfsFile(relative);
+    if (fd < 0)
+        return 0;
+
+    size_t length = preadSysfsFile(fd, buffer, bufferSize);
+    close(fd);
+    return length;
+}
+
+/**
+ * @brief Reads a whole file of unknown size below the root
+ *
+ * A read that fills the buffer may have been cut short, so the
+ * file is reread from offset 0 into a buffer twice the size.
+ *
+ * @param relative Absolute path below the root
+ * @param length Receives the content length, may be NULL
+ * @return char* Terminated content, NULL if failed
+ */
+char *readSysfsFileAlloc(const char *relative, size_t *length)
+{
+    int fd = openSysfsFile(relative);
+    if (fd < 0)
+        return NULL;
+
+    size_t size = SYSFS_READ_INITIAL;
+    size_t used = 0;
+    char *buffer = (char *)festMalloc(size);
+    while (buffer)
+    {
+        used = preadSysfsFile(fd, buffer, size);
+        if (used < size - 1)
+            break;
+
+        char *grown = (char *)festRealloc(buffer, size * 2);
+        if (!grown)
+        {
+            festFree(buffer);
+            buffer = NULL;
+            break;
+        }
+        buffer = grown;
+        size *= 2;
+    }
+    close(fd);
+
+    if (buffer && length)
+        *length = used;
+    return buffer;
+}
+
+/**
+ * @brief Reads the first line of a sysfs attribute
+ *
+ * @param relative Absolute path below the root
+ * @param value Buffer receiving the trimmed line
+ * @param valueSize Size of the buffer in bytes
+ * @return BOOL TRUE if the attribute was read and is not empty
+ */
+BOOL readSysfsString(const char *relative, char *value, size_t valueSize)
+{
+    char content[256];
+    if (!value || valueSize == 0)
+        return FALSE;
+    value[0] = '\0';
+
+    if (readSysfsFile(relative, content, sizeof(content)) == 0)
+        return FALSE;
+
+    const char *start = content;
+    while (*start == ' ' || *start == '\t')
+        start++;
+    const char *end = start;
+    while (*end && *end != '\n')
+        end++;
+    while (end > start && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r'))
+        end--;
+
+    size_t length = (size_t)(end - start);
+    if (length >= valueSize)
+        length = valueSize - 1;
+    memcpy(value, start, length);
+    value[length] = '\0';
+    return length > 0;
+}
+
+/**
+ * @brief Reads a decimal sysfs attribute
+ *
+ * @param relative Absolute path below the root
+ * @param value Receives the number
+ * @return BOOL TRUE if the attribute starts with a decimal number
+ */
+BOOL readSysfsUInt64(const char *relative, UINT64 *value)
+{
+    char content[32];
+    if (readSysfsFile(relative, content, sizeof(content)) == 0)
+        return FALSE;
+
+    const char *cursor = content;
+    while (*cursor == ' ' || *cursor == '\t')
+        cursor++;
+    if (*cursor < '0' || *cursor > '9')
+        return FALSE;
+
+    UINT64 number = 0;
+    while (*cursor >= '0' && *cursor <= '9')
+        number = number * 10 + (UINT64)(*cursor++ - '0');
+    *value = number;
+    return TRUE;
+}
+
+/**
+ * @brief Reads the target of a sysfs symbolic link
+ *
+ * @param relative Absolute path of the link below the root
+ * @param target Buffer receiving the terminated link target
+ * @param targetSize Size of the buffer in bytes
+ * @return BOOL TRUE if the link was read and fit
+ */
+BOOL readSysfsLink(const char *relative, char *target, size_t targetSize)
+{
+    char path[SYSFS_PATH_LENGTH];
+    if (targetSize == 0 || !buildSysfsPath(relative, path, sizeof(path)))
+        return FALSE;
+
+    ssize_t length = readlink(path, target, targetSize);
+    if (length <= 0 || (size_t)length >= targetSize)
+        return FALSE;
+
+    target[length] = '\0';
+    return TRUE;
+}
+
+/**
+ * @brief Returns the number of possible logical cores
+ *
+ * @return UINT Highest possible core number plus one, 0 if the list is missing
+ */
+UINT readSysfsPossibleCPUs(void)
+{
+    char possible[256];
+    UINT last = 0;
+    BOOL found = FALSE;
+
+    if (!readSysfsString("/sys/devices/system/cpu/possible", possible, sizeof(possible)))
+        return 0;
+
+    for (const char *cursor = possible; *cursor;)
+    {
+        if (*cursor < '0' || *cursor > '9')
+        {
+            cursor++;
+            continue;
+        }
+        last = 0;
+        while (*cursor >= '0' && *cursor <= '9')
+            last = last * 10 + (UINT)(*cursor++ - '0');
+        found = TRUE;
+    }
+    return found ? last + 1 : 0;
+}
@@ -13,8 +13,10 @@
 #include "battery_info.h"
 #include "monitor_info.h"
 #include "json_structure.h"
-#include <windows.h>
+#include "fest_platform.h"
+#ifdef _WIN32
 #include <process.h>
+#endif
 
 /**
  * @brief Container for static hardware information
@@ -26,6 +28,7 @@
  * - Network adapters
  * - Audio devices
  * - Monitor setup
+ * - RAM modules
  */
 typedef struct
 {
@@ -35,6 +38,7 @@ typedef struct
     NetworkList *networkList;
     AudioList *audioList;
     MonitorList *monitorList;
+    RAMSlotList *ramSlots;
 } StaticInfo;
 
 /**
@@ -81,6 +85,7 @@ typedef struct
  * - Network adapters
  * - Audio devices
  * - Monitor configuration
+ * - RAM modules
  *
  * @param arg Pointer to ThreadContext structure
  * @return unsigned Thread exit code
@@ -99,6 +104,7 @@ static unsigned __stdcall getStaticHardwareInfoThread(void *arg)
         ctx->staticInfo->networkList = getNetworkList();
         ctx->staticInfo->audioList = getAudioList();
         ctx->staticInfo->monitorList = getMonitorList();
+        ctx->staticInfo->ramSlots = getRAMSlotList();
         ReleaseMutex(ctx->mutex);
     }
 
@@ -144,6 +150,7 @@ static unsigned __stdcall getDynamicInfoThread(void *arg)
  * - Network adapters
  * - Audio devices
  * - Monitor list
+ * - RAM modules
  *
  * @param info Pointer to StaticInfo structure
  */
@@ -163,6 +170,8 @@ static void cleanupStaticInfo(StaticInfo *info)
         freeAudioList(info->audioList);
     if (info->monitorList)
         freeMonitorList(info->monitorList);
+    if (info->ramSlots)
+        freeRAMSlotList(info->ramSlots);
 }
 
 /**
@@ -229,9 +238,9 @@ int main()
 
         // Generate and output JSON
         char *jsonOutput = generateSystemInfoJSON(
-            staticInfo.gpuList, staticInfo.mbInfo, staticInfo.cpuList,
-            dynamicInfo.memInfo, dynamicInfo.storageList, staticInfo.networkList,
-            staticInfo.audioList, dynamicInfo.batteryInfo, staticInfo.monitorList);
+            staticInfo.gpuList, staticInfo.mbInfo, staticInfo.cpuList, NULL, NULL,
+            dynamicInfo.memInfo, staticInfo.ramSlots, dynamicInfo.storageList, NULL, staticInfo.networkList,
+            staticInfo.audioList, dynamicInfo.batteryInfo, staticInfo.monitorList, NULL);
 
         if (jsonOutput)
         {
@@ -1,7 +1,13 @@
 #include "memory_info.h"
+#include "fest_alloc.h"
 #include "wmi_helper.h"
+#include "smbios.h"
 #include <stdio.h>
 
+#ifdef _WIN32
+#include <psapi.h>
+#endif
+
 /**
  * @brief Converts bytes to gigabytes
  *
@@ -13,40 +19,70 @@ double bytesToGB(UINT64 bytes)
     return (double)bytes / (1024.0 * 1024.0 * 1024.0);
 }
 
+#ifdef _WIN32
+/**
+ * @brief Win32_PhysicalMemory properties read into RAMSlotInfo
+ */
+static const WMIPropertySpec g_PhysicalMemoryProperties[] = {
+    WMI_UINT64_PROPERTY(L"Capacity", RAMSlotInfo, capacity),
+    WMI_UINT32_PROPERTY(L"Speed", RAMSlotInfo, speed),
+    WMI_UINT32_PROPERTY(L"ConfiguredClockSpeed", RAMSlotInfo, configuredSpeed),
+    WMI_STRING_PROPERTY(L"DeviceLocator", RAMSlotInfo, slot),
+    WMI_STRING_PROPERTY(L"Manufacturer", RAMSlotInfo, manufacturer)};
+
+static const WMIQuerySpec g_PhysicalMemoryQuery = {
+    L"Win32_PhysicalMemory", g_PhysicalMemoryProperties, WMI_PROPERTY_COUNT(g_PhysicalMemoryProperties), NULL};
+
+/**
+ * @brief Fills defaults for properties the module did not report
+ *
+ * @param pclsObj Win32_PhysicalMemory object
+ * @param row RAMSlotInfo with projected properties stored
+ * @param context Unused
+ * @return BOOL TRUE, every module is kept
+ */
+static BOOL completePhysicalMemory(IWbemClassObject *pclsObj, void *row, void *context)
+{
+    RAMSlotInfo *slot = (RAMSlotInfo *)row;
+
+    // Use rated speed when the configured speed is unknown
+    if (slot->configuredSpeed == 0)
+        slot->configuredSpeed = slot->speed;
+
+    return TRUE;
+}
+
 /**
- * @brief Retrieves comprehensive memory information from the system
+ * @brief Retrieves system memory counters
  *
- * This function collects two types of memory information:
- * 1. System-wide memory statistics:
- *    - Total physical memory
- *    - Available memory
- *    - Memory usage percentage
+ * This function collects:
+ * - Total physical memory
+ * - Available memory
+ * - Memory usage percentage
+ * - Page cache and page file usage
  *
- * 2. Physical RAM slot information via WMI:
- *    - Capacity per slot
- *    - Speed ratings
- *    - Slot locations
- *    - Manufacturer details
+ * Both calls are plain counter reads; the RAM modules are
+ * enumerated once by getRAMSlotList().
  *
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
  * @return MemoryInfo* Pointer to allocated memory information structure, NULL if failed
- * @note Caller is responsible for freeing the returned structure using freeMemoryInfo()
+ * @note Without an arena, caller is responsible for freeing the returned structure using freeMemoryInfo()
  */
-MemoryInfo *getMemoryInfo(void)
+MemoryInfo *collectMemoryInfo(SnapshotArena *arena)
 {
-    MemoryInfo *info = (MemoryInfo *)malloc(sizeof(MemoryInfo));
+    MemoryInfo *info = (MemoryInfo *)snapshotAlloc(arena, sizeof(MemoryInfo));
     if (!info)
         return NULL;
 
-    // Initialize RAM slot list
-    info->slotList.slots = NULL;
-    info->slotList.count = 0;
+    // Counters without a Windows equivalent stay empty
+    memset(info, 0, sizeof(MemoryInfo));
 
     // Query system-wide memory statistics
     MEMORYSTATUSEX memStatus;
     memStatus.dwLength = sizeof(MEMORYSTATUSEX);
     if (!GlobalMemoryStatusEx(&memStatus))
     {
-        free(info);
+        snapshotFree(arena, info);
         return NULL;
     }
 
@@ -56,100 +92,96 @@ MemoryInfo *getMemoryInfo(void)
     info->usedPhys = memStatus.ullTotalPhys - memStatus.ullAvailPhys;
     info->memoryLoad = memStatus.dwMemoryLoad;
 
-    // Initialize WMI for detailed RAM information
-    WMISession *session = initializeWMI();
-    if (!session)
+    // Page cache and the page file part of the commit limit
+    PERFORMANCE_INFORMATION performance;
+    performance.cb = sizeof(PERFORMANCE_INFORMATION);
+    if (GetPerformanceInfo(&performance, sizeof(PERFORMANCE_INFORMATION)))
     {
-        free(info);
-        return NULL;
+        UINT64 pageSize = performance.PageSize;
+        UINT64 swapPages = performance.CommitLimit > performance.PhysicalTotal
+                               ? performance.CommitLimit - performance.PhysicalTotal
+                               : 0;
+        UINT64 headroom = performance.CommitLimit > performance.CommitTotal
+                              ? performance.CommitLimit - performance.CommitTotal
+                              : 0;
+        info->cached = (UINT64)performance.SystemCache * pageSize;
+        info->totalSwap = swapPages * pageSize;
+        info->freeSwap = (headroom < swapPages ? headroom : swapPages) * pageSize;
     }
 
-    // Query physical memory modules
-    IEnumWbemClassObject *pEnumerator = NULL;
-    if (executeWQLQuery(session, L"SELECT * FROM Win32_PhysicalMemory", &pEnumerator))
+    return info;
+}
+
+/**
+ * @brief Retrieves the installed RAM modules through WMI
+ *
+ * Queries Win32_PhysicalMemory for:
+ * - Capacity per slot
+ * - Speed ratings
+ * - Slot locations
+ * - Manufacturer details
+ *
+ * @return RAMSlotList* Pointer to allocated list of RAM modules, NULL if failed
+ */
+static RAMSlotList *queryWMIRAMSlotList(void)
+{
+    RAMSlotList *list = (RAMSlotList *)festMalloc(sizeof(RAMSlotList));
+    if (!list)
+        return NULL;
+
+    list->slots = NULL;
+    list->count = 0;
+
+    // Lease the thread's pooled WMI connection
+    WMISession *session = acquireWMISession();
+    if (!session)
     {
-        IWbemClassObject *pclsObj = NULL;
-        ULONG uReturn = 0;
-
-        // First pass: Count total number of RAM slots
-        while (SUCCEEDED(pEnumerator->lpVtbl->Next(pEnumerator, WBEM_INFINITE, 1, &pclsObj, &uReturn)) && uReturn != 0)
-        {
-            info->slotList.count++;
-            pclsObj->lpVtbl->Release(pclsObj);
-        }
-        pEnumerator->lpVtbl->Release(pEnumerator);
-
-        if (info->slotList.count > 0)
-        {
-            // Allocate memory for RAM slot array
-            info->slotList.slots = (RAMSlotInfo *)malloc(sizeof(RAMSlotInfo) * info->slotList.count);
-            if (!info->slotList.slots)
-            {
-                cleanupWMI(session);
-                free(info);
-                return NULL;
-            }
-
-            // Second pass: Collect detailed RAM module information
-            if (executeWQLQuery(session, L"SELECT * FROM Win32_PhysicalMemory", &pEnumerator))
-            {
-                UINT i = 0;
-                while (SUCCEEDED(pEnumerator->lpVtbl->Next(pEnumerator, WBEM_INFINITE, 1, &pclsObj, &uReturn)) && uReturn != 0)
-                {
-                    RAMSlotInfo *slot = &info->slotList.slots[i];
-                    VARIANT vtProp;
-
-                    // Get module capacity in bytes
-                    if (SUCCEEDED(pclsObj->lpVtbl->Get(pclsObj, L"Capacity", 0, &vtProp, 0, 0)) && vtProp.vt != VT_NULL)
-                    {
-                        slot->capacity = _wtoi64(vtProp.bstrVal);
-                    }
-                    else
-                    {
-                        slot->capacity = 0;
-                    }
-                    VariantClear(&vtProp);
-
-                    // Get rated memory speed in MHz
-                    if (SUCCEEDED(pclsObj->lpVtbl->Get(pclsObj, L"Speed", 0, &vtProp, 0, 0)) && vtProp.vt != VT_NULL)
-                    {
-                        slot->speed = vtProp.uintVal;
-                    }
-                    else
-                    {
-                        slot->speed = 0;
-                    }
-                    VariantClear(&vtProp);
-
-                    // Get actual configured speed in MHz
-                    if (SUCCEEDED(pclsObj->lpVtbl->Get(pclsObj, L"ConfiguredClockSpeed", 0, &vtProp, 0, 0)) && vtProp.vt != VT_NULL)
-                    {
-                        slot->configuredSpeed = vtProp.uintVal;
-                    }
-                    else
-                    {
-                        slot->configuredSpeed = slot->speed; // Use rated speed as fallback
-                    }
-                    VariantClear(&vtProp);
-
-                    // Get physical slot location identifier
-                    getWMIPropertyString(pclsObj, L"DeviceLocator", slot->slot, sizeof(slot->slot));
-
-                    // Get module manufacturer information
-                    getWMIPropertyString(pclsObj, L"Manufacturer", slot->manufacturer, sizeof(slot->manufacturer));
-
-                    pclsObj->lpVtbl->Release(pclsObj);
-                    i++;
-                }
-                pEnumerator->lpVtbl->Release(pEnumerator);
-            }
-        }
+        festFree(list);
+        return NULL;
     }
 
-    cleanupWMI(session);
-    return info;
+    // Query the physical memory module properties we report, in one pass
+    WMIRowVector rows;
+    initWMIRowVector(&rows, NULL, sizeof(RAMSlotInfo), 4);
+    if (!queryWMIProjected(session, &g_PhysicalMemoryQuery, &rows, completePhysicalMemory, NULL))
+        releaseWMIRowVector(&rows);
+
+    list->slots = (RAMSlotInfo *)rows.rows;
+    list->count = rows.count;
+
+    releaseWMISession(session);
+    return list;
+}
+
+/**
+ * @brief Retrieves the installed RAM modules
+ *
+ * The modules are decoded from the SMBIOS type 17 structures that
+ * Win32_PhysicalMemory is built from. WMI is only queried when the
+ * firmware table cannot be read.
+ *
+ * @return RAMSlotList* Pointer to allocated list of RAM modules, NULL if failed
+ * @note Caller is responsible for freeing the returned list using freeRAMSlotList()
+ */
+RAMSlotList *getRAMSlotList(void)
+{
+    RAMSlotList *list = getSMBIOSRAMSlotList();
+    return list ? list : queryWMIRAMSlotList();
 }
 
+/**
+ * @brief Retrieves memory information from the heap
+ *
+ * @return MemoryInfo* Pointer to allocated memory information, NULL if failed
+ * @note Caller is responsible for freeing the returned structure using freeMemoryInfo()
+ */
+MemoryInfo *getMemoryInfo(void)
+{
+    return collectMemoryInfo(NULL);
+}
+
+#endif // _WIN32
+
 /**
  * @brief Frees memory allocated for MemoryInfo structure
  *
@@ -158,12 +190,21 @@ MemoryInfo *getMemoryInfo(void)
 void freeMemoryInfo(MemoryInfo *info)
 {
     if (info)
+        festFree(info);
+}
+
+/**
+ * @brief Frees memory allocated for RAMSlotList structure
+ *
+ * @param list Pointer to RAMSlotList structure to be freed
+ */
+void freeRAMSlotList(RAMSlotList *list)
+{
+    if (list)
     {
-        if (info->slotList.slots)
-        {
-            free(info->slotList.slots);
-        }
-        free(info);
+        if (list->slots)
+            festFree(list->slots);
+        festFree(list);
     }
 }
 
@@ -0,0 +1,172 @@
+#include "memory_info.h"
+#include "linux_sysfs.h"
+#include <unistd.h>
+
+#define PROC_MEMINFO_PATH "/proc/meminfo" // System memory counters
+#define MEMINFO_BUFFER_SIZE 8192          // /proc/meminfo is about 1.5 KB
+
+/**
+ * @brief /proc/meminfo counters read by the collector
+ */
+typedef enum
+{
+    MEMINFO_TOTAL,
+    MEMINFO_FREE,
+    MEMINFO_AVAILABLE,
+    MEMINFO_BUFFERS,
+    MEMINFO_CACHED,
+    MEMINFO_SWAP_TOTAL,
+    MEMINFO_SWAP_FREE,
+    MEMINFO_DIRTY,
+    MEMINFO_HUGEPAGES_TOTAL,
+    MEMINFO_HUGEPAGES_FREE,
+    MEMINFO_HUGEPAGE_SIZE,
+    MEMINFO_FIELD_COUNT
+} MeminfoField;
+
+/**
+ * @brief Label of each counter, in MeminfoField order
+ */
+static const char *const g_MeminfoKeys[MEMINFO_FIELD_COUNT] = {
+    "MemTotal",
+    "MemFree",
+    "MemAvailable",
+    "Buffers",
+    "Cached",
+    "SwapTotal",
+    "SwapFree",
+    "Dirty",
+    "HugePages_Total",
+    "HugePages_Free",
+    "Hugepagesize"};
+
+/**
+ * @brief Reader state of the Linux collector, owned by the monitoring thread
+ */
+static struct
+{
+    int fd;                           // /proc/meminfo, kept open across ticks
+    char buffer[MEMINFO_BUFFER_SIZE]; // Content of the last read
+} g_LinuxMemory = {-1, {0}};
+
+/**
+ * @brief Parses /proc/meminfo in a single pass
+ *
+ * Every line is "Label:   value[ kB]". Labels are matched against
+ * the table of counters the collector reports; other lines are
+ * skipped. Values with a kB unit are converted to bytes, counts
+ * such as HugePages_Total are kept as they are.
+ *
+ * @param content Terminated /proc/meminfo content
+ * @param values Receives the counters, indexed by MeminfoField
+ * @return DWORD Bit (1 << field) of every counter found
+ */
+static DWORD parseMeminfo(const char *content, UINT64 values[MEMINFO_FIELD_COUNT])
+{
+    DWORD found = 0;
+    const DWORD all = (1UL << MEMINFO_FIELD_COUNT) - 1;
+
+    for (const char *line = content; *line && found != all;)
+    {
+        const char *colon = line;
+        while (*colon && *colon != ':' && *colon != '\n')
+            colon++;
+
+        if (*colon == ':')
+        {
+            size_t keyLength = (size_t)(colon - line);
+            for (UINT field = 0; field < MEMINFO_FIELD_COUNT; field++)
+            {
+                const char *key = g_MeminfoKeys[field];
+                if (strncmp(line, key, keyLength) != 0 || key[keyLength] != '\0')
+                    continue;
+
+                const char *cursor = colon + 1;
+                while (*cursor == ' ')
+                    cursor++;
+                UINT64 value = 0;
+                while (*cursor >= '0' && *cursor <= '9')
+                    value = value * 10 + (UINT64)(*cursor++ - '0');
+                if (cursor[0] == ' ' && cursor[1] == 'k' && cursor[2] == 'B')
+                    value *= 1024;
+
+                values[field] = value;
+                found |= 1UL << field;
+                break;
+            }
+        }
+
+        const char *next = strchr(colon, '\n');
+        if (!next)
+            break;
+        line = next + 1;
+    }
+    return found;
+}
+
+/**
+ * @brief Opens /proc/meminfo for the monitoring session
+ *
+ * @return BOOL TRUE if /proc/meminfo could be opened
+ */
+BOOL openLinuxMemory(void)
+{
+    g_LinuxMemory.fd = openSysfsFile(PROC_MEMINFO_PATH);
+    return g_LinuxMemory.fd >= 0;
+}
+
+/**
+ * @brief Closes /proc/meminfo
+ */
+void closeLinuxMemory(void)
+{
+    if (g_LinuxMemory.fd >= 0)
+        close(g_LinuxMemory.fd);
+    g_LinuxMemory.fd = -1;
+}
+
+/**
+ * @brief Collects memory counters from /proc/meminfo
+ *
+ * Kernels before 3.14 have no MemAvailable; free memory plus
+ * buffers and page cache stands in for it, as free(1) did.
+ *
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return MemoryInfo* Pointer to memory information, NULL if failed or not opened
+ */
+MemoryInfo *collectLinuxMemoryInfo(SnapshotArena *arena)
+{
+    if (g_LinuxMemory.fd < 0 ||
+        preadSysfsFile(g_LinuxMemory.fd, g_LinuxMemory.buffer, sizeof(g_LinuxMemory.buffer)) == 0)
+        return NULL;
+
+    UINT64 values[MEMINFO_FIELD_COUNT] = {0};
+    DWORD found = parseMeminfo(g_LinuxMemory.buffer, values);
+    if (!(found & (1UL << MEMINFO_TOTAL)) || values[MEMINFO_TOTAL] == 0)
+        return NULL;
+
+    MemoryInfo *info = (MemoryInfo *)snapshotAlloc(arena, sizeof(MemoryInfo));
+    if (!info)
+        return NULL;
+    memset(info, 0, sizeof(MemoryInfo));
+
+    UINT64 available = (found & (1UL << MEMINFO_AVAILABLE))
+                           ? values[MEMINFO_AVAILABLE]
+                           : values[MEMINFO_FREE] + values[MEMINFO_BUFFERS] + values[MEMINFO_CACHED];
+    if (available > values[MEMINFO_TOTAL])
+        available = values[MEMINFO_TOTAL];
+
+    info->totalPhys = values[MEMINFO_TOTAL];
+    info->availPhys = available;
+    info->usedPhys = info->totalPhys - available;
+    info->memoryLoad = (DWORD)((info->usedPhys * 100 + info->totalPhys / 2) / info->totalPhys);
+    info->totalSwap = values[MEMINFO_SWAP_TOTAL];
+    info->freeSwap = values[MEMINFO_SWAP_FREE];
+    info->cached = values[MEMINFO_CACHED];
+    info->buffers = values[MEMINFO_BUFFERS];
+    info->dirty = values[MEMINFO_DIRTY];
+    info->hugePagesTotal = values[MEMINFO_HUGEPAGES_TOTAL];
+    info->hugePagesFree = values[MEMINFO_HUGEPAGES_FREE];
+    info->hugePageSize = values[MEMINFO_HUGEPAGE_SIZE];
+    return info;
+}
@@ -1,7 +1,9 @@
 #include "monitor_info.h"
+#include "fest_alloc.h"
 #include <math.h>
 #include <stdio.h>
 
+#ifdef _WIN32
 /**
  * @brief Calculates pixels per inch (PPI) for display
  *
@@ -52,7 +54,7 @@ static BOOL getMonitorSizeFromEDID(const char *deviceName, int *widthMm, int *he
         DWORD requiredSize = 0;
         SetupDiGetDeviceInterfaceDetail(hDevInfo, &devInfo, NULL, 0, &requiredSize, NULL);
 
-        PSP_DEVICE_INTERFACE_DETAIL_DATA pDevDetail = (PSP_DEVICE_INTERFACE_DETAIL_DATA)malloc(requiredSize);
+        PSP_DEVICE_INTERFACE_DETAIL_DATA pDevDetail = (PSP_DEVICE_INTERFACE_DETAIL_DATA)festMalloc(requiredSize);
         if (!pDevDetail)
             continue;
 
@@ -62,7 +64,7 @@ static BOOL getMonitorSizeFromEDID(const char *deviceName, int *widthMm, int *he
 
         if (!SetupDiGetDeviceInterfaceDetail(hDevInfo, &devInfo, pDevDetail, requiredSize, NULL, &devInfoData))
         {
-            free(pDevDetail);
+            festFree(pDevDetail);
             continue;
         }
 
@@ -79,19 +81,34 @@ static BOOL getMonitorSizeFromEDID(const char *deviceName, int *widthMm, int *he
                 *heightMm = ((edid[68] & 0x0F) << 8) + edid[67];
 
                 RegCloseKey(hEDIDRegKey);
-                free(pDevDetail);
+                festFree(pDevDetail);
                 SetupDiDestroyDeviceInfoList(hDevInfo);
                 return TRUE;
             }
             RegCloseKey(hEDIDRegKey);
         }
-        free(pDevDetail);
+        festFree(pDevDetail);
     }
 
     SetupDiDestroyDeviceInfoList(hDevInfo);
     return FALSE;
 }
 
+/**
+ * @brief Callback function counting monitors for EnumDisplayMonitors
+ *
+ * @param hMonitor Handle to the monitor (unused)
+ * @param hdcMonitor Handle to device context (unused)
+ * @param lprcMonitor Monitor rectangle (unused)
+ * @param dwData Pointer to UINT counter
+ * @return BOOL TRUE to continue enumeration
+ */
+static BOOL CALLBACK CountMonitorsProc(HMONITOR hMonitor, HDC hdcMonitor, LPRECT lprcMonitor, LPARAM dwData)
+{
+    (*(UINT *)dwData)++;
+    return TRUE;
+}
+
 /**
  * @brief Callback function for EnumDisplayMonitors
  *
@@ -111,13 +128,11 @@ static BOOL CALLBACK MonitorEnumProc(HMONITOR hMonitor, HDC hdcMonitor, LPRECT l
 {
     MonitorList *list = (MonitorList *)dwData;
 
-    // Reallocate array for new monitor
-    list->count++;
-    list->monitors = (MonitorInfo *)realloc(list->monitors, sizeof(MonitorInfo) * list->count);
-    if (!list->monitors)
+    // Array was sized by a counting pass, stop if a monitor appeared since
+    if (list->count >= list->capacity)
         return FALSE;
 
-    MonitorInfo *monitor = &list->monitors[list->count - 1];
+    MonitorInfo *monitor = &list->monitors[list->count++];
     memset(monitor, 0, sizeof(MonitorInfo));
 
     // Get basic monitor information
@@ -199,7 +214,7 @@ static BOOL CALLBACK MonitorEnumProc(HMONITOR hMonitor, HDC hdcMonitor, LPRECT l
                 DWORD requiredSize = 0;
                 SetupDiGetDeviceInterfaceDetail(hDevInfo, &devInfo, NULL, 0, &requiredSize, NULL);
 
-                PSP_DEVICE_INTERFACE_DETAIL_DATA pDevDetail = (PSP_DEVICE_INTERFACE_DETAIL_DATA)malloc(requiredSize);
+                PSP_DEVICE_INTERFACE_DETAIL_DATA pDevDetail = (PSP_DEVICE_INTERFACE_DETAIL_DATA)festMalloc(requiredSize);
                 if (!pDevDetail)
                     continue;
 
@@ -209,7 +224,7 @@ static BOOL CALLBACK MonitorEnumProc(HMONITOR hMonitor, HDC hdcMonitor, LPRECT l
 
                 if (!SetupDiGetDeviceInterfaceDetail(hDevInfo, &devInfo, pDevDetail, requiredSize, NULL, &devInfoData))
                 {
-                    free(pDevDetail);
+                    festFree(pDevDetail);
                     continue;
                 }
 
@@ -234,7 +249,7 @@ static BOOL CALLBACK MonitorEnumProc(HMONITOR hMonitor, HDC hdcMonitor, LPRECT l
                     }
                     RegCloseKey(hEDIDRegKey);
                 }
-                free(pDevDetail);
+                festFree(pDevDetail);
             }
             SetupDiDestroyDeviceInfoList(hDevInfo);
         }
@@ -258,23 +273,40 @@ static BOOL CALLBACK MonitorEnumProc(HMONITOR hMonitor, HDC hdcMonitor, LPRECT l
  */
 MonitorList *getMonitorList(void)
 {
-    MonitorList *list = (MonitorList *)malloc(sizeof(MonitorList));
+    MonitorList *list = (MonitorList *)festMalloc(sizeof(MonitorList));
     if (!list)
         return NULL;
 
     list->monitors = NULL;
     list->count = 0;
+    list->capacity = 0;
 
-    // Enumerate all monitors
-    if (!EnumDisplayMonitors(NULL, NULL, MonitorEnumProc, (LPARAM)list))
+    // Count monitors so the array is allocated once
+    if (!EnumDisplayMonitors(NULL, NULL, CountMonitorsProc, (LPARAM)&list->capacity))
     {
-        free(list);
+        festFree(list);
         return NULL;
     }
 
+    if (list->capacity > 0)
+    {
+        list->monitors = (MonitorInfo *)festMalloc(sizeof(MonitorInfo) * list->capacity);
+        if (!list->monitors)
+        {
+            festFree(list);
+            return NULL;
+        }
+
+        // Enumerate all monitors, a monitor removed since counting leaves
+        // the array partly used and one added is skipped
+        EnumDisplayMonitors(NULL, NULL, MonitorEnumProc, (LPARAM)list);
+    }
+
     return list;
 }
 
+#endif // _WIN32
+
 /**
  * @brief Frees memory allocated for MonitorList structure
  *
@@ -285,8 +317,8 @@ void freeMonitorList(MonitorList *list)
     if (list)
     {
         if (list->monitors)
-            free(list->monitors);
-        free(list);
+            festFree(list->monitors);
+        festFree(list);
     }
 }
 
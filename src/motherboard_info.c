@@ -1,9 +1,42 @@
 #include "motherboard_info.h"
-#include "wmi_helper.h"
+#include "fest_alloc.h"
+#include "wmi_cache.h"
+#include "smbios.h"
 #include <stdio.h>
 
+#ifdef _WIN32
+#define MOTHERBOARD_CACHE_TTL_MS 600000 // Board, BIOS and SKU only change with a reboot
+
 /**
- * @brief Retrieves comprehensive motherboard and system information
+ * @brief Win32_BaseBoard properties read into MotherboardInfo
+ */
+static const WMIPropertySpec g_BaseBoardProperties[] = {
+    WMI_STRING_PROPERTY(L"Product", MotherboardInfo, productName),
+    WMI_STRING_PROPERTY(L"Manufacturer", MotherboardInfo, manufacturer),
+    WMI_STRING_PROPERTY(L"SerialNumber", MotherboardInfo, serialNumber)};
+
+/**
+ * @brief Win32_BIOS properties read into MotherboardInfo
+ */
+static const WMIPropertySpec g_BIOSProperties[] = {
+    WMI_STRING_PROPERTY(L"SMBIOSBIOSVersion", MotherboardInfo, biosVersion),
+    WMI_STRING_PROPERTY(L"SerialNumber", MotherboardInfo, biosSerial)};
+
+/**
+ * @brief Win32_ComputerSystem properties read into MotherboardInfo
+ */
+static const WMIPropertySpec g_ComputerSystemProperties[] = {
+    WMI_STRING_PROPERTY(L"SystemSKUNumber", MotherboardInfo, systemSKU)};
+
+static const WMIQuerySpec g_BaseBoardQuery = {
+    L"Win32_BaseBoard", g_BaseBoardProperties, WMI_PROPERTY_COUNT(g_BaseBoardProperties), NULL};
+static const WMIQuerySpec g_BIOSQuery = {
+    L"Win32_BIOS", g_BIOSProperties, WMI_PROPERTY_COUNT(g_BIOSProperties), NULL};
+static const WMIQuerySpec g_ComputerSystemQuery = {
+    L"Win32_ComputerSystem", g_ComputerSystemProperties, WMI_PROPERTY_COUNT(g_ComputerSystemProperties), NULL};
+
+/**
+ * @brief Retrieves motherboard and system information through WMI
  *
  * This function queries multiple WMI classes to collect:
  * 1. Baseboard (Motherboard) information:
@@ -19,77 +52,51 @@
  *    - System SKU number
  *
  * @return MotherboardInfo* Pointer to allocated motherboard information structure, NULL if failed
- * @note Caller is responsible for freeing the returned structure using freeMotherboardInfo()
  */
-MotherboardInfo *getMotherboardInfo(void)
+static MotherboardInfo *queryWMIMotherboardInfo(void)
 {
-    MotherboardInfo *info = (MotherboardInfo *)malloc(sizeof(MotherboardInfo));
+    MotherboardInfo *info = (MotherboardInfo *)festMalloc(sizeof(MotherboardInfo));
     if (!info)
         return NULL;
 
-    // Initialize WMI connection
-    WMISession *session = initializeWMI();
+    memset(info, 0, sizeof(MotherboardInfo));
+
+    // Lease the thread's pooled WMI connection
+    WMISession *session = acquireWMISession();
     if (!session)
     {
-        free(info);
+        festFree(info);
         return NULL;
     }
 
-    // Query Win32_BaseBoard for motherboard information
-    IEnumWbemClassObject *pEnumerator = NULL;
-    if (executeWQLQuery(session, L"SELECT * FROM Win32_BaseBoard", &pEnumerator))
-    {
-        IWbemClassObject *pclsObj = NULL;
-        ULONG uReturn = 0;
-
-        if (SUCCEEDED(pEnumerator->lpVtbl->Next(pEnumerator, WBEM_INFINITE, 1, &pclsObj, &uReturn)) && uReturn != 0)
-        {
-            // Get motherboard identification details
-            getWMIPropertyString(pclsObj, L"Product", info->productName, sizeof(info->productName));
-            getWMIPropertyString(pclsObj, L"Manufacturer", info->manufacturer, sizeof(info->manufacturer));
-            getWMIPropertyString(pclsObj, L"SerialNumber", info->serialNumber, sizeof(info->serialNumber));
-
-            pclsObj->lpVtbl->Release(pclsObj);
-        }
-        pEnumerator->lpVtbl->Release(pEnumerator);
-    }
+    // Query motherboard identification, BIOS and system SKU details,
+    // answered from the query cache when static info is re-collected
+    queryWMIObjectCached(session, &g_BaseBoardQuery, info, sizeof(MotherboardInfo), MOTHERBOARD_CACHE_TTL_MS);
+    queryWMIObjectCached(session, &g_BIOSQuery, info, sizeof(MotherboardInfo), MOTHERBOARD_CACHE_TTL_MS);
+    queryWMIObjectCached(session, &g_ComputerSystemQuery, info, sizeof(MotherboardInfo), MOTHERBOARD_CACHE_TTL_MS);
 
-    // Query Win32_BIOS for BIOS information
-    if (executeWQLQuery(session, L"SELECT * FROM Win32_BIOS", &pEnumerator))
-    {
-        IWbemClassObject *pclsObj = NULL;
-        ULONG uReturn = 0;
-
-        if (SUCCEEDED(pEnumerator->lpVtbl->Next(pEnumerator, WBEM_INFINITE, 1, &pclsObj, &uReturn)) && uReturn != 0)
-        {
-            // Get BIOS version and serial information
-            getWMIPropertyString(pclsObj, L"SMBIOSBIOSVersion", info->biosVersion, sizeof(info->biosVersion));
-            getWMIPropertyString(pclsObj, L"SerialNumber", info->biosSerial, sizeof(info->biosSerial));
-
-            pclsObj->lpVtbl->Release(pclsObj);
-        }
-        pEnumerator->lpVtbl->Release(pEnumerator);
-    }
-
-    // Query Win32_ComputerSystem for system SKU
-    if (executeWQLQuery(session, L"SELECT * FROM Win32_ComputerSystem", &pEnumerator))
-    {
-        IWbemClassObject *pclsObj = NULL;
-        ULONG uReturn = 0;
-
-        if (SUCCEEDED(pEnumerator->lpVtbl->Next(pEnumerator, WBEM_INFINITE, 1, &pclsObj, &uReturn)) && uReturn != 0)
-        {
-            // Get system SKU number
-            getWMIPropertyString(pclsObj, L"SystemSKUNumber", info->systemSKU, sizeof(info->systemSKU));
-            pclsObj->lpVtbl->Release(pclsObj);
-        }
-        pEnumerator->lpVtbl->Release(pEnumerator);
-    }
-
-    cleanupWMI(session);
+    releaseWMISession(session);
     return info;
 }
 
+/**
+ * @brief Retrieves comprehensive motherboard and system information
+ *
+ * The same strings are decoded from the raw SMBIOS table (types 0,
+ * 1 and 2) without a WMI round trip. WMI is only queried when the
+ * firmware table cannot be read.
+ *
+ * @return MotherboardInfo* Pointer to allocated motherboard information structure, NULL if failed
+ * @note Caller is responsible for freeing the returned structure using freeMotherboardInfo()
+ */
+MotherboardInfo *getMotherboardInfo(void)
+{
+    MotherboardInfo *info = getSMBIOSMotherboardInfo();
+    return info ? info : queryWMIMotherboardInfo();
+}
+
+#endif // _WIN32
+
 /**
  * @brief Frees memory allocated for MotherboardInfo structure
  *
@@ -99,7 +106,7 @@ void freeMotherboardInfo(MotherboardInfo *info)
 {
     if (info)
     {
-        free(info);
+        festFree(info);
     }
 }
 
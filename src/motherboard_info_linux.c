@@ -0,0 +1,38 @@
+#include "motherboard_info.h"
+#include "fest_alloc.h"
+#include "linux_sysfs.h"
+#include "smbios.h"
+#include <stdio.h>
+
+#define DMI_ID_DIR "/sys/class/dmi/id" // Decoded SMBIOS strings
+
+/**
+ * @brief Reads board, BIOS and SKU strings
+ *
+ * The raw SMBIOS table is only readable by root; other users get
+ * the strings the kernel decoded into /sys/class/dmi/id, where
+ * serial numbers are root-only as well. Missing or unreadable
+ * attributes leave their field empty.
+ *
+ * @return MotherboardInfo* Pointer to allocated information, NULL if failed
+ * @note Caller is responsible for freeing the returned structure using freeMotherboardInfo()
+ */
+MotherboardInfo *getLinuxMotherboardInfo(void)
+{
+    MotherboardInfo *smbios = getSMBIOSMotherboardInfo();
+    if (smbios)
+        return smbios;
+
+    MotherboardInfo *info = (MotherboardInfo *)festMalloc(sizeof(MotherboardInfo));
+    if (!info)
+        return NULL;
+
+    memset(info, 0, sizeof(MotherboardInfo));
+    readSysfsString(DMI_ID_DIR "/board_name", info->productName, sizeof(info->productName));
+    readSysfsString(DMI_ID_DIR "/board_vendor", info->manufacturer, sizeof(info->manufacturer));
+    readSysfsString(DMI_ID_DIR "/board_serial", info->serialNumber, sizeof(info->serialNumber));
+    readSysfsString(DMI_ID_DIR "/bios_version", info->biosVersion, sizeof(info->biosVersion));
+    readSysfsString(DMI_ID_DIR "/product_serial", info->biosSerial, sizeof(info->biosSerial));
+    readSysfsString(DMI_ID_DIR "/product_sku", info->systemSKU, sizeof(info->systemSKU));
+    return info;
+}
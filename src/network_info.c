@@ -1,9 +1,19 @@
 #include "network_info.h"
+#include "fest_alloc.h"
 #include <stdio.h>
 #include <ctype.h>
+#include <stdlib.h>
 
+#ifdef _WIN32
 #pragma comment(lib, "iphlpapi.lib")
 
+#define ADAPTER_INFO_INITIAL_COUNT 16 // Adapters the first GetAdaptersInfo buffer can hold
+
+/**
+ * @brief Traffic counters of the previous tick, owned by the monitoring thread
+ */
+static NetworkSampler g_NetworkSampler;
+
 /**
  * @brief Determines if a network adapter is virtual or system-created
  *
@@ -34,6 +44,80 @@ static BOOL isSystemAdapter(const char *description)
             strstr(lowerDesc, "microsoft") != NULL);
 }
 
+/**
+ * @brief Counts the leading one bits of a dotted IPv4 netmask
+ *
+ * @param mask Netmask such as "255.255.255.0"
+ * @return UINT Prefix length in bits
+ */
+static UINT maskPrefixLength(const char *mask)
+{
+    UINT prefix = 0;
+    for (const char *part = mask; part && *part;)
+    {
+        for (ULONG octet = strtoul(part, NULL, 10); octet & 0x80; octet = (octet << 1) & 0xFF)
+            prefix++;
+        part = strchr(part, '.');
+        if (part)
+            part++;
+    }
+    return prefix;
+}
+
+/**
+ * @brief RFC 2863 names of IF_OPER_STATUS, indexed by value
+ *
+ * IfOperStatusUp (1) to IfOperStatusLowerLayerDown (7) follow
+ * ifOperStatus, the Linux collector reports the same names.
+ */
+static const char *const g_OperStates[] = {
+    "unknown",        // 0, not defined by IF_OPER_STATUS
+    "up",             // IfOperStatusUp
+    "down",           // IfOperStatusDown
+    "testing",        // IfOperStatusTesting
+    "unknown",        // IfOperStatusUnknown
+    "dormant",        // IfOperStatusDormant
+    "notpresent",     // IfOperStatusNotPresent
+    "lowerlayerdown", // IfOperStatusLowerLayerDown
+};
+
+/**
+ * @brief Reads the operational state and traffic counters of an interface
+ *
+ * GetIfEntry2 fills one MIB_IF_ROW2 in place, where GetIfTable2
+ * would allocate a table of every interface, filtered ones
+ * included, on each tick.
+ *
+ * @param index Interface index
+ * @param operState Buffer receiving the RFC 2863 operational state
+ * @param operStateSize Size of the buffer in bytes
+ * @param counters Receives the counters
+ * @return BOOL TRUE if the interface could be read
+ */
+static BOOL readInterfaceCounters(UINT index, char *operState, size_t operStateSize, NetworkCounters *counters)
+{
+    MIB_IF_ROW2 row;
+    memset(&row, 0, sizeof(row));
+    row.InterfaceIndex = index;
+    if (GetIfEntry2(&row) != NO_ERROR)
+        return FALSE;
+
+    UINT state = (UINT)row.OperStatus;
+    if (state >= sizeof(g_OperStates) / sizeof(g_OperStates[0]))
+        state = 0;
+    strcpy_s(operState, operStateSize, g_OperStates[state]);
+
+    counters->rxBytes = row.InOctets;
+    counters->txBytes = row.OutOctets;
+    counters->rxPackets = row.InUcastPkts + row.InNUcastPkts;
+    counters->txPackets = row.OutUcastPkts + row.OutNUcastPkts;
+    counters->rxErrors = row.InErrors;
+    counters->txErrors = row.OutErrors;
+    counters->rxDropped = row.InDiscards;
+    counters->txDropped = row.OutDiscards;
+    return TRUE;
+}
+
 /**
  * @brief Retrieves information about physical network adapters
  *
@@ -44,96 +128,178 @@ static BOOL isSystemAdapter(const char *description)
  * - IP address
  * - Connection status
  * - Adapter type (Ethernet/WiFi)
+ * - Traffic rates, when a sampler is given
  *
  * Virtual and system adapters are filtered out.
  *
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @param sampler Traffic sampler started for this tick, NULL for no rates
  * @return NetworkList* Pointer to allocated list of network adapters, NULL if failed
- * @note Caller is responsible for freeing the returned list using freeNetworkList()
+ * @note Without an arena, caller is responsible for freeing the returned list using freeNetworkList()
  */
-NetworkList *getNetworkList(void)
+static NetworkList *collectAdapters(SnapshotArena *arena, NetworkSampler *sampler)
 {
-    NetworkList *list = (NetworkList *)malloc(sizeof(NetworkList));
+    NetworkList *list = (NetworkList *)snapshotAlloc(arena, sizeof(NetworkList));
     if (!list)
         return NULL;
 
     list->adapters = NULL;
     list->count = 0;
+    list->addresses = NULL;
+    list->addressCount = 0;
 
-    // Initialize IP adapter info structure
-    PIP_ADAPTER_INFO pAdapterInfo = NULL;
-    ULONG ulOutBufLen = sizeof(IP_ADAPTER_INFO);
-
-    pAdapterInfo = (IP_ADAPTER_INFO *)malloc(sizeof(IP_ADAPTER_INFO));
+    // Initialize IP adapter info buffer, sized for a typical machine
+    // so a single GetAdaptersInfo call usually suffices
+    ULONG ulOutBufLen = sizeof(IP_ADAPTER_INFO) * ADAPTER_INFO_INITIAL_COUNT;
+    PIP_ADAPTER_INFO pAdapterInfo = (IP_ADAPTER_INFO *)snapshotAlloc(arena, ulOutBufLen);
     if (!pAdapterInfo)
     {
-        free(list);
+        snapshotFree(arena, list);
         return NULL;
     }
 
-    // Get required buffer size and reallocate if needed
-    if (GetAdaptersInfo(pAdapterInfo, &ulOutBufLen) == ERROR_BUFFER_OVERFLOW)
+    // Reallocate with the required size if the buffer was too small
+    DWORD result = GetAdaptersInfo(pAdapterInfo, &ulOutBufLen);
+    if (result == ERROR_BUFFER_OVERFLOW)
     {
-        free(pAdapterInfo);
-        pAdapterInfo = (IP_ADAPTER_INFO *)malloc(ulOutBufLen);
+        snapshotFree(arena, pAdapterInfo);
+        pAdapterInfo = (IP_ADAPTER_INFO *)snapshotAlloc(arena, ulOutBufLen);
         if (!pAdapterInfo)
         {
-            free(list);
+            snapshotFree(arena, list);
             return NULL;
         }
+        result = GetAdaptersInfo(pAdapterInfo, &ulOutBufLen);
     }
 
     // Enumerate network adapters
-    if (GetAdaptersInfo(pAdapterInfo, &ulOutBufLen) == NO_ERROR)
+    if (result == NO_ERROR)
     {
-        PIP_ADAPTER_INFO pAdapter = pAdapterInfo;
+        // First pass: count physical adapters and their addresses
+        UINT count = 0;
+        UINT addressCount = 0;
+        for (PIP_ADAPTER_INFO pAdapter = pAdapterInfo; pAdapter; pAdapter = pAdapter->Next)
+        {
+            if (isSystemAdapter(pAdapter->Description))
+                continue;
+            count++;
+            for (PIP_ADDR_STRING ip = &pAdapter->IpAddressList; ip; ip = ip->Next)
+            {
+                if (strcmp(ip->IpAddress.String, "0.0.0.0") != 0)
+                    addressCount++;
+            }
+        }
 
-        while (pAdapter)
+        if (count > 0)
+            list->adapters = (NetworkAdapterInfo *)snapshotAlloc(arena, sizeof(NetworkAdapterInfo) * count);
+        if (addressCount > 0 && list->adapters)
+        {
+            list->addresses = (NetworkAddress *)snapshotAlloc(arena, sizeof(NetworkAddress) * addressCount);
+            if (!list->addresses)
+            {
+                snapshotFree(arena, list->adapters);
+                list->adapters = NULL;
+            }
+        }
+
+        // Second pass: fill adapter details
+        for (PIP_ADAPTER_INFO pAdapter = pAdapterInfo; pAdapter && list->adapters; pAdapter = pAdapter->Next)
         {
             // Filter out virtual and system adapters
-            if (!isSystemAdapter(pAdapter->Description))
+            if (isSystemAdapter(pAdapter->Description))
+                continue;
+
+            NetworkAdapterInfo *adapter = &list->adapters[list->count++];
+            memset(adapter, 0, sizeof(NetworkAdapterInfo));
+
+            // Store adapter identification; AdapterName is the GUID of the adapter
+            strncpy_s(adapter->name, sizeof(adapter->name),
+                      pAdapter->Description, _TRUNCATE);
+            formatMacAddress(pAdapter->Address, pAdapter->AddressLength,
+                             adapter->macAddress, sizeof(adapter->macAddress));
+            adapter->index = pAdapter->Index;
+
+            // List every assigned IPv4 address, unassigned ones read as 0.0.0.0
+            adapter->firstAddress = list->addressCount;
+            for (PIP_ADDR_STRING ip = &pAdapter->IpAddressList; ip; ip = ip->Next)
+            {
+                if (strcmp(ip->IpAddress.String, "0.0.0.0") == 0)
+                    continue;
+                NetworkAddress *address = &list->addresses[list->addressCount++];
+                strncpy_s(address->address, sizeof(address->address), ip->IpAddress.String, _TRUNCATE);
+                address->prefixLength = maskPrefixLength(ip->IpMask.String);
+                address->ipv6 = FALSE;
+                adapter->addressCount++;
+            }
+
+            // Determine connection status from IP address
+            if (adapter->addressCount > 0)
+            {
+                strncpy_s(adapter->ipAddress, sizeof(adapter->ipAddress),
+                          list->addresses[adapter->firstAddress].address, _TRUNCATE);
+                strcpy_s(adapter->status, sizeof(adapter->status), "Connected");
+            }
+            else
             {
-                list->count++;
-                list->adapters = (NetworkAdapterInfo *)realloc(list->adapters,
-                                                               sizeof(NetworkAdapterInfo) * list->count);
-
-                NetworkAdapterInfo *adapter = &list->adapters[list->count - 1];
-
-                // Store adapter identification
-                strncpy_s(adapter->name, sizeof(adapter->name),
-                          pAdapter->Description, _TRUNCATE);
-                strncpy_s(adapter->macAddress, sizeof(adapter->macAddress),
-                          pAdapter->AdapterName, _TRUNCATE);
-
-                // Determine connection status from IP address
-                if (strcmp(pAdapter->IpAddressList.IpAddress.String, "0.0.0.0") != 0)
-                {
-                    strncpy_s(adapter->ipAddress, sizeof(adapter->ipAddress),
-                              pAdapter->IpAddressList.IpAddress.String, _TRUNCATE);
-                    strcpy_s(adapter->status, sizeof(adapter->status), "Connected");
-                }
-                else
-                {
-                    strcpy_s(adapter->ipAddress, sizeof(adapter->ipAddress), "N/A");
-                    strcpy_s(adapter->status, sizeof(adapter->status), "Not Connected");
-                }
-
-                // Store adapter type for interface identification
-                adapter->type = pAdapter->Type;
+                strcpy_s(adapter->ipAddress, sizeof(adapter->ipAddress), "N/A");
+                strcpy_s(adapter->status, sizeof(adapter->status), "Not Connected");
             }
 
-            pAdapter = pAdapter->Next;
+            // Store adapter type for interface identification
+            adapter->type = pAdapter->Type;
+
+            // Operational state as the interface reports it, not derived from the address
+            NetworkCounters counters;
+            if (!readInterfaceCounters(adapter->index, adapter->operState, sizeof(adapter->operState), &counters))
+                strcpy_s(adapter->operState, sizeof(adapter->operState), "unknown");
+            else if (sampler)
+                computeNetworkRates(sampler, adapter, &counters);
         }
     }
 
-    // Cleanup allocated resources
-    if (pAdapterInfo)
-    {
-        free(pAdapterInfo);
-    }
+    // Cleanup scratch buffer (arena scratch is released with the snapshot)
+    snapshotFree(arena, pAdapterInfo);
 
     return list;
 }
 
+/**
+ * @brief Collects adapter list and traffic rates into a snapshot arena
+ *
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return NetworkList* Pointer to adapter list, NULL if failed
+ * @note Heap results (NULL arena) must be freed with freeNetworkList()
+ */
+NetworkList *collectNetworkList(SnapshotArena *arena)
+{
+    beginNetworkSample(&g_NetworkSampler, GetTickCount64());
+    return collectAdapters(arena, &g_NetworkSampler);
+}
+
+/**
+ * @brief Releases the Windows traffic sampler
+ */
+void closeNetworkCollector(void)
+{
+    releaseNetworkSampler(&g_NetworkSampler);
+}
+
+/**
+ * @brief Retrieves network adapter information from the heap
+ *
+ * Called outside the monitoring thread, so the sampler is left
+ * alone and no rates are reported.
+ *
+ * @return NetworkList* Pointer to allocated network adapter information, NULL if failed
+ * @note Caller is responsible for freeing the returned structure using freeNetworkList()
+ */
+NetworkList *getNetworkList(void)
+{
+    return collectAdapters(NULL, NULL);
+}
+
+#endif // _WIN32
+
 /**
  * @brief Frees memory allocated for NetworkList structure
  *
@@ -144,11 +310,209 @@ void freeNetworkList(NetworkList *list)
     if (list)
     {
         if (list->adapters)
-            free(list->adapters);
-        free(list);
+            festFree(list->adapters);
+        if (list->addresses)
+            festFree(list->addresses);
+        festFree(list);
+    }
+}
+
+/**
+ * @brief First map entry probed for an interface index
+ *
+ * Multiplicative hashing spreads consecutive indexes, and the
+ * high indexes of a container host, over the whole map.
+ *
+ * @param sampler Sampler whose map is probed
+ * @param index Interface index
+ * @return UINT Map entry
+ */
+static UINT networkMapStart(const NetworkSampler *sampler, UINT index)
+{
+    return (UINT)(index * 2654435761U) & (sampler->capacity * 2 - 1);
+}
+
+/**
+ * @brief Enters every used slot into the map
+ *
+ * @param sampler Sampler whose slots were added, moved or removed
+ */
+static void rebuildNetworkMap(NetworkSampler *sampler)
+{
+    UINT mask = sampler->capacity * 2 - 1;
+    memset(sampler->map, 0, sampler->capacity * 2 * sizeof(UINT));
+    for (UINT i = 0; i < sampler->count; i++)
+    {
+        UINT entry = networkMapStart(sampler, sampler->slots[i].index);
+        while (sampler->map[entry])
+            entry = (entry + 1) & mask;
+        sampler->map[entry] = i + 1;
     }
 }
 
+/**
+ * @brief Starts a tick of a traffic sampler
+ *
+ * @param sampler Sampler, zeroed before the first tick
+ * @param now GetTickCount64() of this tick
+ */
+void beginNetworkSample(NetworkSampler *sampler, UINT64 now)
+{
+    sampler->previousTime = sampler->currentTime;
+    sampler->currentTime = now;
+
+    // Interfaces the previous tick did not read are gone or were skipped
+    UINT kept = 0;
+    for (UINT i = 0; i < sampler->count; i++)
+    {
+        if (sampler->slots[i].time == sampler->previousTime)
+            sampler->slots[kept++] = sampler->slots[i];
+    }
+    if (kept != sampler->count)
+    {
+        sampler->count = kept;
+        rebuildNetworkMap(sampler);
+    }
+}
+
+/**
+ * @brief Makes room for one more slot
+ *
+ * @param sampler Sampler to grow, zeroed for the first call
+ * @return BOOL TRUE if a slot is free
+ */
+static BOOL reserveNetworkSampler(NetworkSampler *sampler)
+{
+    if (sampler->count < sampler->capacity)
+        return TRUE;
+
+    UINT capacity = sampler->capacity ? sampler->capacity * 2 : NETWORK_INITIAL_SLOTS;
+    NetworkCounterSlot *slots = (NetworkCounterSlot *)festRealloc(sampler->slots, capacity * sizeof(NetworkCounterSlot));
+    if (!slots)
+        return FALSE;
+    sampler->slots = slots;
+
+    UINT *map = (UINT *)festMalloc(capacity * 2 * sizeof(UINT));
+    if (!map)
+        return FALSE;
+    if (sampler->map)
+        festFree(sampler->map);
+    sampler->map = map;
+    sampler->capacity = capacity;
+    rebuildNetworkMap(sampler);
+    return TRUE;
+}
+
+/**
+ * @brief Finds the slot of an interface index, taking a free one if new
+ *
+ * @param sampler Sampler started with beginNetworkSample()
+ * @param index Interface index
+ * @return NetworkCounterSlot* Slot of the index, NULL if none could be allocated
+ */
+static NetworkCounterSlot *findNetworkSlot(NetworkSampler *sampler, UINT index)
+{
+    if (sampler->capacity > 0)
+    {
+        UINT mask = sampler->capacity * 2 - 1;
+        for (UINT entry = networkMapStart(sampler, index); sampler->map[entry]; entry = (entry + 1) & mask)
+        {
+            NetworkCounterSlot *slot = &sampler->slots[sampler->map[entry] - 1];
+            if (slot->index == index)
+                return slot;
+        }
+    }
+
+    if (!reserveNetworkSampler(sampler))
+        return NULL;
+
+    NetworkCounterSlot *slot = &sampler->slots[sampler->count];
+    memset(slot, 0, sizeof(NetworkCounterSlot));
+    slot->index = index;
+
+    UINT mask = sampler->capacity * 2 - 1;
+    UINT entry = networkMapStart(sampler, index);
+    while (sampler->map[entry])
+        entry = (entry + 1) & mask;
+    sampler->map[entry] = ++sampler->count;
+    return slot;
+}
+
+/**
+ * @brief Difference of a cumulative 64-bit counter between two ticks
+ *
+ * @param now Counter of this tick
+ * @param before Counter of the previous tick
+ * @return UINT64 Increase since the previous tick, now if the counter was reset
+ */
+static UINT64 counterDelta(UINT64 now, UINT64 before)
+{
+    return now >= before ? now - before : now;
+}
+
+/**
+ * @brief Turns the counters of an adapter into rates
+ *
+ * @param sampler Sampler started with beginNetworkSample()
+ * @param adapter Adapter whose index is set, receives the rates
+ * @param counters Cumulative counters read this tick
+ */
+void computeNetworkRates(NetworkSampler *sampler, NetworkAdapterInfo *adapter, const NetworkCounters *counters)
+{
+    NetworkCounterSlot *slot = findNetworkSlot(sampler, adapter->index);
+    if (!slot)
+        return;
+
+    // Only counters stored by the previous tick are a baseline
+    if (sampler->previousTime && slot->time == sampler->previousTime && sampler->currentTime > sampler->previousTime)
+    {
+        const NetworkCounters *before = &slot->counters;
+        double seconds = (double)(sampler->currentTime - sampler->previousTime) / 1000.0;
+        adapter->rxBytesPerSec = (double)counterDelta(counters->rxBytes, before->rxBytes) / seconds;
+        adapter->txBytesPerSec = (double)counterDelta(counters->txBytes, before->txBytes) / seconds;
+        adapter->rxPacketsPerSec = (double)counterDelta(counters->rxPackets, before->rxPackets) / seconds;
+        adapter->txPacketsPerSec = (double)counterDelta(counters->txPackets, before->txPackets) / seconds;
+        adapter->rxErrors = counterDelta(counters->rxErrors, before->rxErrors);
+        adapter->txErrors = counterDelta(counters->txErrors, before->txErrors);
+        adapter->rxDropped = counterDelta(counters->rxDropped, before->rxDropped);
+        adapter->txDropped = counterDelta(counters->txDropped, before->txDropped);
+    }
+
+    slot->counters = *counters;
+    slot->time = sampler->currentTime;
+}
+
+/**
+ * @brief Frees the counter arrays of a sampler
+ *
+ * @param sampler Sampler to release, zeroed afterwards
+ */
+void releaseNetworkSampler(NetworkSampler *sampler)
+{
+    if (sampler->slots)
+        festFree(sampler->slots);
+    if (sampler->map)
+        festFree(sampler->map);
+    memset(sampler, 0, sizeof(NetworkSampler));
+}
+
+/**
+ * @brief Formats a hardware address as dash-separated hex bytes
+ *
+ * @param address Address bytes
+ * @param length Number of bytes
+ * @param buffer Receives the text (e.g., "00-1A-2B-3C-4D-5E")
+ * @param bufferSize Size of buffer in bytes
+ */
+void formatMacAddress(const BYTE *address, UINT length, char *buffer, size_t bufferSize)
+{
+    size_t position = 0;
+    buffer[0] = '\0';
+    for (UINT i = 0; i < length && position + 3 < bufferSize; i++)
+        position += (size_t)_snprintf_s(buffer + position, bufferSize - position, _TRUNCATE,
+                                        i > 0 ? "-%02X" : "%02X", address[i]);
+}
+
 /**
  * @brief Gets the adapter name/description
  *
@@ -193,6 +557,17 @@ const char *getAdapterStatus(const NetworkAdapterInfo *adapter)
     return adapter ? adapter->status : "";
 }
 
+/**
+ * @brief Gets the adapter's operational state
+ *
+ * @param adapter Pointer to NetworkAdapterInfo structure
+ * @return const char* Operational state ("up", "down", ...) or empty string if adapter is NULL
+ */
+const char *getAdapterOperState(const NetworkAdapterInfo *adapter)
+{
+    return adapter ? adapter->operState : "";
+}
+
 /**
  * @brief Checks if the adapter is an Ethernet interface
  *
@@ -0,0 +1,287 @@
+#ifndef _WIN32
+#define _GNU_SOURCE // RUSAGE_THREAD
+#endif
+
+#include "overhead_stats.h"
+#include "fest_alloc.h"
+#include <string.h>
+
+#ifdef _WIN32
+#define SYSTEM_PROCESS_INFORMATION_CLASS 5
+#define STATUS_INFO_LENGTH_MISMATCH_CODE ((LONG)0xC0000004L)
+
+/**
+ * @brief Per-process record returned by NtQuerySystemInformation
+ *
+ * Mirrors the documented SYSTEM_PROCESS_INFORMATION layout,
+ * thread records follow it directly in the buffer
+ */
+typedef struct
+{
+    ULONG NextEntryOffset;
+    ULONG NumberOfThreads;
+    BYTE Reserved1[48];
+    USHORT ImageNameLength;
+    USHORT ImageNameMaximumLength;
+    PWSTR ImageNameBuffer;
+    LONG BasePriority;
+    HANDLE UniqueProcessId;
+    PVOID Reserved2;
+    ULONG HandleCount;
+    ULONG SessionId;
+    PVOID Reserved3;
+    SIZE_T PeakVirtualSize;
+    SIZE_T VirtualSize;
+    ULONG Reserved4;
+    SIZE_T PeakWorkingSetSize;
+    SIZE_T WorkingSetSize;
+    PVOID Reserved5;
+    SIZE_T QuotaPagedPoolUsage;
+    PVOID Reserved6;
+    SIZE_T QuotaNonPagedPoolUsage;
+    SIZE_T PagefileUsage;
+    SIZE_T PeakPagefileUsage;
+    SIZE_T PrivatePageCount;
+    LARGE_INTEGER Reserved7[6];
+} ProcessRecord;
+
+/**
+ * @brief Per-thread record following a ProcessRecord
+ */
+typedef struct
+{
+    LARGE_INTEGER KernelTime;
+    LARGE_INTEGER UserTime;
+    LARGE_INTEGER CreateTime;
+    ULONG WaitTime;
+    PVOID StartAddress;
+    HANDLE UniqueProcess;
+    HANDLE UniqueThread;
+    LONG Priority;
+    LONG BasePriority;
+    ULONG ContextSwitches;
+    ULONG ThreadState;
+    ULONG WaitReason;
+} ThreadRecord;
+
+typedef LONG(NTAPI *NtQuerySystemInformationFn)(ULONG, PVOID, ULONG, PULONG);
+
+/**
+ * @brief Cached state of the context switch sampler
+ *
+ * The snapshot buffer only grows, so steady-state sampling
+ * does not allocate. It comes from the process heap rather
+ * than festMalloc() to keep the sampler out of the
+ * allocation figures it reports.
+ *
+ * @note Only used from the monitoring thread
+ */
+static struct
+{
+    NtQuerySystemInformationFn query; // Resolved ntdll entry point
+    BOOL resolved;                    // Lookup already attempted
+    BYTE *buffer;                     // Process snapshot buffer
+    ULONG bufferSize;                 // Snapshot buffer capacity
+} g_Sampler = {0};
+
+/**
+ * @brief Converts a FILETIME duration to microseconds
+ *
+ * @param ft Duration in 100ns units
+ * @return UINT64 Duration in microseconds
+ */
+static UINT64 fileTimeToUs(const FILETIME *ft)
+{
+    ULARGE_INTEGER value;
+    value.LowPart = ft->dwLowDateTime;
+    value.HighPart = ft->dwHighDateTime;
+    return value.QuadPart / 10;
+}
+
+/**
+ * @brief Reads the CPU time of the calling thread
+ *
+ * @param cpuTimeUs Receives user plus kernel time in microseconds
+ * @return BOOL TRUE if the time was read
+ */
+static BOOL getThreadCpuTimeUs(UINT64 *cpuTimeUs)
+{
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime))
+        return FALSE;
+
+    *cpuTimeUs = fileTimeToUs(&kernelTime) + fileTimeToUs(&userTime);
+    return TRUE;
+}
+
+/**
+ * @brief Reads the context switch counter of the calling thread
+ *
+ * Windows exposes per-thread context switches only through
+ * the system process snapshot, so this function:
+ * 1. Resolves NtQuerySystemInformation from ntdll
+ * 2. Takes a process snapshot into the cached buffer
+ * 3. Finds the current process and thread records
+ *
+ * @param switches Receives the context switch count
+ * @return BOOL TRUE if the counter was found, FALSE otherwise
+ */
+static BOOL getThreadContextSwitches(UINT64 *switches)
+{
+    if (!g_Sampler.resolved)
+    {
+        HMODULE ntdll = GetModuleHandleA("ntdll.dll");
+        if (ntdll)
+            g_Sampler.query = (NtQuerySystemInformationFn)GetProcAddress(ntdll, "NtQuerySystemInformation");
+        g_Sampler.resolved = TRUE;
+    }
+    if (!g_Sampler.query)
+        return FALSE;
+
+    // Take snapshot, growing the buffer while it is too small
+    for (;;)
+    {
+        ULONG needed = 0;
+        LONG status = STATUS_INFO_LENGTH_MISMATCH_CODE;
+        if (g_Sampler.buffer)
+            status = g_Sampler.query(SYSTEM_PROCESS_INFORMATION_CLASS, g_Sampler.buffer, g_Sampler.bufferSize, &needed);
+
+        if (status == STATUS_INFO_LENGTH_MISMATCH_CODE)
+        {
+            // Leave headroom for processes started before the next sample
+            ULONG newSize = (needed > g_Sampler.bufferSize ? needed : g_Sampler.bufferSize) + 64 * 1024;
+            BYTE *newBuffer = g_Sampler.buffer
+                                  ? (BYTE *)HeapReAlloc(GetProcessHeap(), 0, g_Sampler.buffer, newSize)
+                                  : (BYTE *)HeapAlloc(GetProcessHeap(), 0, newSize);
+            if (!newBuffer)
+                return FALSE;
+            g_Sampler.buffer = newBuffer;
+            g_Sampler.bufferSize = newSize;
+            continue;
+        }
+        if (status < 0)
+            return FALSE;
+        break;
+    }
+
+    // Walk process records to find this thread
+    HANDLE pid = (HANDLE)(ULONG_PTR)GetCurrentProcessId();
+    HANDLE tid = (HANDLE)(ULONG_PTR)GetCurrentThreadId();
+    BYTE *cursor = g_Sampler.buffer;
+    for (;;)
+    {
+        ProcessRecord *process = (ProcessRecord *)cursor;
+        if (process->UniqueProcessId == pid)
+        {
+            ThreadRecord *threads = (ThreadRecord *)(process + 1);
+            for (ULONG i = 0; i < process->NumberOfThreads; i++)
+            {
+                if (threads[i].UniqueThread == tid)
+                {
+                    *switches = threads[i].ContextSwitches;
+                    return TRUE;
+                }
+            }
+            return FALSE;
+        }
+        if (process->NextEntryOffset == 0)
+            return FALSE;
+        cursor += process->NextEntryOffset;
+    }
+}
+
+/**
+ * @brief Releases buffers cached by the sampler
+ */
+void releaseOverheadSampler(void)
+{
+    if (g_Sampler.buffer)
+        HeapFree(GetProcessHeap(), 0, g_Sampler.buffer);
+    g_Sampler.buffer = NULL;
+    g_Sampler.bufferSize = 0;
+}
+#else
+#include <sys/resource.h>
+
+/**
+ * @brief Reads the CPU time of the calling thread
+ *
+ * @param cpuTimeUs Receives user plus system time in microseconds
+ * @return BOOL TRUE if the time was read
+ */
+static BOOL getThreadCpuTimeUs(UINT64 *cpuTimeUs)
+{
+    struct timespec cpuTime;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuTime) != 0)
+        return FALSE;
+
+    *cpuTimeUs = (UINT64)cpuTime.tv_sec * 1000000 + (UINT64)cpuTime.tv_nsec / 1000;
+    return TRUE;
+}
+
+/**
+ * @brief Reads the context switch counter of the calling thread
+ *
+ * Counts voluntary and involuntary switches, like the single
+ * counter Windows keeps per thread
+ *
+ * @param switches Receives the context switch count
+ * @return BOOL TRUE if the counter was read
+ */
+static BOOL getThreadContextSwitches(UINT64 *switches)
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_THREAD, &usage) != 0)
+        return FALSE;
+
+    *switches = (UINT64)usage.ru_nvcsw + (UINT64)usage.ru_nivcsw;
+    return TRUE;
+}
+
+/**
+ * @brief Releases buffers cached by the sampler
+ *
+ * The Linux sampler keeps no buffers
+ */
+void releaseOverheadSampler(void)
+{
+}
+#endif
+
+/**
+ * @brief Samples resource counters of the calling thread
+ *
+ * @param sample Structure to receive the counters
+ * @return BOOL TRUE if all counters were read, FALSE if any is unavailable
+ */
+BOOL takeOverheadSample(OverheadSample *sample)
+{
+    if (!sample)
+        return FALSE;
+
+    BOOL complete = TRUE;
+    memset(sample, 0, sizeof(OverheadSample));
+
+    // Monotonic wall clock
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    sample->wallTimeUs = (UINT64)(counter.QuadPart / frequency.QuadPart) * 1000000 +
+                         (UINT64)(counter.QuadPart % frequency.QuadPart) * 1000000 / frequency.QuadPart;
+
+    // Thread CPU time
+    if (!getThreadCpuTimeUs(&sample->cpuTimeUs))
+        complete = FALSE;
+
+    // Context switches
+    if (!getThreadContextSwitches(&sample->contextSwitches))
+        complete = FALSE;
+
+    // Library heap counters
+    AllocStats allocStats;
+    getAllocStats(&allocStats);
+    sample->allocCount = allocStats.allocCount;
+    sample->allocatedBytes = allocStats.allocatedBytes;
+
+    return complete;
+}
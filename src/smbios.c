@@ -0,0 +1,425 @@
+#include "smbios.h"
+#include "fest_alloc.h"
+#include <stdio.h>
+#include <stddef.h>
+
+#ifdef __linux__
+#include "linux_sysfs.h"
+#endif
+
+#define SMBIOS_DMI_TABLE_PATH "/sys/firmware/dmi/tables/DMI" // Structure table exported by the kernel
+#define SMBIOS_SIZE_EXTENDED 0x7FFF                          // Module size kept in Extended Size
+#define SMBIOS_SIZE_UNKNOWN 0xFFFF                           // Module size not known
+#define SMBIOS_SIZE_IN_KB 0x8000                             // Module size granularity bit
+#define SMBIOS_SPEED_EXTENDED 0xFFFF                         // Speed kept in Extended Speed
+#define SMBIOS_SLOTS_INITIAL 4                               // First capacity of the slot array
+
+static SRWLOCK g_SMBIOSLock = SRWLOCK_INIT;   // Guards the fields below
+static LONG g_SMBIOSOpens = 0;                // Open collectors sharing the decoded table
+static BOOL g_SMBIOSMissing = FALSE;          // The table could not be read at open
+static MotherboardInfo *g_SMBIOSBoard = NULL; // Board strings not yet taken by the getter
+static RAMSlotList *g_SMBIOSSlots = NULL;     // RAM modules not yet taken by the getter
+
+/**
+ * @brief One structure of the table
+ */
+typedef struct
+{
+    const BYTE *data;    // Formatted area, header included
+    BYTE length;         // Size of the formatted area
+    const char *strings; // First string of the string set
+} SMBIOSStructure;
+
+/**
+ * @brief Reads a little-endian WORD field
+ *
+ * @param structure Structure to read from
+ * @param offset Offset of the field in the formatted area
+ * @return WORD Field value, 0 if the structure predates the field
+ */
+static WORD readSMBIOSWord(const SMBIOSStructure *structure, BYTE offset)
+{
+    if ((UINT)offset + 2 > structure->length)
+        return 0;
+
+    const BYTE *field = structure->data + offset;
+    return (WORD)(field[0] | (field[1] << 8));
+}
+
+/**
+ * @brief Reads a little-endian DWORD field
+ *
+ * @param structure Structure to read from
+ * @param offset Offset of the field in the formatted area
+ * @return DWORD Field value, 0 if the structure predates the field
+ */
+static DWORD readSMBIOSDword(const SMBIOSStructure *structure, BYTE offset)
+{
+    if ((UINT)offset + 4 > structure->length)
+        return 0;
+
+    const BYTE *field = structure->data + offset;
+    return (DWORD)field[0] | ((DWORD)field[1] << 8) | ((DWORD)field[2] << 16) | ((DWORD)field[3] << 24);
+}
+
+/**
+ * @brief Copies a string referenced by a formatted field
+ *
+ * The field holds the 1-based number of the string in the string
+ * set, 0 for none. An out-of-range number leaves the value empty.
+ *
+ * @param structure Structure to read from
+ * @param offset Offset of the string number in the formatted area
+ * @param value Buffer receiving the string without surrounding spaces
+ * @param valueSize Size of the buffer in bytes
+ */
+static void copySMBIOSString(const SMBIOSStructure *structure, BYTE offset, char *value, size_t valueSize)
+{
+    value[0] = '\0';
+    if (offset >= structure->length || structure->data[offset] == 0)
+        return;
+
+    // The string set is terminated by an empty string
+    const char *string = structure->strings;
+    for (BYTE number = 1; number < structure->data[offset]; number++)
+    {
+        if (*string == '\0')
+            return;
+        string += strlen(string) + 1;
+    }
+
+    while (*string == ' ')
+        string++;
+    size_t length = strlen(string);
+    while (length > 0 && string[length - 1] == ' ')
+        length--;
+    _snprintf_s(value, valueSize, _TRUNCATE, "%.*s", (int)length, string);
+}
+
+/**
+ * @brief Appends a zeroed slot to the list
+ *
+ * @param slots List being filled
+ * @param capacity Allocated entries, updated when the array grows
+ * @return RAMSlotInfo* New slot, NULL if allocation failed
+ */
+static RAMSlotInfo *appendSMBIOSSlot(RAMSlotList *slots, UINT *capacity)
+{
+    if (slots->count == *capacity)
+    {
+        UINT grown = *capacity ? *capacity * 2 : SMBIOS_SLOTS_INITIAL;
+        RAMSlotInfo *array = (RAMSlotInfo *)festRealloc(slots->slots, grown * sizeof(RAMSlotInfo));
+        if (!array)
+            return NULL;
+        slots->slots = array;
+        *capacity = grown;
+    }
+
+    RAMSlotInfo *slot = &slots->slots[slots->count++];
+    memset(slot, 0, sizeof(RAMSlotInfo));
+    return slot;
+}
+
+/**
+ * @brief Decodes a type 17 Memory Device into a slot
+ *
+ * Empty slots (size 0) are skipped, as Win32_PhysicalMemory does.
+ * Modules of 32 GB and more keep their size in MB in the Extended
+ * Size field (SMBIOS 2.7); speeds above 65534 MT/s in Extended
+ * Speed (SMBIOS 3.3).
+ *
+ * @param structure Memory Device structure
+ * @param slots List receiving the module
+ * @param capacity Allocated entries of the list
+ */
+static void decodeMemoryDevice(const SMBIOSStructure *structure, RAMSlotList *slots, UINT *capacity)
+{
+    WORD size = readSMBIOSWord(structure, 0x0C);
+    if (size == 0)
+        return;
+
+    RAMSlotInfo *slot = appendSMBIOSSlot(slots, capacity);
+    if (!slot)
+        return;
+
+    if (size == SMBIOS_SIZE_EXTENDED)
+        slot->capacity = (UINT64)(readSMBIOSDword(structure, 0x1C) & 0x7FFFFFFF) * 1024 * 1024;
+    else if (size != SMBIOS_SIZE_UNKNOWN && (size & SMBIOS_SIZE_IN_KB))
+        slot->capacity = (UINT64)(size & ~SMBIOS_SIZE_IN_KB) * 1024;
+    else if (size != SMBIOS_SIZE_UNKNOWN)
+        slot->capacity = (UINT64)size * 1024 * 1024;
+
+    slot->speed = readSMBIOSWord(structure, 0x15);
+    if (slot->speed == SMBIOS_SPEED_EXTENDED)
+        slot->speed = readSMBIOSDword(structure, 0x54);
+    slot->configuredSpeed = readSMBIOSWord(structure, 0x20);
+    if (slot->configuredSpeed == SMBIOS_SPEED_EXTENDED)
+        slot->configuredSpeed = readSMBIOSDword(structure, 0x58);
+
+    copySMBIOSString(structure, 0x10, slot->slot, sizeof(slot->slot));
+    copySMBIOSString(structure, 0x17, slot->manufacturer, sizeof(slot->manufacturer));
+}
+
+/**
+ * @brief Decodes a raw SMBIOS structure table
+ *
+ * Each structure is a formatted area of the length given in its
+ * header, followed by a string set ending in two NUL bytes. A
+ * structure running past the end of the table ends the walk.
+ *
+ * @param table Structure table, without the entry point
+ * @param length Size of the table in bytes
+ * @param board Receives board, BIOS and SKU strings, may be NULL
+ * @param slots Receives the populated slots, may be NULL
+ * @return BOOL TRUE if at least one structure was decoded
+ */
+BOOL parseSMBIOSTable(const BYTE *table, size_t length, MotherboardInfo *board, RAMSlotList *slots)
+{
+    BOOL decoded = FALSE;
+    BOOL boardFound = FALSE;
+    UINT capacity = 0;
+
+    if (slots)
+    {
+        slots->slots = NULL;
+        slots->count = 0;
+    }
+
+    const BYTE *end = table + length;
+    for (const BYTE *cursor = table; (size_t)(end - cursor) >= SMBIOS_HEADER_LENGTH;)
+    {
+        SMBIOSStructure structure = {cursor, cursor[1], NULL};
+        if (structure.length < SMBIOS_HEADER_LENGTH || structure.length > (size_t)(end - cursor))
+            break;
+
+        // Find the two NUL bytes closing the string set
+        const BYTE *next = cursor + structure.length;
+        while (next + 1 < end && (next[0] != 0 || next[1] != 0))
+            next++;
+        if (next + 1 >= end)
+            break;
+        structure.strings = (const char *)(cursor + structure.length);
+
+        BYTE type = cursor[0];
+        if (board && type == SMBIOS_TYPE_BIOS)
+        {
+            copySMBIOSString(&structure, 0x05, board->biosVersion, sizeof(board->biosVersion));
+        }
+        else if (board && type == SMBIOS_TYPE_SYSTEM)
+        {
+            copySMBIOSString(&structure, 0x07, board->biosSerial, sizeof(board->biosSerial));
+            copySMBIOSString(&structure, 0x19, board->systemSKU, sizeof(board->systemSKU));
+        }
+        else if (board && type == SMBIOS_TYPE_BASEBOARD && !boardFound)
+        {
+            // Servers list daughter boards after the main board
+            copySMBIOSString(&structure, 0x04, board->manufacturer, sizeof(board->manufacturer));
+            copySMBIOSString(&structure, 0x05, board->productName, sizeof(board->productName));
+            copySMBIOSString(&structure, 0x07, board->serialNumber, sizeof(board->serialNumber));
+            boardFound = TRUE;
+        }
+        else if (slots && type == SMBIOS_TYPE_MEMORY_DEVICE)
+        {
+            decodeMemoryDevice(&structure, slots, &capacity);
+        }
+
+        decoded = TRUE;
+        if (type == SMBIOS_TYPE_END)
+            break;
+        cursor = next + 2;
+    }
+    return decoded;
+}
+
+#ifdef _WIN32
+/**
+ * @brief Buffer returned by GetSystemFirmwareTable('RSMB')
+ *
+ * The SDK documents the layout but declares no type for it.
+ */
+typedef struct
+{
+    BYTE Used20CallingMethod; // Unused
+    BYTE SMBIOSMajorVersion;  // Major version of the table
+    BYTE SMBIOSMinorVersion;  // Minor version of the table
+    BYTE DmiRevision;         // Unused
+    DWORD Length;             // Size of the structure table
+    BYTE SMBIOSTableData[1];  // Structure table
+} RawSMBIOSData;
+
+/**
+ * @brief Reads the structure table through GetSystemFirmwareTable
+ *
+ * The table is moved to the start of the returned buffer.
+ *
+ * @param length Receives the size of the table in bytes
+ * @return BYTE* Structure table, NULL if unavailable
+ */
+BYTE *readSMBIOSTable(size_t *length)
+{
+    UINT size = GetSystemFirmwareTable('RSMB', 0, NULL, 0);
+    if (size <= offsetof(RawSMBIOSData, SMBIOSTableData))
+        return NULL;
+
+    RawSMBIOSData *raw = (RawSMBIOSData *)festMalloc(size);
+    if (!raw)
+        return NULL;
+
+    if (GetSystemFirmwareTable('RSMB', 0, raw, size) != size ||
+        raw->Length > size - offsetof(RawSMBIOSData, SMBIOSTableData))
+    {
+        festFree(raw);
+        return NULL;
+    }
+
+    *length = raw->Length;
+    memmove(raw, raw->SMBIOSTableData, raw->Length);
+    return (BYTE *)raw;
+}
+#elif defined(__linux__)
+/**
+ * @brief Reads the structure table exported in sysfs
+ *
+ * @param length Receives the size of the table in bytes
+ * @return BYTE* Structure table, NULL if missing or not readable
+ */
+BYTE *readSMBIOSTable(size_t *length)
+{
+    return (BYTE *)readSysfsFileAlloc(SMBIOS_DMI_TABLE_PATH, length);
+}
+#else
+/**
+ * @brief No SMBIOS access on this platform
+ *
+ * @param length Unused
+ * @return BYTE* Always NULL
+ */
+BYTE *readSMBIOSTable(size_t *length)
+{
+    (void)length;
+    return NULL;
+}
+#endif
+
+/**
+ * @brief Decodes board strings and RAM modules from one table read
+ *
+ * @param board Receives the board, BIOS and SKU strings, may be NULL
+ * @param slots Receives the installed RAM modules, may be NULL
+ * @return BOOL TRUE if the table was read and decoded, FALSE if unavailable
+ * @note Release the results with freeMotherboardInfo() and freeRAMSlotList()
+ */
+BOOL getSMBIOSInfo(MotherboardInfo **board, RAMSlotList **slots)
+{
+    if (board)
+        *board = NULL;
+    if (slots)
+        *slots = NULL;
+
+    size_t length = 0;
+    BYTE *table = readSMBIOSTable(&length);
+    if (!table)
+        return FALSE;
+
+    MotherboardInfo *info = board ? (MotherboardInfo *)festMalloc(sizeof(MotherboardInfo)) : NULL;
+    RAMSlotList *list = slots ? (RAMSlotList *)festMalloc(sizeof(RAMSlotList)) : NULL;
+    if (info)
+        memset(info, 0, sizeof(MotherboardInfo));
+    if (list)
+        memset(list, 0, sizeof(RAMSlotList));
+
+    BOOL ok = (!board || info) && (!slots || list) && parseSMBIOSTable(table, length, info, list);
+    festFree(table);
+
+    if (!ok)
+    {
+        freeMotherboardInfo(info);
+        freeRAMSlotList(list);
+        return FALSE;
+    }
+
+    if (board)
+        *board = info;
+    if (slots)
+        *slots = list;
+    return TRUE;
+}
+
+/**
+ * @brief Decodes the table for the static collectors of a session
+ *
+ * The motherboard and RAM slot collectors both open this hook, so
+ * the table is read and decoded by the first open and each result
+ * is handed to the first call of its getter.
+ *
+ * @return BOOL TRUE, collectors fall back to other sources without a table
+ */
+BOOL openSMBIOSCollector(void)
+{
+    AcquireSRWLockExclusive(&g_SMBIOSLock);
+    if (g_SMBIOSOpens++ == 0)
+        g_SMBIOSMissing = !getSMBIOSInfo(&g_SMBIOSBoard, &g_SMBIOSSlots);
+    ReleaseSRWLockExclusive(&g_SMBIOSLock);
+    return TRUE;
+}
+
+/**
+ * @brief Releases results no getter took, on the last close
+ */
+void closeSMBIOSCollector(void)
+{
+    AcquireSRWLockExclusive(&g_SMBIOSLock);
+    if (g_SMBIOSOpens > 0 && --g_SMBIOSOpens == 0)
+    {
+        freeMotherboardInfo(g_SMBIOSBoard);
+        freeRAMSlotList(g_SMBIOSSlots);
+        g_SMBIOSBoard = NULL;
+        g_SMBIOSSlots = NULL;
+        g_SMBIOSMissing = FALSE;
+    }
+    ReleaseSRWLockExclusive(&g_SMBIOSLock);
+}
+
+/**
+ * @brief Retrieves board, BIOS and SKU strings from SMBIOS
+ *
+ * Takes the strings decoded by openSMBIOSCollector() when they are
+ * still held, and reads the table otherwise.
+ *
+ * @return MotherboardInfo* Pointer to allocated information, NULL if the table is unavailable
+ * @note Caller is responsible for freeing the returned structure using freeMotherboardInfo()
+ */
+MotherboardInfo *getSMBIOSMotherboardInfo(void)
+{
+    AcquireSRWLockExclusive(&g_SMBIOSLock);
+    MotherboardInfo *info = g_SMBIOSBoard;
+    BOOL missing = g_SMBIOSMissing;
+    g_SMBIOSBoard = NULL;
+    ReleaseSRWLockExclusive(&g_SMBIOSLock);
+
+    if (!info && !missing)
+        getSMBIOSInfo(&info, NULL);
+    return info;
+}
+
+/**
+ * @brief Retrieves the installed RAM modules from SMBIOS
+ *
+ * Takes the modules decoded by openSMBIOSCollector() when they are
+ * still held, and reads the table otherwise.
+ *
+ * @return RAMSlotList* Pointer to allocated list of RAM modules, NULL if the table is unavailable
+ * @note Caller is responsible for freeing the returned list using freeRAMSlotList()
+ */
+RAMSlotList *getSMBIOSRAMSlotList(void)
+{
+    AcquireSRWLockExclusive(&g_SMBIOSLock);
+    RAMSlotList *list = g_SMBIOSSlots;
+    BOOL missing = g_SMBIOSMissing;
+    g_SMBIOSSlots = NULL;
+    ReleaseSRWLockExclusive(&g_SMBIOSLock);
+
+    if (!list && !missing)
+        getSMBIOSInfo(NULL, &list);
+    return list;
+}
@@ -0,0 +1,192 @@
+#include "snapshot_arena.h"
+#include "fest_alloc.h"
+
+#define ARENA_ALIGNMENT 16 // Matches the alignment of festMalloc blocks
+
+/**
+ * @brief Header of a block of arena memory
+ *
+ * Data starts at the header size rounded up to
+ * ARENA_ALIGNMENT, so every block is aligned
+ */
+struct ArenaChunk
+{
+    ArenaChunk *next; // Next chunk in the chain
+    size_t capacity;  // Usable bytes after the header
+    size_t used;      // Bytes handed out from this chunk
+};
+
+/**
+ * @brief Rounds a size up to the arena alignment
+ *
+ * @param size Size in bytes
+ * @return size_t Aligned size
+ */
+static size_t alignSize(size_t size)
+{
+    return (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+/**
+ * @brief Allocates an empty chunk
+ *
+ * @param capacity Usable bytes of the chunk
+ * @return ArenaChunk* New chunk, NULL if allocation failed
+ */
+static ArenaChunk *createChunk(size_t capacity)
+{
+    ArenaChunk *chunk = (ArenaChunk *)festMalloc(alignSize(sizeof(ArenaChunk)) + capacity);
+    if (!chunk)
+        return NULL;
+
+    chunk->next = NULL;
+    chunk->capacity = capacity;
+    chunk->used = 0;
+    return chunk;
+}
+
+/**
+ * @brief Releases a chain of chunks
+ *
+ * @param chunk First chunk of the chain, may be NULL
+ */
+static void releaseChunks(ArenaChunk *chunk)
+{
+    while (chunk)
+    {
+        ArenaChunk *next = chunk->next;
+        festFree(chunk);
+        chunk = next;
+    }
+}
+
+/**
+ * @brief Prepares an arena with one chunk of the given size
+ *
+ * @param arena Arena to initialize
+ * @param initialSize Capacity of the first chunk in bytes
+ * @return BOOL TRUE if the first chunk was allocated, FALSE if failed
+ */
+BOOL initSnapshotArena(SnapshotArena *arena, size_t initialSize)
+{
+    if (!arena)
+        return FALSE;
+
+    arena->chunks = createChunk(alignSize(initialSize));
+    arena->current = arena->chunks;
+    arena->used = 0;
+    arena->highWater = 0;
+    return arena->chunks != NULL;
+}
+
+/**
+ * @brief Allocates a block from the arena
+ *
+ * This function:
+ * 1. Bumps the offset of the current chunk if the block fits
+ * 2. Otherwise moves to the next chunk, reusing chunks kept
+ *    from earlier ticks before allocating a new one
+ *
+ * @param arena Arena to allocate from
+ * @param size Number of bytes to allocate
+ * @return void* Pointer to the block, NULL if failed
+ */
+void *arenaAlloc(SnapshotArena *arena, size_t size)
+{
+    if (!arena || !arena->current)
+        return NULL;
+
+    size = alignSize(size ? size : 1);
+    ArenaChunk *chunk = arena->current;
+
+    while (chunk->capacity - chunk->used < size)
+    {
+        if (!chunk->next)
+        {
+            size_t capacity = chunk->capacity * 2;
+            chunk->next = createChunk(capacity > size ? capacity : size);
+            if (!chunk->next)
+                return NULL;
+        }
+        chunk = chunk->next;
+        chunk->used = 0;
+    }
+
+    void *block = (BYTE *)chunk + alignSize(sizeof(ArenaChunk)) + chunk->used;
+    chunk->used += size;
+    arena->current = chunk;
+    arena->used += size;
+    if (arena->used > arena->highWater)
+        arena->highWater = arena->used;
+    return block;
+}
+
+/**
+ * @brief Invalidates all blocks and makes the memory reusable
+ *
+ * A chain of several chunks means the snapshot outgrew the first
+ * one; it is replaced by a single chunk large enough for the
+ * high-water mark, so later ticks bump through contiguous memory.
+ *
+ * @param arena Arena to reset
+ */
+void resetSnapshotArena(SnapshotArena *arena)
+{
+    if (!arena || !arena->chunks)
+        return;
+
+    if (arena->chunks->next)
+    {
+        ArenaChunk *merged = createChunk(alignSize(arena->highWater));
+        if (merged)
+        {
+            releaseChunks(arena->chunks);
+            arena->chunks = merged;
+        }
+    }
+
+    arena->chunks->used = 0;
+    arena->current = arena->chunks;
+    arena->used = 0;
+}
+
+/**
+ * @brief Releases all memory owned by the arena
+ *
+ * @param arena Arena to release, may be reinitialized afterwards
+ */
+void releaseSnapshotArena(SnapshotArena *arena)
+{
+    if (!arena)
+        return;
+
+    releaseChunks(arena->chunks);
+    arena->chunks = NULL;
+    arena->current = NULL;
+    arena->used = 0;
+    arena->highWater = 0;
+}
+
+/**
+ * @brief Allocates collector output from an arena or the heap
+ *
+ * @param arena Snapshot arena, NULL to use festMalloc()
+ * @param size Number of bytes to allocate
+ * @return void* Pointer to the block, NULL if failed
+ */
+void *snapshotAlloc(SnapshotArena *arena, size_t size)
+{
+    return arena ? arenaAlloc(arena, size) : festMalloc(size);
+}
+
+/**
+ * @brief Releases a block obtained from snapshotAlloc()
+ *
+ * @param arena Arena the block came from, NULL for heap blocks
+ * @param ptr Block to release, NULL is ignored
+ */
+void snapshotFree(SnapshotArena *arena, void *ptr)
+{
+    if (!arena)
+        festFree(ptr);
+}
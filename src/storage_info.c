@@ -1,230 +1,248 @@
 #include "storage_info.h"
+#include "storage_join.h"
+#include "storage_topology.h"
+#include "fest_alloc.h"
 #include "wmi_helper.h"
 #include <stdio.h>
 
+#ifdef _WIN32
+#define STORAGE_PATH_LENGTH 512 // Longest association reference path read
+
 /**
- * @brief Structure to map physical disks to logical drive letters
+ * @brief Win32_DiskDrive row before the join
  */
 typedef struct
 {
-    char logicalDrive[4];
-    PhysicalDiskInfo info;
-} DiskMapping;
+    char deviceID[STORAGE_KEY_LENGTH]; // Join key, e.g. \\.\PHYSICALDRIVE0
+    char model[256];                   // Device model
+    char interfaceType[64];            // Connection type (SATA, NVMe, etc.)
+    UINT64 size;                       // Capacity in bytes
+} DiskDriveRow;
 
 /**
- * @brief Container for disk mapping information
+ * @brief Win32_LogicalDisk row before the join
  */
 typedef struct
 {
-    DiskMapping *mappings;
-    UINT count;
-} DiskMappingList;
+    char deviceID[STORAGE_KEY_LENGTH]; // Join key, the drive letter (e.g. "C:")
+    UINT driveType;                    // Win32_LogicalDisk DriveType code
+    UINT64 freeSpace;                  // Available space in bytes
+    char volumeName[256];              // Volume label
+    char fileSystem[16];               // Filesystem type (NTFS, FAT32, ...)
+} LogicalVolumeRow;
+
+static const WMIPropertySpec g_DiskDriveProperties[] = {
+    WMI_STRING_PROPERTY(L"DeviceID", DiskDriveRow, deviceID),
+    WMI_STRING_PROPERTY(L"Model", DiskDriveRow, model),
+    WMI_STRING_PROPERTY(L"InterfaceType", DiskDriveRow, interfaceType),
+    WMI_UINT64_PROPERTY(L"Size", DiskDriveRow, size)};
+
+static const WMIQuerySpec g_DiskDriveQuery = {
+    L"Win32_DiskDrive", g_DiskDriveProperties, WMI_PROPERTY_COUNT(g_DiskDriveProperties), NULL};
 
 /**
- * @brief Retrieves physical disk information and maps to logical drives
+ * @brief Association references, decoded by decodeStorageLink()
+ */
+static const WMIPropertySpec g_StorageLinkProperties[] = {
+    WMI_COLUMN(L"Antecedent"),
+    WMI_COLUMN(L"Dependent")};
+
+static const WMIQuerySpec g_DiskPartitionQuery = {
+    L"Win32_DiskDriveToDiskPartition", g_StorageLinkProperties, WMI_PROPERTY_COUNT(g_StorageLinkProperties), NULL};
+
+static const WMIQuerySpec g_PartitionVolumeQuery = {
+    L"Win32_LogicalDiskToPartition", g_StorageLinkProperties, WMI_PROPERTY_COUNT(g_StorageLinkProperties), NULL};
+
+static const WMIPropertySpec g_LogicalDiskProperties[] = {
+    WMI_STRING_PROPERTY(L"DeviceID", LogicalVolumeRow, deviceID),
+    WMI_UINT32_PROPERTY(L"DriveType", LogicalVolumeRow, driveType),
+    WMI_UINT64_PROPERTY(L"FreeSpace", LogicalVolumeRow, freeSpace),
+    WMI_STRING_PROPERTY(L"VolumeName", LogicalVolumeRow, volumeName),
+    WMI_STRING_PROPERTY(L"FileSystem", LogicalVolumeRow, fileSystem)};
+
+static const WMIQuerySpec g_LogicalDiskQuery = {
+    L"Win32_LogicalDisk", g_LogicalDiskProperties, WMI_PROPERTY_COUNT(g_LogicalDiskProperties), NULL};
+
+/**
+ * @brief Decodes the two references of an association object
  *
- * This function queries WMI to get physical disk information and establishes
- * the relationship between physical disks and their logical drive letters.
+ * @param pclsObj Win32_DiskDriveToDiskPartition or Win32_LogicalDiskToPartition object
+ * @param row StorageLinkRow to fill
+ * @param context Unused
+ * @return BOOL TRUE if both DeviceID keys were found
+ */
+static BOOL decodeStorageLink(IWbemClassObject *pclsObj, void *row, void *context)
+{
+    StorageLinkRow *link = (StorageLinkRow *)row;
+    char path[STORAGE_PATH_LENGTH];
+
+    if (!getWMIPropertyString(pclsObj, L"Antecedent", path, sizeof(path)) ||
+        !parseStorageObjectKey(path, link->antecedent, sizeof(link->antecedent)))
+        return FALSE;
+
+    if (!getWMIPropertyString(pclsObj, L"Dependent", path, sizeof(path)) ||
+        !parseStorageObjectKey(path, link->dependent, sizeof(link->dependent)))
+        return FALSE;
+
+    return TRUE;
+}
+
+/**
+ * @brief Gets the display name of a Win32_LogicalDisk DriveType
  *
- * @param session Active WMI session
- * @return DiskMappingList* List of disk mappings, NULL if failed
+ * @param driveType DriveType code
+ * @return const char* Display name, NULL if the type was not reported
  */
-static DiskMappingList *getPhysicalDiskMappings(WMISession *session)
+static const char *getDriveTypeName(UINT driveType)
 {
-    DiskMappingList *mappings = (DiskMappingList *)malloc(sizeof(DiskMappingList));
-    if (!mappings)
+    switch (driveType)
+    {
+    case 0:
         return NULL;
+    case 2:
+        return "Removable Disk";
+    case 3:
+        return "Local Disk";
+    case 4:
+        return "Network Drive";
+    case 5:
+        return "CD/DVD Drive";
+    case 6:
+        return "RAM Disk";
+    default:
+        return "Unknown";
+    }
+}
 
-    mappings->mappings = NULL;
-    mappings->count = 0;
+/**
+ * @brief Applies one volume of a disk to the disk's entry
+ *
+ * A disk with several volumes reports the last one joined
+ *
+ * @param entry Topology entry of the physical disk
+ * @param volume Joined Win32_LogicalDisk row
+ */
+static void applyLogicalVolume(StorageVolumeEntry *entry, const LogicalVolumeRow *volume)
+{
+    LogicalDiskInfo *disk = &entry->info;
+    strcpy_s(disk->drive, sizeof(disk->drive), volume->deviceID);
+    _snprintf_s(entry->mountPoint, sizeof(entry->mountPoint), _TRUNCATE, "%s\\", volume->deviceID);
+    strcpy_s(disk->mountPoint, sizeof(disk->mountPoint), entry->mountPoint);
+    strcpy_s(disk->fileSystem, sizeof(disk->fileSystem), volume->fileSystem);
 
-    IEnumWbemClassObject *pDiskEnum = NULL;
-    if (executeWQLQuery(session, L"SELECT * FROM Win32_DiskDrive", &pDiskEnum))
-    {
-        IWbemClassObject *pDiskObj = NULL;
-        ULONG uReturn = 0;
+    const char *typeName = getDriveTypeName(volume->driveType);
+    if (typeName)
+        strcpy_s(disk->type, sizeof(disk->type), typeName);
 
-        while (SUCCEEDED(pDiskEnum->lpVtbl->Next(pDiskEnum, WBEM_INFINITE, 1, &pDiskObj, &uReturn)) && uReturn != 0)
-        {
-            VARIANT vtProp;
-            PhysicalDiskInfo diskInfo;
-            wchar_t deviceID[256];
-
-            // Get disk device ID
-            if (SUCCEEDED(pDiskObj->lpVtbl->Get(pDiskObj, L"DeviceID", 0, &vtProp, 0, 0)) && vtProp.vt != VT_NULL)
-            {
-                wcscpy_s(deviceID, 256, vtProp.bstrVal);
-            }
-            VariantClear(&vtProp);
-
-            // Get disk model
-            getWMIPropertyString(pDiskObj, L"Model", diskInfo.model, sizeof(diskInfo.model));
-
-            // Get interface type
-            getWMIPropertyString(pDiskObj, L"InterfaceType", diskInfo.interfaceType, sizeof(diskInfo.interfaceType));
-
-            // Get associated partitions
-            IEnumWbemClassObject *pPartEnum = NULL;
-            wchar_t query[512];
-            swprintf_s(query, 512, L"ASSOCIATORS OF {Win32_DiskDrive.DeviceID='%s'} WHERE AssocClass = Win32_DiskDriveToDiskPartition", deviceID);
-
-            if (executeWQLQuery(session, query, &pPartEnum))
-            {
-                IWbemClassObject *pPartObj = NULL;
-                ULONG uPartReturn = 0;
-
-                while (SUCCEEDED(pPartEnum->lpVtbl->Next(pPartEnum, WBEM_INFINITE, 1, &pPartObj, &uPartReturn)) && uPartReturn != 0)
-                {
-                    VARIANT vtPartProp;
-                    if (SUCCEEDED(pPartObj->lpVtbl->Get(pPartObj, L"DeviceID", 0, &vtPartProp, 0, 0)))
-                    {
-                        // Get logical disks for each partition
-                        IEnumWbemClassObject *pLogicalEnum = NULL;
-                        wchar_t partQuery[512];
-                        swprintf_s(partQuery, 512, L"ASSOCIATORS OF {Win32_DiskPartition.DeviceID='%s'} WHERE AssocClass = Win32_LogicalDiskToPartition", vtPartProp.bstrVal);
-
-                        if (executeWQLQuery(session, partQuery, &pLogicalEnum))
-                        {
-                            IWbemClassObject *pLogicalObj = NULL;
-                            ULONG uLogicalReturn = 0;
-
-                            while (SUCCEEDED(pLogicalEnum->lpVtbl->Next(pLogicalEnum, WBEM_INFINITE, 1, &pLogicalObj, &uLogicalReturn)) && uLogicalReturn != 0)
-                            {
-                                VARIANT vtLogicalProp;
-                                if (SUCCEEDED(pLogicalObj->lpVtbl->Get(pLogicalObj, L"DeviceID", 0, &vtLogicalProp, 0, 0)))
-                                {
-                                    // Add new mapping
-                                    mappings->count++;
-                                    mappings->mappings = (DiskMapping *)realloc(mappings->mappings, sizeof(DiskMapping) * mappings->count);
-
-                                    DiskMapping *mapping = &mappings->mappings[mappings->count - 1];
-                                    wcstombs_s(NULL, mapping->logicalDrive, 4, vtLogicalProp.bstrVal, _TRUNCATE);
-                                    memcpy(&mapping->info, &diskInfo, sizeof(PhysicalDiskInfo));
-                                }
-                                VariantClear(&vtLogicalProp);
-                                pLogicalObj->lpVtbl->Release(pLogicalObj);
-                            }
-                            pLogicalEnum->lpVtbl->Release(pLogicalEnum);
-                        }
-                    }
-                    VariantClear(&vtPartProp);
-                    pPartObj->lpVtbl->Release(pPartObj);
-                }
-                pPartEnum->lpVtbl->Release(pPartEnum);
-            }
-            pDiskObj->lpVtbl->Release(pDiskObj);
-        }
-        pDiskEnum->lpVtbl->Release(pDiskEnum);
-    }
+    disk->freeSpace = (double)volume->freeSpace / (1024.0 * 1024.0 * 1024.0);
 
-    return mappings;
+    // Use the volume name when the disk reports no model
+    if (strlen(disk->model) == 0)
+        strcpy_s(disk->model, sizeof(disk->model), volume->volumeName);
 }
 
 /**
- * @brief Gets logical disk information for a physical disk
+ * @brief Discovers disks, their volumes and the mapping between them
  *
- * This function follows the association chain:
- * Physical Disk -> Partition -> Logical Disk
- * to get information about logical drives associated with a physical disk.
+ * Disks, both association classes and logical disks are read
+ * with one flat query each and joined in memory on DeviceID,
+ * so the number of queries does not grow with disk or
+ * partition count. The queries are started together and
+ * waited for once, so the build costs the slowest query
+ * rather than the sum of all four.
  *
- * @param session Active WMI session
- * @param deviceID Physical disk device ID
- * @param disk Pointer to LogicalDiskInfo structure to fill
+ * @param topology Receives one entry per physical disk
+ * @return BOOL TRUE on success, FALSE if WMI was unavailable, a query did not complete or allocation failed
  */
-static void getLogicalDisksForPhysicalDisk(WMISession *session, const wchar_t *deviceID, LogicalDiskInfo *disk)
+static BOOL buildWMIStorageTopology(StorageTopology *topology)
 {
-    wchar_t query[512];
-    swprintf_s(query, 512,
-               L"ASSOCIATORS OF {Win32_DiskDrive.DeviceID='%s'} "
-               L"WHERE AssocClass = Win32_DiskDriveToDiskPartition",
-               deviceID);
-
-    IEnumWbemClassObject *pPartEnum = NULL;
-    if (executeWQLQuery(session, query, &pPartEnum))
+    topology->entries = NULL;
+    topology->count = 0;
+
+    // Lease the thread's pooled WMI connection
+    WMISession *session = acquireWMISession();
+    if (!session)
+        return FALSE;
+
+    WMIRowVector disks, diskPartitions, partitionVolumes, volumes;
+    initWMIRowVector(&disks, NULL, sizeof(DiskDriveRow), 4);
+    initWMIRowVector(&diskPartitions, NULL, sizeof(StorageLinkRow), 8);
+    initWMIRowVector(&partitionVolumes, NULL, sizeof(StorageLinkRow), 8);
+    initWMIRowVector(&volumes, NULL, sizeof(LogicalVolumeRow), 8);
+
+    // The four queries run in the provider at the same time
+    WMIAsyncQuery queries[4];
+    startWMIProjectedQuery(session, &g_DiskDriveQuery, &disks, NULL, NULL, 0, &queries[0]);
+    startWMIProjectedQuery(session, &g_DiskPartitionQuery, &diskPartitions, decodeStorageLink, NULL, 0, &queries[1]);
+    startWMIProjectedQuery(session, &g_PartitionVolumeQuery, &partitionVolumes, decodeStorageLink, NULL, 0, &queries[2]);
+    startWMIProjectedQuery(session, &g_LogicalDiskQuery, &volumes, NULL, NULL, 0, &queries[3]);
+    waitWMIQueries(queries, 4);
+
+    releaseWMISession(session);
+
+    // A failed, timed out or cancelled query leaves a partial topology;
+    // failing the build keeps it out of the cache so the next tick retries
+    BOOL ok = TRUE;
+    for (int i = 0; i < 4; i++)
     {
-        IWbemClassObject *pPartObj = NULL;
-        ULONG uPartReturn = 0;
+        if (queries[i].state != WMI_QUERY_COMPLETE || FAILED(queries[i].result))
+            ok = FALSE;
+    }
 
-        while (SUCCEEDED(pPartEnum->lpVtbl->Next(pPartEnum, WBEM_INFINITE, 1, &pPartObj, &uPartReturn)) && uPartReturn != 0)
+    if (ok && disks.count > 0)
+    {
+        topology->entries = (StorageVolumeEntry *)festMalloc(sizeof(StorageVolumeEntry) * disks.count);
+        ok = topology->entries != NULL;
+    }
+
+    if (topology->entries)
+    {
+        const DiskDriveRow *diskRows = (const DiskDriveRow *)disks.rows;
+        topology->count = disks.count;
+        for (UINT i = 0; i < disks.count; i++)
         {
-            VARIANT vtPartID;
-            if (SUCCEEDED(pPartObj->lpVtbl->Get(pPartObj, L"DeviceID", 0, &vtPartID, 0, 0)))
-            {
-                wchar_t partQuery[512];
-                swprintf_s(partQuery, 512,
-                           L"ASSOCIATORS OF {Win32_DiskPartition.DeviceID='%s'} "
-                           L"WHERE AssocClass = Win32_LogicalDiskToPartition",
-                           vtPartID.bstrVal);
-
-                IEnumWbemClassObject *pLogicalEnum = NULL;
-                if (executeWQLQuery(session, partQuery, &pLogicalEnum))
-                {
-                    IWbemClassObject *pLogicalObj = NULL;
-                    ULONG uLogicalReturn = 0;
-
-                    while (SUCCEEDED(pLogicalEnum->lpVtbl->Next(pLogicalEnum, WBEM_INFINITE, 1, &pLogicalObj, &uLogicalReturn)) && uLogicalReturn != 0)
-                    {
-                        // Get drive letter
-                        char driveLetter[4] = {0};
-                        if (getWMIPropertyString(pLogicalObj, L"DeviceID", driveLetter, sizeof(driveLetter)))
-                        {
-                            strcpy_s(disk->drive, sizeof(disk->drive), driveLetter);
-                        }
-
-                        // Get drive type
-                        VARIANT vtDriveType;
-                        if (SUCCEEDED(pLogicalObj->lpVtbl->Get(pLogicalObj, L"DriveType", 0, &vtDriveType, 0, 0)) && vtDriveType.vt != VT_NULL)
-                        {
-                            switch (vtDriveType.uintVal)
-                            {
-                            case 2:
-                                strcpy_s(disk->type, sizeof(disk->type), "Removable Disk");
-                                break;
-                            case 3:
-                                strcpy_s(disk->type, sizeof(disk->type), "Local Disk");
-                                break;
-                            case 4:
-                                strcpy_s(disk->type, sizeof(disk->type), "Network Drive");
-                                break;
-                            case 5:
-                                strcpy_s(disk->type, sizeof(disk->type), "CD/DVD Drive");
-                                break;
-                            case 6:
-                                strcpy_s(disk->type, sizeof(disk->type), "RAM Disk");
-                                break;
-                            default:
-                                strcpy_s(disk->type, sizeof(disk->type), "Unknown");
-                                break;
-                            }
-                        }
-                        VariantClear(&vtDriveType);
-
-                        // Get free space
-                        VARIANT vtFreeSpace;
-                        if (SUCCEEDED(pLogicalObj->lpVtbl->Get(pLogicalObj, L"FreeSpace", 0, &vtFreeSpace, 0, 0)) && vtFreeSpace.vt != VT_NULL)
-                        {
-                            disk->freeSpace = _wtof(vtFreeSpace.bstrVal) / (1024.0 * 1024.0 * 1024.0);
-                        }
-                        VariantClear(&vtFreeSpace);
-
-                        // Get volume name for model if empty
-                        if (strlen(disk->model) == 0)
-                        {
-                            getWMIPropertyString(pLogicalObj, L"VolumeName", disk->model, sizeof(disk->model));
-                        }
-
-                        pLogicalObj->lpVtbl->Release(pLogicalObj);
-                    }
-                    pLogicalEnum->lpVtbl->Release(pLogicalEnum);
-                }
-            }
-            VariantClear(&vtPartID);
-            pPartObj->lpVtbl->Release(pPartObj);
+            StorageVolumeEntry *entry = &topology->entries[i];
+            LogicalDiskInfo *disk = &entry->info;
+            memset(entry, 0, sizeof(StorageVolumeEntry));
+            strcpy_s(disk->drive, sizeof(disk->drive), "N/A");
+            strcpy_s(disk->type, sizeof(disk->type), "Local Disk");
+            strcpy_s(disk->model, sizeof(disk->model), diskRows[i].model);
+            strcpy_s(disk->interfaceType, sizeof(disk->interfaceType), diskRows[i].interfaceType);
+            disk->diskSize = (double)diskRows[i].size / (1024.0 * 1024.0 * 1024.0);
+            disk->totalSize = disk->diskSize;
+        }
+
+        StorageJoinInput input = {
+            {disks.rows, disks.count, sizeof(DiskDriveRow), offsetof(DiskDriveRow, deviceID)},
+            (const StorageLinkRow *)diskPartitions.rows,
+            diskPartitions.count,
+            (const StorageLinkRow *)partitionVolumes.rows,
+            partitionVolumes.count,
+            {volumes.rows, volumes.count, sizeof(LogicalVolumeRow), offsetof(LogicalVolumeRow, deviceID)}};
+
+        StorageJoinMatch *matches = NULL;
+        UINT matchCount = 0;
+        if (joinStorageTables(&input, NULL, &matches, &matchCount))
+        {
+            const LogicalVolumeRow *volumeRows = (const LogicalVolumeRow *)volumes.rows;
+            for (UINT i = 0; i < matchCount; i++)
+                applyLogicalVolume(&topology->entries[matches[i].disk], &volumeRows[matches[i].volume]);
+            snapshotFree(NULL, matches);
         }
-        pPartEnum->lpVtbl->Release(pPartEnum);
     }
+
+    releaseWMIRowVector(&volumes);
+    releaseWMIRowVector(&partitionVolumes);
+    releaseWMIRowVector(&diskPartitions);
+    releaseWMIRowVector(&disks);
+    return ok;
 }
 
+/**
+ * @brief Storage topology shared by every caller of the collector
+ */
+static StorageTopologyCache g_StorageTopology = STORAGE_TOPOLOGY_CACHE_INIT(buildWMIStorageTopology);
+
 /**
  * @brief Retrieves comprehensive storage device information
  *
@@ -240,99 +258,43 @@ static void getLogicalDisksForPhysicalDisk(WMISession *session, const wchar_t *d
  *    - Free space
  *    - Volume names
  *
+ * Everything but the space figures comes from the cached
+ * topology, rediscovered through WMI only when a drive letter
+ * appears or disappears. Size and free space of each volume
+ * are read with GetDiskFreeSpaceEx on every call.
+ *
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
  * @return StorageList* Pointer to allocated storage information list, NULL if failed
- * @note Caller is responsible for freeing the returned list using freeStorageList()
+ * @note Without an arena, caller is responsible for freeing the returned list using freeStorageList()
  */
-StorageList *getStorageList(void)
+StorageList *collectStorageList(SnapshotArena *arena)
 {
-    StorageList *list = (StorageList *)malloc(sizeof(StorageList));
-    if (!list)
-        return NULL;
-
-    list->disks = NULL;
-    list->count = 0;
-
-    // Initialize WMI connection
-    WMISession *session = initializeWMI();
-    if (!session)
-    {
-        free(list);
-        return NULL;
-    }
-
-    // Query physical disk information
-    IEnumWbemClassObject *pEnumerator = NULL;
-    if (executeWQLQuery(session, L"SELECT * FROM Win32_DiskDrive", &pEnumerator))
-    {
-        IWbemClassObject *pclsObj = NULL;
-        ULONG uReturn = 0;
-
-        // Count disks first
-        while (SUCCEEDED(pEnumerator->lpVtbl->Next(pEnumerator, WBEM_INFINITE, 1, &pclsObj, &uReturn)) && uReturn != 0)
-        {
-            list->count++;
-            pclsObj->lpVtbl->Release(pclsObj);
-        }
-        pEnumerator->lpVtbl->Release(pEnumerator);
+    return collectStorageSpace(&g_StorageTopology, arena);
+}
 
-        if (list->count > 0)
-        {
-            // Allocate memory for disks
-            list->disks = (LogicalDiskInfo *)malloc(sizeof(LogicalDiskInfo) * list->count);
-            if (!list->disks)
-            {
-                cleanupWMI(session);
-                free(list);
-                return NULL;
-            }
-
-            // Re-query to get data
-            if (executeWQLQuery(session, L"SELECT * FROM Win32_DiskDrive", &pEnumerator))
-            {
-                UINT i = 0;
-                while (SUCCEEDED(pEnumerator->lpVtbl->Next(pEnumerator, WBEM_INFINITE, 1, &pclsObj, &uReturn)) && uReturn != 0)
-                {
-                    LogicalDiskInfo *disk = &list->disks[i];
-
-                    // Initialize with default values
-                    memset(disk, 0, sizeof(LogicalDiskInfo));
-                    strcpy_s(disk->drive, sizeof(disk->drive), "N/A");
-                    strcpy_s(disk->type, sizeof(disk->type), "Local Disk");
-
-                    // Get disk model
-                    getWMIPropertyString(pclsObj, L"Model", disk->model, sizeof(disk->model));
-
-                    // Get interface type
-                    getWMIPropertyString(pclsObj, L"InterfaceType", disk->interfaceType, sizeof(disk->interfaceType));
-
-                    // Get size information
-                    VARIANT vtProp;
-                    if (SUCCEEDED(pclsObj->lpVtbl->Get(pclsObj, L"Size", 0, &vtProp, 0, 0)) && vtProp.vt != VT_NULL)
-                    {
-                        disk->totalSize = _wtof(vtProp.bstrVal) / (1024.0 * 1024.0 * 1024.0);
-                    }
-                    VariantClear(&vtProp);
-
-                    // Get device ID and logical disk information
-                    VARIANT vtDeviceID;
-                    if (SUCCEEDED(pclsObj->lpVtbl->Get(pclsObj, L"DeviceID", 0, &vtDeviceID, 0, 0)) && vtDeviceID.vt != VT_NULL)
-                    {
-                        getLogicalDisksForPhysicalDisk(session, vtDeviceID.bstrVal, disk);
-                        VariantClear(&vtDeviceID);
-                    }
-
-                    pclsObj->lpVtbl->Release(pclsObj);
-                    i++;
-                }
-                pEnumerator->lpVtbl->Release(pEnumerator);
-            }
-        }
-    }
+/**
+ * @brief Drops the cached storage topology
+ *
+ * The next collection rediscovers it through WMI.
+ */
+void releaseStorageTopology(void)
+{
+    releaseStorageTopologyCache(&g_StorageTopology);
+}
 
-    cleanupWMI(session);
-    return list;
+/**
+ * @brief Retrieves storage volume information from the heap
+ *
+ * @return StorageList* Pointer to allocated storage volume information, NULL if failed
+ * @note Caller is responsible for freeing the returned structure using freeStorageList()
+ */
+StorageList *getStorageList(void)
+{
+    return collectStorageList(NULL);
 }
 
+#endif // _WIN32
+
 /**
  * @brief Frees memory allocated for StorageList structure
  *
@@ -343,8 +305,8 @@ void freeStorageList(StorageList *list)
     if (list)
     {
         if (list->disks)
-            free(list->disks);
-        free(list);
+            festFree(list->disks);
+        festFree(list);
     }
 }
 
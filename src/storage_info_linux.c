@@ -0,0 +1,513 @@
+#include "storage_info.h"
+#include "storage_topology.h"
+#include "fest_alloc.h"
+#include "linux_sysfs.h"
+#include <stdio.h>
+
+#define PROC_MOUNTINFO_PATH "/proc/self/mountinfo" // Mount table of the process' mount namespace
+#define STORAGE_NAME_LENGTH 32                     // Longest block device name kept
+#define STORAGE_NO_ENTRY ((UINT)-1)                // Empty hash slot
+#define SECTOR_SIZE 512ULL                         // Unit of /sys/block/<disk>/size
+#define BYTES_PER_GB (1024.0 * 1024.0 * 1024.0)
+
+/**
+ * @brief One line of mountinfo kept after filtering
+ *
+ * Strings point into the mountinfo buffer, unescaped in place.
+ */
+typedef struct
+{
+    UINT64 dev;             // major << 32 | minor of the mounted device
+    const char *root;       // Directory of the filesystem mounted, "/" unless a bind mount
+    const char *mountPoint; // Mount point
+    const char *fileSystem; // Filesystem type
+    const char *source;     // Mount source, "/dev/..." for block devices, "pool/dataset" for ZFS
+} LinuxMount;
+
+/**
+ * @brief Description of one disk, read once per topology build
+ */
+typedef struct
+{
+    char name[STORAGE_NAME_LENGTH]; // Disk name below /sys/block
+    char model[256];                // Device model
+    char interfaceType[64];         // Bus the disk hangs off
+    char type[32];                  // Local, removable or optical
+    BOOL rotational;                // Spinning platters
+    UINT64 size;                    // Capacity in bytes
+} LinuxDisk;
+
+/**
+ * @brief Bus of a disk, recognized in its /sys/devices path
+ *
+ * Checked in order: a USB enclosure hides the SATA or NVMe
+ * bridge behind it.
+ */
+static const struct
+{
+    const char *pathPart;      // Part of the /sys/devices path
+    const char *interfaceType; // Reported connection type
+} g_DiskBuses[] = {
+    {"/usb", "USB"},
+    {"/nvme/", "NVMe"},
+    {"/ata", "SATA"},
+    {"/mmc_host/", "SD/MMC"},
+    {"/virtio", "VirtIO"},
+    {"/virtual/", "Virtual"},
+    {"/host", "SCSI"}};
+
+/**
+ * @brief Block device filesystems that are not volumes
+ *
+ * Snap packages mount one read-only squashfs image per revision,
+ * always full and irrelevant to free space.
+ */
+static const char *const g_SkippedFileSystems[] = {"squashfs"};
+
+/**
+ * @brief Local filesystems mounted from a pool instead of a /dev node
+ *
+ * ZFS mounts every dataset with a source of "pool/dataset" and an
+ * anonymous device number; each dataset is reported as a volume.
+ */
+static const char *const g_PoolFileSystems[] = {"zfs"};
+
+/**
+ * @brief FNV-1a hash of a string
+ */
+static UINT hashName(const char *name)
+{
+    UINT hash = 2166136261u;
+    for (; *name; name++)
+    {
+        hash ^= (BYTE)*name;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Hash of a device number
+ */
+static UINT hashDevice(UINT64 dev)
+{
+    dev ^= dev >> 29;
+    dev *= 0xBF58476D1CE4E5B9ULL;
+    return (UINT)(dev ^ (dev >> 32));
+}
+
+/**
+ * @brief Returns the slot count of a hash table holding count keys
+ *
+ * @param count Number of keys
+ * @return UINT Power of two, at least twice the count
+ */
+static UINT hashSlotCount(UINT count)
+{
+    UINT slotCount = 8;
+    while (slotCount < count * 2)
+        slotCount *= 2;
+    return slotCount;
+}
+
+/**
+ * @brief Undoes the octal escaping of a mountinfo field in place
+ *
+ * Space, tab, newline and backslash are written as \040, \011,
+ * \012 and \134.
+ *
+ * @param field Terminated field
+ */
+static void unescapeMountField(char *field)
+{
+    char *out = field;
+    for (const char *in = field; *in; out++)
+    {
+        if (in[0] == '\\' && in[1] >= '0' && in[1] <= '3' && in[2] >= '0' && in[2] <= '7' && in[3] >= '0' && in[3] <= '7')
+        {
+            *out = (char)(((in[1] - '0') << 6) | ((in[2] - '0') << 3) | (in[3] - '0'));
+            in += 4;
+        }
+        else
+        {
+            *out = *in++;
+        }
+    }
+    *out = '\0';
+}
+
+/**
+ * @brief Splits one mountinfo line
+ *
+ * "36 35 98:0 /mnt1 /mnt/parent rw master:1 - ext3 /dev/root rw":
+ * id, parent id, major:minor, root, mount point, options, a
+ * variable number of optional fields closed by "-", filesystem
+ * type, source and superblock options.
+ *
+ * @param line Terminated line, split and unescaped in place
+ * @param mount Receives the fields
+ * @return BOOL TRUE if the line is complete
+ */
+static BOOL parseMountLine(char *line, LinuxMount *mount)
+{
+    char *fields[6];
+    char *cursor = line;
+    for (UINT i = 0; i < 6; i++)
+    {
+        while (*cursor == ' ')
+            cursor++;
+        if (!*cursor)
+            return FALSE;
+        fields[i] = cursor;
+        while (*cursor && *cursor != ' ')
+            cursor++;
+        if (*cursor)
+            *cursor++ = '\0';
+    }
+
+    // Skip the optional fields up to the separator
+    char *separator = strstr(cursor, "- ");
+    while (separator && separator != cursor && separator[-1] != ' ')
+        separator = strstr(separator + 1, "- ");
+    if (!separator)
+        return FALSE;
+
+    char *fileSystem = separator + 2;
+    char *source = strchr(fileSystem, ' ');
+    if (!source)
+        return FALSE;
+    *source++ = '\0';
+    char *end = strchr(source, ' ');
+    if (end)
+        *end = '\0';
+
+    UINT major = 0, minor = 0;
+    if (sscanf_s(fields[2], "%u:%u", &major, &minor) != 2)
+        return FALSE;
+
+    unescapeMountField(fields[3]);
+    unescapeMountField(fields[4]);
+    unescapeMountField(source);
+    mount->dev = ((UINT64)major << 32) | minor;
+    mount->root = fields[3];
+    mount->mountPoint = fields[4];
+    mount->fileSystem = fileSystem;
+    mount->source = source;
+    return TRUE;
+}
+
+/**
+ * @brief Tells whether a mount is a volume worth reporting
+ *
+ * Pseudo and network filesystems (proc, tmpfs, overlay, nfs, ...)
+ * have no /dev source. Pool filesystems have none either, but
+ * live on local disks and are kept.
+ *
+ * @param mount Parsed mount
+ * @return BOOL TRUE for a block device or pool filesystem
+ */
+static BOOL isVolumeMount(const LinuxMount *mount)
+{
+    if (strncmp(mount->source, "/dev/", 5) != 0)
+    {
+        for (UINT i = 0; i < sizeof(g_PoolFileSystems) / sizeof(g_PoolFileSystems[0]); i++)
+        {
+            if (strcmp(mount->fileSystem, g_PoolFileSystems[i]) == 0)
+                return TRUE;
+        }
+        return FALSE;
+    }
+
+    for (UINT i = 0; i < sizeof(g_SkippedFileSystems) / sizeof(g_SkippedFileSystems[0]); i++)
+    {
+        if (strcmp(mount->fileSystem, g_SkippedFileSystems[i]) == 0)
+            return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief Parses mountinfo into one mount per block device
+ *
+ * Container hosts mount the same device hundreds of times (bind
+ * mounts into every container). Devices are deduplicated through
+ * a hash table, so the cost stays linear in the number of lines;
+ * the mount of the filesystem root wins over bind mounts.
+ *
+ * @param content Terminated mountinfo content, split in place
+ * @param mounts Receives the mounts, allocated with festMalloc()
+ * @param count Receives the number of mounts
+ * @return BOOL TRUE on success, FALSE if allocation failed
+ */
+static BOOL collectVolumeMounts(char *content, LinuxMount **mounts, UINT *count)
+{
+    UINT lineCount = 1;
+    for (const char *c = content; *c; c++)
+        lineCount += (*c == '\n');
+
+    UINT slotCount = hashSlotCount(lineCount);
+    *count = 0;
+    *mounts = (LinuxMount *)festMalloc(lineCount * sizeof(LinuxMount));
+    UINT *slots = (UINT *)festMalloc(slotCount * sizeof(UINT));
+    if (!*mounts || !slots)
+    {
+        festFree(*mounts);
+        festFree(slots);
+        *mounts = NULL;
+        return FALSE;
+    }
+    memset(slots, 0xFF, slotCount * sizeof(UINT));
+
+    for (char *line = content; line && *line;)
+    {
+        char *next = strchr(line, '\n');
+        if (next)
+            *next++ = '\0';
+
+        LinuxMount mount;
+        if (parseMountLine(line, &mount) && isVolumeMount(&mount))
+        {
+            UINT slot = hashDevice(mount.dev) & (slotCount - 1);
+            while (slots[slot] != STORAGE_NO_ENTRY && (*mounts)[slots[slot]].dev != mount.dev)
+                slot = (slot + 1) & (slotCount - 1);
+
+            if (slots[slot] == STORAGE_NO_ENTRY)
+            {
+                slots[slot] = *count;
+                (*mounts)[(*count)++] = mount;
+            }
+            else if (strcmp(mount.root, "/") == 0 && strcmp((*mounts)[slots[slot]].root, "/") != 0)
+            {
+                (*mounts)[slots[slot]] = mount;
+            }
+        }
+        line = next;
+    }
+
+    festFree(slots);
+    return TRUE;
+}
+
+/**
+ * @brief Finds the block device and disk of a mount
+ *
+ * /sys/dev/block/<major>:<minor> links to the device in
+ * /sys/devices; a partition sits in the directory of its disk.
+ * Btrfs reports an anonymous device number, so the name of the
+ * mount source is tried next. A pool dataset may span several
+ * disks, so it is named after its pool and has no disk.
+ *
+ * @param mount Mount to resolve
+ * @param device Receives the block device or pool name
+ * @param disk Receives the disk name, empty if unknown
+ */
+static void resolveMountDevice(const LinuxMount *mount, char device[STORAGE_NAME_LENGTH], char disk[STORAGE_NAME_LENGTH])
+{
+    char link[SYSFS_PATH_LENGTH];
+    char target[SYSFS_PATH_LENGTH];
+    disk[0] = '\0';
+
+    if (strncmp(mount->source, "/dev/", 5) != 0)
+    {
+        const char *dataset = strchr(mount->source, '/');
+        int poolLength = dataset ? (int)(dataset - mount->source) : (int)strlen(mount->source);
+        _snprintf_s(device, STORAGE_NAME_LENGTH, _TRUNCATE, "%.*s", poolLength, mount->source);
+        return;
+    }
+
+    const char *sourceName = strrchr(mount->source, '/') + 1;
+    strcpy_s(device, STORAGE_NAME_LENGTH, sourceName);
+
+    _snprintf_s(link, sizeof(link), _TRUNCATE, "/sys/dev/block/%u:%u",
+                (UINT)(mount->dev >> 32), (UINT)(mount->dev & 0xFFFFFFFF));
+    if (!readSysfsLink(link, target, sizeof(target)))
+    {
+        _snprintf_s(link, sizeof(link), _TRUNCATE, "/sys/class/block/%s", sourceName);
+        if (!readSysfsLink(link, target, sizeof(target)))
+            return;
+    }
+
+    char *name = strrchr(target, '/');
+    name = name ? name + 1 : target;
+    strcpy_s(device, STORAGE_NAME_LENGTH, name);
+
+    char attribute[SYSFS_PATH_LENGTH];
+    _snprintf_s(attribute, sizeof(attribute), _TRUNCATE, "%s/partition", link);
+    UINT64 partition = 0;
+    if (name > target && readSysfsUInt64(attribute, &partition))
+    {
+        name[-1] = '\0';
+        char *parent = strrchr(target, '/');
+        strcpy_s(disk, STORAGE_NAME_LENGTH, parent ? parent + 1 : target);
+    }
+    else
+    {
+        strcpy_s(disk, STORAGE_NAME_LENGTH, device);
+    }
+}
+
+/**
+ * @brief Describes a disk from /sys/block/<disk>
+ *
+ * @param disk Receives the description, name already set
+ */
+static void readLinuxDisk(LinuxDisk *disk)
+{
+    char path[SYSFS_PATH_LENGTH];
+    char target[SYSFS_PATH_LENGTH];
+
+    // SCSI, ATA, USB and NVMe disks report a model, SD cards a name, LVM a mapping name
+    _snprintf_s(path, sizeof(path), _TRUNCATE, "/sys/block/%s/device/model", disk->name);
+    if (!readSysfsString(path, disk->model, sizeof(disk->model)))
+    {
+        _snprintf_s(path, sizeof(path), _TRUNCATE, "/sys/block/%s/device/name", disk->name);
+        if (!readSysfsString(path, disk->model, sizeof(disk->model)))
+        {
+            _snprintf_s(path, sizeof(path), _TRUNCATE, "/sys/block/%s/dm/name", disk->name);
+            readSysfsString(path, disk->model, sizeof(disk->model));
+        }
+    }
+
+    _snprintf_s(path, sizeof(path), _TRUNCATE, "/sys/block/%s", disk->name);
+    if (readSysfsLink(path, target, sizeof(target)))
+    {
+        for (UINT i = 0; i < sizeof(g_DiskBuses) / sizeof(g_DiskBuses[0]); i++)
+        {
+            if (strstr(target, g_DiskBuses[i].pathPart))
+            {
+                strcpy_s(disk->interfaceType, sizeof(disk->interfaceType), g_DiskBuses[i].interfaceType);
+                break;
+            }
+        }
+    }
+
+    UINT64 value = 0;
+    _snprintf_s(path, sizeof(path), _TRUNCATE, "/sys/block/%s/queue/rotational", disk->name);
+    disk->rotational = readSysfsUInt64(path, &value) && value != 0;
+
+    _snprintf_s(path, sizeof(path), _TRUNCATE, "/sys/block/%s/size", disk->name);
+    if (readSysfsUInt64(path, &value))
+        disk->size = value * SECTOR_SIZE;
+
+    _snprintf_s(path, sizeof(path), _TRUNCATE, "/sys/block/%s/removable", disk->name);
+    BOOL removable = readSysfsUInt64(path, &value) && value != 0;
+    const char *type = "Local Disk";
+    if (strncmp(disk->name, "sr", 2) == 0)
+        type = "CD/DVD Drive";
+    else if (removable)
+        type = "Removable Disk";
+    strcpy_s(disk->type, sizeof(disk->type), type);
+}
+
+/**
+ * @brief Discovers the mounted block device volumes
+ *
+ * Partitions of the same disk share one LinuxDisk, looked up by
+ * name in a hash table, so every disk is read from sysfs once.
+ *
+ * @param topology Receives one entry per mounted block device
+ * @return BOOL TRUE on success, FALSE if mountinfo is unreadable or allocation failed
+ */
+static BOOL buildLinuxStorageTopology(StorageTopology *topology)
+{
+    topology->entries = NULL;
+    topology->count = 0;
+
+    char *content = readSysfsFileAlloc(PROC_MOUNTINFO_PATH, NULL);
+    if (!content)
+        return FALSE;
+
+    LinuxMount *mounts = NULL;
+    UINT mountCount = 0;
+    if (!collectVolumeMounts(content, &mounts, &mountCount))
+    {
+        festFree(content);
+        return FALSE;
+    }
+
+    UINT slotCount = hashSlotCount(mountCount);
+    LinuxDisk *disks = (LinuxDisk *)festMalloc((mountCount ? mountCount : 1) * sizeof(LinuxDisk));
+    UINT *slots = (UINT *)festMalloc(slotCount * sizeof(UINT));
+    if (mountCount > 0)
+        topology->entries = (StorageVolumeEntry *)festMalloc(mountCount * sizeof(StorageVolumeEntry));
+
+    BOOL ok = disks && slots && (mountCount == 0 || topology->entries);
+    if (ok)
+    {
+        UINT diskCount = 0;
+        memset(slots, 0xFF, slotCount * sizeof(UINT));
+
+        for (UINT i = 0; i < mountCount; i++)
+        {
+            const LinuxMount *mount = &mounts[i];
+            StorageVolumeEntry *entry = &topology->entries[i];
+            LogicalDiskInfo *info = &entry->info;
+            memset(entry, 0, sizeof(StorageVolumeEntry));
+
+            char diskName[STORAGE_NAME_LENGTH];
+            strcpy_s(info->drive, sizeof(info->drive), "N/A");
+            strcpy_s(info->mountPoint, sizeof(info->mountPoint), mount->mountPoint);
+            strcpy_s(info->fileSystem, sizeof(info->fileSystem), mount->fileSystem);
+            strcpy_s(info->type, sizeof(info->type), "Local Disk");
+            resolveMountDevice(mount, info->device, diskName);
+            buildSysfsPath(mount->mountPoint, entry->mountPoint, sizeof(entry->mountPoint));
+
+            if (!diskName[0])
+                continue;
+
+            UINT slot = hashName(diskName) & (slotCount - 1);
+            while (slots[slot] != STORAGE_NO_ENTRY && strcmp(disks[slots[slot]].name, diskName) != 0)
+                slot = (slot + 1) & (slotCount - 1);
+
+            if (slots[slot] == STORAGE_NO_ENTRY)
+            {
+                LinuxDisk *disk = &disks[diskCount];
+                memset(disk, 0, sizeof(LinuxDisk));
+                strcpy_s(disk->name, sizeof(disk->name), diskName);
+                readLinuxDisk(disk);
+                slots[slot] = diskCount++;
+            }
+
+            const LinuxDisk *disk = &disks[slots[slot]];
+            strcpy_s(info->model, sizeof(info->model), disk->model);
+            strcpy_s(info->interfaceType, sizeof(info->interfaceType), disk->interfaceType);
+            strcpy_s(info->type, sizeof(info->type), disk->type);
+            info->rotational = disk->rotational;
+            info->diskSize = (double)disk->size / BYTES_PER_GB;
+        }
+        topology->count = mountCount;
+    }
+
+    festFree(slots);
+    festFree(disks);
+    festFree(mounts);
+    festFree(content);
+    return ok;
+}
+
+/**
+ * @brief Storage topology of the Linux backend
+ */
+static StorageTopologyCache g_LinuxStorageTopology = STORAGE_TOPOLOGY_CACHE_INIT(buildLinuxStorageTopology);
+
+/**
+ * @brief Collects mounted block device volumes
+ *
+ * The topology is rebuilt when the kernel flags a mount table
+ * change; a steady-state tick costs one statvfs per volume.
+ *
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return StorageList* Pointer to volume list, NULL if failed
+ */
+StorageList *collectLinuxStorageList(SnapshotArena *arena)
+{
+    return collectStorageSpace(&g_LinuxStorageTopology, arena);
+}
+
+/**
+ * @brief Drops the cached Linux storage topology
+ */
+void releaseLinuxStorageTopology(void)
+{
+    releaseStorageTopologyCache(&g_LinuxStorageTopology);
+}
@@ -0,0 +1,267 @@
+#include "storage_join.h"
+#include <string.h>
+
+#define STORAGE_NO_ROW ((UINT)-1) // End of a chain, empty hash slot
+
+/**
+ * @brief Open-addressing hash index over the keys of one table
+ *
+ * Each slot holds the first row with a given key; rows sharing
+ * a key are chained through next[] in table order
+ */
+typedef struct
+{
+    UINT *slots;        // First row of each key, STORAGE_NO_ROW if empty
+    UINT *next;         // Next row with the same key, STORAGE_NO_ROW at the end
+    UINT mask;          // Slot count minus one, slot count is a power of two
+    const BYTE *rows;   // Indexed rows
+    size_t rowSize;     // Size of one row in bytes
+    size_t keyOffset;   // Offset of the key in a row
+} StorageKeyIndex;
+
+/**
+ * @brief Folds an ASCII letter to lower case
+ */
+static char foldKeyChar(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+}
+
+/**
+ * @brief Case-insensitive FNV-1a hash of a key
+ */
+static UINT hashKey(const char *key)
+{
+    UINT hash = 2166136261u;
+    for (; *key; key++)
+    {
+        hash ^= (BYTE)foldKeyChar(*key);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Case-insensitive key comparison
+ */
+static BOOL keysEqual(const char *a, const char *b)
+{
+    for (; *a && *b; a++, b++)
+    {
+        if (foldKeyChar(*a) != foldKeyChar(*b))
+            return FALSE;
+    }
+    return *a == *b;
+}
+
+/**
+ * @brief Returns the key of one indexed row
+ */
+static const char *indexKey(const StorageKeyIndex *index, UINT row)
+{
+    return (const char *)(index->rows + index->rowSize * row + index->keyOffset);
+}
+
+/**
+ * @brief Builds a hash index over the keys of a table
+ *
+ * Rows are inserted back to front and prepended to their chain,
+ * so every chain lists its rows in table order.
+ *
+ * @param index Index to build
+ * @param rows First row
+ * @param count Number of rows
+ * @param rowSize Size of one row in bytes
+ * @param keyOffset Offset of the key in a row
+ * @param arena Arena for the index arrays, NULL for the heap
+ * @return BOOL TRUE on success, FALSE if allocation failed
+ */
+static BOOL buildKeyIndex(StorageKeyIndex *index, const void *rows, UINT count, size_t rowSize,
+                          size_t keyOffset, SnapshotArena *arena)
+{
+    // Keep the load factor at or below one half
+    UINT slotCount = 8;
+    while (slotCount < count * 2)
+        slotCount *= 2;
+
+    index->slots = (UINT *)snapshotAlloc(arena, sizeof(UINT) * (slotCount + count));
+    if (!index->slots)
+        return FALSE;
+
+    index->next = index->slots + slotCount;
+    index->mask = slotCount - 1;
+    index->rows = (const BYTE *)rows;
+    index->rowSize = rowSize;
+    index->keyOffset = keyOffset;
+    memset(index->slots, 0xFF, sizeof(UINT) * slotCount);
+
+    for (UINT row = count; row-- > 0;)
+    {
+        const char *key = indexKey(index, row);
+        UINT slot = hashKey(key) & index->mask;
+        while (index->slots[slot] != STORAGE_NO_ROW && !keysEqual(indexKey(index, index->slots[slot]), key))
+            slot = (slot + 1) & index->mask;
+
+        index->next[row] = index->slots[slot];
+        index->slots[slot] = row;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Finds the first row with a key
+ *
+ * @param index Index to search
+ * @param key Key to look up
+ * @return UINT First matching row, STORAGE_NO_ROW if none
+ */
+static UINT findKey(const StorageKeyIndex *index, const char *key)
+{
+    UINT slot = hashKey(key) & index->mask;
+    while (index->slots[slot] != STORAGE_NO_ROW)
+    {
+        if (keysEqual(indexKey(index, index->slots[slot]), key))
+            return index->slots[slot];
+        slot = (slot + 1) & index->mask;
+    }
+    return STORAGE_NO_ROW;
+}
+
+/**
+ * @brief Extracts the DeviceID key from a WMI object path
+ *
+ * @param path Object path of an association reference
+ * @param key Buffer receiving the unescaped key
+ * @param keySize Size of the buffer in bytes
+ * @return BOOL TRUE if a complete quoted key was found and fit
+ */
+BOOL parseStorageObjectKey(const char *path, char *key, size_t keySize)
+{
+    if (!path || !key || keySize == 0)
+        return FALSE;
+
+    key[0] = '\0';
+    const char *value = strstr(path, "=\"");
+    if (!value)
+        return FALSE;
+    value += 2;
+
+    size_t length = 0;
+    for (; *value && *value != '"'; value++)
+    {
+        // A backslash escapes the next character
+        if (*value == '\\' && value[1])
+            value++;
+
+        if (length + 1 >= keySize)
+        {
+            key[0] = '\0';
+            return FALSE;
+        }
+        key[length++] = *value;
+    }
+
+    key[length] = '\0';
+    if (*value != '"')
+    {
+        key[0] = '\0';
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief Walks disk to partition to volume chains
+ *
+ * Called twice: once without output to size the result,
+ * then again to fill it.
+ *
+ * @param input Rows and links to join
+ * @param diskLinks Disk to partition links hashed on the disk key
+ * @param partitionLinks Partition to volume links hashed on the partition key
+ * @param volumes Volume rows hashed on DeviceID
+ * @param matches Output array, NULL to only count
+ * @return UINT Number of matches
+ */
+static UINT walkStorageChains(const StorageJoinInput *input, const StorageKeyIndex *diskLinks,
+                              const StorageKeyIndex *partitionLinks, const StorageKeyIndex *volumes,
+                              StorageJoinMatch *matches)
+{
+    UINT count = 0;
+    const BYTE *diskRows = (const BYTE *)input->disks.rows;
+
+    for (UINT disk = 0; disk < input->disks.count; disk++)
+    {
+        const char *diskKey = (const char *)(diskRows + input->disks.rowSize * disk + input->disks.keyOffset);
+        for (UINT link = findKey(diskLinks, diskKey); link != STORAGE_NO_ROW; link = diskLinks->next[link])
+        {
+            const char *partitionKey = input->diskPartitions[link].dependent;
+            for (UINT volumeLink = findKey(partitionLinks, partitionKey); volumeLink != STORAGE_NO_ROW;
+                 volumeLink = partitionLinks->next[volumeLink])
+            {
+                UINT volume = findKey(volumes, input->partitionVolumes[volumeLink].dependent);
+                if (volume == STORAGE_NO_ROW)
+                    continue;
+
+                if (matches)
+                {
+                    matches[count].disk = disk;
+                    matches[count].volume = volume;
+                }
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Joins disks to volumes through their partitions
+ *
+ * @param input Rows and links to join
+ * @param arena Arena for the scratch tables and result, NULL for the heap
+ * @param matches Receives the matches, NULL when there are none
+ * @param matchCount Receives the number of matches
+ * @return BOOL TRUE on success, FALSE if allocation failed
+ */
+BOOL joinStorageTables(const StorageJoinInput *input, SnapshotArena *arena,
+                       StorageJoinMatch **matches, UINT *matchCount)
+{
+    *matches = NULL;
+    *matchCount = 0;
+
+    StorageKeyIndex diskLinks = {0};
+    StorageKeyIndex partitionLinks = {0};
+    StorageKeyIndex volumes = {0};
+    BOOL ok = FALSE;
+
+    if (buildKeyIndex(&diskLinks, input->diskPartitions, input->diskPartitionCount, sizeof(StorageLinkRow),
+                      offsetof(StorageLinkRow, antecedent), arena) &&
+        buildKeyIndex(&partitionLinks, input->partitionVolumes, input->partitionVolumeCount, sizeof(StorageLinkRow),
+                      offsetof(StorageLinkRow, antecedent), arena) &&
+        buildKeyIndex(&volumes, input->volumes.rows, input->volumes.count, input->volumes.rowSize,
+                      input->volumes.keyOffset, arena))
+    {
+        UINT count = walkStorageChains(input, &diskLinks, &partitionLinks, &volumes, NULL);
+        if (count == 0)
+        {
+            ok = TRUE;
+        }
+        else
+        {
+            *matches = (StorageJoinMatch *)snapshotAlloc(arena, sizeof(StorageJoinMatch) * count);
+            if (*matches)
+            {
+                *matchCount = walkStorageChains(input, &diskLinks, &partitionLinks, &volumes, *matches);
+                ok = TRUE;
+            }
+        }
+    }
+
+    snapshotFree(arena, volumes.slots);
+    snapshotFree(arena, partitionLinks.slots);
+    snapshotFree(arena, diskLinks.slots);
+    return ok;
+}
@@ -0,0 +1,242 @@
+#include "storage_topology.h"
+#include "fest_alloc.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+#endif
+
+#define BYTES_PER_GB (1024.0 * 1024.0 * 1024.0)
+
+static MountSignatureSource g_mountSignatureSource = NULL; // Replaced by tests, NULL for getMountSignature()
+
+#ifndef _WIN32
+static SRWLOCK g_mountWatchLock = SRWLOCK_INIT; // Guards the watch below
+static int g_mountInfoFd = -1;                  // Open /proc/self/mountinfo, -1 until first use
+static UINT64 g_mountGeneration = 0;            // Advanced on every reported mount change
+#endif
+
+/**
+ * @brief Reads the size and free space of a mounted volume
+ *
+ * @param mountPoint Root of the volume (e.g. "C:\\" or "/home")
+ * @param totalBytes Receives the volume size in bytes
+ * @param freeBytes Receives the free space in bytes
+ * @return BOOL TRUE if the volume could be queried
+ */
+BOOL queryVolumeSpace(const char *mountPoint, UINT64 *totalBytes, UINT64 *freeBytes)
+{
+    if (!mountPoint || !mountPoint[0])
+        return FALSE;
+
+#ifdef _WIN32
+    ULARGE_INTEGER total, free;
+    if (!GetDiskFreeSpaceExA(mountPoint, NULL, &total, &free))
+        return FALSE;
+
+    *totalBytes = total.QuadPart;
+    *freeBytes = free.QuadPart;
+#else
+    struct statvfs fs;
+    if (statvfs(mountPoint, &fs) != 0)
+        return FALSE;
+
+    *totalBytes = (UINT64)fs.f_blocks * fs.f_frsize;
+    *freeBytes = (UINT64)fs.f_bfree * fs.f_frsize;
+#endif
+    return TRUE;
+}
+
+/**
+ * @brief Returns the current mount signature
+ *
+ * The kernel flags /proc/self/mountinfo with POLLPRI once per
+ * change of the mount table, so polling it is a single syscall.
+ *
+ * @return UINT64 Value that changes with the set of mounts
+ */
+UINT64 getMountSignature(void)
+{
+#ifdef _WIN32
+    return (UINT64)GetLogicalDrives();
+#else
+    AcquireSRWLockExclusive(&g_mountWatchLock);
+    if (g_mountInfoFd < 0)
+        g_mountInfoFd = open("/proc/self/mountinfo", O_RDONLY | O_CLOEXEC);
+
+    if (g_mountInfoFd >= 0)
+    {
+        struct pollfd watch = {g_mountInfoFd, POLLPRI, 0};
+        if (poll(&watch, 1, 0) > 0 && (watch.revents & (POLLPRI | POLLERR)))
+            g_mountGeneration++;
+    }
+
+    UINT64 generation = g_mountGeneration;
+    ReleaseSRWLockExclusive(&g_mountWatchLock);
+    return generation;
+#endif
+}
+
+/**
+ * @brief Replaces the mount signature source
+ *
+ * @param source Signature function, NULL restores getMountSignature()
+ */
+void setMountSignatureSource(MountSignatureSource source)
+{
+    g_mountSignatureSource = source;
+}
+
+/**
+ * @brief Frees the entries of a topology
+ *
+ * @param topology Topology to empty
+ */
+static void freeTopology(StorageTopology *topology)
+{
+    if (topology->entries)
+        festFree(topology->entries);
+
+    topology->entries = NULL;
+    topology->count = 0;
+}
+
+/**
+ * @brief Makes sure the cache holds a topology for the current mounts
+ *
+ * @param cache Locked topology cache
+ * @return BOOL TRUE if a topology is available
+ */
+static BOOL ensureTopology(StorageTopologyCache *cache)
+{
+    UINT64 signature = g_mountSignatureSource ? g_mountSignatureSource() : getMountSignature();
+
+    if (cache->valid && signature != cache->signature)
+    {
+        freeTopology(&cache->topology);
+        cache->valid = FALSE;
+        cache->stats.invalidations++;
+    }
+
+    if (!cache->valid)
+    {
+        // The signature is read first, so a mount racing the build triggers another one
+        if (!cache->builder(&cache->topology))
+        {
+            freeTopology(&cache->topology);
+            return FALSE;
+        }
+
+        cache->signature = signature;
+        cache->valid = TRUE;
+        cache->stats.builds++;
+    }
+
+    return TRUE;
+}
+
+/**
+ * @brief Collects the storage list from the cached topology
+ *
+ * @param cache Topology cache
+ * @param arena Snapshot arena to allocate from, NULL to allocate from the heap
+ * @return StorageList* Storage list, NULL if the topology could not be built
+ */
+StorageList *collectStorageSpace(StorageTopologyCache *cache, SnapshotArena *arena)
+{
+    StorageList *list = (StorageList *)snapshotAlloc(arena, sizeof(StorageList));
+    if (!list)
+        return NULL;
+
+    list->disks = NULL;
+    list->count = 0;
+
+    AcquireSRWLockExclusive(&cache->lock);
+    if (!ensureTopology(cache))
+    {
+        ReleaseSRWLockExclusive(&cache->lock);
+        snapshotFree(arena, list);
+        return NULL;
+    }
+
+    const StorageTopology *topology = &cache->topology;
+    if (topology->count > 0)
+    {
+        list->disks = (LogicalDiskInfo *)snapshotAlloc(arena, sizeof(LogicalDiskInfo) * topology->count);
+        if (!list->disks)
+        {
+            ReleaseSRWLockExclusive(&cache->lock);
+            snapshotFree(arena, list);
+            return NULL;
+        }
+    }
+
+    for (UINT i = 0; i < topology->count; i++)
+    {
+        const StorageVolumeEntry *entry = &topology->entries[i];
+        LogicalDiskInfo *disk = &list->disks[i];
+        *disk = entry->info;
+
+        if (!entry->mountPoint[0])
+            continue;
+
+        UINT64 totalBytes, freeBytes;
+        if (queryVolumeSpace(entry->mountPoint, &totalBytes, &freeBytes))
+        {
+            disk->totalSize = (double)totalBytes / BYTES_PER_GB;
+            disk->freeSpace = (double)freeBytes / BYTES_PER_GB;
+        }
+        else
+        {
+            cache->stats.spaceFailures++;
+        }
+    }
+
+    list->count = topology->count;
+    cache->stats.refreshes++;
+    ReleaseSRWLockExclusive(&cache->lock);
+    return list;
+}
+
+/**
+ * @brief Forces the next collection to rediscover the topology
+ *
+ * @param cache Topology cache
+ */
+void invalidateStorageTopologyCache(StorageTopologyCache *cache)
+{
+    AcquireSRWLockExclusive(&cache->lock);
+    if (cache->valid)
+        cache->stats.invalidations++;
+    freeTopology(&cache->topology);
+    cache->valid = FALSE;
+    ReleaseSRWLockExclusive(&cache->lock);
+}
+
+/**
+ * @brief Releases the cached topology
+ *
+ * @param cache Topology cache, reusable afterwards
+ */
+void releaseStorageTopologyCache(StorageTopologyCache *cache)
+{
+    AcquireSRWLockExclusive(&cache->lock);
+    freeTopology(&cache->topology);
+    cache->valid = FALSE;
+    ReleaseSRWLockExclusive(&cache->lock);
+}
+
+/**
+ * @brief Reads the activity counters of a cache
+ *
+ * @param cache Topology cache
+ * @param stats Structure to receive the counters
+ */
+void getStorageTopologyCacheStats(StorageTopologyCache *cache, StorageTopologyStats *stats)
+{
+    AcquireSRWLockExclusive(&cache->lock);
+    *stats = cache->stats;
+    ReleaseSRWLockExclusive(&cache->lock);
+}
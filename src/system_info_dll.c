@@ -1,7 +1,14 @@
 #include "system_info_dll.h"
-#include "system_info_internal.h"
+#include "collector_backend.h"
 #include "json_structure.h"
+#include "overhead_stats.h"
+#include "fest_alloc.h"
+#include "trace_events.h"
+#ifdef _WIN32
 #include <process.h>
+#endif
+
+#define SNAPSHOT_ARENA_SIZE 65536 // Initial capacity of each snapshot arena
 
 /**
  * @brief Global context for system monitoring
@@ -10,6 +17,9 @@
  * - Thread control and synchronization
  * - Update interval and callback
  * - Static and dynamic system information
+ * - Double-buffered snapshot arenas and the reusable JSON buffer
+ * - Resource usage of the engine itself
+ * - Collector backend in use
  */
 static struct
 {
@@ -20,14 +30,54 @@ static struct
     SystemInfoCallback callback; // Callback for sending updates
 
     // System information containers
-    StaticInfo staticInfo;   // Static hardware information
-    DynamicInfo dynamicInfo; // Dynamic system metrics
+    StaticInfo staticInfo;          // Static hardware information
+    DynamicInfo dynamicInfo[2];     // Latest and previous dynamic snapshot
+    SnapshotArena snapshotArena[2]; // Backing memory of each snapshot
+    UINT currentSnapshot;           // Index of the latest snapshot
+    JSONBuffer jsonBuffer;          // Reused JSON output
 
     // Synchronization
     HANDLE mutex;    // Mutex for thread safety
     BOOL isFirstRun; // First run flag for static info
+
+    // Self-overhead accounting
+    MonitoringStats stats; // Engine resource usage, guarded by mutex
+    BOOL reportOverhead;   // Include "overhead" section in JSON
+
+    // Data sources
+    const CollectorBackend *backend; // Selected backend, NULL for native
+    const CollectorBackend *active;  // Backend of the running session
 } g_MonitorContext = {0};
 
+/**
+ * @brief Folds the cost of one tick into the engine statistics
+ *
+ * Computes deltas between the samples taken at the start and
+ * end of a tick and accumulates them into g_MonitorContext.stats.
+ *
+ * @param start Sample taken before collection
+ * @param end Sample taken after JSON generation
+ * @param peakBytes Live heap high-water mark during the tick
+ */
+static void recordTickOverhead(const OverheadSample *start, const OverheadSample *end, UINT64 peakBytes)
+{
+    MonitoringStats *stats = &g_MonitorContext.stats;
+
+    WaitForSingleObject(g_MonitorContext.mutex, INFINITE);
+    stats->tickCount++;
+    stats->lastTickMs = (double)(end->wallTimeUs - start->wallTimeUs) / 1000.0;
+    stats->lastTickCpuMs = (double)(end->cpuTimeUs - start->cpuTimeUs) / 1000.0;
+    stats->totalCpuMs += stats->lastTickCpuMs;
+    stats->lastTickContextSwitches = end->contextSwitches - start->contextSwitches;
+    stats->totalContextSwitches += stats->lastTickContextSwitches;
+    stats->lastTickAllocations = end->allocCount - start->allocCount;
+    stats->lastTickAllocatedBytes = end->allocatedBytes - start->allocatedBytes;
+    stats->lastTickPeakHeapBytes = peakBytes;
+    if (peakBytes > stats->peakHeapBytes)
+        stats->peakHeapBytes = peakBytes;
+    ReleaseMutex(g_MonitorContext.mutex);
+}
+
 /**
  * @brief Thread function for system monitoring
  *
@@ -36,70 +86,149 @@ static struct
  * 2. Periodically collects dynamic system information
  * 3. Generates JSON output and sends through callback
  * 4. Handles cleanup of collected information
+ * 5. Accounts its own CPU time, context switches and heap usage
+ * 6. Records trace spans for each stage when tracing is enabled
+ *
+ * Dynamic snapshots are double-buffered: each tick collects into the
+ * arena of the older snapshot after resetting it, so the previous
+ * tick's data stays valid for one more tick and no collector output
+ * is freed individually. The accounted tick ends before the callback
+ * runs, so no application code is executed inside it.
+ *
+ * The thread opens the collectors of the backend before the first
+ * tick and closes them on exit, so state kept across ticks (a pinned
+ * WMI connection, open file descriptors) belongs to this thread.
+ * Collectors the backend does not provide, or that failed to open,
+ * are skipped and their JSON sections omitted.
  *
  * @param arg Thread argument (unused)
  * @return unsigned Thread exit code
  */
 static unsigned __stdcall monitoringThread(void *arg)
 {
+    const CollectorBackend *backend = g_MonitorContext.active;
+    const CollectorTable *collectors = &backend->collectors;
+    setTraceThreadName("fest-monitor");
+    DWORD open = openCollectorBackend(backend);
+
     while (g_MonitorContext.isRunning)
     {
         // Check for stop request
         if (WaitForSingleObject(g_MonitorContext.stopEvent, 0) == WAIT_OBJECT_0)
             break;
 
+        // Start tick accounting
+        OverheadSample tickStart, tickEnd;
+        resetAllocPeak();
+        takeOverheadSample(&tickStart);
+        TRACE_BEGIN("tick");
+
         // Collect static information once
         if (g_MonitorContext.isFirstRun)
         {
             WaitForSingleObject(g_MonitorContext.mutex, INFINITE);
-            g_MonitorContext.staticInfo.cpuList = getCPUList();
-            g_MonitorContext.staticInfo.gpuList = getGPUList();
-            g_MonitorContext.staticInfo.mbInfo = getMotherboardInfo();
-            g_MonitorContext.staticInfo.audioList = getAudioList();
-            g_MonitorContext.staticInfo.monitorList = getMonitorList();
+            TRACE_BEGIN("cpu");
+            if (open & COLLECTOR_BIT(COLLECTOR_CPU))
+                g_MonitorContext.staticInfo.cpuList = collectors->getCPUList();
+            TRACE_END("cpu");
+            TRACE_BEGIN("gpu");
+            if (open & COLLECTOR_BIT(COLLECTOR_GPU))
+                g_MonitorContext.staticInfo.gpuList = collectors->getGPUList();
+            TRACE_END("gpu");
+            TRACE_BEGIN("motherboard");
+            if (open & COLLECTOR_BIT(COLLECTOR_MOTHERBOARD))
+                g_MonitorContext.staticInfo.mbInfo = collectors->getMotherboardInfo();
+            TRACE_END("motherboard");
+            TRACE_BEGIN("audio");
+            if (open & COLLECTOR_BIT(COLLECTOR_AUDIO))
+                g_MonitorContext.staticInfo.audioList = collectors->getAudioList();
+            TRACE_END("audio");
+            TRACE_BEGIN("monitors");
+            if (open & COLLECTOR_BIT(COLLECTOR_MONITORS))
+                g_MonitorContext.staticInfo.monitorList = collectors->getMonitorList();
+            TRACE_END("monitors");
+            TRACE_BEGIN("ram_slots");
+            if (open & COLLECTOR_BIT(COLLECTOR_RAM_SLOTS))
+                g_MonitorContext.staticInfo.ramSlots = collectors->getRAMSlotList();
+            TRACE_END("ram_slots");
             g_MonitorContext.isFirstRun = FALSE;
             ReleaseMutex(g_MonitorContext.mutex);
         }
 
-        // Collect dynamic information
+        // Collect dynamic information into the older snapshot
+        UINT next = g_MonitorContext.currentSnapshot ^ 1;
+        SnapshotArena *arena = &g_MonitorContext.snapshotArena[next];
+        DynamicInfo *dynamicInfo = &g_MonitorContext.dynamicInfo[next];
+        resetSnapshotArena(arena);
+
         WaitForSingleObject(g_MonitorContext.mutex, INFINITE);
-        g_MonitorContext.dynamicInfo.memInfo = getMemoryInfo();
-        g_MonitorContext.dynamicInfo.storageList = getStorageList();
-        g_MonitorContext.dynamicInfo.batteryInfo = getBatteryInfo();
-        g_MonitorContext.dynamicInfo.networkList = getNetworkList();
+        TRACE_BEGIN("cpu_load");
+        dynamicInfo->cpuLoad = (open & COLLECTOR_BIT(COLLECTOR_CPU_LOAD)) ? collectors->collectCPULoad(arena) : NULL;
+        TRACE_END("cpu_load");
+        TRACE_BEGIN("cpu_frequency");
+        dynamicInfo->cpuFrequency = (open & COLLECTOR_BIT(COLLECTOR_CPU_FREQUENCY)) ? collectors->collectCPUFrequency(arena) : NULL;
+        TRACE_END("cpu_frequency");
+        TRACE_BEGIN("memory");
+        dynamicInfo->memInfo = (open & COLLECTOR_BIT(COLLECTOR_MEMORY)) ? collectors->collectMemoryInfo(arena) : NULL;
+        TRACE_END("memory");
+        TRACE_BEGIN("storage");
+        dynamicInfo->storageList = (open & COLLECTOR_BIT(COLLECTOR_STORAGE)) ? collectors->collectStorageList(arena) : NULL;
+        TRACE_END("storage");
+        TRACE_BEGIN("disk_io");
+        dynamicInfo->diskIO = (open & COLLECTOR_BIT(COLLECTOR_DISK_IO)) ? collectors->collectDiskIO(arena) : NULL;
+        TRACE_END("disk_io");
+        TRACE_BEGIN("battery");
+        dynamicInfo->batteryInfo = (open & COLLECTOR_BIT(COLLECTOR_BATTERY)) ? collectors->collectBatteryInfo(arena) : NULL;
+        TRACE_END("battery");
+        TRACE_BEGIN("network");
+        dynamicInfo->networkList = (open & COLLECTOR_BIT(COLLECTOR_NETWORK)) ? collectors->collectNetworkList(arena) : NULL;
+        TRACE_END("network");
+        g_MonitorContext.currentSnapshot = next;
+        MonitoringStats overhead = g_MonitorContext.stats;
         ReleaseMutex(g_MonitorContext.mutex);
 
-        // Generate and send JSON data
-        char *jsonOutput = generateSystemInfoJSON(
+        // Generate JSON data
+        TRACE_BEGIN("json");
+        const char *jsonOutput = renderSystemInfoJSON(
+            &g_MonitorContext.jsonBuffer,
             g_MonitorContext.staticInfo.gpuList,
             g_MonitorContext.staticInfo.mbInfo,
             g_MonitorContext.staticInfo.cpuList,
-            g_MonitorContext.dynamicInfo.memInfo,
-            g_MonitorContext.dynamicInfo.storageList,
-            g_MonitorContext.dynamicInfo.networkList,
+            dynamicInfo->cpuLoad,
+            dynamicInfo->cpuFrequency,
+            dynamicInfo->memInfo,
+            g_MonitorContext.staticInfo.ramSlots,
+            dynamicInfo->storageList,
+            dynamicInfo->diskIO,
+            dynamicInfo->networkList,
             g_MonitorContext.staticInfo.audioList,
-            g_MonitorContext.dynamicInfo.batteryInfo,
-            g_MonitorContext.staticInfo.monitorList);
+            dynamicInfo->batteryInfo,
+            g_MonitorContext.staticInfo.monitorList,
+            g_MonitorContext.reportOverhead ? &overhead : NULL);
+        TRACE_END("json");
 
-        if (jsonOutput && g_MonitorContext.callback)
+        // Finish tick accounting before handing control to the application
+        AllocStats allocStats;
+        takeOverheadSample(&tickEnd);
+        getAllocStats(&allocStats);
+        recordTickOverhead(&tickStart, &tickEnd, allocStats.peakBytes);
+
+        // Send JSON data
+        if (jsonOutput)
         {
-            g_MonitorContext.callback(jsonOutput);
-            freeJSONString(jsonOutput);
+            TRACE_BEGIN("callback");
+            if (g_MonitorContext.callback)
+                g_MonitorContext.callback(jsonOutput);
+            TRACE_END("callback");
         }
+        TRACE_END("tick");
 
-        // Cleanup dynamic information
-        if (g_MonitorContext.dynamicInfo.memInfo)
-            freeMemoryInfo(g_MonitorContext.dynamicInfo.memInfo);
-        if (g_MonitorContext.dynamicInfo.storageList)
-            freeStorageList(g_MonitorContext.dynamicInfo.storageList);
-        if (g_MonitorContext.dynamicInfo.batteryInfo)
-            freeBatteryInfo(g_MonitorContext.dynamicInfo.batteryInfo);
-        if (g_MonitorContext.dynamicInfo.networkList)
-            freeNetworkList(g_MonitorContext.dynamicInfo.networkList);
-
-        Sleep(g_MonitorContext.updateInterval);
+        // Sleep until the next tick, waking early when stopped
+        WaitForSingleObject(g_MonitorContext.stopEvent, (DWORD)g_MonitorContext.updateInterval);
     }
 
+    closeCollectorBackend(backend, open);
+    releaseTraceThread();
     return 0;
 }
 
@@ -121,6 +250,20 @@ SYSTEM_INFO_API BOOL startSystemMonitoring(int updateIntervalMs)
     g_MonitorContext.isRunning = TRUE;
     g_MonitorContext.updateInterval = updateIntervalMs;
     g_MonitorContext.isFirstRun = TRUE;
+    g_MonitorContext.active = g_MonitorContext.backend ? g_MonitorContext.backend : getNativeCollectorBackend();
+    memset(&g_MonitorContext.stats, 0, sizeof(g_MonitorContext.stats));
+    enableCrtAllocCounting();
+
+    // Snapshot memory is reserved up front so ticks do not allocate
+    if (!initSnapshotArena(&g_MonitorContext.snapshotArena[0], SNAPSHOT_ARENA_SIZE) ||
+        !initSnapshotArena(&g_MonitorContext.snapshotArena[1], SNAPSHOT_ARENA_SIZE))
+    {
+        releaseSnapshotArena(&g_MonitorContext.snapshotArena[0]);
+        releaseSnapshotArena(&g_MonitorContext.snapshotArena[1]);
+        g_MonitorContext.isRunning = FALSE;
+        return FALSE;
+    }
+
     g_MonitorContext.mutex = CreateMutex(NULL, FALSE, NULL);
     g_MonitorContext.stopEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
 
@@ -141,9 +284,12 @@ SYSTEM_INFO_API void stopSystemMonitoring(void)
     if (!g_MonitorContext.isRunning)
         return;
 
-    // Signal and wait for thread completion
+    // Signal and wait for thread completion, ending any collection it waits on
+    const CollectorBackend *backend = g_MonitorContext.active;
     SetEvent(g_MonitorContext.stopEvent);
     g_MonitorContext.isRunning = FALSE;
+    if (backend->cancel)
+        backend->cancel();
 
     if (g_MonitorContext.monitorThread)
     {
@@ -151,23 +297,37 @@ SYSTEM_INFO_API void stopSystemMonitoring(void)
         CloseHandle(g_MonitorContext.monitorThread);
     }
 
-    // Cleanup static information
+    // Cleanup static information, the collectors were closed by the thread
+    const CollectorTable *collectors = &backend->collectors;
     if (g_MonitorContext.staticInfo.gpuList)
-        freeGPUList(g_MonitorContext.staticInfo.gpuList);
+        collectors->freeGPUList(g_MonitorContext.staticInfo.gpuList);
     if (g_MonitorContext.staticInfo.mbInfo)
-        freeMotherboardInfo(g_MonitorContext.staticInfo.mbInfo);
+        collectors->freeMotherboardInfo(g_MonitorContext.staticInfo.mbInfo);
     if (g_MonitorContext.staticInfo.cpuList)
-        freeCPUList(g_MonitorContext.staticInfo.cpuList);
+        collectors->freeCPUList(g_MonitorContext.staticInfo.cpuList);
     if (g_MonitorContext.staticInfo.audioList)
-        freeAudioList(g_MonitorContext.staticInfo.audioList);
+        collectors->freeAudioList(g_MonitorContext.staticInfo.audioList);
     if (g_MonitorContext.staticInfo.monitorList)
-        freeMonitorList(g_MonitorContext.staticInfo.monitorList);
+        collectors->freeMonitorList(g_MonitorContext.staticInfo.monitorList);
+    if (g_MonitorContext.staticInfo.ramSlots)
+        collectors->freeRAMSlotList(g_MonitorContext.staticInfo.ramSlots);
+
+    // Cleanup snapshot memory
+    releaseSnapshotArena(&g_MonitorContext.snapshotArena[0]);
+    releaseSnapshotArena(&g_MonitorContext.snapshotArena[1]);
+    releaseJSONBuffer(&g_MonitorContext.jsonBuffer);
 
     // Cleanup synchronization objects
     CloseHandle(g_MonitorContext.mutex);
     CloseHandle(g_MonitorContext.stopEvent);
+    releaseOverheadSampler();
 
+    // Overhead reporting and the backend are configured before start, keep them across sessions
+    BOOL reportOverhead = g_MonitorContext.reportOverhead;
+    const CollectorBackend *selected = g_MonitorContext.backend;
     memset(&g_MonitorContext, 0, sizeof(g_MonitorContext));
+    g_MonitorContext.reportOverhead = reportOverhead;
+    g_MonitorContext.backend = selected;
 }
 
 /**
@@ -189,3 +349,90 @@ SYSTEM_INFO_API void setSystemInfoCallback(SystemInfoCallback callback)
 {
     g_MonitorContext.callback = callback;
 }
+
+/**
+ * @brief Retrieves resource usage of the monitoring engine
+ *
+ * @param stats Structure to receive the statistics
+ * @return BOOL TRUE if monitoring is running and stats were copied, FALSE otherwise
+ */
+SYSTEM_INFO_API BOOL getMonitoringStats(MonitoringStats *stats)
+{
+    if (!stats || !g_MonitorContext.isRunning)
+        return FALSE;
+
+    WaitForSingleObject(g_MonitorContext.mutex, INFINITE);
+    *stats = g_MonitorContext.stats;
+    ReleaseMutex(g_MonitorContext.mutex);
+    return TRUE;
+}
+
+/**
+ * @brief Enables or disables the "overhead" section in the JSON output
+ *
+ * @param enabled TRUE to include the section, FALSE to omit it
+ */
+SYSTEM_INFO_API void setOverheadReporting(BOOL enabled)
+{
+    g_MonitorContext.reportOverhead = enabled;
+}
+
+/**
+ * @brief Starts or stops recording of tick trace events
+ *
+ * @param enabled TRUE to record spans, FALSE to stop
+ */
+SYSTEM_INFO_API void setTracingEnabled(BOOL enabled)
+{
+    enableTraceEvents(enabled);
+}
+
+/**
+ * @brief Writes recorded spans as Chrome trace-event JSON
+ *
+ * @param path Output file path
+ * @return BOOL TRUE if the file was written, FALSE if failed
+ */
+SYSTEM_INFO_API BOOL writeTraceFile(const char *path)
+{
+    return exportTraceEvents(path);
+}
+
+/**
+ * @brief Selects the collector backend by name
+ *
+ * @param name Registered backend name, NULL for the native backend
+ * @return BOOL TRUE if selected, FALSE if unknown or monitoring is running
+ */
+SYSTEM_INFO_API BOOL selectCollectorBackend(const char *name)
+{
+    const CollectorBackend *backend = name ? findCollectorBackend(name) : NULL;
+    if (name && !backend)
+        return FALSE;
+    return setCollectorBackend(backend);
+}
+
+/**
+ * @brief Replaces the backend used by the monitoring engine
+ *
+ * @param backend Backend that must outlive its use, NULL restores the native backend
+ * @return BOOL TRUE if replaced, FALSE if monitoring is running
+ */
+BOOL setCollectorBackend(const CollectorBackend *backend)
+{
+    if (g_MonitorContext.isRunning)
+        return FALSE;
+
+    g_MonitorContext.backend = (backend == getNativeCollectorBackend()) ? NULL : backend;
+    return TRUE;
+}
+
+/**
+ * @brief Returns the backend used by the monitoring engine
+ *
+ * @return const CollectorBackend* Selected backend
+ */
+const CollectorBackend *getCollectorBackend(void)
+{
+    return g_MonitorContext.backend ? g_MonitorContext.backend : getNativeCollectorBackend();
+}
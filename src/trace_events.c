@@ -0,0 +1,273 @@
+#include "trace_events.h"
+#include "fest_alloc.h"
+#include <stdio.h>
+
+#define TRACE_BUFFER_EVENTS 16384 // Events kept per thread and capture
+
+/**
+ * @brief A single begin or end event
+ */
+typedef struct
+{
+    const char *name; // Span name
+    LONG64 ticks;     // QueryPerformanceCounter value
+    char phase;       // 'B' or 'E'
+} TraceEvent;
+
+/**
+ * @brief Event buffer owned by one thread
+ *
+ * Only the owning thread writes events and bumps count; the
+ * exporter reads count first and then the events below it.
+ * Buffers are linked into a global list on first use and are
+ * never unlinked, so they stay readable after their thread exits.
+ * A thread that exits releases its buffer, and the next thread
+ * that starts tracing in a later capture takes it over instead
+ * of allocating a new one.
+ */
+typedef struct TraceBuffer
+{
+    struct TraceBuffer *next;          // Next registered buffer
+    DWORD threadId;                    // Owning thread
+    volatile LONG owned;               // 1 while a live thread writes it
+    const char *threadName;            // Optional viewer label
+    volatile LONG generation;          // Capture the events belong to
+    volatile LONG count;               // Published event count
+    LONG dropped;                      // Events lost to a full buffer
+    TraceEvent events[TRACE_BUFFER_EVENTS];
+} TraceBuffer;
+
+volatile LONG g_traceEnabled = 0;
+
+static TraceBuffer *volatile g_traceBuffers = NULL; // Registered buffers
+static volatile LONG g_traceGeneration = 0;         // Current capture
+static LONG64 g_traceStartTicks = 0;                // Capture start time
+static __declspec(thread) TraceBuffer *t_traceBuffer = NULL;
+static __declspec(thread) const char *t_traceThreadName = NULL;
+
+/**
+ * @brief Takes over a buffer released by an exited thread
+ *
+ * Only buffers whose events are not part of the current capture
+ * (or that hold no events) are reused, so recycling never loses
+ * events that have not been exported yet.
+ *
+ * @param generation Current capture
+ * @return TraceBuffer* Claimed buffer, NULL if none is free
+ */
+static TraceBuffer *claimReleasedBuffer(LONG generation)
+{
+    for (TraceBuffer *buffer = g_traceBuffers; buffer; buffer = buffer->next)
+    {
+        if (buffer->owned || (buffer->generation == generation && buffer->count > 0))
+            continue;
+        if (InterlockedCompareExchange(&buffer->owned, 1, 0) != 0)
+            continue;
+
+        // Recheck now that the buffer is ours, a capture may have written it
+        if (buffer->generation == generation && buffer->count > 0)
+        {
+            InterlockedExchange(&buffer->owned, 0);
+            continue;
+        }
+        return buffer;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Returns the calling thread's buffer for the current capture
+ *
+ * Reuses a buffer released by an exited thread when one is free,
+ * registers a new buffer otherwise, and rewinds a buffer left
+ * over from a previous capture. All of this happens without
+ * locks: buffers are claimed and the list is extended with
+ * compare-exchanges, and a buffer is only rewound by its owner.
+ *
+ * @return TraceBuffer* Buffer of the calling thread, NULL if allocation failed
+ */
+static TraceBuffer *getThreadBuffer(void)
+{
+    TraceBuffer *buffer = t_traceBuffer;
+    LONG generation = g_traceGeneration;
+    if (!buffer)
+    {
+        buffer = claimReleasedBuffer(generation);
+        if (!buffer)
+        {
+            buffer = (TraceBuffer *)festMalloc(sizeof(TraceBuffer));
+            if (!buffer)
+                return NULL;
+
+            buffer->owned = 1;
+            buffer->generation = generation;
+            buffer->count = 0;
+            buffer->dropped = 0;
+
+            // Push onto global buffer list
+            do
+            {
+                buffer->next = g_traceBuffers;
+            } while (InterlockedCompareExchangePointer((PVOID volatile *)&g_traceBuffers, buffer, buffer->next) != buffer->next);
+        }
+
+        buffer->threadId = GetCurrentThreadId();
+        buffer->threadName = t_traceThreadName;
+        t_traceBuffer = buffer;
+    }
+
+    // Rewind events of an earlier capture, including a claimed buffer's
+    if (buffer->generation != generation)
+    {
+        InterlockedExchange(&buffer->count, 0);
+        buffer->dropped = 0;
+        InterlockedExchange(&buffer->generation, generation);
+    }
+
+    return buffer;
+}
+
+/**
+ * @brief Records a trace event into the calling thread's buffer
+ *
+ * @param name Event name, must outlive the trace
+ * @param phase Chrome trace phase ('B' begin, 'E' end)
+ */
+void recordTraceEvent(const char *name, char phase)
+{
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+
+    TraceBuffer *buffer = getThreadBuffer();
+    if (!buffer)
+        return;
+
+    LONG index = buffer->count;
+    if (index >= TRACE_BUFFER_EVENTS)
+    {
+        buffer->dropped++;
+        return;
+    }
+
+    TraceEvent *event = &buffer->events[index];
+    event->name = name;
+    event->ticks = now.QuadPart;
+    event->phase = phase;
+
+    // Publish the event to the exporter
+    InterlockedExchange(&buffer->count, index + 1);
+}
+
+/**
+ * @brief Labels the calling thread in exported traces
+ *
+ * @param name Thread name shown by the trace viewer, must outlive the trace
+ */
+void setTraceThreadName(const char *name)
+{
+    // The buffer is created lazily, so naming a thread while tracing
+    // is off costs no allocation. While tracing, it is set up here
+    // so that the thread's first span does not allocate
+    t_traceThreadName = name;
+    if (t_traceBuffer)
+        t_traceBuffer->threadName = name;
+    else if (g_traceEnabled)
+        getThreadBuffer();
+}
+
+/**
+ * @brief Releases the calling thread's buffer before it exits
+ *
+ * Recorded events stay exportable until a thread tracing in a
+ * later capture takes the buffer over.
+ */
+void releaseTraceThread(void)
+{
+    TraceBuffer *buffer = t_traceBuffer;
+    if (!buffer)
+        return;
+
+    t_traceBuffer = NULL;
+    InterlockedExchange(&buffer->owned, 0);
+}
+
+/**
+ * @brief Starts or stops event capture
+ *
+ * @param enabled TRUE to record events, FALSE to stop
+ */
+void enableTraceEvents(BOOL enabled)
+{
+    if (enabled && !g_traceEnabled)
+    {
+        LARGE_INTEGER now;
+        QueryPerformanceCounter(&now);
+        g_traceStartTicks = now.QuadPart;
+        InterlockedIncrement(&g_traceGeneration);
+    }
+    InterlockedExchange(&g_traceEnabled, enabled ? 1 : 0);
+}
+
+/**
+ * @brief Writes captured events as Chrome trace-event JSON
+ *
+ * Emits a thread_name metadata record for every labelled thread,
+ * followed by the begin/end events of every buffer that belongs
+ * to the current capture.
+ *
+ * @param path Output file path
+ * @return BOOL TRUE if the file was written, FALSE if failed
+ */
+BOOL exportTraceEvents(const char *path)
+{
+    FILE *file = NULL;
+    if (!path || fopen_s(&file, path, "w") != 0 || !file)
+        return FALSE;
+
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    DWORD pid = GetCurrentProcessId();
+    LONG generation = g_traceGeneration;
+    BOOL first = TRUE;
+
+    fprintf(file, "{\n  \"traceEvents\": [\n");
+    for (TraceBuffer *buffer = g_traceBuffers; buffer; buffer = buffer->next)
+    {
+        if (buffer->generation != generation)
+            continue;
+
+        if (buffer->threadName)
+        {
+            fprintf(file,
+                    "%s    {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": %lu, \"tid\": %lu, "
+                    "\"args\": {\"name\": \"%s\"}}",
+                    first ? "" : ",\n", (unsigned long)pid, (unsigned long)buffer->threadId, buffer->threadName);
+            first = FALSE;
+        }
+
+        LONG count = InterlockedCompareExchange(&buffer->count, 0, 0);
+        for (LONG i = 0; i < count; i++)
+        {
+            const TraceEvent *event = &buffer->events[i];
+            double ts = (double)(event->ticks - g_traceStartTicks) * 1000000.0 / (double)frequency.QuadPart;
+            fprintf(file,
+                    "%s    {\"name\": \"%s\", \"cat\": \"fest\", \"ph\": \"%c\", \"ts\": %.3f, \"pid\": %lu, \"tid\": %lu}",
+                    first ? "" : ",\n", event->name, event->phase, ts, (unsigned long)pid, (unsigned long)buffer->threadId);
+            first = FALSE;
+        }
+
+        if (buffer->dropped > 0)
+        {
+            fprintf(file,
+                    "%s    {\"name\": \"dropped_events\", \"ph\": \"M\", \"pid\": %lu, \"tid\": %lu, "
+                    "\"args\": {\"count\": %ld}}",
+                    first ? "" : ",\n", (unsigned long)pid, (unsigned long)buffer->threadId, (long)buffer->dropped);
+            first = FALSE;
+        }
+    }
+    fprintf(file, "\n  ],\n  \"displayTimeUnit\": \"ms\"\n}\n");
+
+    BOOL ok = !ferror(file);
+    fclose(file);
+    return ok;
+}
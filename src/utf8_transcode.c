@@ -0,0 +1,274 @@
+#include "utf8_transcode.h"
+#include <string.h>
+#include <wchar.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define UTF8_USE_SSE2 1
+#else
+#define UTF8_USE_SSE2 0
+#endif
+
+#define UTF8_ASCII_BLOCK 16 // Code units checked and stored per SIMD step
+
+/**
+ * @brief Returns the UTF-8 length of a valid code point
+ */
+static size_t getUtf8Length(UINT codePoint)
+{
+    if (codePoint < 0x80)
+        return 1;
+    if (codePoint < 0x800)
+        return 2;
+    if (codePoint < 0x10000)
+        return 3;
+    return 4;
+}
+
+/**
+ * @brief Writes the UTF-8 sequence of a valid code point
+ *
+ * @param codePoint Code point, surrogates already combined or replaced
+ * @param out Receives getUtf8Length(codePoint) bytes
+ */
+static void encodeUtf8(UINT codePoint, BYTE *out)
+{
+    if (codePoint < 0x80)
+    {
+        out[0] = (BYTE)codePoint;
+    }
+    else if (codePoint < 0x800)
+    {
+        out[0] = (BYTE)(0xC0 | (codePoint >> 6));
+        out[1] = (BYTE)(0x80 | (codePoint & 0x3F));
+    }
+    else if (codePoint < 0x10000)
+    {
+        out[0] = (BYTE)(0xE0 | (codePoint >> 12));
+        out[1] = (BYTE)(0x80 | ((codePoint >> 6) & 0x3F));
+        out[2] = (BYTE)(0x80 | (codePoint & 0x3F));
+    }
+    else
+    {
+        out[0] = (BYTE)(0xF0 | (codePoint >> 18));
+        out[1] = (BYTE)(0x80 | ((codePoint >> 12) & 0x3F));
+        out[2] = (BYTE)(0x80 | ((codePoint >> 6) & 0x3F));
+        out[3] = (BYTE)(0x80 | (codePoint & 0x3F));
+    }
+}
+
+/**
+ * @brief Copies the leading ASCII run of UTF-16 text
+ *
+ * @param src UTF-16 code units
+ * @param count Code units that may be copied, bounded by the output room
+ * @param dst Output, receives one byte per copied unit
+ * @return size_t Code units copied, the next one is non-ASCII or past count
+ */
+static size_t copyAsciiRun16(const WORD *src, size_t count, char *dst)
+{
+    size_t i = 0;
+
+#if UTF8_USE_SSE2
+    const __m128i nonAscii = _mm_set1_epi16((short)0xFF80);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + UTF8_ASCII_BLOCK <= count; i += UTF8_ASCII_BLOCK)
+    {
+        __m128i low = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i high = _mm_loadu_si128((const __m128i *)(src + i + 8));
+        __m128i bits = _mm_and_si128(_mm_or_si128(low, high), nonAscii);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(bits, zero)) != 0xFFFF)
+            break;
+
+        // Every unit is below 0x80, so unsigned saturation keeps the low byte
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(low, high));
+    }
+#else
+    // Four code units per 64-bit test, the mask is the same in either byte order
+    for (; i + 4 <= count; i += 4)
+    {
+        UINT64 block;
+        memcpy(&block, src + i, sizeof(block));
+        if (block & 0xFF80FF80FF80FF80ULL)
+            break;
+
+        dst[i] = (char)src[i];
+        dst[i + 1] = (char)src[i + 1];
+        dst[i + 2] = (char)src[i + 2];
+        dst[i + 3] = (char)src[i + 3];
+    }
+#endif
+
+    while (i < count && src[i] < 0x80)
+    {
+        dst[i] = (char)src[i];
+        i++;
+    }
+    return i;
+}
+
+/**
+ * @brief Converts UTF-16LE text to UTF-8
+ *
+ * @param src UTF-16LE code units
+ * @param srcLength Number of code units to convert
+ * @param dst Buffer receiving the UTF-8 text
+ * @param dstSize Size of the buffer in bytes, terminator included
+ * @return size_t Bytes written, terminator excluded
+ */
+size_t utf16ToUtf8(const WORD *src, size_t srcLength, char *dst, size_t dstSize)
+{
+    if (!dst || dstSize == 0)
+        return 0;
+
+    size_t in = 0;
+    size_t out = 0;
+    size_t limit = dstSize - 1; // Room left for the terminator
+
+    while (src && in < srcLength && out < limit)
+    {
+        size_t room = limit - out;
+        size_t run = copyAsciiRun16(src + in, (srcLength - in < room) ? srcLength - in : room, dst + out);
+        in += run;
+        out += run;
+        if (in >= srcLength || out >= limit)
+            break;
+
+        UINT codePoint = src[in];
+        size_t consumed = 1;
+        if (codePoint >= 0xD800 && codePoint <= 0xDFFF)
+        {
+            if (codePoint <= 0xDBFF && in + 1 < srcLength && src[in + 1] >= 0xDC00 && src[in + 1] <= 0xDFFF)
+            {
+                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (src[in + 1] - 0xDC00);
+                consumed = 2;
+            }
+            else
+            {
+                codePoint = UTF8_REPLACEMENT_CHARACTER;
+            }
+        }
+
+        size_t length = getUtf8Length(codePoint);
+        if (length > limit - out)
+            break;
+
+        encodeUtf8(codePoint, (BYTE *)dst + out);
+        in += consumed;
+        out += length;
+    }
+
+    dst[out] = '\0';
+    return out;
+}
+
+#if WCHAR_MAX > 0xFFFF
+/**
+ * @brief Copies the leading ASCII run of UTF-32 text
+ *
+ * @param src UTF-32 code units
+ * @param count Code units that may be copied, bounded by the output room
+ * @param dst Output, receives one byte per copied unit
+ * @return size_t Code units copied, the next one is non-ASCII or past count
+ */
+static size_t copyAsciiRun32(const wchar_t *src, size_t count, char *dst)
+{
+    size_t i = 0;
+
+#if UTF8_USE_SSE2
+    const __m128i nonAscii = _mm_set1_epi32((int)0xFFFFFF80);
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + UTF8_ASCII_BLOCK <= count; i += UTF8_ASCII_BLOCK)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(src + i + 4));
+        __m128i c = _mm_loadu_si128((const __m128i *)(src + i + 8));
+        __m128i d = _mm_loadu_si128((const __m128i *)(src + i + 12));
+        __m128i bits = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), nonAscii);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(bits, zero)) != 0xFFFF)
+            break;
+
+        __m128i words = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+        _mm_storeu_si128((__m128i *)(dst + i), words);
+    }
+#else
+    for (; i + 2 <= count; i += 2)
+    {
+        UINT64 block;
+        memcpy(&block, src + i, sizeof(block));
+        if (block & 0xFFFFFF80FFFFFF80ULL)
+            break;
+
+        dst[i] = (char)src[i];
+        dst[i + 1] = (char)src[i + 1];
+    }
+#endif
+
+    while (i < count && (UINT)src[i] < 0x80)
+    {
+        dst[i] = (char)src[i];
+        i++;
+    }
+    return i;
+}
+
+/**
+ * @brief Converts UTF-32 text to UTF-8
+ *
+ * Same contract as utf16ToUtf8(), with surrogates and values
+ * above U+10FFFF replaced with U+FFFD.
+ */
+static size_t utf32ToUtf8(const wchar_t *src, size_t srcLength, char *dst, size_t dstSize)
+{
+    if (!dst || dstSize == 0)
+        return 0;
+
+    size_t in = 0;
+    size_t out = 0;
+    size_t limit = dstSize - 1; // Room left for the terminator
+
+    while (src && in < srcLength && out < limit)
+    {
+        size_t room = limit - out;
+        size_t run = copyAsciiRun32(src + in, (srcLength - in < room) ? srcLength - in : room, dst + out);
+        in += run;
+        out += run;
+        if (in >= srcLength || out >= limit)
+            break;
+
+        UINT codePoint = (UINT)src[in];
+        if (codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+            codePoint = UTF8_REPLACEMENT_CHARACTER;
+
+        size_t length = getUtf8Length(codePoint);
+        if (length > limit - out)
+            break;
+
+        encodeUtf8(codePoint, (BYTE *)dst + out);
+        in++;
+        out += length;
+    }
+
+    dst[out] = '\0';
+    return out;
+}
+#endif
+
+/**
+ * @brief Converts a terminated wide string to UTF-8
+ *
+ * @param src Wide string, NULL converts as an empty string
+ * @param dst Buffer receiving the UTF-8 text
+ * @param dstSize Size of the buffer in bytes, terminator included
+ * @return size_t Bytes written, terminator excluded
+ */
+size_t wideToUtf8(const wchar_t *src, char *dst, size_t dstSize)
+{
+    size_t length = src ? wcslen(src) : 0;
+
+#if WCHAR_MAX > 0xFFFF
+    return utf32ToUtf8(src, length, dst, dstSize);
+#else
+    return utf16ToUtf8((const WORD *)src, length, dst, dstSize);
+#endif
+}
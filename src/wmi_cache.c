@@ -0,0 +1,534 @@
+#include "wmi_cache.h"
+#include "fest_alloc.h"
+#include <string.h>
+
+/**
+ * @brief One cached query result
+ *
+ * The key is the normalized text together with the decoder,
+ * the query specification and the row size, since the same
+ * statement decoded differently yields different rows
+ */
+typedef struct
+{
+    wchar_t query[WMI_QUERY_MAX_LENGTH]; // Normalized query text
+    UINT hash;                           // Hash of the normalized text
+    WMIRowDecoder decoder;               // Decoder that produced the rows
+    const WMIQuerySpec *spec;            // Projection, NULL for raw queries
+    size_t rowSize;                      // Size of one row in bytes
+    BOOL single;                         // Holds the first object only
+    void *rows;                          // Heap copy of the rows
+    UINT count;                          // Number of rows
+    size_t bytes;                        // Bytes in use in rows
+    size_t allocated;                    // Bytes allocated for rows, reused on refresh
+    UINT64 expiresAt;                    // Clock value the result expires at
+    UINT64 lastUsed;                     // Use sequence, oldest is evicted first
+} WMICacheEntry;
+
+/**
+ * @brief Lookup key of a cached result
+ */
+typedef struct
+{
+    wchar_t query[WMI_QUERY_MAX_LENGTH]; // Normalized query text
+    UINT hash;                           // Hash of the normalized text
+    WMIRowDecoder decoder;               // Row decoder
+    const WMIQuerySpec *spec;            // Projection, NULL for raw queries
+    size_t rowSize;                      // Size of one row in bytes
+    BOOL single;                         // First object only
+} WMICacheKey;
+
+static SRWLOCK g_cacheLock = SRWLOCK_INIT;                    // Guards everything below
+static WMICacheEntry *g_cacheEntries[WMI_CACHE_MAX_ENTRIES];  // Cached results, NULL slots are free
+static UINT g_cacheMaxEntries = WMI_CACHE_MAX_ENTRIES;        // Entry limit
+static size_t g_cacheMaxBytes = WMI_CACHE_DEFAULT_MAX_BYTES;  // Row byte limit
+static size_t g_cacheBytes = 0;                               // Row bytes in use
+static UINT64 g_cacheUseSequence = 0;                         // Advanced on every hit and store
+static WMICacheStats g_cacheStats = {0};                      // Counters
+static WMICacheClock g_cacheClock = NULL;                     // Replaced by tests, NULL for GetTickCount64()
+
+/**
+ * @brief Reads the cache clock
+ */
+static UINT64 cacheNow(void)
+{
+    return g_cacheClock ? g_cacheClock() : (UINT64)GetTickCount64();
+}
+
+/**
+ * @brief Normalizes WQL text into a cache key
+ *
+ * @param query WQL statement
+ * @param normalized Buffer receiving the key
+ * @param normalizedSize Size of the buffer in characters
+ * @return BOOL TRUE if the key fits, FALSE otherwise
+ */
+BOOL normalizeWMIQuery(const wchar_t *query, wchar_t *normalized, size_t normalizedSize)
+{
+    if (!query || !normalized || normalizedSize == 0)
+        return FALSE;
+
+    size_t length = 0;
+    wchar_t quote = 0;
+    BOOL pendingSpace = FALSE;
+
+    for (; *query; query++)
+    {
+        wchar_t c = *query;
+        if (!quote && (c == L' ' || c == L'\t' || c == L'\r' || c == L'\n'))
+        {
+            // Leading whitespace is dropped, runs become one space
+            pendingSpace = length > 0;
+            continue;
+        }
+
+        if (pendingSpace)
+        {
+            if (length + 1 >= normalizedSize)
+                return FALSE;
+            normalized[length++] = L' ';
+            pendingSpace = FALSE;
+        }
+
+        if (quote)
+        {
+            if (c == quote)
+                quote = 0;
+        }
+        else if (c == L'\'' || c == L'"')
+        {
+            quote = c;
+        }
+        else if (c >= L'a' && c <= L'z')
+        {
+            c = (wchar_t)(c - L'a' + L'A');
+        }
+
+        if (length + 1 >= normalizedSize)
+            return FALSE;
+        normalized[length++] = c;
+    }
+
+    normalized[length] = L'\0';
+    return TRUE;
+}
+
+/**
+ * @brief FNV-1a hash of a normalized query
+ */
+static UINT hashQuery(const wchar_t *query)
+{
+    UINT hash = 2166136261u;
+    for (; *query; query++)
+    {
+        hash ^= (UINT)*query;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Builds the lookup key of a call
+ *
+ * @return BOOL TRUE if the normalized text fits
+ */
+static BOOL makeCacheKey(WMICacheKey *key, const wchar_t *query, WMIRowDecoder decoder,
+                         const WMIQuerySpec *spec, size_t rowSize, BOOL single)
+{
+    if (!normalizeWMIQuery(query, key->query, WMI_QUERY_MAX_LENGTH))
+        return FALSE;
+
+    key->hash = hashQuery(key->query);
+    key->decoder = decoder;
+    key->spec = spec;
+    key->rowSize = rowSize;
+    key->single = single;
+    return TRUE;
+}
+
+/**
+ * @brief Finds the slot holding a key
+ *
+ * @param key Lookup key
+ * @return int Slot index, -1 if not cached
+ */
+static int findCacheSlot(const WMICacheKey *key)
+{
+    for (int i = 0; i < WMI_CACHE_MAX_ENTRIES; i++)
+    {
+        const WMICacheEntry *entry = g_cacheEntries[i];
+        if (entry && entry->hash == key->hash && entry->decoder == key->decoder && entry->spec == key->spec &&
+            entry->rowSize == key->rowSize && entry->single == key->single && wcscmp(entry->query, key->query) == 0)
+            return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief Removes the entry of a slot
+ *
+ * @param slot Occupied slot
+ */
+static void dropCacheSlot(int slot)
+{
+    WMICacheEntry *entry = g_cacheEntries[slot];
+    g_cacheBytes -= entry->bytes;
+    g_cacheStats.entries--;
+    festFree(entry->rows);
+    festFree(entry);
+    g_cacheEntries[slot] = NULL;
+}
+
+/**
+ * @brief Evicts the least recently used entry
+ *
+ * @param keep Slot that must stay, -1 if none
+ * @return BOOL TRUE if an entry was evicted
+ */
+static BOOL evictOldestCacheEntry(int keep)
+{
+    int oldest = -1;
+    for (int i = 0; i < WMI_CACHE_MAX_ENTRIES; i++)
+    {
+        if (i != keep && g_cacheEntries[i] &&
+            (oldest < 0 || g_cacheEntries[i]->lastUsed < g_cacheEntries[oldest]->lastUsed))
+            oldest = i;
+    }
+
+    if (oldest < 0)
+        return FALSE;
+
+    dropCacheSlot(oldest);
+    g_cacheStats.evictions++;
+    return TRUE;
+}
+
+/**
+ * @brief Looks up a fresh result
+ *
+ * Expired entries stay in place so a refresh can reuse their memory.
+ *
+ * @param key Lookup key
+ * @return WMICacheEntry* Fresh entry, NULL on a miss
+ */
+static WMICacheEntry *lookupCacheEntry(const WMICacheKey *key)
+{
+    int slot = findCacheSlot(key);
+    if (slot >= 0 && cacheNow() < g_cacheEntries[slot]->expiresAt)
+    {
+        g_cacheEntries[slot]->lastUsed = ++g_cacheUseSequence;
+        g_cacheStats.hits++;
+        return g_cacheEntries[slot];
+    }
+
+    if (slot >= 0)
+        g_cacheStats.expirations++;
+    g_cacheStats.misses++;
+    return NULL;
+}
+
+/**
+ * @brief Stores a result under a key
+ *
+ * This function:
+ * 1. Reuses the key's entry, or takes a free or evicted slot
+ * 2. Reuses the entry's row memory when the result fits
+ * 3. Evicts old entries until the byte limit holds
+ *
+ * Results over the byte limit or failing allocation are not stored.
+ *
+ * @param key Lookup key
+ * @param rows First row of the result
+ * @param count Number of rows
+ * @param ttlMs Lifetime of the result
+ */
+static void storeCacheEntry(const WMICacheKey *key, const void *rows, UINT count, UINT ttlMs)
+{
+    size_t bytes = key->rowSize * count;
+    int slot = findCacheSlot(key);
+    if (bytes > g_cacheMaxBytes)
+    {
+        if (slot >= 0)
+            dropCacheSlot(slot);
+        return;
+    }
+
+    if (slot < 0)
+    {
+        UINT used = 0;
+        for (int i = 0; i < WMI_CACHE_MAX_ENTRIES; i++)
+        {
+            if (g_cacheEntries[i])
+                used++;
+            else if (slot < 0)
+                slot = i;
+        }
+        if (used >= g_cacheMaxEntries || slot < 0)
+        {
+            evictOldestCacheEntry(-1);
+            for (slot = 0; g_cacheEntries[slot]; slot++)
+                ;
+        }
+
+        WMICacheEntry *entry = (WMICacheEntry *)festMalloc(sizeof(WMICacheEntry));
+        if (!entry)
+            return;
+
+        memset(entry, 0, sizeof(WMICacheEntry));
+        memcpy(entry->query, key->query, sizeof(entry->query));
+        entry->hash = key->hash;
+        entry->decoder = key->decoder;
+        entry->spec = key->spec;
+        entry->rowSize = key->rowSize;
+        entry->single = key->single;
+        g_cacheEntries[slot] = entry;
+        g_cacheStats.entries++;
+    }
+
+    WMICacheEntry *entry = g_cacheEntries[slot];
+    g_cacheBytes -= entry->bytes;
+    entry->bytes = 0;
+    entry->count = 0;
+
+    if (bytes > entry->allocated)
+    {
+        void *copy = festRealloc(entry->rows, bytes);
+        if (!copy)
+        {
+            dropCacheSlot(slot);
+            return;
+        }
+        entry->rows = copy;
+        entry->allocated = bytes;
+    }
+
+    if (bytes > 0)
+        memcpy(entry->rows, rows, bytes);
+    entry->count = count;
+    entry->bytes = bytes;
+    entry->expiresAt = cacheNow() + ttlMs;
+    entry->lastUsed = ++g_cacheUseSequence;
+    g_cacheBytes += bytes;
+    g_cacheStats.insertions++;
+
+    while (g_cacheBytes > g_cacheMaxBytes && evictOldestCacheEntry(slot))
+        ;
+}
+
+/**
+ * @brief Appends a fresh cached result to a vector
+ *
+ * @param key Lookup key
+ * @param vector Vector receiving the rows
+ * @param delivered Receives FALSE if the rows did not fit the vector
+ * @return BOOL TRUE on a hit, FALSE if the query has to run
+ */
+static BOOL takeCachedRows(const WMICacheKey *key, WMIRowVector *vector, BOOL *delivered)
+{
+    AcquireSRWLockExclusive(&g_cacheLock);
+    WMICacheEntry *entry = lookupCacheEntry(key);
+    if (entry)
+    {
+        *delivered = reserveWMIRows(vector, entry->count);
+        if (*delivered && entry->count > 0)
+        {
+            memcpy((BYTE *)vector->rows + vector->rowSize * vector->count, entry->rows, entry->bytes);
+            vector->count += entry->count;
+        }
+    }
+    ReleaseSRWLockExclusive(&g_cacheLock);
+    return entry != NULL;
+}
+
+/**
+ * @brief Stores the rows a query appended to a vector
+ *
+ * The query itself runs unlocked, so concurrent misses on one
+ * key each run it and the last store wins.
+ *
+ * @param key Lookup key
+ * @param vector Vector holding the result
+ * @param first First row of the result
+ * @param ttlMs Lifetime of the result
+ */
+static void storeVectorRows(const WMICacheKey *key, const WMIRowVector *vector, UINT first, UINT ttlMs)
+{
+    AcquireSRWLockExclusive(&g_cacheLock);
+    storeCacheEntry(key, (const BYTE *)vector->rows + vector->rowSize * first, vector->count - first, ttlMs);
+    ReleaseSRWLockExclusive(&g_cacheLock);
+}
+
+/**
+ * @brief Runs a query, or returns its rows from the cache
+ *
+ * @param session Active WMI session, used on a miss
+ * @param query WQL statement
+ * @param vector Vector receiving the rows
+ * @param decoder Row decoder of the collector
+ * @param context Collector data passed to the decoder on a miss
+ * @param ttlMs Lifetime of a stored result, 0 bypasses the cache
+ * @return BOOL TRUE if the rows were delivered, FALSE if the query failed
+ */
+BOOL queryWMIRowsCached(WMISession *session, const wchar_t *query, WMIRowVector *vector,
+                        WMIRowDecoder decoder, void *context, UINT ttlMs)
+{
+    WMICacheKey key;
+    if (ttlMs == 0 || !makeCacheKey(&key, query, decoder, NULL, vector->rowSize, FALSE))
+        return queryWMIRows(session, query, vector, decoder, context);
+
+    BOOL delivered;
+    if (takeCachedRows(&key, vector, &delivered))
+        return delivered;
+
+    UINT first = vector->count;
+    if (!queryWMIRows(session, query, vector, decoder, context))
+        return FALSE;
+
+    storeVectorRows(&key, vector, first, ttlMs);
+    return TRUE;
+}
+
+/**
+ * @brief Cached variant of queryWMIProjected()
+ *
+ * @param session Active WMI session, used on a miss
+ * @param spec Query specification, part of the cache key
+ * @param vector Vector receiving the rows
+ * @param decoder Optional decoder completing each row, NULL if none
+ * @param context Collector data passed to the decoder on a miss
+ * @param ttlMs Lifetime of a stored result, 0 bypasses the cache
+ * @return BOOL TRUE if the rows were delivered, FALSE if the query failed
+ */
+BOOL queryWMIProjectedCached(WMISession *session, const WMIQuerySpec *spec, WMIRowVector *vector,
+                             WMIRowDecoder decoder, void *context, UINT ttlMs)
+{
+    wchar_t query[WMI_QUERY_MAX_LENGTH];
+    WMICacheKey key;
+    if (ttlMs == 0 || !buildWMIQuery(spec, query, WMI_QUERY_MAX_LENGTH) ||
+        !makeCacheKey(&key, query, decoder, spec, vector->rowSize, FALSE))
+        return queryWMIProjected(session, spec, vector, decoder, context);
+
+    BOOL delivered;
+    if (takeCachedRows(&key, vector, &delivered))
+        return delivered;
+
+    UINT first = vector->count;
+    if (!queryWMIProjected(session, spec, vector, decoder, context))
+        return FALSE;
+
+    storeVectorRows(&key, vector, first, ttlMs);
+    return TRUE;
+}
+
+/**
+ * @brief Cached variant of queryWMIObject()
+ *
+ * A hit copies only the fields the specification declares, so
+ * several queries can fill one row like queryWMIObject() does.
+ * A missing object is cached as well, as an empty result; a query
+ * that failed, timed out or was cancelled is not cached, so the
+ * next call asks the provider again.
+ *
+ * @param session Active WMI session, used on a miss
+ * @param spec Query specification, part of the cache key
+ * @param row Row to fill, left untouched if no object was returned
+ * @param rowSize Size of the row in bytes
+ * @param ttlMs Lifetime of a stored result, 0 bypasses the cache
+ * @return BOOL TRUE if an object was decoded, FALSE otherwise
+ */
+BOOL queryWMIObjectCached(WMISession *session, const WMIQuerySpec *spec, void *row, size_t rowSize, UINT ttlMs)
+{
+    wchar_t query[WMI_QUERY_MAX_LENGTH];
+    WMICacheKey key;
+    if (ttlMs == 0 || !buildWMIQuery(spec, query, WMI_QUERY_MAX_LENGTH) ||
+        !makeCacheKey(&key, query, NULL, spec, rowSize, TRUE))
+        return queryWMIObject(session, spec, row, NULL);
+
+    AcquireSRWLockExclusive(&g_cacheLock);
+    WMICacheEntry *entry = lookupCacheEntry(&key);
+    if (entry)
+    {
+        // Only the projected fields, as queryWMIObject() would decode them
+        BOOL found = entry->count > 0;
+        for (UINT i = 0; found && i < spec->propertyCount; i++)
+        {
+            const WMIPropertySpec *property = &spec->properties[i];
+            if (property->type != WMI_PROPERTY_COLUMN)
+                memcpy((BYTE *)row + property->offset, (const BYTE *)entry->rows + property->offset, property->size);
+        }
+        ReleaseSRWLockExclusive(&g_cacheLock);
+        return found;
+    }
+    ReleaseSRWLockExclusive(&g_cacheLock);
+
+    WMIQueryState state;
+    BOOL found = queryWMIObject(session, spec, row, &state);
+    if (state != WMI_QUERY_COMPLETE)
+        return found;
+
+    AcquireSRWLockExclusive(&g_cacheLock);
+    storeCacheEntry(&key, row, found ? 1 : 0, ttlMs);
+    ReleaseSRWLockExclusive(&g_cacheLock);
+    return found;
+}
+
+/**
+ * @brief Sets the size limits of the cache
+ *
+ * @param maxEntries Entries kept, clamped to 1..WMI_CACHE_MAX_ENTRIES
+ * @param maxBytes Row bytes kept over all entries
+ */
+void setWMICacheLimits(UINT maxEntries, size_t maxBytes)
+{
+    if (maxEntries < 1)
+        maxEntries = 1;
+    if (maxEntries > WMI_CACHE_MAX_ENTRIES)
+        maxEntries = WMI_CACHE_MAX_ENTRIES;
+
+    AcquireSRWLockExclusive(&g_cacheLock);
+    g_cacheMaxEntries = maxEntries;
+    g_cacheMaxBytes = maxBytes;
+    while ((g_cacheStats.entries > g_cacheMaxEntries || g_cacheBytes > g_cacheMaxBytes) && evictOldestCacheEntry(-1))
+        ;
+    ReleaseSRWLockExclusive(&g_cacheLock);
+}
+
+/**
+ * @brief Drops every cached result
+ */
+void clearWMICache(void)
+{
+    AcquireSRWLockExclusive(&g_cacheLock);
+    for (int i = 0; i < WMI_CACHE_MAX_ENTRIES; i++)
+    {
+        if (g_cacheEntries[i])
+            dropCacheSlot(i);
+    }
+    ReleaseSRWLockExclusive(&g_cacheLock);
+}
+
+/**
+ * @brief Reads the cache counters
+ *
+ * @param stats Structure to receive the counters
+ */
+void getWMICacheStats(WMICacheStats *stats)
+{
+    if (!stats)
+        return;
+
+    AcquireSRWLockExclusive(&g_cacheLock);
+    *stats = g_cacheStats;
+    stats->bytes = g_cacheBytes;
+    ReleaseSRWLockExclusive(&g_cacheLock);
+}
+
+/**
+ * @brief Replaces the clock used for TTLs
+ *
+ * @param clock Clock function, NULL restores GetTickCount64()
+ */
+void setWMICacheClock(WMICacheClock clock)
+{
+    g_cacheClock = clock;
+}
@@ -0,0 +1,60 @@
+#include "wmi_compat.h"
+
+/*
+ * OLE automation helpers for platform-independent builds. Windows
+ * builds link oleaut32 instead and compile this file empty.
+ */
+#ifndef _WIN32
+
+/**
+ * @brief Allocates a copy of a wide string
+ *
+ * @param source String to copy, NULL yields NULL
+ * @return BSTR Newly allocated copy, release with SysFreeString()
+ */
+BSTR SysAllocString(const WCHAR *source)
+{
+    if (!source)
+        return NULL;
+
+    size_t length = wcslen(source);
+    BSTR copy = (BSTR)malloc((length + 1) * sizeof(WCHAR));
+    if (copy)
+        memcpy(copy, source, (length + 1) * sizeof(WCHAR));
+    return copy;
+}
+
+/**
+ * @brief Releases a string from SysAllocString()
+ *
+ * @param value String to release, NULL is ignored
+ */
+void SysFreeString(BSTR value)
+{
+    free(value);
+}
+
+/**
+ * @brief Initializes a VARIANT to VT_EMPTY
+ *
+ * @param value VARIANT to initialize
+ */
+void VariantInit(VARIANT *value)
+{
+    memset(value, 0, sizeof(VARIANT));
+}
+
+/**
+ * @brief Releases the contents of a VARIANT
+ *
+ * @param value VARIANT to clear, left as VT_EMPTY
+ * @return HRESULT S_OK
+ */
+HRESULT VariantClear(VARIANT *value)
+{
+    if (value->vt == VT_BSTR)
+        SysFreeString(value->bstrVal);
+    VariantInit(value);
+    return S_OK;
+}
+#endif
@@ -1,41 +1,59 @@
 #include "wmi_helper.h"
+#include "fest_alloc.h"
+#include "utf8_transcode.h"
 #include <stdio.h>
 
+#ifdef _WIN32
 #pragma comment(lib, "wbemuuid.lib")
 #pragma comment(lib, "oleaut32.lib")
 #pragma comment(lib, "ole32.lib")
+#endif
+
+// Transport errors reported once the WMI provider host is gone
+#define WMI_E_SERVER_UNAVAILABLE ((HRESULT)0x800706BA) // HRESULT_FROM_WIN32(RPC_S_SERVER_UNAVAILABLE)
+#define WMI_E_CALL_FAILED ((HRESULT)0x800706BE)        // HRESULT_FROM_WIN32(RPC_S_CALL_FAILED)
 
 /**
- * @brief Initializes Windows Management Instrumentation (WMI) connection
+ * @brief Pooled session of the calling thread
+ *
+ * COM interfaces obtained in the multi-threaded apartment may be
+ * shared, but COM initialization itself is per thread, so the
+ * pool keeps one session per thread instead of one per process.
+ * Storage is thread-local: leasing never allocates.
+ */
+static __declspec(thread) WMISession t_session;
+
+static volatile WMIConnector g_wmiConnector = NULL; // NULL selects connectLocalWMI()
+static volatile LONG64 g_poolConnects = 0;
+static volatile LONG64 g_poolDisconnects = 0;
+static volatile LONG64 g_poolReconnects = 0;
+static volatile LONG64 g_poolLeases = 0;
+static volatile LONG64 g_poolFailures = 0;
+static volatile LONG g_wmiBatchSize = WMI_DEFAULT_BATCH_SIZE; // Objects requested per Next call
+static volatile LONG g_wmiQueryTimeoutMs = WMI_DEFAULT_QUERY_TIMEOUT_MS; // Deadline of synchronous queries
+static volatile LONG g_wmiCancelGeneration = 0;                          // Advanced by cancelWMIQueries()
+
+#ifdef _WIN32
+/**
+ * @brief Opens a WMI connection to the local ROOT\CIMV2 namespace
  *
- * This function performs the following initialization steps:
- * 1. Initializes COM library
- * 2. Sets COM security levels
- * 3. Creates WMI locator instance
- * 4. Establishes connection to ROOT\CIMV2 namespace
- * 5. Sets security levels on the proxy
+ * This function performs the following steps:
+ * 1. Sets COM security levels
+ * 2. Creates WMI locator instance
+ * 3. Establishes connection to ROOT\CIMV2 namespace
+ * 4. Sets security levels on the proxy
  *
- * @return WMISession* Pointer to initialized WMI session, NULL if failed
- * @note Caller must call cleanupWMI() to free resources
+ * COM security can be set only once per process. RPC_E_TOO_LATE
+ * means it was already set, by an earlier connection or by the
+ * host application, and is not an error.
+ *
+ * @param ppLoc Receives the locator
+ * @param ppSvc Receives the service connection
+ * @return HRESULT S_OK if connected, failure code otherwise
  */
-WMISession *initializeWMI(void)
+static HRESULT connectLocalWMI(IWbemLocator **ppLoc, IWbemServices **ppSvc)
 {
     HRESULT hr;
-    WMISession *session = (WMISession *)malloc(sizeof(WMISession));
-    if (!session)
-        return NULL;
-
-    session->pSvc = NULL;
-    session->pLoc = NULL;
-    session->initialized = FALSE;
-
-    // Initialize COM in multi-threaded mode
-    hr = CoInitializeEx(0, COINIT_MULTITHREADED);
-    if (FAILED(hr))
-    {
-        free(session);
-        return NULL;
-    }
 
     // Set COM security levels for WMI access
     hr = CoInitializeSecurity(
@@ -49,12 +67,8 @@ WMISession *initializeWMI(void)
         EOAC_NONE,
         NULL);
 
-    if (FAILED(hr))
-    {
-        CoUninitialize();
-        free(session);
-        return NULL;
-    }
+    if (FAILED(hr) && hr != RPC_E_TOO_LATE)
+        return hr;
 
     // Create WMI locator instance
     hr = CoCreateInstance(
@@ -62,18 +76,14 @@ WMISession *initializeWMI(void)
         0,
         CLSCTX_INPROC_SERVER,
         &IID_IWbemLocator,
-        (LPVOID *)&session->pLoc);
+        (LPVOID *)ppLoc);
 
     if (FAILED(hr))
-    {
-        CoUninitialize();
-        free(session);
-        return NULL;
-    }
+        return hr;
 
     // Connect to ROOT\CIMV2 namespace
-    hr = session->pLoc->lpVtbl->ConnectServer(
-        session->pLoc,
+    hr = (*ppLoc)->lpVtbl->ConnectServer(
+        *ppLoc,
         L"ROOT\\CIMV2",
         NULL,
         NULL,
@@ -81,19 +91,18 @@ WMISession *initializeWMI(void)
         0,
         0,
         0,
-        &session->pSvc);
+        ppSvc);
 
     if (FAILED(hr))
     {
-        session->pLoc->lpVtbl->Release(session->pLoc);
-        CoUninitialize();
-        free(session);
-        return NULL;
+        (*ppLoc)->lpVtbl->Release(*ppLoc);
+        *ppLoc = NULL;
+        return hr;
     }
 
     // Set security levels on the WMI connection
     hr = CoSetProxyBlanket(
-        (IUnknown *)session->pSvc,
+        (IUnknown *)*ppSvc,
         RPC_C_AUTHN_WINNT,
         RPC_C_AUTHZ_NONE,
         NULL,
@@ -104,47 +113,298 @@ WMISession *initializeWMI(void)
 
     if (FAILED(hr))
     {
-        session->pSvc->lpVtbl->Release(session->pSvc);
-        session->pLoc->lpVtbl->Release(session->pLoc);
-        CoUninitialize();
-        free(session);
-        return NULL;
+        (*ppSvc)->lpVtbl->Release(*ppSvc);
+        (*ppLoc)->lpVtbl->Release(*ppLoc);
+        *ppSvc = NULL;
+        *ppLoc = NULL;
+        return hr;
     }
 
-    session->initialized = TRUE;
-    return session;
+    return S_OK;
 }
+#define DEFAULT_WMI_CONNECTOR connectLocalWMI
+#else
+// No WMI outside Windows unless a connector is installed
+#define DEFAULT_WMI_CONNECTOR NULL
+#endif
 
 /**
- * @brief Cleans up WMI session and releases resources
+ * @brief Checks whether a failed call means the connection is gone
+ *
+ * @param hr Result of a call on the service connection
+ * @return BOOL TRUE if reconnecting may help, FALSE otherwise
+ */
+static BOOL isConnectionLost(HRESULT hr)
+{
+    return hr == RPC_E_DISCONNECTED ||
+           hr == RPC_E_SERVER_DIED ||
+           hr == RPC_E_SERVER_DIED_DNE ||
+           hr == WBEM_E_TRANSPORT_FAILURE ||
+           hr == WMI_E_SERVER_UNAVAILABLE ||
+           hr == WMI_E_CALL_FAILED;
+}
+
+/**
+ * @brief Connects a pooled session
  *
  * This function:
- * - Releases WMI service interface
- * - Releases WMI locator
- * - Uninitializes COM library
- * - Frees session memory
+ * 1. Initializes COM in multi-threaded mode on first use
+ * 2. Opens the connection through the installed connector
  *
- * @param session Pointer to WMI session to be cleaned up
+ * A thread already initialized into a single-threaded apartment
+ * by the host application still gets a connection; COM is then
+ * left for the host to uninitialize.
+ *
+ * @param session Session of the calling thread
+ * @return BOOL TRUE if connected, FALSE if failed
  */
-void cleanupWMI(WMISession *session)
+static BOOL connectSession(WMISession *session)
 {
-    if (session)
+    WMIConnector connector = g_wmiConnector ? g_wmiConnector : DEFAULT_WMI_CONNECTOR;
+    if (!connector)
+    {
+        InterlockedIncrement64(&g_poolFailures);
+        return FALSE;
+    }
+
+#ifdef _WIN32
+    if (!session->comInitialized)
+    {
+        HRESULT hrCom = CoInitializeEx(0, COINIT_MULTITHREADED);
+        if (SUCCEEDED(hrCom))
+            session->comInitialized = TRUE;
+        else if (hrCom != RPC_E_CHANGED_MODE)
+        {
+            InterlockedIncrement64(&g_poolFailures);
+            return FALSE;
+        }
+    }
+#endif
+
+    session->pLoc = NULL;
+    session->pSvc = NULL;
+    HRESULT hr = connector(&session->pLoc, &session->pSvc);
+    if (FAILED(hr) || !session->pSvc)
     {
         if (session->pSvc)
             session->pSvc->lpVtbl->Release(session->pSvc);
         if (session->pLoc)
             session->pLoc->lpVtbl->Release(session->pLoc);
+        session->pSvc = NULL;
+        session->pLoc = NULL;
+        InterlockedIncrement64(&g_poolFailures);
+        return FALSE;
+    }
+
+    session->initialized = TRUE;
+    InterlockedIncrement64(&g_poolConnects);
+    return TRUE;
+}
+
+/**
+ * @brief Releases the WMI interfaces of a pooled session
+ *
+ * COM stays initialized so the session can reconnect
+ *
+ * @param session Session of the calling thread
+ */
+static void disconnectSession(WMISession *session)
+{
+    if (session->pSvc)
+        session->pSvc->lpVtbl->Release(session->pSvc);
+    if (session->pLoc)
+        session->pLoc->lpVtbl->Release(session->pLoc);
+
+    if (session->initialized)
+        InterlockedIncrement64(&g_poolDisconnects);
 
+    session->pSvc = NULL;
+    session->pLoc = NULL;
+    session->initialized = FALSE;
+}
+
+/**
+ * @brief Disconnects a pooled session and uninitializes COM
+ *
+ * @param session Session of the calling thread
+ */
+static void closeSession(WMISession *session)
+{
+    disconnectSession(session);
+
+#ifdef _WIN32
+    if (session->comInitialized)
+    {
         CoUninitialize();
-        free(session);
+        session->comInitialized = FALSE;
     }
+#endif
+}
+
+/**
+ * @brief Leases the calling thread's WMI session
+ *
+ * @return WMISession* Leased session, NULL if connecting failed
+ * @note Every lease must be returned using releaseWMISession()
+ */
+WMISession *acquireWMISession(void)
+{
+    WMISession *session = &t_session;
+
+    if (!session->initialized && !connectSession(session))
+    {
+        if (session->leases == 0 && session->pins == 0)
+            closeSession(session);
+        return NULL;
+    }
+
+    session->leases++;
+    InterlockedIncrement64(&g_poolLeases);
+    return session;
+}
+
+/**
+ * @brief Returns a lease taken with acquireWMISession()
+ *
+ * @param session Leased session, NULL is ignored
+ */
+void releaseWMISession(WMISession *session)
+{
+    if (!session)
+        return;
+
+    if (session->leases > 0)
+        session->leases--;
+
+    if (session->leases == 0 && session->pins == 0)
+        closeSession(session);
+}
+
+/**
+ * @brief Keeps the calling thread's session connected between leases
+ *
+ * Connecting is deferred to the first lease
+ */
+void pinWMISession(void)
+{
+    t_session.pins++;
+}
+
+/**
+ * @brief Drops a pin taken with pinWMISession()
+ */
+void unpinWMISession(void)
+{
+    WMISession *session = &t_session;
+
+    if (session->pins > 0)
+        session->pins--;
+
+    if (session->pins == 0 && session->leases == 0)
+        closeSession(session);
+}
+
+/**
+ * @brief Sets how many objects one enumerator call fetches
+ *
+ * @param batchSize Objects per call, clamped to 1..WMI_MAX_BATCH_SIZE
+ */
+void setWMIBatchSize(UINT batchSize)
+{
+    if (batchSize < 1)
+        batchSize = 1;
+    if (batchSize > WMI_MAX_BATCH_SIZE)
+        batchSize = WMI_MAX_BATCH_SIZE;
+    InterlockedExchange(&g_wmiBatchSize, (LONG)batchSize);
+}
+
+/**
+ * @brief Returns how many objects one enumerator call fetches
+ *
+ * @return UINT Objects per call
+ */
+UINT getWMIBatchSize(void)
+{
+    return (UINT)g_wmiBatchSize;
+}
+
+/**
+ * @brief Sets the deadline of the synchronous query functions
+ *
+ * @param timeoutMs Deadline in milliseconds, 0 restores WMI_DEFAULT_QUERY_TIMEOUT_MS
+ */
+void setWMIQueryTimeout(UINT timeoutMs)
+{
+    if (timeoutMs == 0 || timeoutMs > 0x7FFFFFFF)
+        timeoutMs = WMI_DEFAULT_QUERY_TIMEOUT_MS;
+    InterlockedExchange(&g_wmiQueryTimeoutMs, (LONG)timeoutMs);
+}
+
+/**
+ * @brief Returns the deadline of the synchronous query functions
+ *
+ * @return UINT Deadline in milliseconds
+ */
+UINT getWMIQueryTimeout(void)
+{
+    return (UINT)g_wmiQueryTimeoutMs;
+}
+
+/**
+ * @brief Replaces the function used to open connections
+ *
+ * @param connector Connection function, NULL restores the default
+ */
+void setWMIConnector(WMIConnector connector)
+{
+    g_wmiConnector = connector;
+}
+
+/**
+ * @brief Reads the counters of the WMI session pool
+ *
+ * @param stats Structure to receive the counters
+ */
+void getWMIPoolStats(WMIPoolStats *stats)
+{
+    if (!stats)
+        return;
+
+    stats->connects = (UINT64)g_poolConnects;
+    stats->disconnects = (UINT64)g_poolDisconnects;
+    stats->reconnects = (UINT64)g_poolReconnects;
+    stats->leases = (UINT64)g_poolLeases;
+    stats->failures = (UINT64)g_poolFailures;
+}
+
+/**
+ * @brief Initializes Windows Management Instrumentation (WMI) connection
+ *
+ * @return WMISession* Pointer to leased WMI session, NULL if failed
+ * @note Caller must call cleanupWMI() to return the lease
+ */
+WMISession *initializeWMI(void)
+{
+    return acquireWMISession();
+}
+
+/**
+ * @brief Cleans up WMI session and releases resources
+ *
+ * @param session Pointer to WMI session to be cleaned up
+ */
+void cleanupWMI(WMISession *session)
+{
+    releaseWMISession(session);
 }
 
 /**
  * @brief Executes a WQL query on the WMI connection
  *
  * This function executes a Windows Query Language (WQL) query
- * with forward-only and immediate return flags.
+ * with forward-only and immediate return flags. If the provider
+ * host went away (service restart, machine resume), the pooled
+ * connection is replaced and the query is retried once.
  *
  * @param session Active WMI session
  * @param query WQL query string (wide character)
@@ -164,14 +424,639 @@ BOOL executeWQLQuery(WMISession *session, const wchar_t *query, IEnumWbemClassOb
         NULL,
         ppEnumerator);
 
+    if (FAILED(hr) && isConnectionLost(hr))
+    {
+        disconnectSession(session);
+        if (!connectSession(session))
+            return FALSE;
+        InterlockedIncrement64(&g_poolReconnects);
+
+        hr = session->pSvc->lpVtbl->ExecQuery(
+            session->pSvc,
+            L"WQL",
+            (BSTR)query,
+            WBEM_FLAG_FORWARD_ONLY | WBEM_FLAG_RETURN_IMMEDIATELY,
+            NULL,
+            ppEnumerator);
+    }
+
     return SUCCEEDED(hr);
 }
 
+/**
+ * @brief Prepares an empty row vector
+ *
+ * No memory is reserved until the first row arrives
+ *
+ * @param vector Vector to prepare
+ * @param arena Arena to allocate rows from, NULL to use the heap
+ * @param rowSize Size of one row in bytes
+ * @param initialCapacity Rows to reserve on the first row, 0 for the default
+ */
+void initWMIRowVector(WMIRowVector *vector, SnapshotArena *arena, size_t rowSize, UINT initialCapacity)
+{
+    vector->rows = NULL;
+    vector->count = 0;
+    vector->capacity = initialCapacity > 0 ? initialCapacity : WMI_ROWS_INITIAL_CAPACITY;
+    vector->rowSize = rowSize;
+    vector->arena = arena;
+}
+
+/**
+ * @brief Makes room for more rows
+ *
+ * Doubles the capacity until the rows fit. Heap rows are
+ * resized in place when possible; arena rows are copied into a
+ * new block and the old one is reclaimed with the arena.
+ *
+ * @param vector Vector to grow
+ * @param count Number of rows to append
+ * @return BOOL TRUE if the rows are free, FALSE if allocation failed
+ */
+BOOL reserveWMIRows(WMIRowVector *vector, UINT count)
+{
+    UINT needed = vector->count + count;
+    if (vector->rows && needed <= vector->capacity)
+        return TRUE;
+
+    UINT capacity = vector->rows ? vector->capacity * 2 : vector->capacity;
+    while (capacity < needed)
+        capacity *= 2;
+
+    void *rows;
+    if (vector->arena)
+    {
+        rows = arenaAlloc(vector->arena, vector->rowSize * capacity);
+        if (rows && vector->rows)
+            memcpy(rows, vector->rows, vector->rowSize * vector->count);
+    }
+    else
+    {
+        rows = festRealloc(vector->rows, vector->rowSize * capacity);
+    }
+
+    if (!rows)
+        return FALSE;
+
+    vector->rows = rows;
+    vector->capacity = capacity;
+    return TRUE;
+}
+
+/**
+ * @brief Decodes a batch of objects into a row vector
+ *
+ * Every object of the batch is released, also after a failed
+ * allocation
+ *
+ * @param batch Objects returned by one enumerator call
+ * @param count Number of objects
+ * @param vector Vector receiving the rows
+ * @param decoder Row decoder of the collector
+ * @param context Collector data passed to the decoder
+ * @return BOOL TRUE if every object was stored or discarded, FALSE if allocation failed
+ */
+static BOOL storeWMIBatch(IWbemClassObject **batch, ULONG count, WMIRowVector *vector, WMIRowDecoder decoder, void *context)
+{
+    BOOL ok = TRUE;
+
+    for (ULONG i = 0; i < count; i++)
+    {
+        if (ok && !reserveWMIRows(vector, 1))
+            ok = FALSE;
+
+        if (ok)
+        {
+            void *row = (BYTE *)vector->rows + vector->rowSize * vector->count;
+            memset(row, 0, vector->rowSize);
+            if (decoder(batch[i], row, context))
+                vector->count++;
+        }
+
+        batch[i]->lpVtbl->Release(batch[i]);
+    }
+
+    return ok;
+}
+
+/**
+ * @brief Ends a query and releases its enumerator
+ *
+ * @param async Pending query
+ * @param state Final state
+ * @param result Failure or enumeration error, S_OK otherwise
+ */
+static void finishWMIQuery(WMIAsyncQuery *async, WMIQueryState state, HRESULT result)
+{
+    if (async->pEnumerator)
+        async->pEnumerator->lpVtbl->Release(async->pEnumerator);
+
+    async->pEnumerator = NULL;
+    async->state = state;
+    async->result = result;
+}
+
+/**
+ * @brief Ends a query that was cancelled or ran past its deadline
+ *
+ * @param async Pending query
+ * @param now Current GetTickCount64() value
+ * @return BOOL TRUE if the query was ended
+ */
+static BOOL expireWMIQuery(WMIAsyncQuery *async, UINT64 now)
+{
+    if (async->cancelGeneration != g_wmiCancelGeneration)
+    {
+        finishWMIQuery(async, WMI_QUERY_CANCELLED, WBEM_E_CALL_CANCELLED);
+        return TRUE;
+    }
+
+    if (now >= async->deadline)
+    {
+        finishWMIQuery(async, WMI_QUERY_TIMED_OUT, WBEM_S_TIMEDOUT);
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+/**
+ * @brief Returns how long a blocking poll of a query may wait
+ *
+ * @param async Pending query
+ * @param now Current GetTickCount64() value
+ * @return LONG Wait in milliseconds, at most WMI_POLL_SLICE_MS
+ */
+static LONG getWMIPollWait(const WMIAsyncQuery *async, UINT64 now)
+{
+    if (now >= async->deadline)
+        return WBEM_NO_WAIT;
+
+    UINT64 remaining = async->deadline - now;
+    return remaining < WMI_POLL_SLICE_MS ? (LONG)remaining : WMI_POLL_SLICE_MS;
+}
+
+/**
+ * @brief Row decoder of a started query
+ *
+ * Stores the declared properties of a projected query, then
+ * hands the row to the collector's decoder
+ *
+ * @param pclsObj WMI class object
+ * @param row Row to fill
+ * @param context WMIAsyncQuery of the row
+ * @return BOOL Result of the collector's decoder, TRUE without one
+ */
+static BOOL decodeAsyncRow(IWbemClassObject *pclsObj, void *row, void *context)
+{
+    WMIAsyncQuery *async = (WMIAsyncQuery *)context;
+
+    if (async->spec)
+        decodeWMIProperties(pclsObj, async->spec->properties, async->spec->propertyCount, row);
+    return async->decoder ? async->decoder(pclsObj, row, async->context) : TRUE;
+}
+
+/**
+ * @brief Fetches the objects a query has ready
+ *
+ * With a timeout of WBEM_NO_WAIT the provider returns at once,
+ * reporting WBEM_S_TIMEDOUT when fewer objects than requested
+ * are ready; the objects it did return are stored either way.
+ *
+ * @param async Pending query
+ * @param timeoutMs Longest wait for a full batch
+ * @return BOOL TRUE if objects arrived or the query ended
+ */
+static BOOL pollWMIQuery(WMIAsyncQuery *async, LONG timeoutMs)
+{
+    IWbemClassObject *batch[WMI_MAX_BATCH_SIZE];
+    ULONG batchSize = (ULONG)g_wmiBatchSize;
+    ULONG uReturn = 0;
+
+    HRESULT hr = async->pEnumerator->lpVtbl->Next(async->pEnumerator, timeoutMs, batchSize, batch, &uReturn);
+    if (!storeWMIBatch(batch, uReturn, async->vector, decodeAsyncRow, async))
+    {
+        finishWMIQuery(async, WMI_QUERY_FAILED, E_OUTOFMEMORY);
+        return TRUE;
+    }
+
+    if (hr == WBEM_S_TIMEDOUT)
+        return uReturn > 0;
+
+    // An enumeration error ends the result, keeping the rows read so far
+    if (FAILED(hr))
+        finishWMIQuery(async, WMI_QUERY_COMPLETE, hr);
+    else if (hr != WBEM_S_NO_ERROR || uReturn < batchSize)
+        finishWMIQuery(async, WMI_QUERY_COMPLETE, S_OK);
+    return TRUE;
+}
+
+/**
+ * @brief Starts a WQL query without waiting for its objects
+ *
+ * ExecQuery runs semisynchronously: it returns as soon as the
+ * provider accepted the query and objects are fetched later
+ * by waitWMIQueries().
+ *
+ * @param session Active WMI session
+ * @param query WQL query string (wide character)
+ * @param vector Vector receiving the rows
+ * @param decoder Row decoder of the collector
+ * @param context Collector data passed to the decoder
+ * @param timeoutMs Time allowed for the whole query, 0 for getWMIQueryTimeout()
+ * @param async Query to start
+ * @return BOOL TRUE if the query is pending, FALSE if failed
+ */
+BOOL startWMIQuery(WMISession *session, const wchar_t *query, WMIRowVector *vector,
+                   WMIRowDecoder decoder, void *context, UINT timeoutMs, WMIAsyncQuery *async)
+{
+    async->pEnumerator = NULL;
+    async->vector = vector;
+    async->spec = NULL;
+    async->decoder = decoder;
+    async->context = context;
+    async->deadline = GetTickCount64() + (timeoutMs ? timeoutMs : getWMIQueryTimeout());
+    async->cancelGeneration = g_wmiCancelGeneration;
+    async->state = WMI_QUERY_PENDING;
+    async->result = S_OK;
+
+    if (!executeWQLQuery(session, query, &async->pEnumerator))
+    {
+        async->pEnumerator = NULL;
+        finishWMIQuery(async, WMI_QUERY_FAILED, WBEM_E_FAILED);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/**
+ * @brief Starts a projected query without waiting for its objects
+ *
+ * @param session Active WMI session
+ * @param spec Query specification, must outlive the query
+ * @param vector Vector receiving the rows
+ * @param decoder Additional row decoder, NULL for none
+ * @param context Collector data passed to the decoder
+ * @param timeoutMs Time allowed for the whole query, 0 for getWMIQueryTimeout()
+ * @param async Query to start
+ * @return BOOL TRUE if the query is pending, FALSE if failed
+ */
+BOOL startWMIProjectedQuery(WMISession *session, const WMIQuerySpec *spec, WMIRowVector *vector,
+                            WMIRowDecoder decoder, void *context, UINT timeoutMs, WMIAsyncQuery *async)
+{
+    wchar_t query[WMI_QUERY_MAX_LENGTH];
+    if (!buildWMIQuery(spec, query, WMI_QUERY_MAX_LENGTH))
+    {
+        async->pEnumerator = NULL;
+        async->state = WMI_QUERY_FAILED;
+        async->result = WBEM_E_INVALID_QUERY;
+        return FALSE;
+    }
+
+    BOOL started = startWMIQuery(session, query, vector, decoder, context, timeoutMs, async);
+    async->spec = spec;
+    return started;
+}
+
+/**
+ * @brief Drives pending queries until each one has finished
+ *
+ * Every round polls all pending queries without blocking. Only
+ * when none of them had objects ready does the thread block,
+ * on the query closest to its deadline and for at most
+ * WMI_POLL_SLICE_MS, so cancellation and the deadlines of the
+ * other queries are noticed within one slice.
+ *
+ * @param queries Queries to drive
+ * @param count Number of queries
+ * @return UINT Number of queries that are WMI_QUERY_COMPLETE
+ */
+UINT waitWMIQueries(WMIAsyncQuery *queries, UINT count)
+{
+    for (;;)
+    {
+        WMIAsyncQuery *nearest = NULL;
+        BOOL progress = FALSE;
+        UINT64 now = GetTickCount64();
+
+        for (UINT i = 0; i < count; i++)
+        {
+            WMIAsyncQuery *async = &queries[i];
+            if (async->state != WMI_QUERY_PENDING || expireWMIQuery(async, now))
+                continue;
+
+            if (pollWMIQuery(async, WBEM_NO_WAIT))
+                progress = TRUE;
+
+            if (async->state == WMI_QUERY_PENDING && (!nearest || async->deadline < nearest->deadline))
+                nearest = async;
+        }
+
+        if (!nearest)
+            break;
+
+        if (!progress)
+        {
+            now = GetTickCount64();
+            if (!expireWMIQuery(nearest, now))
+                pollWMIQuery(nearest, getWMIPollWait(nearest, now));
+        }
+    }
+
+    UINT complete = 0;
+    for (UINT i = 0; i < count; i++)
+    {
+        if (queries[i].state == WMI_QUERY_COMPLETE)
+            complete++;
+    }
+    return complete;
+}
+
+/**
+ * @brief Cancels one pending query
+ *
+ * @param async Query to cancel, ignored unless pending
+ */
+void cancelWMIQuery(WMIAsyncQuery *async)
+{
+    if (async->state == WMI_QUERY_PENDING)
+        finishWMIQuery(async, WMI_QUERY_CANCELLED, WBEM_E_CALL_CANCELLED);
+}
+
+/**
+ * @brief Cancels every query started so far, on any thread
+ *
+ * Only advances a counter: each waiting thread compares it with
+ * the value its queries started under and ends them itself, so
+ * no enumerator is touched outside its owning thread.
+ */
+void cancelWMIQueries(void)
+{
+    InterlockedIncrement(&g_wmiCancelGeneration);
+}
+
+/**
+ * @brief Runs a WQL query and decodes its result in a single pass
+ *
+ * @param session Active WMI session
+ * @param query WQL query string (wide character)
+ * @param vector Vector receiving the rows
+ * @param decoder Row decoder of the collector
+ * @param context Collector data passed to the decoder
+ * @return BOOL TRUE if the query ran to its end and its rows were stored, FALSE if failed
+ */
+BOOL queryWMIRows(WMISession *session, const wchar_t *query, WMIRowVector *vector, WMIRowDecoder decoder, void *context)
+{
+    WMIAsyncQuery async;
+    if (!startWMIQuery(session, query, vector, decoder, context, 0, &async))
+        return FALSE;
+
+    return waitWMIQueries(&async, 1) == 1;
+}
+
+/**
+ * @brief Appends a string to a statement under construction
+ *
+ * @param query Statement buffer
+ * @param querySize Size of the buffer in characters
+ * @param length Current length, advanced past the appended text
+ * @param text Text to append
+ * @return BOOL TRUE if the text fits, FALSE otherwise
+ */
+static BOOL appendQueryText(wchar_t *query, size_t querySize, size_t *length, const wchar_t *text)
+{
+    size_t textLength = wcslen(text);
+    if (*length + textLength >= querySize)
+        return FALSE;
+
+    memcpy(query + *length, text, (textLength + 1) * sizeof(wchar_t));
+    *length += textLength;
+    return TRUE;
+}
+
+/**
+ * @brief Generates the WQL statement of a projected query
+ *
+ * @param spec Query specification
+ * @param query Buffer to receive the statement
+ * @param querySize Size of the buffer in characters
+ * @return BOOL TRUE if the statement fits, FALSE otherwise
+ */
+BOOL buildWMIQuery(const WMIQuerySpec *spec, wchar_t *query, size_t querySize)
+{
+    if (!spec || !spec->className || spec->propertyCount == 0 || !query || querySize == 0)
+        return FALSE;
+
+    size_t length = 0;
+    query[0] = L'\0';
+
+    BOOL ok = appendQueryText(query, querySize, &length, L"SELECT ");
+    for (UINT i = 0; ok && i < spec->propertyCount; i++)
+    {
+        if (i > 0)
+            ok = appendQueryText(query, querySize, &length, L", ");
+        ok = ok && appendQueryText(query, querySize, &length, spec->properties[i].name);
+    }
+    ok = ok && appendQueryText(query, querySize, &length, L" FROM ");
+    ok = ok && appendQueryText(query, querySize, &length, spec->className);
+    if (spec->where)
+    {
+        ok = ok && appendQueryText(query, querySize, &length, L" WHERE ");
+        ok = ok && appendQueryText(query, querySize, &length, spec->where);
+    }
+
+    if (!ok)
+        query[0] = L'\0';
+    return ok;
+}
+
+/**
+ * @brief Converts a numeric VARIANT to an unsigned integer
+ *
+ * WMI returns uint64 properties as strings and smaller
+ * integers in their own VARIANT types
+ *
+ * @param value Property value
+ * @param result Receives the converted value
+ * @return BOOL TRUE if the value is numeric, FALSE otherwise
+ */
+static BOOL variantToUInt64(const VARIANT *value, UINT64 *result)
+{
+    switch (value->vt)
+    {
+    case VT_BSTR:
+        if (!value->bstrVal)
+            return FALSE;
+        *result = wcstoull(value->bstrVal, NULL, 10);
+        return TRUE;
+    case VT_I8:
+    case VT_UI8:
+        *result = value->ullVal;
+        return TRUE;
+    case VT_I4:
+    case VT_UI4:
+    case VT_INT:
+    case VT_UINT:
+        *result = value->ulVal;
+        return TRUE;
+    case VT_I2:
+    case VT_UI2:
+        *result = value->uiVal;
+        return TRUE;
+    case VT_UI1:
+        *result = value->bVal;
+        return TRUE;
+    case VT_BOOL:
+        *result = value->boolVal ? 1 : 0;
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+
+/**
+ * @brief Decodes the declared properties of an object into a row
+ *
+ * @param pclsObj WMI class object
+ * @param properties Property declarations
+ * @param count Number of declarations
+ * @param row Row to fill
+ * @return UINT Number of fields stored
+ */
+UINT decodeWMIProperties(IWbemClassObject *pclsObj, const WMIPropertySpec *properties, UINT count, void *row)
+{
+    UINT stored = 0;
+
+    for (UINT i = 0; i < count; i++)
+    {
+        const WMIPropertySpec *property = &properties[i];
+        if (property->type == WMI_PROPERTY_COLUMN)
+            continue;
+
+        VARIANT vtProp;
+        if (FAILED(pclsObj->lpVtbl->Get(pclsObj, property->name, 0, &vtProp, 0, 0)))
+            continue;
+
+        BYTE *field = (BYTE *)row + property->offset;
+        UINT64 number;
+        switch (property->type)
+        {
+        case WMI_PROPERTY_STRING:
+            if (vtProp.vt == VT_BSTR && vtProp.bstrVal)
+            {
+                wideToUtf8(vtProp.bstrVal, (char *)field, property->size);
+                stored++;
+            }
+            break;
+        case WMI_PROPERTY_UINT32:
+            if (variantToUInt64(&vtProp, &number))
+            {
+                *(UINT *)field = (UINT)number;
+                stored++;
+            }
+            break;
+        case WMI_PROPERTY_UINT64:
+            if (variantToUInt64(&vtProp, &number))
+            {
+                *(UINT64 *)field = number;
+                stored++;
+            }
+            break;
+        default:
+            break;
+        }
+        VariantClear(&vtProp);
+    }
+
+    return stored;
+}
+
+/**
+ * @brief Runs a projected query and decodes its rows in a single pass
+ *
+ * @param session Active WMI session
+ * @param spec Query specification
+ * @param vector Vector receiving the rows
+ * @param decoder Additional row decoder, NULL for none
+ * @param context Collector data passed to the decoder
+ * @return BOOL TRUE if the query ran and its rows were stored, FALSE if failed
+ */
+BOOL queryWMIProjected(WMISession *session, const WMIQuerySpec *spec, WMIRowVector *vector, WMIRowDecoder decoder, void *context)
+{
+    WMIAsyncQuery async;
+    if (!startWMIProjectedQuery(session, spec, vector, decoder, context, 0, &async))
+        return FALSE;
+
+    return waitWMIQueries(&async, 1) == 1;
+}
+
+/**
+ * @brief Runs a projected query and decodes its first object
+ *
+ * @param session Active WMI session
+ * @param spec Query specification
+ * @param row Row to fill, left untouched if no object was returned
+ * @param state Receives how the query ended, NULL if not needed
+ * @return BOOL TRUE if an object was decoded, FALSE otherwise
+ */
+BOOL queryWMIObject(WMISession *session, const WMIQuerySpec *spec, void *row, WMIQueryState *state)
+{
+    wchar_t query[WMI_QUERY_MAX_LENGTH];
+    WMIAsyncQuery async;
+    if (state)
+        *state = WMI_QUERY_FAILED;
+    if (!buildWMIQuery(spec, query, WMI_QUERY_MAX_LENGTH) || !startWMIQuery(session, query, NULL, NULL, NULL, 0, &async))
+        return FALSE;
+
+    BOOL found = FALSE;
+    LONG wait = WBEM_NO_WAIT;
+    while (async.state == WMI_QUERY_PENDING && !expireWMIQuery(&async, GetTickCount64()))
+    {
+        IWbemClassObject *pclsObj = NULL;
+        ULONG uReturn = 0;
+        HRESULT hr = async.pEnumerator->lpVtbl->Next(async.pEnumerator, wait, 1, &pclsObj, &uReturn);
+        if (uReturn != 0)
+        {
+            decodeWMIProperties(pclsObj, spec->properties, spec->propertyCount, row);
+            pclsObj->lpVtbl->Release(pclsObj);
+            found = TRUE;
+            finishWMIQuery(&async, WMI_QUERY_COMPLETE, S_OK);
+        }
+        else if (hr != WBEM_S_TIMEDOUT)
+        {
+            finishWMIQuery(&async, WMI_QUERY_COMPLETE, hr);
+        }
+        else
+        {
+            wait = getWMIPollWait(&async, GetTickCount64());
+        }
+    }
+
+    // An enumeration error ends the query as complete, but it found nothing
+    if (state)
+        *state = async.state == WMI_QUERY_COMPLETE && FAILED(async.result) ? WMI_QUERY_FAILED : async.state;
+    return found;
+}
+
+/**
+ * @brief Releases the rows of a heap-backed vector
+ *
+ * @param vector Vector to release, left empty
+ */
+void releaseWMIRowVector(WMIRowVector *vector)
+{
+    if (!vector->arena && vector->rows)
+        festFree(vector->rows);
+
+    vector->rows = NULL;
+    vector->count = 0;
+}
+
 /**
  * @brief Retrieves a string property from a WMI object
  *
  * This function gets a wide string property from a WMI object
- * and converts it to a narrow string.
+ * and converts it to UTF-8, see wideToUtf8().
  *
  * @param pclsObj WMI class object
  * @param property Property name (wide character)
@@ -187,7 +1072,7 @@ BOOL getWMIPropertyString(IWbemClassObject *pclsObj, const wchar_t *property, ch
     hr = pclsObj->lpVtbl->Get(pclsObj, property, 0, &vtProp, 0, 0);
     if (SUCCEEDED(hr) && vtProp.vt != VT_NULL)
     {
-        wcstombs_s(NULL, buffer, bufferSize, vtProp.bstrVal, _TRUNCATE);
+        wideToUtf8(vtProp.bstrVal, buffer, bufferSize);
         VariantClear(&vtProp);
         return TRUE;
     }
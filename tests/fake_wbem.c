@@ -0,0 +1,424 @@
+#include "fake_wbem.h"
+#include <stdlib.h>
+#include <wchar.h>
+
+/**
+ * @brief Reference-counted fake COM object
+ *
+ * The interface pointer is the first member, so the object can
+ * be recovered from the This pointer of any call
+ */
+typedef struct
+{
+    void *lpVtbl;           // Interface vtable
+    LONG refCount;          // COM reference count
+    UINT position;          // Next row of an enumerator
+    const FakeWbemRow *row; // Row of a class object
+    UINT64 readyAt;         // GetTickCount64() value from which an enumerator has objects
+    wchar_t query[512];     // Query of an enumerator and its objects
+} FakeObject;
+
+static const FakeWbemRow *g_rows = NULL; // Rows returned by every query
+static UINT g_rowCount = 0;              // Number of rows
+static UINT g_failQueries = 0;           // Queries left to fail
+static HRESULT g_failQueryResult = S_OK; // Result of a failing query
+static UINT g_failConnects = 0;          // Connects left to fail
+static UINT g_failEnumAfter = 0;         // Rows returned before Next fails
+static HRESULT g_failEnumResult = S_OK;  // Result of a failing Next
+static FakeWbemStats g_stats = {0};      // Call counters
+static wchar_t g_lastQuery[1024] = L"";  // Text of the most recent query
+static LONG64 g_callCostTicks = 0;       // Busy time added to every Next call
+static UINT g_queryDelayMs = 0;          // Time before a new enumerator has objects
+
+/**
+ * @brief Creates a fake object holding one reference
+ *
+ * @param vtbl Interface vtable of the object
+ * @return FakeObject* New object, NULL if allocation failed
+ */
+static FakeObject *createObject(void *vtbl)
+{
+    FakeObject *object = (FakeObject *)calloc(1, sizeof(FakeObject));
+    if (!object)
+        return NULL;
+
+    object->lpVtbl = vtbl;
+    object->refCount = 1;
+    InterlockedIncrement(&g_stats.liveObjects);
+    return object;
+}
+
+/**
+ * @brief IUnknown methods shared by every fake interface
+ */
+static HRESULT STDMETHODCALLTYPE fakeQueryInterface(void *This, const void *riid, void **ppvObject)
+{
+    *ppvObject = NULL;
+    return E_FAIL;
+}
+
+static ULONG STDMETHODCALLTYPE fakeAddRef(void *This)
+{
+    return (ULONG)InterlockedIncrement(&((FakeObject *)This)->refCount);
+}
+
+static ULONG STDMETHODCALLTYPE fakeRelease(void *This)
+{
+    LONG count = InterlockedDecrement(&((FakeObject *)This)->refCount);
+    if (count == 0)
+    {
+        InterlockedDecrement(&g_stats.liveObjects);
+        free(This);
+    }
+    return (ULONG)count;
+}
+
+/**
+ * @brief Checks whether a query selected a property
+ *
+ * @param query Query that returned the object
+ * @param name Property name
+ * @return BOOL TRUE for "SELECT *" or a listed property
+ */
+static BOOL isPropertySelected(const wchar_t *query, const WCHAR *name)
+{
+    const wchar_t *list = query;
+    if (wcsncmp(list, L"SELECT ", 7) != 0)
+        return TRUE;
+    list += 7;
+
+    const wchar_t *end = wcsstr(list, L" FROM ");
+    if (!end || wcsncmp(list, L"*", 1) == 0)
+        return TRUE;
+
+    size_t nameLength = wcslen(name);
+    while (list < end)
+    {
+        const wchar_t *comma = wcschr(list, L',');
+        const wchar_t *itemEnd = (comma && comma < end) ? comma : end;
+        if ((size_t)(itemEnd - list) == nameLength && wcsncmp(list, name, nameLength) == 0)
+            return TRUE;
+
+        list = itemEnd;
+        while (list < end && (*list == L',' || *list == L' '))
+            list++;
+    }
+    return FALSE;
+}
+
+/**
+ * @brief IWbemClassObject::Get returning a property of the row
+ */
+static HRESULT STDMETHODCALLTYPE classObjectGet(IWbemClassObject *This, const WCHAR *wszName, LONG lFlags,
+                              VARIANT *pVal, CIMTYPE *pType, LONG *plFlavor)
+{
+    const FakeWbemRow *row = ((FakeObject *)This)->row;
+    if (!isPropertySelected(((FakeObject *)This)->query, wszName))
+        return WBEM_E_NOT_FOUND;
+
+    for (UINT i = 0; i < row->count; i++)
+    {
+        if (wcscmp(row->properties[i].name, wszName) != 0)
+            continue;
+
+        VariantInit(pVal);
+        if (row->properties[i].value)
+        {
+            pVal->vt = VT_BSTR;
+            pVal->bstrVal = SysAllocString(row->properties[i].value);
+        }
+        else if (row->properties[i].vt != VT_EMPTY)
+        {
+            pVal->vt = row->properties[i].vt;
+            pVal->llVal = row->properties[i].number;
+        }
+        else
+        {
+            pVal->vt = VT_NULL;
+        }
+        return WBEM_S_NO_ERROR;
+    }
+
+    return WBEM_E_NOT_FOUND;
+}
+
+static IWbemClassObjectVtbl g_classObjectVtbl = {
+    .QueryInterface = (void *)fakeQueryInterface,
+    .AddRef = (void *)fakeAddRef,
+    .Release = (void *)fakeRelease,
+    .Get = classObjectGet};
+
+/**
+ * @brief Busy-waits for the configured cost of one provider call
+ */
+static void spinCallCost(void)
+{
+    if (g_callCostTicks <= 0)
+        return;
+
+    LARGE_INTEGER start, now;
+    QueryPerformanceCounter(&start);
+    do
+    {
+        QueryPerformanceCounter(&now);
+    } while (now.QuadPart - start.QuadPart < g_callCostTicks);
+}
+
+/**
+ * @brief IEnumWbemClassObject methods walking the configured rows
+ */
+static HRESULT STDMETHODCALLTYPE enumReset(IEnumWbemClassObject *This)
+{
+    ((FakeObject *)This)->position = 0;
+    return WBEM_S_NO_ERROR;
+}
+
+static HRESULT STDMETHODCALLTYPE enumNext(IEnumWbemClassObject *This, LONG lTimeout, ULONG uCount,
+                        IWbemClassObject **apObjects, ULONG *puReturned)
+{
+    FakeObject *enumerator = (FakeObject *)This;
+    ULONG returned = 0;
+    g_stats.nextCalls++;
+
+    // A delayed query has nothing ready before its time, like a busy provider
+    UINT64 now = GetTickCount64();
+    if (now < enumerator->readyAt)
+    {
+        UINT64 remaining = enumerator->readyAt - now;
+        if (lTimeout != WBEM_INFINITE && (UINT64)lTimeout < remaining)
+        {
+            if (lTimeout > 0)
+                Sleep((DWORD)lTimeout);
+            g_stats.timeouts++;
+            *puReturned = 0;
+            return WBEM_S_TIMEDOUT;
+        }
+        Sleep((DWORD)remaining);
+    }
+
+    if (FAILED(g_failEnumResult) && enumerator->position >= g_failEnumAfter)
+    {
+        *puReturned = 0;
+        return g_failEnumResult;
+    }
+
+    // Rows past a scripted failure are never returned
+    UINT limit = g_rowCount;
+    if (FAILED(g_failEnumResult) && g_failEnumAfter < limit)
+        limit = g_failEnumAfter;
+
+    spinCallCost();
+    while (returned < uCount && enumerator->position < limit)
+    {
+        FakeObject *object = createObject(&g_classObjectVtbl);
+        if (!object)
+            break;
+        object->row = &g_rows[enumerator->position++];
+        wcscpy(object->query, enumerator->query);
+        apObjects[returned++] = (IWbemClassObject *)object;
+    }
+
+    *puReturned = returned;
+    return returned == uCount ? WBEM_S_NO_ERROR : WBEM_S_FALSE;
+}
+
+static HRESULT STDMETHODCALLTYPE enumSkip(IEnumWbemClassObject *This, LONG lTimeout, ULONG nCount)
+{
+    FakeObject *enumerator = (FakeObject *)This;
+    UINT remaining = g_rowCount - enumerator->position;
+    if (nCount > remaining)
+    {
+        enumerator->position = g_rowCount;
+        return WBEM_S_FALSE;
+    }
+
+    enumerator->position += nCount;
+    return WBEM_S_NO_ERROR;
+}
+
+static IEnumWbemClassObjectVtbl g_enumVtbl = {
+    .QueryInterface = (void *)fakeQueryInterface,
+    .AddRef = (void *)fakeAddRef,
+    .Release = (void *)fakeRelease,
+    .Reset = enumReset,
+    .Next = enumNext,
+    .Skip = enumSkip};
+
+/**
+ * @brief IWbemServices::ExecQuery returning an enumerator over the rows
+ */
+static HRESULT STDMETHODCALLTYPE servicesExecQuery(IWbemServices *This, const BSTR strQueryLanguage, const BSTR strQuery,
+                                 LONG lFlags, IWbemContext *pCtx, IEnumWbemClassObject **ppEnum)
+{
+    g_stats.queries++;
+    *ppEnum = NULL;
+    wcsncpy(g_lastQuery, strQuery, sizeof(g_lastQuery) / sizeof(g_lastQuery[0]) - 1);
+
+    if (g_failQueries > 0)
+    {
+        g_failQueries--;
+        return g_failQueryResult;
+    }
+
+    FakeObject *enumerator = createObject(&g_enumVtbl);
+    if (!enumerator)
+        return E_OUTOFMEMORY;
+
+    wcsncpy(enumerator->query, strQuery, sizeof(enumerator->query) / sizeof(enumerator->query[0]) - 1);
+    enumerator->readyAt = GetTickCount64() + g_queryDelayMs;
+    *ppEnum = (IEnumWbemClassObject *)enumerator;
+    return WBEM_S_NO_ERROR;
+}
+
+static IWbemServicesVtbl g_servicesVtbl = {
+    .QueryInterface = (void *)fakeQueryInterface,
+    .AddRef = (void *)fakeAddRef,
+    .Release = (void *)fakeRelease,
+    .ExecQuery = servicesExecQuery};
+
+/**
+ * @brief IWbemLocator::ConnectServer opening a new fake service
+ */
+static HRESULT STDMETHODCALLTYPE locatorConnectServer(IWbemLocator *This, const BSTR strNetworkResource, const BSTR strUser,
+                                    const BSTR strPassword, const BSTR strLocale, LONG lSecurityFlags,
+                                    const BSTR strAuthority, IWbemContext *pCtx, IWbemServices **ppNamespace)
+{
+    *ppNamespace = NULL;
+    if (g_failConnects > 0)
+    {
+        g_failConnects--;
+        return WBEM_E_TRANSPORT_FAILURE;
+    }
+
+    FakeObject *services = createObject(&g_servicesVtbl);
+    if (!services)
+        return E_OUTOFMEMORY;
+
+    g_stats.connects++;
+    *ppNamespace = (IWbemServices *)services;
+    return WBEM_S_NO_ERROR;
+}
+
+static IWbemLocatorVtbl g_locatorVtbl = {
+    .QueryInterface = (void *)fakeQueryInterface,
+    .AddRef = (void *)fakeAddRef,
+    .Release = (void *)fakeRelease,
+    .ConnectServer = locatorConnectServer};
+
+/**
+ * @brief Connector opening a connection to the fake provider
+ *
+ * Follows the same steps as the real connector: create a
+ * locator, then connect it to a namespace
+ *
+ * @param ppLoc Receives the fake locator
+ * @param ppSvc Receives the fake service connection
+ * @return HRESULT S_OK, or the scripted connect failure
+ */
+HRESULT connectFakeWbem(IWbemLocator **ppLoc, IWbemServices **ppSvc)
+{
+    FakeObject *locator = createObject(&g_locatorVtbl);
+    if (!locator)
+        return E_OUTOFMEMORY;
+
+    *ppLoc = (IWbemLocator *)locator;
+    HRESULT hr = (*ppLoc)->lpVtbl->ConnectServer(*ppLoc, L"ROOT\\CIMV2", NULL, NULL, 0, 0, 0, 0, ppSvc);
+    if (FAILED(hr))
+    {
+        (*ppLoc)->lpVtbl->Release(*ppLoc);
+        *ppLoc = NULL;
+    }
+    return hr;
+}
+
+/**
+ * @brief Sets the rows returned by every query
+ *
+ * @param rows Rows to return, must outlive the queries
+ * @param count Number of rows
+ */
+void fakeWbemSetRows(const FakeWbemRow *rows, UINT count)
+{
+    g_rows = rows;
+    g_rowCount = count;
+}
+
+/**
+ * @brief Returns the text of the most recent query
+ *
+ * @return const wchar_t* Query text, empty before the first query
+ */
+const wchar_t *fakeWbemLastQuery(void)
+{
+    return g_lastQuery;
+}
+
+/**
+ * @brief Makes the next queries fail
+ *
+ * @param count Number of ExecQuery calls to fail
+ * @param hr Failure code to return
+ */
+void fakeWbemFailQueries(UINT count, HRESULT hr)
+{
+    g_failQueries = count;
+    g_failQueryResult = hr;
+}
+
+/**
+ * @brief Makes enumerators fail after returning some rows
+ *
+ * @param rows Rows every enumerator returns before failing
+ * @param hr Failure code returned by Next, S_OK to disable
+ */
+void fakeWbemFailEnumAfter(UINT rows, HRESULT hr)
+{
+    g_failEnumAfter = rows;
+    g_failEnumResult = hr;
+}
+
+/**
+ * @brief Adds a fixed cost to every enumerator call
+ *
+ * @param nanoseconds Busy time per IEnumWbemClassObject::Next call
+ */
+void fakeWbemSetCallCost(UINT nanoseconds)
+{
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    g_callCostTicks = (LONG64)((double)nanoseconds * (double)frequency.QuadPart / 1000000000.0);
+}
+
+/**
+ * @brief Delays the objects of the next queries
+ *
+ * @param milliseconds Time before an enumerator created afterwards has objects
+ */
+void fakeWbemSetQueryDelay(UINT milliseconds)
+{
+    g_queryDelayMs = milliseconds;
+}
+
+/**
+ * @brief Makes the next connection attempts fail
+ *
+ * @param count Number of connection attempts to fail
+ */
+void fakeWbemFailConnects(UINT count)
+{
+    g_failConnects = count;
+}
+
+/**
+ * @brief Reads and resets the call counters
+ *
+ * @param stats Structure to receive the counters
+ */
+void fakeWbemTakeStats(FakeWbemStats *stats)
+{
+    *stats = g_stats;
+    g_stats.connects = 0;
+    g_stats.queries = 0;
+    g_stats.nextCalls = 0;
+    g_stats.timeouts = 0;
+}
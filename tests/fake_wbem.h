@@ -0,0 +1,132 @@
+#ifndef FAKE_WBEM_H
+#define FAKE_WBEM_H
+
+#include "wmi_compat.h"
+
+/**
+ * @brief In-process WMI provider for unit tests
+ *
+ * Implements IWbemLocator, IWbemServices, IEnumWbemClassObject
+ * and IWbemClassObject with the same C vtables the library
+ * calls, so WMI code paths run without a WMI service. Install
+ * it with setWMIConnector(connectFakeWbem).
+ *
+ * Every query returns the configured rows regardless of its
+ * class. Like WMI, a projected query ("SELECT a, b FROM ...")
+ * only exposes the selected properties of its objects. Failures of connects, queries and enumeration can be
+ * scripted, and queries can be delayed.
+ * Built by the platform-independent test build.
+ */
+
+/**
+ * @brief Property of a fake row
+ *
+ * A string value reads as VT_BSTR. Without one, a non-zero vt
+ * reads as that numeric type holding number, otherwise VT_NULL.
+ */
+typedef struct
+{
+    const wchar_t *name;  // Property name
+    const wchar_t *value; // String value, NULL for numeric or VT_NULL
+    VARTYPE vt;           // Numeric VARIANT type when value is NULL
+    LONGLONG number;      // Numeric value
+} FakeWbemProperty;
+
+/**
+ * @brief Object returned by a fake query
+ */
+typedef struct
+{
+    const FakeWbemProperty *properties; // Properties of the object
+    UINT count;                         // Number of properties
+} FakeWbemRow;
+
+/**
+ * @brief Call counters of the fake provider
+ */
+typedef struct
+{
+    UINT connects;    // Successful ConnectServer calls
+    UINT queries;     // ExecQuery calls, failed ones included
+    UINT nextCalls;   // IEnumWbemClassObject::Next calls
+    UINT timeouts;    // Next calls that returned WBEM_S_TIMEDOUT
+    LONG liveObjects; // COM objects not yet released
+} FakeWbemStats;
+
+/**
+ * @brief Connector opening a connection to the fake provider
+ *
+ * @param ppLoc Receives the fake locator
+ * @param ppSvc Receives the fake service connection
+ * @return HRESULT S_OK, or the scripted connect failure
+ */
+HRESULT connectFakeWbem(IWbemLocator **ppLoc, IWbemServices **ppSvc);
+
+/**
+ * @brief Sets the rows returned by every query
+ *
+ * @param rows Rows to return, must outlive the queries
+ * @param count Number of rows
+ */
+void fakeWbemSetRows(const FakeWbemRow *rows, UINT count);
+
+/**
+ * @brief Returns the text of the most recent query
+ *
+ * @return const wchar_t* Query text, empty before the first query
+ */
+const wchar_t *fakeWbemLastQuery(void);
+
+/**
+ * @brief Makes the next queries fail
+ *
+ * @param count Number of ExecQuery calls to fail
+ * @param hr Failure code to return
+ */
+void fakeWbemFailQueries(UINT count, HRESULT hr);
+
+/**
+ * @brief Makes enumerators fail after returning some rows
+ *
+ * @param rows Rows every enumerator returns before failing
+ * @param hr Failure code returned by Next, S_OK to disable
+ */
+void fakeWbemFailEnumAfter(UINT rows, HRESULT hr);
+
+/**
+ * @brief Adds a fixed cost to every enumerator call
+ *
+ * Simulates the cross-process round trip of a real provider
+ *
+ * @param nanoseconds Busy time per IEnumWbemClassObject::Next call
+ */
+void fakeWbemSetCallCost(UINT nanoseconds);
+
+/**
+ * @brief Delays the objects of the next queries
+ *
+ * Simulates a slow provider: until the delay has passed, Next
+ * waits up to its timeout and returns WBEM_S_TIMEDOUT, or
+ * sleeps out the delay when called with WBEM_INFINITE
+ *
+ * @param milliseconds Time before an enumerator created afterwards has objects
+ */
+void fakeWbemSetQueryDelay(UINT milliseconds);
+
+/**
+ * @brief Makes the next connection attempts fail
+ *
+ * @param count Number of connection attempts to fail
+ */
+void fakeWbemFailConnects(UINT count);
+
+/**
+ * @brief Reads and resets the call counters
+ *
+ * The live object count is never reset
+ *
+ * @param stats Structure to receive the counters
+ */
+void fakeWbemTakeStats(FakeWbemStats *stats);
+
+#endif // FAKE_WBEM_H
@@ -0,0 +1,99 @@
+#define _GNU_SOURCE // nftw(), mkdtemp() and symlink()
+
+#include "fixture_tree.h"
+#include "linux_sysfs.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <ftw.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static char g_fixtureRoot[SYSFS_PATH_LENGTH] = ""; // Root of the current tree
+
+/**
+ * @brief Creates the parent directories of a path below the fixture root
+ *
+ * @param path Full path, its last component is not created
+ */
+static void makeParents(char *path)
+{
+    for (char *slash = strchr(path + strlen(g_fixtureRoot) + 1, '/'); slash; slash = strchr(slash + 1, '/'))
+    {
+        *slash = '\0';
+        mkdir(path, 0755);
+        *slash = '/';
+    }
+}
+
+static int removeFixtureEntry(const char *path, const struct stat *info, int flag, struct FTW *ftw)
+{
+    return remove(path);
+}
+
+/**
+ * @brief Creates an empty fixture tree
+ *
+ * @param name Short test name, the tree is /tmp/fest_<name>_XXXXXX
+ * @return const char* Root of the tree, valid until removeFixtureTree()
+ */
+const char *createFixtureTree(const char *name)
+{
+    _snprintf_s(g_fixtureRoot, sizeof(g_fixtureRoot), _TRUNCATE, "/tmp/fest_%s_XXXXXX", name);
+    assert(mkdtemp(g_fixtureRoot));
+    return g_fixtureRoot;
+}
+
+/**
+ * @brief Writes a file below the fixture root, creating its directories
+ *
+ * @param relative Absolute path below the root
+ * @param content File content
+ */
+void writeFixture(const char *relative, const char *content)
+{
+    char path[SYSFS_PATH_LENGTH];
+    _snprintf_s(path, sizeof(path), _TRUNCATE, "%s%s", g_fixtureRoot, relative);
+    makeParents(path);
+
+    FILE *file = NULL;
+    assert(fopen_s(&file, path, "w") == 0 && file);
+    fputs(content, file);
+    fclose(file);
+}
+
+/**
+ * @brief Creates a symbolic link below the fixture root
+ *
+ * @param relative Absolute path of the link below the root
+ * @param target Relative link target, as sysfs uses them
+ */
+void linkFixture(const char *relative, const char *target)
+{
+    char path[SYSFS_PATH_LENGTH];
+    _snprintf_s(path, sizeof(path), _TRUNCATE, "%s%s", g_fixtureRoot, relative);
+    makeParents(path);
+    assert(symlink(target, path) == 0);
+}
+
+/**
+ * @brief Creates a directory below the fixture root
+ *
+ * @param relative Absolute path below the root
+ */
+void makeFixtureDir(const char *relative)
+{
+    char path[SYSFS_PATH_LENGTH];
+    _snprintf_s(path, sizeof(path), _TRUNCATE, "%s%s/", g_fixtureRoot, relative);
+    makeParents(path);
+}
+
+/**
+ * @brief Deletes the fixture tree and everything below it
+ */
+void removeFixtureTree(void)
+{
+    if (g_fixtureRoot[0])
+        nftw(g_fixtureRoot, removeFixtureEntry, 16, FTW_DEPTH | FTW_PHYS);
+    g_fixtureRoot[0] = '\0';
+}
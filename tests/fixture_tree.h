@@ -0,0 +1,55 @@
+#ifndef FIXTURE_TREE_H
+#define FIXTURE_TREE_H
+
+#include "fest_platform.h"
+
+/**
+ * @brief Temporary sysfs/procfs tree for Linux collector tests
+ *
+ * Tests create one tree under /tmp, fill it with the files a
+ * collector reads and point setSysfsRoot() at it. Paths passed
+ * to the helpers are absolute paths below the tree root, as the
+ * collector would open them on a live system.
+ * Built by the Linux test build.
+ */
+
+/**
+ * @brief Creates an empty fixture tree
+ *
+ * @param name Short test name, the tree is /tmp/fest_<name>_XXXXXX
+ * @return const char* Root of the tree, valid until removeFixtureTree()
+ */
+const char *createFixtureTree(const char *name);
+
+/**
+ * @brief Writes a file below the fixture root, creating its directories
+ *
+ * Files are truncated in place, so a descriptor kept open by a
+ * collector sees the new content
+ *
+ * @param relative Absolute path below the root
+ * @param content File content
+ */
+void writeFixture(const char *relative, const char *content);
+
+/**
+ * @brief Creates a symbolic link below the fixture root
+ *
+ * @param relative Absolute path of the link below the root
+ * @param target Relative link target, as sysfs uses them
+ */
+void linkFixture(const char *relative, const char *target);
+
+/**
+ * @brief Creates a directory below the fixture root
+ *
+ * @param relative Absolute path below the root
+ */
+void makeFixtureDir(const char *relative);
+
+/**
+ * @brief Deletes the fixture tree and everything below it
+ */
+void removeFixtureTree(void);
+
+#endif // FIXTURE_TREE_H
@@ -0,0 +1,106 @@
+#include "system_info_dll.h"
+#include "fest_alloc.h"
+#include <stdio.h>
+#include <assert.h>
+
+#ifndef FEST_TICK_ALLOC_BUDGET
+#define FEST_TICK_ALLOC_BUDGET 0 // Allowed library allocations per steady-state tick
+#endif
+
+#define WARMUP_TICKS 3    // Ticks skipped while static info and caches settle
+#define MEASURED_TICKS 10 // Steady-state ticks checked against the budget
+
+static volatile LONG g_ticks = 0;    // Callbacks received
+static UINT64 g_maxAllocations = 0;  // Worst steady-state tick
+static UINT64 g_lastAllocations = 0; // Allocation counter at previous callback
+static BOOL g_crtCounting = FALSE;   // Counter source used for the budget
+
+/**
+ * @brief Reads the allocation counter the budget applies to
+ *
+ * Prefers the CRT hook count, which also sees plain malloc calls
+ * that bypass the library allocator, and falls back to the
+ * library allocator count when the hook is not compiled in.
+ *
+ * @return UINT64 Allocations made by the library so far
+ */
+static UINT64 readAllocations(void)
+{
+    AllocStats stats;
+    getAllocStats(&stats);
+    g_crtCounting = stats.crtCounting;
+    return stats.crtCounting ? stats.crtAllocCount : stats.allocCount;
+}
+
+/**
+ * @brief Measures allocations between consecutive ticks
+ *
+ * Runs on the monitoring thread after each tick, so the delta
+ * between two callbacks covers one complete tick: collection,
+ * JSON generation and release of the previous tick's data.
+ * Allocations made here belong to the test executable and are
+ * not counted.
+ *
+ * @param jsonData JSON-formatted system information string
+ */
+void test_alloc_budget(const char *jsonData)
+{
+    assert(jsonData != NULL);
+
+    UINT64 allocations = readAllocations();
+    LONG tick = InterlockedIncrement(&g_ticks);
+    if (tick > WARMUP_TICKS && tick <= WARMUP_TICKS + MEASURED_TICKS)
+    {
+        UINT64 delta = allocations - g_lastAllocations;
+        if (delta > g_maxAllocations)
+            g_maxAllocations = delta;
+        printf("Tick %ld: %llu allocations\n", tick, delta);
+    }
+    g_lastAllocations = allocations;
+}
+
+/**
+ * @brief Test runner for the steady-state allocation budget
+ *
+ * This function:
+ * 1. Sets up the test environment
+ *    - Registers counting callback
+ *    - Starts system monitoring
+ *
+ * 2. Executes test sequence
+ *    - Skips warmup ticks
+ *    - Waits for the measured ticks (30s timeout)
+ *    - Compares the worst tick against FEST_TICK_ALLOC_BUDGET
+ *
+ * 3. Cleans up
+ *    - Stops monitoring
+ *    - Reports test results
+ *
+ * @return int 0 if all tests passed, 1 if any failed
+ */
+int main()
+{
+    int testsPassed = 0;
+    int totalTests = 2;
+
+    setSystemInfoCallback(test_alloc_budget);
+
+    if (startSystemMonitoring(50))
+    {
+        for (int waited = 0; g_ticks <= WARMUP_TICKS + MEASURED_TICKS && waited < 30000; waited += 50)
+            Sleep(50);
+
+        if (g_ticks > WARMUP_TICKS + MEASURED_TICKS)
+            testsPassed++;
+    }
+
+    stopSystemMonitoring();
+
+    printf("Worst tick: %llu allocations (%s), budget %d\n",
+           g_maxAllocations, g_crtCounting ? "CRT hook" : "library allocator", FEST_TICK_ALLOC_BUDGET);
+    if (testsPassed == 1 && g_maxAllocations <= FEST_TICK_ALLOC_BUDGET)
+        testsPassed++;
+
+    printf("Tests passed: %d/%d\n", testsPassed, totalTests);
+    return (testsPassed == totalTests) ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+#include "system_info_dll.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#ifndef FEST_TICK_ALLOC_BUDGET
+#define FEST_TICK_ALLOC_BUDGET 0 // Allowed heap allocations per steady-state tick
+#endif
+
+#define WARMUP_TICKS 3    // Ticks skipped while static info and caches settle
+#define MEASURED_TICKS 10 // Steady-state ticks checked against the budget
+#define TICK_INTERVAL_MS 50
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *block, size_t size);
+extern void __libc_free(void *block);
+
+static volatile LONG64 g_heapAllocations = 0; // malloc, calloc and realloc calls of the process
+static volatile LONG64 g_heapFrees = 0;       // free calls of the process
+static volatile LONG g_ticks = 0;             // Callbacks received for the current backend
+static UINT64 g_maxAllocations = 0;           // Worst steady-state tick of the current backend
+static UINT64 g_lastAllocations = 0;          // Allocation counter at previous callback
+
+/**
+ * @brief Heap interposers
+ *
+ * Strong definitions replace the C library allocator for the whole
+ * process, so plain malloc calls of the library and the buffers libc
+ * allocates on its behalf (stdio, directory streams) are counted
+ * along with festMalloc(). The main thread only sleeps while the
+ * engine runs, so every counted call belongs to the monitoring thread.
+ */
+void *malloc(size_t size)
+{
+    InterlockedIncrement64(&g_heapAllocations);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    InterlockedIncrement64(&g_heapAllocations);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *block, size_t size)
+{
+    InterlockedIncrement64(&g_heapAllocations);
+    return __libc_realloc(block, size);
+}
+
+void free(void *block)
+{
+    if (block)
+        InterlockedIncrement64(&g_heapFrees);
+    __libc_free(block);
+}
+
+/**
+ * @brief Measures heap allocations between consecutive ticks
+ *
+ * Runs on the monitoring thread after each tick, so the delta
+ * between two callbacks covers one complete tick: collection,
+ * JSON generation and release of the previous tick's data.
+ *
+ * @param jsonData JSON-formatted system information string
+ */
+void test_alloc_budget(const char *jsonData)
+{
+    assert(jsonData != NULL);
+
+    UINT64 allocations = (UINT64)g_heapAllocations;
+    LONG tick = InterlockedIncrement(&g_ticks);
+    if (tick > WARMUP_TICKS && tick <= WARMUP_TICKS + MEASURED_TICKS)
+    {
+        UINT64 delta = allocations - g_lastAllocations;
+        if (delta > g_maxAllocations)
+            g_maxAllocations = delta;
+    }
+    g_lastAllocations = (UINT64)g_heapAllocations;
+}
+
+/**
+ * @brief Runs the engine on one backend and checks its steady-state ticks
+ *
+ * This test validates:
+ * 1. The engine delivers the warmup and measured ticks (30s timeout)
+ * 2. No measured tick makes more than FEST_TICK_ALLOC_BUDGET
+ *    malloc, calloc or realloc calls
+ *
+ * @param backend Registered backend name
+ * @return BOOL TRUE if the budget held
+ */
+static BOOL test_backend_budget(const char *backend)
+{
+    g_ticks = 0;
+    g_maxAllocations = 0;
+    g_lastAllocations = 0;
+
+    // Stopping the engine clears the callback, register it for every run
+    assert(selectCollectorBackend(backend));
+    setSystemInfoCallback(test_alloc_budget);
+    BOOL ran = FALSE;
+    if (startSystemMonitoring(TICK_INTERVAL_MS))
+    {
+        for (int waited = 0; g_ticks <= WARMUP_TICKS + MEASURED_TICKS && waited < 30000; waited += TICK_INTERVAL_MS)
+            Sleep(TICK_INTERVAL_MS);
+        ran = g_ticks > WARMUP_TICKS + MEASURED_TICKS;
+    }
+    stopSystemMonitoring();
+
+    printf("Backend %s (%ld ticks): worst tick %llu allocations, budget %d\n",
+           backend, (long)g_ticks, (unsigned long long)g_maxAllocations, FEST_TICK_ALLOC_BUDGET);
+    return ran && g_maxAllocations <= FEST_TICK_ALLOC_BUDGET;
+}
+
+/**
+ * @brief Test runner for the Linux steady-state allocation budget
+ *
+ * This function:
+ * 1. Runs the engine on the fixture backend, then on the linux backend
+ * 2. Restores the native backend and reports test results
+ *
+ * @return int 0 if all tests passed, 1 if any failed
+ */
+int main(void)
+{
+    int testsPassed = 0;
+    int totalTests = 2;
+
+    if (test_backend_budget("fixture"))
+        testsPassed++;
+    if (test_backend_budget("linux"))
+        testsPassed++;
+
+    selectCollectorBackend(NULL);
+    printf("Heap calls: %lld allocations, %lld frees\n", (long long)g_heapAllocations, (long long)g_heapFrees);
+    printf("Tests passed: %d/%d\n", testsPassed, totalTests);
+    return (testsPassed == totalTests) ? 0 : 1;
+}
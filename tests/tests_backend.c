@@ -0,0 +1,347 @@
+#include "collector_backend.h"
+#include "system_info_dll.h"
+#include "fest_alloc.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#ifdef __linux__
+#include "linux_sysfs.h"
+#include "fixture_tree.h"
+#endif
+
+#define TEST_TICK_TIMEOUT_MS 10000 // Give up on a stalled engine
+#define TEST_JSON_SIZE 65536       // Copy of the first delivered document
+
+static CollectorBackend g_Counting;      // Fixture collectors with counting hooks
+static LONG g_opens = 0;                 // Successful open() calls
+static LONG g_closes = 0;                // close() calls
+static LONG g_refusals = 0;              // open() calls that failed
+static LONG g_cancels = 0;               // cancel() calls
+static DWORD g_openThread = 0;           // Thread of the last open()
+static DWORD g_closeThread = 0;          // Thread of the last close()
+static HANDLE g_TickEvent = NULL;        // Set by the first callback
+static char g_json[TEST_JSON_SIZE] = ""; // First document delivered
+
+static BOOL openCounted(void)
+{
+    InterlockedIncrement(&g_opens);
+    g_openThread = GetCurrentThreadId();
+    return TRUE;
+}
+
+static void closeCounted(void)
+{
+    InterlockedIncrement(&g_closes);
+    g_closeThread = GetCurrentThreadId();
+}
+
+static BOOL openRefused(void)
+{
+    InterlockedIncrement(&g_refusals);
+    return FALSE;
+}
+
+static void cancelCounted(void)
+{
+    InterlockedIncrement(&g_cancels);
+}
+
+/**
+ * @brief Keeps the first document delivered by the engine
+ *
+ * @param jsonData JSON-formatted system information string
+ */
+static void onTick(const char *jsonData)
+{
+    if (g_json[0] == '\0')
+    {
+        strcpy_s(g_json, sizeof(g_json), jsonData);
+        SetEvent(g_TickEvent);
+    }
+}
+
+/**
+ * @brief Runs the engine on the selected backend until the first tick
+ *
+ * @return BOOL TRUE if a document was delivered
+ */
+static BOOL runOneTick(void)
+{
+    g_json[0] = '\0';
+    g_TickEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+    setSystemInfoCallback(onTick);
+    assert(startSystemMonitoring(10));
+    BOOL delivered = WaitForSingleObject(g_TickEvent, TEST_TICK_TIMEOUT_MS) == WAIT_OBJECT_0;
+    stopSystemMonitoring();
+    setSystemInfoCallback(NULL);
+    CloseHandle(g_TickEvent);
+    return delivered;
+}
+
+/**
+ * @brief Builds the counting backend from the fixture collectors
+ *
+ * CPU, memory and storage count their lifecycle, GPU refuses to
+ * open and network is not provided at all.
+ */
+static void initCountingBackend(void)
+{
+    memset(&g_Counting, 0, sizeof(g_Counting));
+    g_Counting.name = "counting";
+    g_Counting.collectors = getFixtureCollectorBackend()->collectors;
+    g_Counting.collectors.collectNetworkList = NULL;
+    g_Counting.lifecycle[COLLECTOR_CPU].open = openCounted;
+    g_Counting.lifecycle[COLLECTOR_CPU].close = closeCounted;
+    g_Counting.lifecycle[COLLECTOR_GPU].open = openRefused;
+    g_Counting.lifecycle[COLLECTOR_GPU].close = closeCounted;
+    g_Counting.lifecycle[COLLECTOR_MEMORY].open = openCounted;
+    g_Counting.lifecycle[COLLECTOR_MEMORY].close = closeCounted;
+    g_Counting.lifecycle[COLLECTOR_STORAGE].open = openCounted;
+    g_Counting.lifecycle[COLLECTOR_STORAGE].close = closeCounted;
+    g_Counting.lifecycle[COLLECTOR_NETWORK].open = openCounted;
+    g_Counting.lifecycle[COLLECTOR_NETWORK].close = closeCounted;
+    g_Counting.cancel = cancelCounted;
+}
+
+/**
+ * @brief Tests backend registration and lookup
+ *
+ * This test validates:
+ * 1. Built-in backends are registered on first use
+ * 2. A backend with an existing name replaces it
+ * 3. Unknown names are rejected by lookup and selection
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_registry(void)
+{
+    const CollectorBackend *native = getNativeCollectorBackend();
+    assert(findCollectorBackend("fixture") == getFixtureCollectorBackend());
+    assert(findCollectorBackend(native->name) == native);
+    assert(findCollectorBackend("nonexistent") == NULL);
+    assert(findCollectorBackend(NULL) == NULL);
+
+    static CollectorBackend first = {"counting"};
+    assert(registerCollectorBackend(&first));
+    assert(findCollectorBackend("counting") == &first);
+    assert(registerCollectorBackend(&g_Counting));
+    assert(findCollectorBackend("counting") == &g_Counting);
+    assert(!registerCollectorBackend(NULL));
+
+    assert(!selectCollectorBackend("nonexistent"));
+    assert(getCollectorBackend() == native);
+    assert(selectCollectorBackend("fixture"));
+    assert(getCollectorBackend() == getFixtureCollectorBackend());
+    assert(selectCollectorBackend(NULL));
+    assert(getCollectorBackend() == native);
+
+    printf("Registry test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests opening and closing the collectors of a backend
+ *
+ * This test validates:
+ * 1. Every provided collector is opened once
+ * 2. A collector whose open() fails is left out and never closed
+ * 3. Collectors that are not provided are neither opened nor closed
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_lifecycle(void)
+{
+    g_opens = g_closes = g_refusals = 0;
+
+    DWORD open = openCollectorBackend(&g_Counting);
+    assert(g_opens == 3 && g_refusals == 1);
+    assert(open & COLLECTOR_BIT(COLLECTOR_CPU));
+    assert(open & COLLECTOR_BIT(COLLECTOR_BATTERY));
+    assert(!(open & COLLECTOR_BIT(COLLECTOR_GPU)));
+    assert(!(open & COLLECTOR_BIT(COLLECTOR_NETWORK)));
+
+    closeCollectorBackend(&g_Counting, open);
+    assert(g_closes == 3);
+
+    DWORD all = COLLECTOR_BIT(COLLECTOR_COUNT) - 1;
+    assert(openCollectorBackend(getFixtureCollectorBackend()) == all);
+
+    printf("Lifecycle test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests the monitoring engine on a registered backend
+ *
+ * This test validates:
+ * 1. The engine runs on a backend selected by name
+ * 2. Collectors are opened and closed on the monitoring thread
+ * 3. Skipped collectors omit their JSON sections
+ * 4. Stopping cancels through the backend
+ * 5. The backend cannot change while monitoring runs
+ * 6. Static RAM slots render inside the memory section
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_engine(void)
+{
+    g_opens = g_closes = g_refusals = g_cancels = 0;
+    assert(selectCollectorBackend("counting"));
+    assert(runOneTick());
+
+    assert(g_opens == 3 && g_closes == 3 && g_cancels == 1);
+    assert(g_openThread == g_closeThread);
+    assert(g_openThread != GetCurrentThreadId());
+
+    assert(strstr(g_json, "\"cpu\": ["));
+    assert(strstr(g_json, "\"memory\": {"));
+    assert(strstr(g_json, "\"location\": \"Controller1-DIMM1\""));
+    assert(strstr(g_json, "\"battery\": {"));
+    assert(!strstr(g_json, "\"gpu\": ["));
+    assert(!strstr(g_json, "\"network\": {"));
+
+    // The selection survives the session
+    assert(getCollectorBackend() == &g_Counting);
+    assert(startSystemMonitoring(10));
+    assert(!selectCollectorBackend("fixture"));
+    assert(!setCollectorBackend(NULL));
+    stopSystemMonitoring();
+    assert(g_opens == 6 && g_closes == 6);
+
+    assert(selectCollectorBackend(NULL));
+    printf("Engine test passed\n");
+    return TRUE;
+}
+
+#ifdef __linux__
+/**
+ * @brief Tests the Linux backend against a captured sysfs tree
+ *
+ * This test validates:
+ * 1. DMI strings fill the motherboard, missing ones stay empty
+ * 2. System batteries are averaged and peripherals skipped
+ * 3. AC state comes from the mains supply
+ * 4. Sound cards are named from /proc/asound/cards with their PCI vendor
+ * 5. An empty tree reports a desktop without audio devices
+ * 6. The engine renders the tree on the "linux" backend
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_linux_backend(void)
+{
+    const char *root = createFixtureTree("backend");
+
+    writeFixture("/sys/class/dmi/id/board_name", "PRIME B450M-A\n");
+    writeFixture("/sys/class/dmi/id/board_vendor", "ASUSTeK COMPUTER INC.\n");
+    writeFixture("/sys/class/dmi/id/bios_version", "3211\n");
+    writeFixture("/sys/class/dmi/id/product_sku", "  SKU \n");
+    writeFixture("/sys/class/power_supply/BAT0/type", "Battery\n");
+    writeFixture("/sys/class/power_supply/BAT0/capacity", "80\n");
+    writeFixture("/sys/class/power_supply/BAT0/status", "Discharging\n");
+    writeFixture("/sys/class/power_supply/BAT1/type", "Battery\n");
+    writeFixture("/sys/class/power_supply/BAT1/capacity", "60\n");
+    writeFixture("/sys/class/power_supply/BAT1/status", "Charging\n");
+    writeFixture("/sys/class/power_supply/hidpp_battery_0/type", "Battery\n");
+    writeFixture("/sys/class/power_supply/hidpp_battery_0/scope", "Device\n");
+    writeFixture("/sys/class/power_supply/hidpp_battery_0/capacity", "5\n");
+    writeFixture("/sys/class/power_supply/AC/type", "Mains\n");
+    writeFixture("/sys/class/power_supply/AC/online", "0\n");
+    writeFixture("/proc/asound/cards",
+                 " 0 [PCH            ]: HDA-Intel - HDA Intel PCH\n"
+                 "                      HDA Intel PCH at 0xf7f10000 irq 32\n"
+                 " 1 [NVidia         ]: HDA-Intel - HDA NVidia\n"
+                 "                      HDA NVidia at 0xf7080000 irq 17\n"
+                 " 2 [Device         ]: USB-Audio - USB Audio Device\n"
+                 "                      Generic USB Audio Device at usb-0000:00:14.0-2\n");
+    writeFixture("/sys/class/sound/card0/device/vendor", "0x8086\n");
+    writeFixture("/sys/class/sound/card1/device/vendor", "0x10de\n");
+
+    const CollectorTable *collectors = &getLinuxCollectorBackend()->collectors;
+    setSysfsRoot(root);
+
+    MotherboardInfo *mbInfo = collectors->getMotherboardInfo();
+    assert(mbInfo);
+    assert(strcmp(mbInfo->productName, "PRIME B450M-A") == 0);
+    assert(strcmp(mbInfo->manufacturer, "ASUSTeK COMPUTER INC.") == 0);
+    assert(strcmp(mbInfo->biosVersion, "3211") == 0);
+    assert(strcmp(mbInfo->systemSKU, "SKU") == 0);
+    assert(mbInfo->serialNumber[0] == '\0');
+    collectors->freeMotherboardInfo(mbInfo);
+
+    BatteryInfo *battery = collectors->collectBatteryInfo(NULL);
+    assert(battery && !battery->isDesktop);
+    assert(battery->percent == 70 && !battery->powerPlugged);
+    festFree(battery);
+    writeFixture("/sys/class/power_supply/AC/online", "1\n");
+    battery = collectors->collectBatteryInfo(NULL);
+    assert(battery && battery->powerPlugged);
+    festFree(battery);
+
+    AudioList *audio = collectors->getAudioList();
+    assert(audio && audio->count == 3);
+    assert(strcmp(audio->devices[0].name, "HDA Intel PCH") == 0);
+    assert(strcmp(audio->devices[0].manufacturer, "Intel(R) Corporation") == 0);
+    assert(strcmp(audio->devices[1].manufacturer, "NVIDIA") == 0);
+    assert(strcmp(audio->devices[2].name, "USB Audio Device") == 0);
+    assert(strcmp(audio->devices[2].manufacturer, "N/A") == 0);
+    collectors->freeAudioList(audio);
+
+    assert(selectCollectorBackend("linux"));
+    assert(runOneTick());
+    assert(strstr(g_json, "PRIME B450M-A"));
+    assert(strstr(g_json, "HDA NVidia"));
+    assert(!strstr(g_json, "\"gpu\": ["));
+    assert(selectCollectorBackend(NULL));
+
+    // An empty tree is a desktop without DMI or sound cards
+    char empty[SYSFS_PATH_LENGTH];
+    _snprintf_s(empty, sizeof(empty), _TRUNCATE, "%s/empty/", root);
+    makeFixtureDir("/empty");
+    setSysfsRoot(empty);
+    assert(strcmp(getSysfsRoot(), empty) != 0);
+
+    mbInfo = collectors->getMotherboardInfo();
+    assert(mbInfo && mbInfo->productName[0] == '\0');
+    collectors->freeMotherboardInfo(mbInfo);
+    battery = collectors->collectBatteryInfo(NULL);
+    assert(battery && battery->isDesktop && battery->percent == 100 && battery->powerPlugged);
+    festFree(battery);
+    audio = collectors->getAudioList();
+    assert(audio && audio->count == 0 && audio->devices == NULL);
+    collectors->freeAudioList(audio);
+
+    setSysfsRoot(NULL);
+    removeFixtureTree();
+    printf("Linux backend test passed\n");
+    return TRUE;
+}
+#endif
+
+/**
+ * @brief Main test runner
+ *
+ * @return int 0 if all tests passed, 1 if any test failed
+ */
+int main(void)
+{
+    int testsPassed = 0;
+    int totalTests = 3;
+
+    initCountingBackend();
+    if (test_registry())
+        testsPassed++;
+    if (test_lifecycle())
+        testsPassed++;
+    if (test_engine())
+        testsPassed++;
+
+#ifdef __linux__
+    totalTests++;
+    if (test_linux_backend())
+        testsPassed++;
+#endif
+
+    printf("Tests passed: %d/%d\n", testsPassed, totalTests);
+    return testsPassed == totalTests ? 0 : 1;
+}
@@ -0,0 +1,152 @@
+#include "cpu_freq.h"
+#include "fest_alloc.h"
+#include "linux_sysfs.h"
+#include "fixture_tree.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#define TEST_ARENA_SIZE 4096 // Snapshot memory of one tick
+
+static const char *g_root = NULL; // Fixture root of all tests
+
+/**
+ * @brief Tests the portable summary
+ *
+ * This test validates:
+ * 1. Cores reporting 0 are left out of min, avg and max
+ * 2. A result without any reporting core summarizes to zeros
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_summary(void)
+{
+    CPUFrequencyInfo *info = allocCPUFrequencyInfo(4, NULL);
+    assert(info && info->coreCount == 4);
+    info->cores[0] = 3000;
+    info->cores[2] = 1000;
+    info->cores[3] = 2600;
+    summarizeCPUFrequency(info);
+    assert(info->minMhz == 1000 && info->avgMhz == 2200 && info->maxMhz == 3000);
+
+    memset(info->cores, 0, 4 * sizeof(UINT));
+    summarizeCPUFrequency(info);
+    assert(info->minMhz == 0 && info->avgMhz == 0 && info->maxMhz == 0);
+    freeCPUFrequencyInfo(info);
+
+    printf("Summary test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests sampling scaling_cur_freq across ticks
+ *
+ * This test validates:
+ * 1. kHz are rounded to MHz
+ * 2. A core without cpufreq reports 0
+ * 3. The descriptors kept open see the rewritten files
+ * 4. A tick allocates nothing besides its arena output
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_scaling_cur_freq(void)
+{
+    writeFixture("/sys/devices/system/cpu/possible", "0-3\n");
+    writeFixture("/sys/devices/system/cpu/cpu0/cpufreq/scaling_cur_freq", "4199812\n");
+    writeFixture("/sys/devices/system/cpu/cpu1/cpufreq/scaling_cur_freq", "800000\n");
+    writeFixture("/sys/devices/system/cpu/cpu3/cpufreq/scaling_cur_freq", "2400000\n");
+
+    setSysfsRoot(g_root);
+    assert(openLinuxCPUFrequency());
+
+    SnapshotArena arena;
+    assert(initSnapshotArena(&arena, TEST_ARENA_SIZE));
+    CPUFrequencyInfo *info = collectLinuxCPUFrequency(&arena);
+    assert(info && info->coreCount == 4);
+    assert(info->cores[0] == 4200 && info->cores[1] == 800 && info->cores[2] == 0 && info->cores[3] == 2400);
+    assert(info->minMhz == 800 && info->avgMhz == 2466 && info->maxMhz == 4200);
+
+    // Thermal throttling pulls the boosting core down
+    writeFixture("/sys/devices/system/cpu/cpu0/cpufreq/scaling_cur_freq", "1200000\n");
+
+    AllocStats before, after;
+    getAllocStats(&before);
+    resetSnapshotArena(&arena);
+    info = collectLinuxCPUFrequency(&arena);
+    getAllocStats(&after);
+    assert(after.allocCount == before.allocCount);
+    assert(info && info->cores[0] == 1200 && info->maxMhz == 2400);
+
+    closeLinuxCPUFrequency();
+    assert(collectLinuxCPUFrequency(&arena) == NULL);
+    releaseSnapshotArena(&arena);
+    setSysfsRoot(NULL);
+
+    printf("Scaling cur freq test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests machines without a possible list or without cpufreq
+ *
+ * This test validates:
+ * 1. Cores are counted from the cpuN directories
+ * 2. Opening fails when no core exposes its frequency
+ * 3. Opening and closing leaves no allocation behind
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_fallbacks(void)
+{
+    char path[SYSFS_PATH_LENGTH];
+    _snprintf_s(path, sizeof(path), _TRUNCATE, "%s/sys/devices/system/cpu/possible", g_root);
+    remove(path);
+
+    AllocStats before, after;
+    getAllocStats(&before);
+    setSysfsRoot(g_root);
+    assert(openLinuxCPUFrequency());
+    CPUFrequencyInfo *info = collectLinuxCPUFrequency(NULL);
+    assert(info && info->coreCount == 4 && info->cores[3] == 2400);
+    freeCPUFrequencyInfo(info);
+    closeLinuxCPUFrequency();
+
+    // A VM without a frequency driver
+    char empty[SYSFS_PATH_LENGTH];
+    _snprintf_s(empty, sizeof(empty), _TRUNCATE, "%s/vm", g_root);
+    makeFixtureDir("/vm");
+    writeFixture("/vm/sys/devices/system/cpu/possible", "0-1\n");
+    setSysfsRoot(empty);
+    assert(!openLinuxCPUFrequency());
+    assert(collectLinuxCPUFrequency(NULL) == NULL);
+    setSysfsRoot(NULL);
+    getAllocStats(&after);
+    assert(after.currentBytes == before.currentBytes);
+
+    printf("Fallbacks test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Main test runner
+ *
+ * @return int 0 if all tests passed, 1 if any test failed
+ */
+int main(void)
+{
+    int testsPassed = 0;
+    int totalTests = 3;
+
+    g_root = createFixtureTree("cpu_freq");
+
+    if (test_summary())
+        testsPassed++;
+    if (test_scaling_cur_freq())
+        testsPassed++;
+    if (test_fallbacks())
+        testsPassed++;
+
+    removeFixtureTree();
+    printf("Tests passed: %d/%d\n", testsPassed, totalTests);
+    return testsPassed == totalTests ? 0 : 1;
+}
@@ -0,0 +1,164 @@
+#include "cpu_info.h"
+#include "fest_alloc.h"
+#include "linux_sysfs.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+/**
+ * @brief Collects the CPU list of a captured fixture tree
+ *
+ * @param name Fixture directory below tests/fixtures
+ * @return CPUList* Processor list of the fixture
+ */
+static CPUList *collectFixture(const char *name)
+{
+    char root[SYSFS_PATH_LENGTH];
+    _snprintf_s(root, sizeof(root), _TRUNCATE, "%s/%s", FEST_FIXTURE_DIR, name);
+    setSysfsRoot(root);
+    CPUList *list = getLinuxCPUList();
+    setSysfsRoot(NULL);
+    assert(list);
+    return list;
+}
+
+/**
+ * @brief Tests a dual-socket server with Hyper-Threading
+ *
+ * This test validates:
+ * 1. Logical CPUs are grouped by physical package
+ * 2. Sparse core ids count as distinct cores
+ * 3. The acpi-cpufreq maximum is the base clock
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_dual_socket(void)
+{
+    CPUList *list = collectFixture("xeon-2s");
+    assert(list->count == 2);
+    for (UINT i = 0; i < list->count; i++)
+    {
+        assert(strcmp(getCPUName(&list->cpus[i]), "Intel(R) Xeon(R) CPU E5-2620 v4 @ 2.10GHz") == 0);
+        assert(getCPUCores(&list->cpus[i]) == 2);
+        assert(getCPUThreads(&list->cpus[i]) == 4);
+        assert(getCPUClockSpeed(&list->cpus[i]) == 2101);
+    }
+    freeCPUList(list);
+
+    printf("Dual socket test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests a desktop processor on amd-pstate
+ *
+ * This test validates:
+ * 1. Trailing spaces of the model name are dropped
+ * 2. base_frequency wins over the boost maximum
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_pstate_base_clock(void)
+{
+    CPUList *list = collectFixture("ryzen-pstate");
+    assert(list->count == 1);
+    assert(strcmp(list->cpus[0].name, "AMD Ryzen 3 5300G with Radeon Graphics") == 0);
+    assert(list->cpus[0].cores == 4 && list->cpus[0].threads == 8);
+    assert(list->cpus[0].clockSpeed == 4000);
+    freeCPUList(list);
+
+    printf("P-state base clock test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests an ARM board without x86 cpuinfo fields
+ *
+ * This test validates:
+ * 1. sysfs topology groups CPUs without "physical id"
+ * 2. A missing model name falls back to "Unknown Processor"
+ * 3. The board's "Model" line is not taken for the CPU name
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_arm_board(void)
+{
+    CPUList *list = collectFixture("rpi4");
+    assert(list->count == 1);
+    assert(strcmp(list->cpus[0].name, "Unknown Processor") == 0);
+    assert(list->cpus[0].cores == 4 && list->cpus[0].threads == 4);
+    assert(list->cpus[0].clockSpeed == 1800);
+    freeCPUList(list);
+
+    printf("ARM board test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests cpuinfo without sysfs, as seen in containers
+ *
+ * This test validates:
+ * 1. cpuinfo topology ids are used when sysfs is missing
+ * 2. The cpuinfo clock is used without cpufreq
+ * 3. A missing cpuinfo yields an empty list
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_cpuinfo_only(void)
+{
+    CPUList *list = collectFixture("container");
+    assert(list->count == 1);
+    assert(list->cpus[0].cores == 1 && list->cpus[0].threads == 2);
+    assert(list->cpus[0].clockSpeed == 2699);
+    freeCPUList(list);
+
+    list = collectFixture("nonexistent");
+    assert(list->count == 0 && list->cpus == NULL);
+    freeCPUList(list);
+
+    printf("Cpuinfo only test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests that collection leaves no allocation behind
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_no_leaks(void)
+{
+    AllocStats before, after;
+    getAllocStats(&before);
+    freeCPUList(collectFixture("xeon-2s"));
+    freeCPUList(collectFixture("rpi4"));
+    getAllocStats(&after);
+    assert(after.currentBytes == before.currentBytes);
+
+    printf("No leaks test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Main test runner
+ *
+ * @return int 0 if all tests passed, 1 if any test failed
+ */
+int main(void)
+{
+    int testsPassed = 0;
+    int totalTests = 5;
+
+    if (test_dual_socket())
+        testsPassed++;
+    if (test_pstate_base_clock())
+        testsPassed++;
+    if (test_arm_board())
+        testsPassed++;
+    if (test_cpuinfo_only())
+        testsPassed++;
+    if (test_no_leaks())
+        testsPassed++;
+
+    printf("Tests passed: %d/%d\n", testsPassed, totalTests);
+    return testsPassed == totalTests ? 0 : 1;
+}
@@ -0,0 +1,192 @@
+#include "cpu_load.h"
+#include "fest_alloc.h"
+#include "linux_sysfs.h"
+#include "fixture_tree.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+
+#define TEST_ARENA_SIZE 4096 // Snapshot memory of one tick
+#define TEST_EPSILON 0.001   // Allowed rounding error of a percentage
+
+static const char *g_root = NULL; // Fixture root of all tests
+
+/**
+ * @brief Compares a percentage with its expected value
+ *
+ * @param value Computed percentage
+ * @param expected Expected percentage
+ * @return BOOL TRUE if both agree within TEST_EPSILON
+ */
+static BOOL near(double value, double expected)
+{
+    return fabs(value - expected) < TEST_EPSILON;
+}
+
+/**
+ * @brief Tests the portable delta computation
+ *
+ * This test validates:
+ * 1. The first tick only takes the baseline and reports zeros
+ * 2. Later ticks only see the time elapsed since the previous one
+ * 3. A counter that went backwards is treated as restarted
+ * 4. A core without elapsed time reports all zeros
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_compute_deltas(void)
+{
+    CPULoadSampler sampler;
+    assert(initCPULoadSampler(&sampler, 2));
+
+    sampler.current[0] = (CPUTimes){300, 100, 0, 600};
+    sampler.current[1] = (CPUTimes){150, 50, 0, 300};
+    sampler.current[2] = (CPUTimes){150, 50, 0, 300};
+    CPULoadInfo *info = computeCPULoad(&sampler, NULL);
+    assert(info && info->coreCount == 2);
+    assert(info->total.user == 0.0 && info->total.system == 0.0 && info->total.idle == 0.0);
+    assert(info->cores[0].user == 0.0 && info->cores[1].idle == 0.0);
+    freeCPULoadInfo(info);
+
+    sampler.current[0] = (CPUTimes){350, 150, 50, 650};
+    sampler.current[1] = (CPUTimes){200, 100, 50, 350};
+    sampler.current[2] = (CPUTimes){150, 50, 0, 300};
+    info = computeCPULoad(&sampler, NULL);
+    assert(near(info->total.user, 25.0) && near(info->total.iowait, 25.0));
+    assert(near(info->cores[0].system, 25.0) && near(info->cores[0].idle, 25.0));
+    assert(info->cores[1].user == 0.0 && info->cores[1].idle == 0.0);
+    freeCPULoadInfo(info);
+
+    // Core 1 went offline and came back with fresh counters
+    sampler.current[0] = (CPUTimes){400, 200, 50, 700};
+    sampler.current[1] = (CPUTimes){210, 110, 50, 360};
+    sampler.current[2] = (CPUTimes){30, 0, 0, 10};
+    info = computeCPULoad(&sampler, NULL);
+    assert(near(info->cores[1].user, 75.0) && near(info->cores[1].idle, 25.0));
+    freeCPULoadInfo(info);
+
+    releaseCPULoadSampler(&sampler);
+    printf("Compute deltas test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests sampling /proc/stat across ticks
+ *
+ * This test validates:
+ * 1. The first tick reports zeros, the second the elapsed share
+ * 2. nice is counted as user, irq/softirq/steal as system
+ * 3. Cores are sized from the possible list, offline ones read zero
+ * 4. The descriptor kept open sees the rewritten file
+ * 5. A tick allocates nothing besides its arena output
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_proc_stat(void)
+{
+    writeFixture("/sys/devices/system/cpu/possible", "0-3\n");
+    writeFixture("/proc/stat",
+                 "cpu  100 0 50 800 50 0 0 0 0 0\n"
+                 "cpu0 50 0 25 400 25 0 0 0 0 0\n"
+                 "cpu2 50 0 25 400 25 0 0 0 0 0\n"
+                 "intr 12345 0 0\n"
+                 "ctxt 67890\n");
+
+    setSysfsRoot(g_root);
+    assert(openLinuxCPULoad());
+
+    SnapshotArena arena;
+    assert(initSnapshotArena(&arena, TEST_ARENA_SIZE));
+    CPULoadInfo *info = collectLinuxCPULoad(&arena);
+    assert(info && info->coreCount == 4);
+    assert(info->total.user == 0.0 && info->total.idle == 0.0);
+    assert(info->cores[2].iowait == 0.0);
+    assert(info->cores[1].idle == 0.0 && info->cores[3].idle == 0.0);
+
+    writeFixture("/proc/stat",
+                 "cpu  130 20 65 820 50 5 5 5 0 0\n"
+                 "cpu0 80 20 40 420 25 5 5 5 0 0\n"
+                 "cpu2 50 0 25 400 25 0 0 0 0 0\n"
+                 "intr 12400 0 0\n"
+                 "ctxt 67999\n");
+
+    AllocStats before, after;
+    getAllocStats(&before);
+    resetSnapshotArena(&arena);
+    info = collectLinuxCPULoad(&arena);
+    getAllocStats(&after);
+    assert(after.allocCount == before.allocCount);
+
+    assert(info && near(info->total.user, 50.0) && near(info->total.system, 30.0) && near(info->total.idle, 20.0));
+    assert(near(info->cores[0].user, 50.0) && near(info->cores[0].system, 30.0));
+    assert(info->cores[2].user == 0.0 && info->cores[2].idle == 0.0);
+
+    closeLinuxCPULoad();
+    assert(collectLinuxCPULoad(&arena) == NULL);
+    releaseSnapshotArena(&arena);
+    setSysfsRoot(NULL);
+
+    printf("Proc stat test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests the fallback without a possible list
+ *
+ * This test validates:
+ * 1. Cores are counted from the "cpuN" lines of /proc/stat
+ * 2. Opening fails without /proc/stat
+ * 3. Opening and closing leaves no allocation behind
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_possible_fallback(void)
+{
+    char path[SYSFS_PATH_LENGTH];
+    _snprintf_s(path, sizeof(path), _TRUNCATE, "%s/sys/devices/system/cpu/possible", g_root);
+    remove(path);
+
+    AllocStats before, after;
+    getAllocStats(&before);
+    setSysfsRoot(g_root);
+    assert(openLinuxCPULoad());
+    CPULoadInfo *info = collectLinuxCPULoad(NULL);
+    assert(info && info->coreCount == 2);
+    freeCPULoadInfo(info);
+    closeLinuxCPULoad();
+
+    _snprintf_s(path, sizeof(path), _TRUNCATE, "%s/proc/stat", g_root);
+    remove(path);
+    assert(!openLinuxCPULoad());
+    setSysfsRoot(NULL);
+    getAllocStats(&after);
+    assert(after.currentBytes == before.currentBytes);
+
+    printf("Possible fallback test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Main test runner
+ *
+ * @return int 0 if all tests passed, 1 if any test failed
+ */
+int main(void)
+{
+    int testsPassed = 0;
+    int totalTests = 3;
+
+    g_root = createFixtureTree("cpu_load");
+
+    if (test_compute_deltas())
+        testsPassed++;
+    if (test_proc_stat())
+        testsPassed++;
+    if (test_possible_fallback())
+        testsPassed++;
+
+    removeFixtureTree();
+    printf("Tests passed: %d/%d\n", testsPassed, totalTests);
+    return testsPassed == totalTests ? 0 : 1;
+}
@@ -0,0 +1,288 @@
+#include "disk_io.h"
+#include "collector_backend.h"
+#include "json_structure.h"
+#include "fest_alloc.h"
+#include "linux_sysfs.h"
+#include "fixture_tree.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+
+#define TEST_ARENA_SIZE 65536   // Snapshot memory of one tick
+#define TEST_EPSILON 0.001      // Allowed rounding error of a rate
+#define TEST_TICK_MS 20         // Time between two sampled ticks
+#define TEST_MANY_DEVICES 200   // Devices that outgrow the initial read buffer
+
+static const char *g_root = NULL; // Fixture root of all tests
+
+/**
+ * @brief Compares a rate with its expected value
+ *
+ * @param value Computed rate
+ * @param expected Expected rate
+ * @return BOOL TRUE if both agree within TEST_EPSILON
+ */
+static BOOL near(double value, double expected)
+{
+    return fabs(value - expected) < TEST_EPSILON;
+}
+
+/**
+ * @brief Stores the counters of one device in the sampler
+ *
+ * @param sampler Sampler being filled for this tick
+ * @param counters Counters of the device, name included
+ */
+static void addCounters(DiskIOSampler *sampler, DiskIOCounters counters)
+{
+    assert(reserveDiskIOSampler(sampler, sampler->currentCount + 1));
+    sampler->current[sampler->currentCount++] = counters;
+}
+
+/**
+ * @brief Tests the portable delta computation
+ *
+ * This test validates:
+ * 1. The first tick has no baseline and reports zeros
+ * 2. IOPS, bytes per second, service time and utilization of a tick
+ * 3. A 32-bit time counter wraps instead of restarting
+ * 4. A 64-bit counter that went backwards restarted, even from the top of the 32-bit range
+ * 5. A plugged device reports zeros, an unplugged one disappears
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_compute_deltas(void)
+{
+    DiskIOSampler sampler;
+    memset(&sampler, 0, sizeof(sampler));
+
+    addCounters(&sampler, (DiskIOCounters){"sda", 1000, 8000, 500, 2000, 16000, 4000, 3000});
+    addCounters(&sampler, (DiskIOCounters){"nvme0n1", 0xFFFFFFFFULL - 99, 0, 0xFFFFFF00ULL, 0, 0, 0, 0xFFFFFFF0ULL});
+    sampler.currentTime = 10000;
+    DiskIOList *list = computeDiskIO(&sampler, NULL);
+    assert(list && list->count == 2);
+    assert(strcmp(list->devices[0].device, "sda") == 0 && list->devices[0].readIOPS == 0.0);
+    assert(list->devices[1].utilization == 0.0);
+    freeDiskIOList(list);
+
+    // Half a second later; the NVMe time counters wrapped at 2^32
+    addCounters(&sampler, (DiskIOCounters){"sda", 1100, 8800, 600, 2050, 20000, 4150, 3400});
+    addCounters(&sampler, (DiskIOCounters){"nvme0n1", 0xFFFFFFFFULL + 1, 0, 0x40, 0, 0, 0, 0x100});
+    sampler.currentTime = 10500;
+    list = computeDiskIO(&sampler, NULL);
+    assert(list && list->count == 2);
+    const DiskIOStats *sda = findDiskIO(list, "sda");
+    assert(sda && near(sda->readIOPS, 200.0) && near(sda->writeIOPS, 100.0));
+    assert(near(sda->readBytesPerSec, 800.0 * 512 * 2) && near(sda->writeBytesPerSec, 4000.0 * 512 * 2));
+    assert(near(sda->serviceTimeMs, 250.0 / 150.0) && near(sda->utilization, 80.0));
+    const DiskIOStats *nvme = findDiskIO(list, "nvme0n1");
+    assert(nvme && near(nvme->readIOPS, 200.0));
+    assert(near(nvme->serviceTimeMs, (double)(0x100 + 0x40) / 100.0));
+    assert(near(nvme->utilization, (double)(0x110) / 5.0));
+    assert(findDiskIO(list, "sdb") == NULL && findDiskIO(NULL, "sda") == NULL);
+    freeDiskIOList(list);
+
+    // sdb plugged in, nvme0n1 unplugged
+    addCounters(&sampler, (DiskIOCounters){"sdb", 500, 4000, 100, 0, 0, 0, 100});
+    addCounters(&sampler, (DiskIOCounters){"sda", 0x100000010ULL, 0, 0, 0, 0, 0, 0});
+    sampler.currentTime = 11500;
+    list = computeDiskIO(&sampler, NULL);
+    assert(list && list->count == 2);
+    assert(strcmp(list->devices[0].device, "sdb") == 0 && list->devices[0].readIOPS == 0.0);
+    assert(near(findDiskIO(list, "sda")->readIOPS, (double)(0x100000010ULL - 1100)));
+    assert(findDiskIO(list, "nvme0n1") == NULL);
+    freeDiskIOList(list);
+
+    // sda was replaced under its name and restarted; busy time capped at 100%
+    addCounters(&sampler, (DiskIOCounters){"sda", 40, 0, 0, 0, 0, 0, 5000});
+    addCounters(&sampler, (DiskIOCounters){"sdb", 500, 4000, 100, 0, 0, 0, 100});
+    sampler.currentTime = 12500;
+    list = computeDiskIO(&sampler, NULL);
+    sda = findDiskIO(list, "sda");
+    assert(sda && near(sda->readIOPS, 40.0) && sda->utilization == 100.0);
+    assert(findDiskIO(list, "sdb")->readIOPS == 0.0);
+    freeDiskIOList(list);
+
+    // Counts near 2^32 that went backwards restarted rather than wrapped
+    addCounters(&sampler, (DiskIOCounters){"sda", 0xFFFFFF00ULL, 0xFFFFFF00ULL, 0, 0, 0, 0, 5000});
+    sampler.currentTime = 13500;
+    freeDiskIOList(computeDiskIO(&sampler, NULL));
+    addCounters(&sampler, (DiskIOCounters){"sda", 0x10, 0x20, 0, 0, 0, 0, 5000});
+    sampler.currentTime = 14500;
+    list = computeDiskIO(&sampler, NULL);
+    sda = findDiskIO(list, "sda");
+    assert(sda && near(sda->readIOPS, 16.0) && near(sda->readBytesPerSec, 0x20 * 512.0));
+    freeDiskIOList(list);
+
+    releaseDiskIOSampler(&sampler);
+    printf("Compute deltas test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests sampling /proc/diskstats across ticks
+ *
+ * This test validates:
+ * 1. Loop and RAM disks are left out
+ * 2. Lines of old (14 fields) and new (20 fields) kernels are read
+ * 3. The descriptor kept open sees the rewritten file
+ * 4. A steady tick allocates nothing besides its arena output
+ * 5. Hundreds of plugged devices grow the buffer and the sampler once
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_diskstats(void)
+{
+    writeFixture("/proc/diskstats",
+                 "   7       0 loop0 52 0 2214 12 0 0 0 0 0 40 12 0 0 0 0 0 0\n"
+                 "   1       0 ram0 0 0 0 0 0 0 0 0 0 0 0\n"
+                 " 259       0 nvme0n1 1000 20 64000 400 500 10 16000 200 0 600 600 0 0 0 0 40 3\n"
+                 " 259       1 nvme0n1p1 900 20 60000 380 500 10 16000 200 0 580 580 0 0 0 0 0 0\n"
+                 "   8       0 sda 100 0 800 1000 0 0 0 0 0 900 1000\n"
+                 " 253       0 dm-0 900 0 60000 390 510 0 16000 210 0 590 600 0 0 0 0 0 0\n");
+
+    setSysfsRoot(g_root);
+    assert(openLinuxDiskIO());
+
+    SnapshotArena arena;
+    assert(initSnapshotArena(&arena, TEST_ARENA_SIZE));
+    DiskIOList *list = collectLinuxDiskIO(&arena);
+    assert(list && list->count == 4);
+    assert(strcmp(list->devices[0].device, "nvme0n1") == 0 && strcmp(list->devices[3].device, "dm-0") == 0);
+    assert(findDiskIO(list, "loop0") == NULL && findDiskIO(list, "ram0") == NULL);
+
+    writeFixture("/proc/diskstats",
+                 "   7       0 loop0 52 0 2214 12 0 0 0 0 0 40 12 0 0 0 0 0 0\n"
+                 "   1       0 ram0 0 0 0 0 0 0 0 0 0 0 0\n"
+                 " 259       0 nvme0n1 1100 20 72000 420 600 10 24000 230 0 610 650 0 0 0 0 40 3\n"
+                 " 259       1 nvme0n1p1 1000 20 68000 400 600 10 24000 230 0 590 630 0 0 0 0 0 0\n"
+                 "   8       0 sda 110 0 880 1100 0 0 0 0 0 910 1100\n"
+                 " 253       0 dm-0 900 0 60000 390 510 0 16000 210 0 590 600 0 0 0 0 0 0\n");
+    Sleep(TEST_TICK_MS);
+
+    AllocStats before, after;
+    getAllocStats(&before);
+    resetSnapshotArena(&arena);
+    list = collectLinuxDiskIO(&arena);
+    getAllocStats(&after);
+    assert(after.allocCount == before.allocCount);
+
+    assert(list && list->count == 4);
+    const DiskIOStats *nvme = findDiskIO(list, "nvme0n1");
+    assert(nvme && nvme->readIOPS > 0.0 && nvme->writeIOPS > 0.0 && nvme->utilization > 0.0);
+    assert(near(nvme->readBytesPerSec / nvme->readIOPS, 8000.0 * 512 / 100));
+    assert(near(nvme->writeIOPS / nvme->readIOPS, 1.0));
+    assert(near(nvme->serviceTimeMs, 50.0 / 200.0));
+    const DiskIOStats *sda = findDiskIO(list, "sda");
+    assert(sda && near(sda->serviceTimeMs, 10.0) && sda->writeIOPS == 0.0);
+    const DiskIOStats *dm = findDiskIO(list, "dm-0");
+    assert(dm && dm->readIOPS == 0.0 && dm->utilization == 0.0);
+
+    // A container host plugs hundreds of thin volumes at once
+    size_t contentSize = (TEST_MANY_DEVICES + 1) * 128;
+    char *content = (char *)festMalloc(contentSize);
+    size_t length = (size_t)_snprintf_s(content, contentSize, _TRUNCATE,
+                                        " 259       0 nvme0n1 1200 20 80000 440 700 10 32000 260 0 620 700 0 0 0 0 40 3\n");
+    for (UINT i = 0; i < TEST_MANY_DEVICES; i++)
+        length += (size_t)_snprintf_s(content + length, contentSize - length, _TRUNCATE,
+                                      " 253 %7u dm-%u %u 0 %u 0 0 0 0 0 0 0 0 0 0 0 0 0 0\n", i + 1, i + 1, i, i * 8);
+    writeFixture("/proc/diskstats", content);
+    festFree(content);
+    Sleep(TEST_TICK_MS);
+
+    resetSnapshotArena(&arena);
+    list = collectLinuxDiskIO(&arena);
+    assert(list && list->count == TEST_MANY_DEVICES + 1);
+    assert(findDiskIO(list, "nvme0n1")->readIOPS > 0.0);
+    assert(findDiskIO(list, "sda") == NULL);
+    assert(strcmp(list->devices[TEST_MANY_DEVICES].device, "dm-200") == 0);
+    assert(findDiskIO(list, "dm-200")->readIOPS == 0.0);
+
+    Sleep(TEST_TICK_MS);
+    getAllocStats(&before);
+    resetSnapshotArena(&arena);
+    list = collectLinuxDiskIO(&arena);
+    getAllocStats(&after);
+    assert(after.allocCount == before.allocCount);
+    assert(list && list->count == TEST_MANY_DEVICES + 1);
+
+    closeLinuxDiskIO();
+    assert(collectLinuxDiskIO(&arena) == NULL);
+    releaseSnapshotArena(&arena);
+    setSysfsRoot(NULL);
+
+    printf("Diskstats test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests the activity rendered inside the storage section
+ *
+ * This test validates:
+ * 1. A volume gets an "io" object for its block device
+ * 2. A volume whose device was not sampled has none
+ * 3. Opening without /proc/diskstats fails and leaks nothing
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_storage_json(void)
+{
+    const CollectorTable *fixtures = &getFixtureCollectorBackend()->collectors;
+    StorageList *storage = fixtures->collectStorageList(NULL);
+    DiskIOList *io = fixtures->collectDiskIO(NULL);
+    assert(storage && io);
+    strcpy_s(storage->disks[1].device, sizeof(storage->disks[1].device), "mmcblk0p1");
+
+    char *json = generateSystemInfoJSON(NULL, NULL, NULL, NULL, NULL, NULL, NULL, storage, io,
+                                        NULL, NULL, NULL, NULL, NULL);
+    assert(json);
+    assert(strstr(json, "\"device\": \"nvme0n1p1\",\n      \"file_system\""));
+    assert(strstr(json, "\"used_space\": 96.64,\n      \"io\": {\n        \"read_iops\": 1650.0,"));
+    assert(strstr(json, "\"read_bytes_per_sec\": 216268800,"));
+    assert(strstr(json, "\"service_time_ms\": 4.38,\n        \"utilization\": 96.4\n      }\n    }\n"));
+    const char *mmc = strstr(json, "\"mmcblk0p1\"");
+    assert(mmc && strstr(mmc, "\"io\"") > strstr(mmc, "\"drive\""));
+    freeJSONString(json);
+    freeStorageList(storage);
+    freeDiskIOList(io);
+
+    char path[SYSFS_PATH_LENGTH];
+    _snprintf_s(path, sizeof(path), _TRUNCATE, "%s/proc/diskstats", g_root);
+    remove(path);
+
+    AllocStats before, after;
+    getAllocStats(&before);
+    setSysfsRoot(g_root);
+    assert(!openLinuxDiskIO());
+    setSysfsRoot(NULL);
+    getAllocStats(&after);
+    assert(after.currentBytes == before.currentBytes);
+
+    printf("Storage JSON test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Main test runner
+ *
+ * @return int 0 if all tests passed, 1 if any test failed
+ */
+int main(void)
+{
+    int testsPassed = 0;
+    int totalTests = 3;
+
+    g_root = createFixtureTree("disk_io");
+
+    if (test_compute_deltas())
+        testsPassed++;
+    if (test_diskstats())
+        testsPassed++;
+    if (test_storage_json())
+        testsPassed++;
+
+    removeFixtureTree();
+    printf("Tests passed: %d/%d\n", testsPassed, totalTests);
+    return testsPassed == totalTests ? 0 : 1;
+}
@@ -0,0 +1,172 @@
+#include "memory_info.h"
+#include "fest_alloc.h"
+#include "linux_sysfs.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#define TEST_ARENA_SIZE 4096 // Snapshot memory of one tick
+#define KB 1024ULL           // /proc/meminfo unit
+
+/**
+ * @brief Collects the memory counters of a captured fixture tree
+ *
+ * @param name Fixture directory below tests/fixtures
+ * @return MemoryInfo* Memory counters of the fixture
+ */
+static MemoryInfo *collectFixture(const char *name)
+{
+    char root[SYSFS_PATH_LENGTH];
+    _snprintf_s(root, sizeof(root), _TRUNCATE, "%s/%s", FEST_FIXTURE_DIR, name);
+    setSysfsRoot(root);
+    assert(openLinuxMemory());
+    MemoryInfo *info = collectLinuxMemoryInfo(NULL);
+    closeLinuxMemory();
+    setSysfsRoot(NULL);
+    assert(info);
+    return info;
+}
+
+/**
+ * @brief Tests a server with swap and a huge page pool
+ *
+ * This test validates:
+ * 1. kB values are converted to bytes
+ * 2. MemAvailable is the available memory
+ * 3. Huge page counts are kept as counts
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_server(void)
+{
+    MemoryInfo *info = collectFixture("xeon-2s");
+    assert(info->totalPhys == 131927568 * KB);
+    assert(info->availPhys == 88915320 * KB);
+    assert(info->usedPhys == (131927568 - 88915320) * KB);
+    assert(info->memoryLoad == 33);
+    assert(info->totalSwap == 8388604 * KB && info->freeSwap == 8126460 * KB);
+    assert(info->cached == 82644968 * KB && info->buffers == 913412 * KB);
+    assert(info->dirty == 18236 * KB);
+    assert(info->hugePagesTotal == 1024 && info->hugePagesFree == 512);
+    assert(info->hugePageSize == 2048 * KB);
+    freeMemoryInfo(info);
+
+    printf("Server test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests a board without swap or huge pages
+ *
+ * This test validates:
+ * 1. Missing counters read as zero
+ * 2. Lines the parser does not know are skipped
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_no_swap(void)
+{
+    MemoryInfo *info = collectFixture("rpi4");
+    assert(info->totalPhys == 3884096 * KB && info->availPhys == 3417176 * KB);
+    assert(info->memoryLoad == 12);
+    assert(info->totalSwap == 0 && info->freeSwap == 0);
+    assert(info->hugePagesTotal == 0 && info->hugePageSize == 0);
+    assert(info->dirty == 28 * KB);
+    freeMemoryInfo(info);
+
+    printf("No swap test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests a kernel without MemAvailable
+ *
+ * This test validates:
+ * 1. Free memory, buffers and page cache count as available
+ * 2. A missing meminfo disables the collector
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_legacy_kernel(void)
+{
+    MemoryInfo *info = collectFixture("container");
+    assert(info->availPhys == (512000 + 102400 + 409600) * KB);
+    assert(info->memoryLoad == 50);
+    assert(info->totalSwap == 1048576 * KB && info->freeSwap == info->totalSwap);
+    freeMemoryInfo(info);
+
+    char root[SYSFS_PATH_LENGTH];
+    _snprintf_s(root, sizeof(root), _TRUNCATE, "%s/nonexistent", FEST_FIXTURE_DIR);
+    setSysfsRoot(root);
+    assert(!openLinuxMemory());
+    assert(collectLinuxMemoryInfo(NULL) == NULL);
+    setSysfsRoot(NULL);
+
+    printf("Legacy kernel test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests the cost of a tick
+ *
+ * This test validates:
+ * 1. Repeated ticks reread the open descriptor
+ * 2. A tick allocates nothing besides its arena output
+ * 3. Collection leaves no allocation behind
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_tick_cost(void)
+{
+    char root[SYSFS_PATH_LENGTH];
+    _snprintf_s(root, sizeof(root), _TRUNCATE, "%s/xeon-2s", FEST_FIXTURE_DIR);
+
+    AllocStats start, before, after;
+    getAllocStats(&start);
+    SnapshotArena arena;
+    assert(initSnapshotArena(&arena, TEST_ARENA_SIZE));
+    setSysfsRoot(root);
+    assert(openLinuxMemory());
+
+    getAllocStats(&before);
+    for (UINT tick = 0; tick < 3; tick++)
+    {
+        resetSnapshotArena(&arena);
+        MemoryInfo *info = collectLinuxMemoryInfo(&arena);
+        assert(info && info->hugePagesFree == 512);
+    }
+    getAllocStats(&after);
+    assert(after.allocCount == before.allocCount);
+
+    closeLinuxMemory();
+    setSysfsRoot(NULL);
+    releaseSnapshotArena(&arena);
+    getAllocStats(&after);
+    assert(after.currentBytes == start.currentBytes);
+
+    printf("Tick cost test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Main test runner
+ *
+ * @return int 0 if all tests passed, 1 if any test failed
+ */
+int main(void)
+{
+    int testsPassed = 0;
+    int totalTests = 4;
+
+    if (test_server())
+        testsPassed++;
+    if (test_no_swap())
+        testsPassed++;
+    if (test_legacy_kernel())
+        testsPassed++;
+    if (test_tick_cost())
+        testsPassed++;
+
+    printf("Tests passed: %d/%d\n", testsPassed, totalTests);
+    return testsPassed == totalTests ? 0 : 1;
+}
@@ -0,0 +1,580 @@
+#include "network_info.h"
+#include "collector_backend.h"
+#include "json_structure.h"
+#include "fest_alloc.h"
+#include "linux_sysfs.h"
+#include "fixture_tree.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <net/if_arp.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+#define TEST_ARENA_SIZE 65536  // Snapshot memory of one tick
+#define TEST_DUMP_SIZE 4096    // Room for one synthetic dump
+#define TEST_OPER_DOWN 2       // IF_OPER_DOWN
+#define TEST_OPER_UP 6         // IF_OPER_UP
+#define TEST_EPSILON 0.001     // Allowed rounding error of a rate
+#define TEST_TICK_MS 20        // Time between two live ticks
+#define TEST_DATAGRAMS 64      // Datagrams sent over loopback between two live ticks
+#define TEST_DATAGRAM_SIZE 512 // Payload of each datagram
+#define TEST_STATS64_V1 64     // Size of the first eight fields of rtnl_link_stats64
+
+#ifndef IFLA_PERM_ADDRESS
+#define IFLA_PERM_ADDRESS 54 // Permanent hardware address, Linux 5.6 and newer
+#endif
+
+static const char *g_root = NULL; // Fixture root of all tests
+
+/**
+ * @brief Appends a netlink message without attributes to a dump
+ *
+ * @param dump Dump being built
+ * @param length Bytes used in dump, moved past the message
+ * @param type Message type
+ * @param body Fixed part of the message
+ * @param bodySize Size of body in bytes
+ * @return struct nlmsghdr* Header of the message, to add attributes to
+ */
+static struct nlmsghdr *addMessage(BYTE *dump, size_t *length, WORD type, const void *body, size_t bodySize)
+{
+    struct nlmsghdr *header = (struct nlmsghdr *)(dump + *length);
+    assert(*length + NLMSG_SPACE(bodySize) <= TEST_DUMP_SIZE);
+    memset(header, 0, NLMSG_SPACE(bodySize));
+    header->nlmsg_len = NLMSG_LENGTH(bodySize);
+    header->nlmsg_type = type;
+    header->nlmsg_flags = NLM_F_MULTI;
+    memcpy(NLMSG_DATA(header), body, bodySize);
+    *length += NLMSG_ALIGN(header->nlmsg_len);
+    return header;
+}
+
+/**
+ * @brief Appends an attribute to the last message of a dump
+ *
+ * @param dump Dump being built
+ * @param length Bytes used in dump, moved past the attribute
+ * @param header Last message of the dump
+ * @param type Attribute type
+ * @param data Attribute payload
+ * @param size Size of data in bytes
+ */
+static void addAttribute(BYTE *dump, size_t *length, struct nlmsghdr *header, WORD type, const void *data, size_t size)
+{
+    struct rtattr *attribute = (struct rtattr *)(dump + *length);
+    assert(*length + RTA_SPACE(size) <= TEST_DUMP_SIZE);
+    memset(attribute, 0, RTA_SPACE(size));
+    attribute->rta_len = RTA_LENGTH(size);
+    attribute->rta_type = type;
+    memcpy(RTA_DATA(attribute), data, size);
+    header->nlmsg_len = NLMSG_ALIGN(header->nlmsg_len) + RTA_SPACE(size);
+    *length += RTA_SPACE(size);
+}
+
+/**
+ * @brief Compares a rate with its expected value
+ *
+ * @param value Computed rate
+ * @param expected Expected rate
+ * @return BOOL TRUE if both agree within TEST_EPSILON
+ */
+static BOOL near(double value, double expected)
+{
+    return fabs(value - expected) < TEST_EPSILON;
+}
+
+/**
+ * @brief Appends an RTM_NEWLINK message to a dump
+ *
+ * @param dump Dump being built
+ * @param length Bytes used in dump
+ * @param index Interface index
+ * @param type ARPHRD_* of the link
+ * @param flags IFF_* flags
+ * @param name Interface name
+ * @param operState IF_OPER_* value
+ * @return struct nlmsghdr* Header of the message, to add addresses to
+ */
+static struct nlmsghdr *addLink(BYTE *dump, size_t *length, int index, WORD type, UINT flags,
+                                const char *name, BYTE operState)
+{
+    struct ifinfomsg link;
+    memset(&link, 0, sizeof(link));
+    link.ifi_family = AF_UNSPEC;
+    link.ifi_index = index;
+    link.ifi_type = type;
+    link.ifi_flags = flags;
+
+    struct nlmsghdr *header = addMessage(dump, length, RTM_NEWLINK, &link, sizeof(link));
+    addAttribute(dump, length, header, IFLA_IFNAME, name, strlen(name) + 1);
+    addAttribute(dump, length, header, IFLA_OPERSTATE, &operState, sizeof(operState));
+    return header;
+}
+
+/**
+ * @brief Appends an RTM_NEWADDR message to a dump
+ *
+ * @param dump Dump being built
+ * @param length Bytes used in dump
+ * @param index Interface index
+ * @param family AF_INET or AF_INET6
+ * @param text Address in text form
+ * @param prefixLength Network prefix in bits
+ */
+static void addAddress(BYTE *dump, size_t *length, int index, BYTE family, const char *text, BYTE prefixLength)
+{
+    struct ifaddrmsg message;
+    memset(&message, 0, sizeof(message));
+    message.ifa_family = family;
+    message.ifa_prefixlen = prefixLength;
+    message.ifa_index = (UINT)index;
+
+    BYTE binary[16];
+    assert(inet_pton(family, text, binary) == 1);
+    size_t size = family == AF_INET6 ? 16 : 4;
+
+    struct nlmsghdr *header = addMessage(dump, length, RTM_NEWADDR, &message, sizeof(message));
+    addAttribute(dump, length, header, IFA_ADDRESS, binary, size);
+    if (family == AF_INET)
+        addAttribute(dump, length, header, IFA_LOCAL, binary, size);
+}
+
+/**
+ * @brief Finds an adapter by name
+ *
+ * @param list Adapter list
+ * @param name Interface name
+ * @return const NetworkAdapterInfo* Adapter, NULL if not listed
+ */
+static const NetworkAdapterInfo *findAdapterByName(const NetworkList *list, const char *name)
+{
+    for (UINT i = 0; i < list->count; i++)
+    {
+        if (strcmp(list->adapters[i].name, name) == 0)
+            return &list->adapters[i];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Tests parsing a synthetic rtnetlink dump
+ *
+ * This test validates:
+ * 1. Adapters are ordered by index whatever the dump order
+ * 2. The permanent MAC wins over a randomized one, a zero one does not
+ * 3. Loopback, Wi-Fi (phy80211 in sysfs), Ethernet and other links are typed,
+ *    Ethernet-framed veth and bridge links without a device as other
+ * 4. Operstate and connection status, "unknown" but running included
+ * 5. IPv4 and IPv6 addresses are grouped per adapter, unknown indexes dropped
+ * 6. ipAddress is the first IPv4 address, "N/A" without one
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_parse_dump(void)
+{
+    static BYTE links[TEST_DUMP_SIZE];
+    static BYTE addresses[TEST_DUMP_SIZE];
+    static const BYTE randomMac[] = {0x3a, 0x11, 0x22, 0x33, 0x44, 0x55};
+    static const BYTE permanentMac[] = {0x00, 0x1a, 0x2b, 0x3c, 0x4d, 0x5e};
+    static const BYTE wirelessMac[] = {0x8c, 0x16, 0x45, 0x01, 0x02, 0x03};
+    static const BYTE zeroMac[6] = {0};
+    size_t linksLength = 0;
+    size_t addressesLength = 0;
+
+    writeFixture("/sys/class/net/wlp2s0/phy80211/index", "0\n");
+    writeFixture("/sys/class/net/enp3s0/device/vendor", "0x10ec\n");
+    writeFixture("/sys/class/net/veth1a2b3c/ifindex", "12\n");
+    writeFixture("/sys/class/net/br0/bridge/stp_state", "0\n");
+    setSysfsRoot(g_root);
+
+    struct nlmsghdr *header = addLink(links, &linksLength, 3, ARPHRD_ETHER, IFF_UP, "wlp2s0", TEST_OPER_DOWN);
+    addAttribute(links, &linksLength, header, IFLA_ADDRESS, wirelessMac, sizeof(wirelessMac));
+    addAttribute(links, &linksLength, header, IFLA_PERM_ADDRESS, zeroMac, sizeof(zeroMac));
+    addLink(links, &linksLength, 1, ARPHRD_LOOPBACK, IFF_UP | IFF_RUNNING | IFF_LOOPBACK, "lo", 0);
+    header = addLink(links, &linksLength, 2, ARPHRD_ETHER, IFF_UP | IFF_RUNNING, "enp3s0", TEST_OPER_UP);
+    addAttribute(links, &linksLength, header, IFLA_ADDRESS, randomMac, sizeof(randomMac));
+    addAttribute(links, &linksLength, header, IFLA_PERM_ADDRESS, permanentMac, sizeof(permanentMac));
+    addLink(links, &linksLength, 7, ARPHRD_NONE, IFF_UP | IFF_POINTOPOINT, "tun0", TEST_OPER_UP);
+    addLink(links, &linksLength, 11, ARPHRD_ETHER, IFF_UP | IFF_RUNNING, "br0", TEST_OPER_UP);
+    addLink(links, &linksLength, 12, ARPHRD_ETHER, IFF_UP | IFF_RUNNING, "veth1a2b3c", TEST_OPER_UP);
+    addMessage(links, &linksLength, NLMSG_DONE, &(int){0}, sizeof(int));
+
+    addAddress(addresses, &addressesLength, 1, AF_INET, "127.0.0.1", 8);
+    addAddress(addresses, &addressesLength, 2, AF_INET6, "fe80::21a:2bff:fe3c:4d5e", 64);
+    addAddress(addresses, &addressesLength, 2, AF_INET, "192.168.1.20", 24);
+    addAddress(addresses, &addressesLength, 9, AF_INET, "10.0.0.1", 8);
+    addAddress(addresses, &addressesLength, 1, AF_INET6, "::1", 128);
+    addAddress(addresses, &addressesLength, 7, AF_INET6, "fd00::2", 64);
+    addMessage(addresses, &addressesLength, NLMSG_DONE, &(int){0}, sizeof(int));
+
+    SnapshotArena arena;
+    assert(initSnapshotArena(&arena, TEST_ARENA_SIZE));
+    NetworkList *list = parseLinuxNetworkDump(links, linksLength, addresses, addressesLength, NULL, &arena);
+    assert(list && list->count == 6 && list->addressCount == 5);
+    for (UINT i = 0; i < 4; i++)
+        assert(list->adapters[i].index == (i < 3 ? i + 1 : 7));
+
+    const NetworkAdapterInfo *lo = &list->adapters[0];
+    assert(strcmp(lo->name, "lo") == 0 && lo->type == MIB_IF_TYPE_LOOPBACK);
+    assert(strcmp(lo->operState, "unknown") == 0 && strcmp(lo->status, "Connected") == 0);
+    assert(lo->macAddress[0] == '\0' && strcmp(lo->ipAddress, "127.0.0.1") == 0);
+    assert(lo->addressCount == 2 && list->addresses[lo->firstAddress].prefixLength == 8);
+    assert(strcmp(list->addresses[lo->firstAddress + 1].address, "::1") == 0 && list->addresses[lo->firstAddress + 1].ipv6);
+
+    const NetworkAdapterInfo *wired = findAdapterByName(list, "enp3s0");
+    assert(wired && isEthernetAdapter(wired) && strcmp(wired->macAddress, "00-1A-2B-3C-4D-5E") == 0);
+    assert(strcmp(wired->operState, "up") == 0 && strcmp(wired->status, "Connected") == 0);
+    assert(strcmp(wired->ipAddress, "192.168.1.20") == 0 && wired->addressCount == 2);
+    assert(strcmp(list->addresses[wired->firstAddress].address, "fe80::21a:2bff:fe3c:4d5e") == 0);
+    assert(list->addresses[wired->firstAddress].prefixLength == 64);
+
+    const NetworkAdapterInfo *wireless = findAdapterByName(list, "wlp2s0");
+    assert(wireless && isWiFiAdapter(wireless) && strcmp(wireless->macAddress, "8C-16-45-01-02-03") == 0);
+    assert(strcmp(wireless->operState, "down") == 0 && strcmp(wireless->status, "Not Connected") == 0);
+    assert(strcmp(wireless->ipAddress, "N/A") == 0 && wireless->addressCount == 0);
+
+    const NetworkAdapterInfo *tunnel = findAdapterByName(list, "tun0");
+    assert(tunnel && tunnel->type == IF_TYPE_OTHER && !isEthernetAdapter(tunnel) && !isWiFiAdapter(tunnel));
+    assert(strcmp(tunnel->ipAddress, "N/A") == 0 && tunnel->addressCount == 1);
+
+    // Virtual Ethernet links have no device behind them
+    const NetworkAdapterInfo *bridge = findAdapterByName(list, "br0");
+    assert(bridge && bridge->type == IF_TYPE_OTHER && !isEthernetAdapter(bridge));
+    const NetworkAdapterInfo *veth = findAdapterByName(list, "veth1a2b3c");
+    assert(veth && veth->type == IF_TYPE_OTHER && !isEthernetAdapter(veth));
+
+    // Links without addresses and an empty dump
+    resetSnapshotArena(&arena);
+    list = parseLinuxNetworkDump(links, linksLength, NULL, 0, NULL, &arena);
+    assert(list && list->count == 6 && list->addressCount == 0 && list->addresses == NULL);
+    list = parseLinuxNetworkDump(NULL, 0, NULL, 0, NULL, &arena);
+    assert(list && list->count == 0);
+
+    releaseSnapshotArena(&arena);
+    setSysfsRoot(NULL);
+
+    printf("Parse dump test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests the portable rate computation
+ *
+ * This test validates:
+ * 1. The first tick has no baseline and reports zeros
+ * 2. Bytes and packets per second, errors and drops since the previous tick
+ * 3. An index new since the previous tick, or missing from it, reports zeros
+ * 4. A reset counter counts from zero
+ * 5. The slot of an index the previous tick did not read is reclaimed
+ * 6. High indexes of a container host are sampled like low ones
+ * 7. A steady tick allocates nothing
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_compute_rates(void)
+{
+    NetworkSampler sampler;
+    NetworkAdapterInfo adapter;
+    memset(&sampler, 0, sizeof(sampler));
+
+    memset(&adapter, 0, sizeof(adapter));
+    adapter.index = 2;
+    beginNetworkSample(&sampler, 10000);
+    computeNetworkRates(&sampler, &adapter, &(NetworkCounters){1000000, 50000, 800, 400, 2, 0, 5, 1});
+    assert(adapter.rxBytesPerSec == 0.0 && adapter.rxDropped == 0 && sampler.count == 1);
+
+    // Half a second later
+    AllocStats before, after;
+    getAllocStats(&before);
+    memset(&adapter, 0, sizeof(adapter));
+    adapter.index = 2;
+    beginNetworkSample(&sampler, 10500);
+    computeNetworkRates(&sampler, &adapter, &(NetworkCounters){1600000, 60000, 1200, 450, 3, 0, 9, 1});
+    getAllocStats(&after);
+    assert(after.allocCount == before.allocCount);
+    assert(near(adapter.rxBytesPerSec, 1200000.0) && near(adapter.txBytesPerSec, 20000.0));
+    assert(near(adapter.rxPacketsPerSec, 800.0) && near(adapter.txPacketsPerSec, 100.0));
+    assert(adapter.rxErrors == 1 && adapter.txErrors == 0 && adapter.rxDropped == 4 && adapter.txDropped == 0);
+
+    NetworkAdapterInfo plugged;
+    memset(&plugged, 0, sizeof(plugged));
+    plugged.index = 40;
+    computeNetworkRates(&sampler, &plugged, &(NetworkCounters){5000, 5000, 5, 5, 0, 0, 0, 0});
+    assert(plugged.rxBytesPerSec == 0.0 && sampler.count == 2);
+
+    // The driver of index 2 was reloaded; index 40 is sampled again
+    memset(&adapter, 0, sizeof(adapter));
+    adapter.index = 2;
+    beginNetworkSample(&sampler, 11500);
+    computeNetworkRates(&sampler, &adapter, &(NetworkCounters){3000, 1000, 3, 2, 0, 0, 0, 0});
+    assert(near(adapter.rxBytesPerSec, 3000.0) && near(adapter.txPacketsPerSec, 2.0));
+
+    // Index 40 skipped a tick, its counters are no baseline any more
+    beginNetworkSample(&sampler, 12500);
+    memset(&plugged, 0, sizeof(plugged));
+    plugged.index = 40;
+    computeNetworkRates(&sampler, &plugged, &(NetworkCounters){9000, 9000, 9, 9, 0, 0, 0, 0});
+    assert(plugged.rxBytesPerSec == 0.0 && sampler.count == 2);
+
+    // Veths of a container host, created and removed over and over
+    UINT capacity = sampler.capacity;
+    for (UINT tick = 0; tick < 4 * NETWORK_INITIAL_SLOTS; tick++)
+    {
+        beginNetworkSample(&sampler, 13000 + tick * 1000);
+        memset(&adapter, 0, sizeof(adapter));
+        adapter.index = 200000 + tick;
+        computeNetworkRates(&sampler, &adapter, &(NetworkCounters){tick, tick, 0, 0, 0, 0, 0, 0});
+        assert(sampler.count == 2); // This veth and the one the previous tick read
+    }
+    assert(sampler.capacity == capacity);
+
+    NetworkAdapterInfo high[3];
+    const UINT highIndex[3] = {2, 200000, 0xFFFFFFF0U};
+    for (UINT tick = 0; tick < 2; tick++)
+    {
+        getAllocStats(&before);
+        beginNetworkSample(&sampler, 100000 + tick * 1000);
+        for (UINT i = 0; i < 3; i++)
+        {
+            memset(&high[i], 0, sizeof(high[i]));
+            high[i].index = highIndex[i];
+            computeNetworkRates(&sampler, &high[i], &(NetworkCounters){tick * 1000 * (i + 1), 0, 0, 0, 0, 0, 0, 0});
+        }
+        getAllocStats(&after);
+        assert(after.allocCount == before.allocCount);
+    }
+    assert(sampler.count == 3);
+    assert(near(high[0].rxBytesPerSec, 1000.0) && near(high[1].rxBytesPerSec, 2000.0));
+    assert(near(high[2].rxBytesPerSec, 3000.0));
+
+    releaseNetworkSampler(&sampler);
+    assert(sampler.slots == NULL && sampler.map == NULL && sampler.capacity == 0);
+
+    printf("Compute rates test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Builds a link dump of one Ethernet link with traffic counters
+ *
+ * @param dump Dump being built
+ * @param stats Counters of the link
+ * @param statsSize Bytes of stats the kernel sends
+ * @return size_t Bytes used in dump
+ */
+static size_t buildStatsDump(BYTE *dump, const struct rtnl_link_stats64 *stats, size_t statsSize)
+{
+    size_t length = 0;
+    struct nlmsghdr *header = addLink(dump, &length, 2, ARPHRD_ETHER, IFF_UP | IFF_RUNNING, "enp3s0", TEST_OPER_UP);
+    addAttribute(dump, &length, header, IFLA_STATS64, stats, statsSize);
+    addLink(dump, &length, 1, ARPHRD_LOOPBACK, IFF_UP | IFF_RUNNING | IFF_LOOPBACK, "lo", 0);
+    return length;
+}
+
+/**
+ * @brief Tests traffic rates read from IFLA_STATS64
+ *
+ * This test validates:
+ * 1. Rates come from the counters of two parsed dumps
+ * 2. A shorter struct of an older kernel is read
+ * 3. A link without IFLA_STATS64 reports zeros
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_stats64_rates(void)
+{
+    static BYTE links[TEST_DUMP_SIZE];
+    struct rtnl_link_stats64 stats;
+    NetworkSampler sampler;
+    memset(&sampler, 0, sizeof(sampler));
+    memset(&stats, 0, sizeof(stats));
+
+    SnapshotArena arena;
+    assert(initSnapshotArena(&arena, TEST_ARENA_SIZE));
+
+    stats.rx_bytes = 0x100000000ULL;
+    stats.tx_bytes = 2000;
+    stats.rx_packets = 100;
+    stats.tx_packets = 10;
+    stats.rx_dropped = 7;
+    beginNetworkSample(&sampler, 5000);
+    size_t length = buildStatsDump(links, &stats, sizeof(stats));
+    NetworkList *list = parseLinuxNetworkDump(links, length, NULL, 0, &sampler, &arena);
+    assert(list && list->count == 2 && list->adapters[1].rxBytesPerSec == 0.0);
+
+    // Two seconds later, from a kernel without the newer fields
+    stats.rx_bytes += 4000000;
+    stats.tx_bytes += 100000;
+    stats.rx_packets += 3000;
+    stats.tx_packets += 1000;
+    stats.rx_errors = 2;
+    stats.tx_errors = 1;
+    stats.rx_dropped += 6;
+    beginNetworkSample(&sampler, 7000);
+    length = buildStatsDump(links, &stats, TEST_STATS64_V1);
+    resetSnapshotArena(&arena);
+    list = parseLinuxNetworkDump(links, length, NULL, 0, &sampler, &arena);
+    assert(list && list->count == 2);
+
+    const NetworkAdapterInfo *wired = findAdapterByName(list, "enp3s0");
+    assert(wired && near(wired->rxBytesPerSec, 2000000.0) && near(wired->txBytesPerSec, 50000.0));
+    assert(near(wired->rxPacketsPerSec, 1500.0) && near(wired->txPacketsPerSec, 500.0));
+    assert(wired->rxErrors == 2 && wired->txErrors == 1 && wired->rxDropped == 6 && wired->txDropped == 0);
+    const NetworkAdapterInfo *lo = findAdapterByName(list, "lo");
+    assert(lo && lo->rxBytesPerSec == 0.0 && lo->rxPacketsPerSec == 0.0);
+
+    releaseSnapshotArena(&arena);
+    releaseNetworkSampler(&sampler);
+
+    printf("STATS64 rates test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Sends datagrams to the discard port over loopback
+ */
+static void sendLoopbackTraffic(void)
+{
+    static char payload[TEST_DATAGRAM_SIZE];
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    assert(fd >= 0);
+
+    struct sockaddr_in target;
+    memset(&target, 0, sizeof(target));
+    target.sin_family = AF_INET;
+    target.sin_port = htons(9);
+    target.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (UINT i = 0; i < TEST_DATAGRAMS; i++)
+        sendto(fd, payload, sizeof(payload), 0, (struct sockaddr *)&target, sizeof(target));
+    close(fd);
+}
+
+/**
+ * @brief Tests collecting through a live rtnetlink socket
+ *
+ * This test validates:
+ * 1. The loopback interface is found with 127.0.0.1/8
+ * 2. A steady tick allocates nothing besides its arena output
+ * 3. Traffic sent over loopback between two ticks shows in its rates
+ * 4. Closing releases the socket and every buffer
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_live_socket(void)
+{
+    AllocStats start, before, after;
+    getAllocStats(&start);
+    if (!openLinuxNetwork())
+    {
+        printf("Live socket test skipped, no rtnetlink\n");
+        return TRUE;
+    }
+
+    SnapshotArena arena;
+    assert(initSnapshotArena(&arena, TEST_ARENA_SIZE));
+    NetworkList *list = collectLinuxNetworkList(&arena);
+    assert(list && list->count > 0);
+
+    getAllocStats(&before);
+    resetSnapshotArena(&arena);
+    list = collectLinuxNetworkList(&arena);
+    getAllocStats(&after);
+    assert(list && after.allocCount == before.allocCount);
+
+    const NetworkAdapterInfo *lo = findAdapterByName(list, "lo");
+    assert(lo && lo->type == MIB_IF_TYPE_LOOPBACK && lo->index > 0);
+    BOOL found = FALSE;
+    for (UINT i = 0; i < lo->addressCount; i++)
+    {
+        const NetworkAddress *address = &list->addresses[lo->firstAddress + i];
+        if (strcmp(address->address, "127.0.0.1") == 0 && address->prefixLength == 8)
+            found = TRUE;
+    }
+    assert(found && strcmp(lo->ipAddress, "127.0.0.1") == 0);
+
+    sendLoopbackTraffic();
+    Sleep(TEST_TICK_MS);
+    resetSnapshotArena(&arena);
+    list = collectLinuxNetworkList(&arena);
+    lo = list ? findAdapterByName(list, "lo") : NULL;
+    assert(lo && lo->txPacketsPerSec > 0.0);
+    assert(lo->txBytesPerSec / lo->txPacketsPerSec >= TEST_DATAGRAM_SIZE / 2);
+    releaseSnapshotArena(&arena);
+
+    list = collectLinuxNetworkList(NULL);
+    assert(list);
+    freeNetworkList(list);
+
+    closeLinuxNetwork();
+    assert(collectLinuxNetworkList(NULL) == NULL);
+    getAllocStats(&after);
+    assert(after.currentBytes == start.currentBytes);
+
+    printf("Live socket test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests the adapter fields rendered in JSON
+ *
+ * This test validates:
+ * 1. Every adapter reports its operstate
+ * 2. Addresses are listed with their prefix, an empty array without any
+ * 3. Traffic rates, errors and drops follow the addresses
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_network_json(void)
+{
+    NetworkList *network = getFixtureCollectorBackend()->collectors.collectNetworkList(NULL);
+    assert(network);
+
+    char *json = generateSystemInfoJSON(NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+                                        network, NULL, NULL, NULL, NULL);
+    assert(json);
+    assert(strstr(json, "\"name\": \"Ethernet\",\n        \"mac_address\": \"00-1A-2B-3C-4D-50\",\n"));
+    assert(strstr(json, "\"status\": \"Connected\",\n        \"oper_state\": \"up\",\n"
+                        "        \"addresses\": [\"192.168.0.10/24\", \"fe80::21a:2bff:fe3c:4d50/64\"],\n"));
+    assert(strstr(json, "\"oper_state\": \"down\",\n        \"addresses\": [],\n"));
+    assert(strstr(json, "\"fe80::21a:2bff:fe3c:4d50/64\"],\n        \"rx_bytes_per_sec\": 11750000,\n"
+                        "        \"tx_bytes_per_sec\": 420000,\n        \"rx_packets_per_sec\": 8120.0,\n"));
+    assert(strstr(json, "\"rx_dropped\": 3,\n        \"tx_dropped\": 0\n      }"));
+    freeJSONString(json);
+    freeNetworkList(network);
+
+    printf("Network JSON test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Main test runner
+ *
+ * @return int 0 if all tests passed, 1 if any test failed
+ */
+int main(void)
+{
+    int testsPassed = 0;
+    int totalTests = 5;
+
+    g_root = createFixtureTree("network");
+
+    if (test_parse_dump())
+        testsPassed++;
+    if (test_compute_rates())
+        testsPassed++;
+    if (test_stats64_rates())
+        testsPassed++;
+    if (test_live_socket())
+        testsPassed++;
+    if (test_network_json())
+        testsPassed++;
+
+    removeFixtureTree();
+    printf("Tests passed: %d/%d\n", testsPassed, totalTests);
+    return testsPassed == totalTests ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+#include "system_info_dll.h"
+#include <stdio.h>
+#include <assert.h>
+
+/**
+ * @brief Tests engine overhead JSON output
+ *
+ * This test validates:
+ * 1. JSON data integrity
+ *    - Non-null data
+ *    - Non-empty string
+ *    - Contains "overhead" section
+ *
+ * 2. Required overhead fields
+ *    - Tick counter and duration
+ *    - Thread CPU time
+ *    - Context switches
+ *    - Heap allocations and peak usage
+ *
+ * The test is called as a callback by the monitoring system
+ * and validates the JSON structure matches MonitoringStats
+ *
+ * @param jsonData JSON-formatted system information string
+ */
+void test_overhead_info(const char *jsonData)
+{
+    assert(jsonData != NULL);
+    assert(strlen(jsonData) > 0);
+    assert(strstr(jsonData, "\"overhead\"") != NULL);
+
+    /**
+     * Validate important Overhead fields
+     *  check if tick and tick_ms are present
+     *  check if cpu_ms are present
+     *  check if context_switches are present
+     *  check if allocations and peak_heap_bytes are present
+     */
+    assert(strstr(jsonData, "\"tick\"") != NULL);
+    assert(strstr(jsonData, "\"tick_ms\"") != NULL);
+    assert(strstr(jsonData, "\"cpu_ms\"") != NULL);
+    assert(strstr(jsonData, "\"context_switches\"") != NULL);
+    assert(strstr(jsonData, "\"allocations\"") != NULL);
+    assert(strstr(jsonData, "\"peak_heap_bytes\"") != NULL);
+
+    printf("Overhead test passed\n");
+}
+
+/**
+ * @brief Test runner for engine overhead tests
+ *
+ * This function:
+ * 1. Sets up the test environment
+ *    - Enables overhead reporting
+ *    - Registers test callback
+ *    - Starts system monitoring
+ *
+ * 2. Executes test sequence
+ *    - Waits for data collection (300ms)
+ *    - Validates the stats API after at least one tick
+ *
+ * 3. Cleans up
+ *    - Stops monitoring
+ *    - Reports test results
+ *
+ * @return int 0 if all tests passed, 1 if any failed
+ */
+int main()
+{
+    int testsPassed = 0;
+    int totalTests = 2;
+
+    setOverheadReporting(TRUE);
+    setSystemInfoCallback(test_overhead_info);
+
+    if (startSystemMonitoring(100))
+    {
+        Sleep(300);
+        testsPassed++;
+
+        MonitoringStats stats;
+        if (getMonitoringStats(&stats) && stats.tickCount > 0)
+        {
+            assert(stats.lastTickMs >= 0.0);
+            assert(stats.totalCpuMs >= stats.lastTickCpuMs);
+            assert(stats.peakHeapBytes >= stats.lastTickPeakHeapBytes);
+            assert(stats.peakHeapBytes > 0);
+            testsPassed++;
+        }
+    }
+
+    stopSystemMonitoring();
+
+    printf("Tests passed: %d/%d\n", testsPassed, totalTests);
+    return (testsPassed == totalTests) ? 0 : 1;
+}
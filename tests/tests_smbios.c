@@ -0,0 +1,260 @@
+#include "smbios.h"
+#include "fest_alloc.h"
+#include "linux_sysfs.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#define GB (1024ULL * 1024 * 1024) // Module capacities are reported in bytes
+
+/**
+ * @brief Points the sysfs root at a captured fixture tree
+ *
+ * @param name Fixture directory below tests/fixtures
+ */
+static void useFixture(const char *name)
+{
+    char root[SYSFS_PATH_LENGTH];
+    _snprintf_s(root, sizeof(root), _TRUNCATE, "%s/%s", FEST_FIXTURE_DIR, name);
+    setSysfsRoot(root);
+}
+
+/**
+ * @brief Tests the table of a dual-socket server
+ *
+ * This test validates:
+ * 1. Board, BIOS and SKU strings come from types 0, 1 and 2
+ * 2. Only the 8 populated of 16 slots are listed
+ * 3. Speeds, locators and trimmed manufacturers of type 17
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_server(void)
+{
+    useFixture("xeon-2s");
+    MotherboardInfo *board = getSMBIOSMotherboardInfo();
+    assert(board);
+    assert(strcmp(board->manufacturer, "Supermicro") == 0);
+    assert(strcmp(board->productName, "X10DRi") == 0);
+    assert(strcmp(board->serialNumber, "NM167S012345") == 0);
+    assert(strcmp(board->biosVersion, "3.2") == 0);
+    assert(strcmp(board->biosSerial, "S214512X8A09216") == 0);
+    assert(strcmp(board->systemSKU, "Default string") == 0);
+    freeMotherboardInfo(board);
+
+    RAMSlotList *slots = getSMBIOSRAMSlotList();
+    assert(slots && slots->count == 8);
+    assert(strcmp(slots->slots[0].slot, "P1-DIMMA1") == 0);
+    assert(strcmp(slots->slots[7].slot, "P2-DIMMH1") == 0);
+    for (UINT i = 0; i < slots->count; i++)
+    {
+        assert(slots->slots[i].capacity == 16 * GB);
+        assert(slots->slots[i].speed == 2400 && slots->slots[i].configuredSpeed == 2133);
+        assert(strcmp(slots->slots[i].manufacturer, "Samsung") == 0);
+    }
+    freeRAMSlotList(slots);
+    setSysfsRoot(NULL);
+
+    printf("Server test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests the table of a desktop with 32 GB modules
+ *
+ * This test validates:
+ * 1. Sizes of 32 GB and more are read from Extended Size
+ * 2. The Linux motherboard collector prefers the SMBIOS table
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_extended_size(void)
+{
+    useFixture("ryzen-pstate");
+    RAMSlotList *slots = getSMBIOSRAMSlotList();
+    assert(slots && slots->count == 2);
+    assert(strcmp(slots->slots[0].slot, "DIMM_A2") == 0 && strcmp(slots->slots[1].slot, "DIMM_B2") == 0);
+    assert(slots->slots[0].capacity == 32 * GB && slots->slots[1].capacity == 32 * GB);
+    assert(slots->slots[1].speed == 3200 && slots->slots[1].configuredSpeed == 3200);
+    assert(strcmp(slots->slots[1].manufacturer, "Kingston") == 0);
+    freeRAMSlotList(slots);
+
+    MotherboardInfo *board = getLinuxMotherboardInfo();
+    assert(board);
+    assert(strcmp(board->productName, "TUF GAMING B550M-PLUS") == 0);
+    assert(strcmp(board->manufacturer, "ASUSTeK COMPUTER INC.") == 0);
+    assert(strcmp(board->biosVersion, "2803") == 0 && strcmp(board->systemSKU, "SKU") == 0);
+    freeMotherboardInfo(board);
+    setSysfsRoot(NULL);
+
+    printf("Extended size test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests a machine without SMBIOS
+ *
+ * This test validates:
+ * 1. Both getters fail without a table
+ * 2. The Linux motherboard collector falls back to /sys/class/dmi/id
+ * 3. Nothing is leaked on the failure paths
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_missing_table(void)
+{
+    AllocStats before, after;
+    getAllocStats(&before);
+
+    useFixture("rpi4");
+    assert(getSMBIOSMotherboardInfo() == NULL);
+    assert(getSMBIOSRAMSlotList() == NULL);
+    MotherboardInfo *board = getLinuxMotherboardInfo();
+    assert(board && board->productName[0] == '\0');
+    freeMotherboardInfo(board);
+    setSysfsRoot(NULL);
+
+    getAllocStats(&after);
+    assert(after.currentBytes == before.currentBytes);
+
+    printf("Missing table test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests structures firmware gets wrong
+ *
+ * This test validates:
+ * 1. KB granularity, unknown sizes and Extended Speed
+ * 2. A string number past the string set reads as empty
+ * 3. Only the first baseboard is reported
+ * 4. A truncated structure ends the walk without reading past the table
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_malformed(void)
+{
+    static const BYTE table[] = {
+        // Type 2, main board with a string number past its set
+        2, 8, 0x01, 0x00, 1, 2, 3, 4, 'M', 'a', 'i', 'n', 0, ' ', 'B', 'o', 'a', 'r', 'd', ' ', 0, 0,
+        // Type 2, daughter board
+        2, 8, 0x02, 0x00, 1, 1, 0, 0, 'R', 'i', 's', 'e', 'r', 0, 0,
+        // Type 17, 512 KB module with Extended Speed (SMBIOS 3.3 length 0x5C)
+        17, 0x5C, 0x03, 0x00, 0, 0, 0, 0, 0, 0, 0, 0, 0x00, 0x82, 0, 0, 1, 0, 0, 0, 0, 0xFF, 0xFF,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0xFF, 0xFF, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x40, 0x1F, 0, 0, 0x10, 0x27, 0, 0,
+        'S', '0', 0, 0,
+        // Type 17, SMBIOS 2.1 length without speeds, size unknown
+        17, 0x15, 0x04, 0x00, 0, 0, 0, 0, 0, 0, 0, 0, 0xFF, 0xFF, 0, 0, 1, 0, 0, 0, 0, 'S', '1', 0, 0,
+        // Type 17, string set running past the end of the table
+        17, 0x15, 0x05, 0x00, 0, 0, 0, 0, 0, 0, 0, 0, 0x00, 0x04, 0, 0, 1, 0, 0, 0, 0, 'S', '2'};
+
+    MotherboardInfo board;
+    RAMSlotList slots;
+    memset(&board, 0, sizeof(board));
+    assert(parseSMBIOSTable(table, sizeof(table), &board, &slots));
+    assert(strcmp(board.manufacturer, "Main") == 0 && strcmp(board.productName, "Board") == 0);
+    assert(board.serialNumber[0] == '\0');
+
+    assert(slots.count == 2);
+    assert(slots.slots[0].capacity == 512 * 1024);
+    assert(slots.slots[0].speed == 8000 && slots.slots[0].configuredSpeed == 10000);
+    assert(strcmp(slots.slots[0].slot, "S0") == 0);
+    assert(slots.slots[1].capacity == 0 && slots.slots[1].speed == 0);
+    assert(strcmp(slots.slots[1].slot, "S1") == 0);
+    festFree(slots.slots);
+
+    // A header claiming less than itself
+    static const BYTE broken[] = {17, 2, 0x00, 0x00, 0, 0};
+    assert(!parseSMBIOSTable(broken, sizeof(broken), &board, &slots));
+    assert(slots.count == 0 && slots.slots == NULL);
+
+    printf("Malformed test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests that the static collectors share one table read
+ *
+ * This test validates:
+ * 1. getSMBIOSInfo() fills board and slots from one read
+ * 2. Opening both collectors decodes the table once
+ * 3. The getters take the decoded results without rereading
+ * 4. Results no getter took are freed by the last close
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_shared_read(void)
+{
+    AllocStats before, after;
+    getAllocStats(&before);
+
+    useFixture("xeon-2s");
+    MotherboardInfo *board = NULL;
+    RAMSlotList *slots = NULL;
+    assert(getSMBIOSInfo(&board, &slots));
+    assert(board && strcmp(board->productName, "X10DRi") == 0);
+    assert(slots && slots->count == 8);
+    freeMotherboardInfo(board);
+    freeRAMSlotList(slots);
+
+    // Both collectors open before the table disappears
+    assert(openSMBIOSCollector());
+    assert(openSMBIOSCollector());
+    useFixture("rpi4");
+
+    board = getSMBIOSMotherboardInfo();
+    assert(board && strcmp(board->productName, "X10DRi") == 0);
+    freeMotherboardInfo(board);
+    slots = getSMBIOSRAMSlotList();
+    assert(slots && slots->count == 8);
+    freeRAMSlotList(slots);
+
+    // A second call rereads, and finds no table
+    assert(getSMBIOSMotherboardInfo() == NULL);
+    closeSMBIOSCollector();
+    closeSMBIOSCollector();
+
+    // Untaken results are released by the last close
+    useFixture("xeon-2s");
+    assert(openSMBIOSCollector());
+    assert(openSMBIOSCollector());
+    closeSMBIOSCollector();
+    slots = getSMBIOSRAMSlotList();
+    assert(slots && slots->count == 8);
+    freeRAMSlotList(slots);
+    closeSMBIOSCollector();
+    setSysfsRoot(NULL);
+
+    getAllocStats(&after);
+    assert(after.currentBytes == before.currentBytes);
+
+    printf("Shared read test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Main test runner
+ *
+ * @return int 0 if all tests passed, 1 if any test failed
+ */
+int main(void)
+{
+    int testsPassed = 0;
+    int totalTests = 5;
+
+    if (test_server())
+        testsPassed++;
+    if (test_extended_size())
+        testsPassed++;
+    if (test_missing_table())
+        testsPassed++;
+    if (test_malformed())
+        testsPassed++;
+    if (test_shared_read())
+        testsPassed++;
+
+    printf("Tests passed: %d/%d\n", testsPassed, totalTests);
+    return testsPassed == totalTests ? 0 : 1;
+}
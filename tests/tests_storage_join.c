@@ -0,0 +1,219 @@
+#include "storage_join.h"
+#include "fest_alloc.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#define SCALE_DISKS 200     // Disks of the scaling test
+#define SCALE_PARTITIONS 4  // Partitions per disk of the scaling test
+
+typedef struct
+{
+    char name[32];                     // Payload carried through the join
+    char deviceID[STORAGE_KEY_LENGTH]; // Join key
+} TestDisk;
+
+typedef struct
+{
+    char deviceID[STORAGE_KEY_LENGTH]; // Join key
+    UINT id;                           // Payload carried through the join
+} TestVolume;
+
+static TestDisk g_scaleDisks[SCALE_DISKS];
+static StorageLinkRow g_scaleDiskLinks[SCALE_DISKS * SCALE_PARTITIONS];
+static StorageLinkRow g_scaleVolumeLinks[SCALE_DISKS * SCALE_PARTITIONS];
+static TestVolume g_scaleVolumes[SCALE_DISKS * SCALE_PARTITIONS];
+
+/**
+ * @brief Describes the test tables to the join
+ */
+static StorageJoinInput makeInput(const TestDisk *disks, UINT diskCount,
+                                  const StorageLinkRow *diskLinks, UINT diskLinkCount,
+                                  const StorageLinkRow *volumeLinks, UINT volumeLinkCount,
+                                  const TestVolume *volumes, UINT volumeCount)
+{
+    StorageJoinInput input = {
+        {disks, diskCount, sizeof(TestDisk), offsetof(TestDisk, deviceID)},
+        diskLinks,
+        diskLinkCount,
+        volumeLinks,
+        volumeLinkCount,
+        {volumes, volumeCount, sizeof(TestVolume), offsetof(TestVolume, deviceID)}};
+    return input;
+}
+
+/**
+ * @brief Tests DeviceID extraction from association references
+ *
+ * This test validates:
+ * 1. Backslash escaping of the quoted key is removed
+ * 2. Keys without escapes are copied as they are
+ * 3. Unterminated and oversized keys are rejected
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_parse_object_key(void)
+{
+    char key[STORAGE_KEY_LENGTH];
+
+    assert(parseStorageObjectKey("\\\\HOST\\root\\cimv2:Win32_DiskDrive.DeviceID=\"\\\\\\\\.\\\\PHYSICALDRIVE0\"",
+                                 key, sizeof(key)));
+    assert(strcmp(key, "\\\\.\\PHYSICALDRIVE0") == 0);
+
+    assert(parseStorageObjectKey("\\\\HOST\\root\\cimv2:Win32_DiskPartition.DeviceID=\"Disk #0, Partition #1\"",
+                                 key, sizeof(key)));
+    assert(strcmp(key, "Disk #0, Partition #1") == 0);
+
+    assert(parseStorageObjectKey("Win32_LogicalDisk.DeviceID=\"C:\"", key, sizeof(key)));
+    assert(strcmp(key, "C:") == 0);
+
+    assert(!parseStorageObjectKey("Win32_LogicalDisk.DeviceID=\"C:", key, sizeof(key)));
+    assert(key[0] == '\0');
+    assert(!parseStorageObjectKey("Win32_LogicalDisk", key, sizeof(key)));
+
+    char small[3];
+    assert(!parseStorageObjectKey("Win32_LogicalDisk.DeviceID=\"C:\\\\\"", small, sizeof(small)));
+    assert(small[0] == '\0');
+
+    printf("Parse object key test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests the join on a small synthetic system
+ *
+ * This test validates:
+ * 1. Matches are grouped by disk, in link order
+ * 2. Keys compare case-insensitively
+ * 3. Dangling links and unknown volumes are skipped
+ * 4. Scratch tables are released on the heap path
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_join(void)
+{
+    static const TestDisk disks[] = {
+        {"system", "\\\\.\\PHYSICALDRIVE0"},
+        {"data", "\\\\.\\PHYSICALDRIVE1"},
+        {"empty", "\\\\.\\PHYSICALDRIVE2"}};
+    static const StorageLinkRow diskLinks[] = {
+        {"\\\\.\\PHYSICALDRIVE1", "Disk #1, Partition #0"},
+        {"\\\\.\\PHYSICALDRIVE0", "Disk #0, Partition #0"},
+        {"\\\\.\\physicaldrive0", "Disk #0, Partition #1"},
+        {"\\\\.\\PHYSICALDRIVE9", "Disk #9, Partition #0"}};
+    static const StorageLinkRow volumeLinks[] = {
+        {"Disk #0, Partition #1", "C:"},
+        {"DISK #1, PARTITION #0", "D:"},
+        {"Disk #1, Partition #0", "E:"},
+        {"Disk #0, Partition #0", "Z:"},
+        {"Disk #9, Partition #0", "F:"}};
+    static const TestVolume volumes[] = {
+        {"F:", 5},
+        {"e:", 4},
+        {"D:", 3},
+        {"C:", 2}};
+
+    AllocStats before, after;
+    getAllocStats(&before);
+
+    StorageJoinInput input = makeInput(disks, 3, diskLinks, 4, volumeLinks, 5, volumes, 4);
+    StorageJoinMatch *matches = NULL;
+    UINT matchCount = 0;
+    assert(joinStorageTables(&input, NULL, &matches, &matchCount));
+
+    // Z: has no volume row and disk 9 is not in the disk table
+    assert(matchCount == 3);
+    assert(matches[0].disk == 0 && volumes[matches[0].volume].id == 2);
+    assert(matches[1].disk == 1 && volumes[matches[1].volume].id == 3);
+    assert(matches[2].disk == 1 && volumes[matches[2].volume].id == 4);
+
+    snapshotFree(NULL, matches);
+    getAllocStats(&after);
+    assert(after.currentBytes == before.currentBytes);
+
+    // Empty tables join to nothing
+    input = makeInput(disks, 3, NULL, 0, NULL, 0, NULL, 0);
+    assert(joinStorageTables(&input, NULL, &matches, &matchCount));
+    assert(matches == NULL && matchCount == 0);
+
+    printf("Join test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests the join on many disks and partitions from an arena
+ *
+ * This test validates:
+ * 1. Every disk finds all of its volumes
+ * 2. Arena-backed joins do not touch the heap once the arena is warm
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_join_scale(void)
+{
+    UINT links = 0;
+    for (UINT d = 0; d < SCALE_DISKS; d++)
+    {
+        _snprintf_s(g_scaleDisks[d].deviceID, STORAGE_KEY_LENGTH, _TRUNCATE, "\\\\.\\PHYSICALDRIVE%u", d);
+        for (UINT p = 0; p < SCALE_PARTITIONS; p++, links++)
+        {
+            strcpy_s(g_scaleDiskLinks[links].antecedent, STORAGE_KEY_LENGTH, g_scaleDisks[d].deviceID);
+            _snprintf_s(g_scaleDiskLinks[links].dependent, STORAGE_KEY_LENGTH, _TRUNCATE, "Disk #%u, Partition #%u", d, p);
+            strcpy_s(g_scaleVolumeLinks[links].antecedent, STORAGE_KEY_LENGTH, g_scaleDiskLinks[links].dependent);
+            _snprintf_s(g_scaleVolumeLinks[links].dependent, STORAGE_KEY_LENGTH, _TRUNCATE, "V%u", links);
+            _snprintf_s(g_scaleVolumes[links].deviceID, STORAGE_KEY_LENGTH, _TRUNCATE, "V%u", links);
+            g_scaleVolumes[links].id = links;
+        }
+    }
+
+    SnapshotArena arena;
+    assert(initSnapshotArena(&arena, 1024));
+
+    StorageJoinInput input = makeInput(g_scaleDisks, SCALE_DISKS, g_scaleDiskLinks, links,
+                                       g_scaleVolumeLinks, links, g_scaleVolumes, links);
+    for (int pass = 0; pass < 3; pass++)
+    {
+        AllocStats before, after;
+        getAllocStats(&before);
+
+        StorageJoinMatch *matches = NULL;
+        UINT matchCount = 0;
+        assert(joinStorageTables(&input, &arena, &matches, &matchCount));
+        assert(matchCount == links);
+        for (UINT i = 0; i < matchCount; i++)
+        {
+            assert(matches[i].disk == i / SCALE_PARTITIONS);
+            assert(g_scaleVolumes[matches[i].volume].id == i);
+        }
+
+        resetSnapshotArena(&arena);
+        getAllocStats(&after);
+        if (pass == 2)
+            assert(after.allocCount == before.allocCount);
+    }
+
+    releaseSnapshotArena(&arena);
+    printf("Join scale test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Main test runner
+ *
+ * @return int 0 if all tests passed, 1 if any test failed
+ */
+int main(void)
+{
+    int testsPassed = 0;
+    int totalTests = 3;
+
+    if (test_parse_object_key())
+        testsPassed++;
+    if (test_join())
+        testsPassed++;
+    if (test_join_scale())
+        testsPassed++;
+
+    printf("Tests passed: %d/%d\n", testsPassed, totalTests);
+    return testsPassed == totalTests ? 0 : 1;
+}
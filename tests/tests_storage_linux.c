@@ -0,0 +1,326 @@
+#include "storage_info.h"
+#include "storage_topology.h"
+#include "fest_alloc.h"
+#include "linux_sysfs.h"
+#include "fixture_tree.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#define TEST_ARENA_SIZE 262144 // Snapshot memory of one tick
+#define DOCKER_VOLUMES 100     // Thin devices of the container host
+#define BIND_MOUNTS 300        // Bind mounts of the root device on the container host
+
+static const char *g_root = NULL;   // Fixture root of all tests
+static UINT64 g_mountSignature = 1; // Value of the fake signature source
+
+/**
+ * @brief Writes the sysfs attributes of a disk
+ *
+ * @param device Directory of the disk below /sys/devices
+ * @param model Device model, NULL for none
+ * @param sectors Size in 512-byte sectors
+ * @param rotational 1 for spinning disks
+ * @param removable 1 for removable media
+ */
+static void writeDisk(const char *device, const char *model, const char *sectors, const char *rotational,
+                      const char *removable)
+{
+    char path[SYSFS_PATH_LENGTH];
+    if (model)
+    {
+        _snprintf_s(path, sizeof(path), _TRUNCATE, "%s/device/model", device);
+        writeFixture(path, model);
+    }
+    _snprintf_s(path, sizeof(path), _TRUNCATE, "%s/size", device);
+    writeFixture(path, sectors);
+    _snprintf_s(path, sizeof(path), _TRUNCATE, "%s/queue/rotational", device);
+    writeFixture(path, rotational);
+    _snprintf_s(path, sizeof(path), _TRUNCATE, "%s/removable", device);
+    writeFixture(path, removable);
+}
+
+/**
+ * @brief Fake mount signature controlled by the tests
+ */
+static UINT64 readTestSignature(void)
+{
+    return g_mountSignature;
+}
+
+/**
+ * @brief Finds a volume by mount point
+ *
+ * @param list Collected volumes
+ * @param mountPoint Mount point to look for
+ * @return LogicalDiskInfo* Volume, NULL if not listed
+ */
+static LogicalDiskInfo *findVolume(StorageList *list, const char *mountPoint)
+{
+    for (UINT i = 0; i < list->count; i++)
+    {
+        if (strcmp(list->disks[i].mountPoint, mountPoint) == 0)
+            return &list->disks[i];
+    }
+    return NULL;
+}
+
+/**
+ * @brief Tests a desktop with NVMe, SATA, USB and VirtIO disks
+ *
+ * This test validates:
+ * 1. Pseudo filesystems, snap images and bind mounts are left out
+ * 2. Partitions are mapped to their disk through /sys/dev/block
+ * 3. Model, bus, rotational flag, removable type and disk size
+ * 4. Btrfs volumes are resolved by their source name
+ * 5. Escaped mount points and statvfs space below the root
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_desktop(void)
+{
+    const char *nvme = "/sys/devices/pci0000:00/0000:00:06.0/0000:02:00.0/nvme/nvme0/nvme0n1";
+    const char *sata = "/sys/devices/pci0000:00/0000:00:17.0/ata1/host0/target0:0:0/0:0:0:0/block/sda";
+    const char *usb = "/sys/devices/pci0000:00/0000:00:14.0/usb2/2-1/2-1:1.0/host6/target6:0:0/6:0:0:0/block/sdb";
+    const char *virtio = "/sys/devices/pci0000:00/0000:00:05.0/virtio2/block/vda";
+
+    writeDisk(nvme, "Samsung SSD 980 PRO 1TB\n", "1953525168\n", "0\n", "0\n");
+    writeFixture("/sys/devices/pci0000:00/0000:00:06.0/0000:02:00.0/nvme/nvme0/nvme0n1/nvme0n1p1/partition", "1\n");
+    writeFixture("/sys/devices/pci0000:00/0000:00:06.0/0000:02:00.0/nvme/nvme0/nvme0n1/nvme0n1p2/partition", "2\n");
+    writeDisk(sata, "ST2000DM008-2FR1\n", "3907029168\n", "1\n", "0\n");
+    writeFixture("/sys/devices/pci0000:00/0000:00:17.0/ata1/host0/target0:0:0/0:0:0:0/block/sda/sda1/partition", "1\n");
+    writeDisk(usb, "Ultra Fit       \n", "60063744\n", "0\n", "1\n");
+    writeFixture("/sys/devices/pci0000:00/0000:00:14.0/usb2/2-1/2-1:1.0/host6/target6:0:0/6:0:0:0/block/sdb/sdb1/partition", "1\n");
+    writeDisk(virtio, NULL, "209715200\n", "1\n", "0\n");
+
+    linkFixture("/sys/block/nvme0n1", "../devices/pci0000:00/0000:00:06.0/0000:02:00.0/nvme/nvme0/nvme0n1");
+    linkFixture("/sys/block/sda", "../devices/pci0000:00/0000:00:17.0/ata1/host0/target0:0:0/0:0:0:0/block/sda");
+    linkFixture("/sys/block/sdb", "../devices/pci0000:00/0000:00:14.0/usb2/2-1/2-1:1.0/host6/target6:0:0/6:0:0:0/block/sdb");
+    linkFixture("/sys/block/vda", "../devices/pci0000:00/0000:00:05.0/virtio2/block/vda");
+    linkFixture("/sys/class/block/vda", "../../devices/pci0000:00/0000:00:05.0/virtio2/block/vda");
+    linkFixture("/sys/dev/block/259:1", "../../devices/pci0000:00/0000:00:06.0/0000:02:00.0/nvme/nvme0/nvme0n1/nvme0n1p1");
+    linkFixture("/sys/dev/block/259:2", "../../devices/pci0000:00/0000:00:06.0/0000:02:00.0/nvme/nvme0/nvme0n1/nvme0n1p2");
+    linkFixture("/sys/dev/block/8:1", "../../devices/pci0000:00/0000:00:17.0/ata1/host0/target0:0:0/0:0:0:0/block/sda/sda1");
+    linkFixture("/sys/dev/block/8:17", "../../devices/pci0000:00/0000:00:14.0/usb2/2-1/2-1:1.0/host6/target6:0:0/6:0:0:0/block/sdb/sdb1");
+
+    makeFixtureDir("/boot/efi");
+    makeFixtureDir("/home");
+    makeFixtureDir("/media/usb stick");
+    writeFixture("/proc/self/mountinfo",
+                 "22 1 0:21 / /proc rw,nosuid,nodev,noexec,relatime shared:5 - proc proc rw\n"
+                 "23 1 0:22 / /sys rw,nosuid,nodev,noexec,relatime shared:6 - sysfs sysfs rw\n"
+                 "26 1 259:2 / / rw,relatime shared:1 - ext4 /dev/nvme0n1p2 rw,errors=remount-ro\n"
+                 "27 26 0:5 / /dev rw,nosuid,relatime shared:2 - devtmpfs udev rw,size=8123456k\n"
+                 "30 26 0:25 / /run rw,nosuid,nodev,noexec,relatime shared:9 - tmpfs tmpfs rw,size=1629164k\n"
+                 "45 26 7:0 / /snap/core22/1380 ro,nodev,relatime shared:21 - squashfs /dev/loop0 ro\n"
+                 "48 26 259:1 / /boot/efi rw,relatime shared:25 - vfat /dev/nvme0n1p1 rw,fmask=0077\n"
+                 "50 26 8:1 / /home rw,relatime shared:27 - ext4 /dev/sda1 rw\n"
+                 "52 26 0:45 / /data rw,relatime shared:29 - btrfs /dev/vda rw,space_cache=v2,subvol=/\n"
+                 "53 26 8:17 / /media/usb\\040stick rw,nosuid,nodev,relatime shared:31 - exfat /dev/sdb1 rw\n"
+                 "54 26 8:1 /alice/shared /srv/shared rw,relatime shared:27 - ext4 /dev/sda1 rw\n"
+                 "60 26 0:50 / /mnt/nas rw,relatime shared:33 - nfs4 nas:/export rw,vers=4.2\n");
+
+    setSysfsRoot(g_root);
+    setMountSignatureSource(readTestSignature);
+    StorageList *list = collectLinuxStorageList(NULL);
+    assert(list && list->count == 5);
+    assert(strcmp(list->disks[0].mountPoint, "/") == 0);
+
+    LogicalDiskInfo *system = findVolume(list, "/");
+    assert(strcmp(system->device, "nvme0n1p2") == 0 && strcmp(system->fileSystem, "ext4") == 0);
+    assert(strcmp(system->model, "Samsung SSD 980 PRO 1TB") == 0);
+    assert(strcmp(system->interfaceType, "NVMe") == 0 && !system->rotational);
+    assert(strcmp(system->type, "Local Disk") == 0 && strcmp(system->drive, "N/A") == 0);
+    assert(system->diskSize > 931.5 && system->diskSize < 931.6);
+    assert(system->totalSize > 0.0);
+
+    LogicalDiskInfo *efi = findVolume(list, "/boot/efi");
+    assert(strcmp(efi->device, "nvme0n1p1") == 0 && strcmp(efi->model, system->model) == 0);
+
+    LogicalDiskInfo *home = findVolume(list, "/home");
+    assert(strcmp(home->interfaceType, "SATA") == 0 && home->rotational);
+    assert(strcmp(home->model, "ST2000DM008-2FR1") == 0);
+
+    LogicalDiskInfo *stick = findVolume(list, "/media/usb stick");
+    assert(stick && strcmp(stick->interfaceType, "USB") == 0);
+    assert(strcmp(stick->type, "Removable Disk") == 0 && strcmp(stick->model, "Ultra Fit") == 0);
+
+    // Btrfs reports an anonymous device, /data is missing from the fixture
+    LogicalDiskInfo *data = findVolume(list, "/data");
+    assert(strcmp(data->device, "vda") == 0 && strcmp(data->interfaceType, "VirtIO") == 0);
+    assert(data->model[0] == '\0' && data->rotational);
+    assert(data->totalSize == 0.0);
+    freeStorageList(list);
+
+    releaseLinuxStorageTopology();
+    setMountSignatureSource(NULL);
+    setSysfsRoot(NULL);
+
+    printf("Desktop test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests a root-on-ZFS machine
+ *
+ * This test validates:
+ * 1. ZFS datasets are volumes although their source is not in /dev
+ * 2. Each dataset is named after its pool and has no disk
+ * 3. Network and pseudo filesystems stay excluded
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_zfs_pool(void)
+{
+    writeFixture("/proc/self/mountinfo",
+                 "26 1 0:24 / / rw,relatime shared:1 - zfs rpool/ROOT/ubuntu_k3v1 rw,xattr,posixacl\n"
+                 "27 26 0:5 / /dev rw,nosuid,relatime shared:2 - devtmpfs udev rw,size=8123456k\n"
+                 "30 26 0:25 / /run rw,nosuid,nodev,noexec,relatime shared:9 - tmpfs tmpfs rw,size=1629164k\n"
+                 "48 26 0:46 / /home rw,relatime shared:25 - zfs rpool/USERDATA/home_k3v1 rw,xattr\n"
+                 "50 26 0:48 / /tank rw,relatime shared:27 - zfs tank rw,xattr\n"
+                 "60 26 0:50 / /mnt/nas rw,relatime shared:33 - nfs4 nas:/export rw,vers=4.2\n");
+
+    setSysfsRoot(g_root);
+    setMountSignatureSource(readTestSignature);
+    g_mountSignature++;
+    StorageList *list = collectLinuxStorageList(NULL);
+    assert(list && list->count == 3);
+
+    LogicalDiskInfo *system = findVolume(list, "/");
+    assert(system && strcmp(system->device, "rpool") == 0 && strcmp(system->fileSystem, "zfs") == 0);
+    assert(strcmp(system->type, "Local Disk") == 0 && system->model[0] == '\0' && system->diskSize == 0.0);
+
+    LogicalDiskInfo *home = findVolume(list, "/home");
+    assert(home && strcmp(home->device, "rpool") == 0);
+
+    LogicalDiskInfo *tank = findVolume(list, "/tank");
+    assert(tank && strcmp(tank->device, "tank") == 0);
+    assert(findVolume(list, "/mnt/nas") == NULL);
+    freeStorageList(list);
+
+    releaseLinuxStorageTopology();
+    setMountSignatureSource(NULL);
+    setSysfsRoot(NULL);
+
+    printf("ZFS pool test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests a container host with hundreds of mounts
+ *
+ * This test validates:
+ * 1. Bind mounts of one device collapse into its root mount
+ * 2. Every thin device becomes one volume named after its mapping
+ * 3. Steady-state ticks reuse the topology and allocate nothing
+ * 4. A mount table change rebuilds the topology
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_container_host(void)
+{
+    static char mountinfo[256 * 1024];
+    size_t length = 0;
+    char line[512];
+    char relative[SYSFS_PATH_LENGTH];
+    char target[SYSFS_PATH_LENGTH];
+
+    // Container bind mounts come first, like a host whose root was remounted
+    for (UINT i = 0; i < BIND_MOUNTS; i++)
+    {
+        _snprintf_s(line, sizeof(line), _TRUNCATE,
+                    "%u 1 8:1 /var/lib/docker/containers/%04u/hosts /ctr/%04u/etc/hosts rw - ext4 /dev/sda1 rw\n"
+                    "%u 1 0:%u / /ctr/%04u/rootfs rw - overlay overlay rw,lowerdir=/l%u\n",
+                    1000 + 2 * i, i, i, 1001 + 2 * i, 100 + i, i, i);
+        memcpy(mountinfo + length, line, strlen(line));
+        length += strlen(line);
+    }
+    _snprintf_s(line, sizeof(line), _TRUNCATE, "26 1 8:1 / / rw - ext4 /dev/sda1 rw\n");
+    memcpy(mountinfo + length, line, strlen(line));
+    length += strlen(line);
+
+    for (UINT i = 0; i < DOCKER_VOLUMES; i++)
+    {
+        _snprintf_s(line, sizeof(line), _TRUNCATE,
+                    "%u 26 253:%u / /var/lib/docker/devicemapper/mnt/%04u rw - xfs /dev/mapper/docker-%04u rw\n",
+                    3000 + i, i, i, i);
+        memcpy(mountinfo + length, line, strlen(line));
+        length += strlen(line);
+
+        _snprintf_s(relative, sizeof(relative), _TRUNCATE, "/sys/devices/virtual/block/dm-%u/dm/name", i);
+        _snprintf_s(line, sizeof(line), _TRUNCATE, "docker-%04u\n", i);
+        writeFixture(relative, line);
+        _snprintf_s(relative, sizeof(relative), _TRUNCATE, "/sys/dev/block/253:%u", i);
+        _snprintf_s(target, sizeof(target), _TRUNCATE, "../../devices/virtual/block/dm-%u", i);
+        linkFixture(relative, target);
+        _snprintf_s(relative, sizeof(relative), _TRUNCATE, "/sys/block/dm-%u", i);
+        linkFixture(relative, target + 3);
+    }
+    mountinfo[length] = '\0';
+    writeFixture("/proc/self/mountinfo", mountinfo);
+
+    AllocStats start, before, after;
+    getAllocStats(&start);
+    SnapshotArena arena;
+    assert(initSnapshotArena(&arena, TEST_ARENA_SIZE));
+    setSysfsRoot(g_root);
+    setMountSignatureSource(readTestSignature);
+
+    StorageList *list = collectLinuxStorageList(&arena);
+    assert(list && list->count == 1 + DOCKER_VOLUMES);
+    assert(strcmp(list->disks[0].mountPoint, "/") == 0 && strcmp(list->disks[0].device, "sda1") == 0);
+    LogicalDiskInfo *last = &list->disks[DOCKER_VOLUMES];
+    assert(strcmp(last->device, "dm-99") == 0 && strcmp(last->model, "docker-0099") == 0);
+    assert(strcmp(last->interfaceType, "Virtual") == 0 && strcmp(last->fileSystem, "xfs") == 0);
+
+    getAllocStats(&before);
+    for (UINT tick = 0; tick < 3; tick++)
+    {
+        resetSnapshotArena(&arena);
+        list = collectLinuxStorageList(&arena);
+        assert(list && list->count == 1 + DOCKER_VOLUMES);
+    }
+    getAllocStats(&after);
+    assert(after.allocCount == before.allocCount);
+
+    // Every container stopped
+    writeFixture("/proc/self/mountinfo", "26 1 8:1 / / rw - ext4 /dev/sda1 rw\n");
+    g_mountSignature++;
+    resetSnapshotArena(&arena);
+    list = collectLinuxStorageList(&arena);
+    assert(list && list->count == 1);
+
+    releaseLinuxStorageTopology();
+    setMountSignatureSource(NULL);
+    setSysfsRoot(NULL);
+    releaseSnapshotArena(&arena);
+    getAllocStats(&after);
+    assert(after.currentBytes == start.currentBytes);
+
+    printf("Container host test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Main test runner
+ *
+ * @return int 0 if all tests passed, 1 if any test failed
+ */
+int main(void)
+{
+    int testsPassed = 0;
+    int totalTests = 3;
+
+    g_root = createFixtureTree("storage");
+
+    if (test_desktop())
+        testsPassed++;
+    if (test_zfs_pool())
+        testsPassed++;
+    if (test_container_host())
+        testsPassed++;
+
+    removeFixtureTree();
+    printf("Tests passed: %d/%d\n", testsPassed, totalTests);
+    return testsPassed == totalTests ? 0 : 1;
+}
@@ -0,0 +1,286 @@
+#include "storage_topology.h"
+#include "fest_alloc.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#ifdef _WIN32
+#define TEST_MOUNT_POINT "C:\\"
+#else
+#define TEST_MOUNT_POINT "/"
+#endif
+
+static UINT g_builds = 0;            // Calls of the fake builder
+static BOOL g_buildFails = FALSE;    // Makes the fake builder fail
+static UINT64 g_mountSignature = 1;  // Value of the fake signature source
+
+/**
+ * @brief Builds a topology of three disks
+ *
+ * Disk 0 is mounted at the filesystem root, disk 1 has no
+ * volume and disk 2 points at a mount point that does not exist
+ */
+static BOOL buildTestTopology(StorageTopology *topology)
+{
+    g_builds++;
+    topology->entries = NULL;
+    topology->count = 0;
+    if (g_buildFails)
+        return FALSE;
+
+    topology->entries = (StorageVolumeEntry *)festMalloc(sizeof(StorageVolumeEntry) * 3);
+    if (!topology->entries)
+        return FALSE;
+
+    memset(topology->entries, 0, sizeof(StorageVolumeEntry) * 3);
+    for (UINT i = 0; i < 3; i++)
+    {
+        _snprintf_s(topology->entries[i].info.model, sizeof(topology->entries[i].info.model), _TRUNCATE, "Disk %u", i);
+        topology->entries[i].info.totalSize = 100.0 + i;
+        topology->entries[i].info.freeSpace = 1.0;
+    }
+    strcpy_s(topology->entries[0].mountPoint, STORAGE_MOUNT_PATH_LENGTH, TEST_MOUNT_POINT);
+    strcpy_s(topology->entries[2].mountPoint, STORAGE_MOUNT_PATH_LENGTH, "/nonexistent/fest/volume");
+    topology->count = 3;
+    return TRUE;
+}
+
+/**
+ * @brief Fake mount signature controlled by the tests
+ */
+static UINT64 readTestSignature(void)
+{
+    return g_mountSignature;
+}
+
+/**
+ * @brief Frees a heap storage list without the WMI collector module
+ */
+static void freeTestList(StorageList *list)
+{
+    if (list)
+    {
+        festFree(list->disks);
+        festFree(list);
+    }
+}
+
+static StorageTopologyCache g_cache = STORAGE_TOPOLOGY_CACHE_INIT(buildTestTopology);
+
+/**
+ * @brief Fails the first build after filling part of the topology
+ *
+ * Stands in for a WMI build whose link or volume query timed
+ * out or was cancelled after the disks were read
+ */
+static BOOL buildPartialOnceTopology(StorageTopology *topology)
+{
+    static BOOL failed = FALSE;
+    if (failed)
+        return buildTestTopology(topology);
+
+    failed = TRUE;
+    g_builds++;
+    topology->entries = (StorageVolumeEntry *)festMalloc(sizeof(StorageVolumeEntry));
+    assert(topology->entries);
+    memset(topology->entries, 0, sizeof(StorageVolumeEntry));
+    topology->count = 1;
+    return FALSE;
+}
+
+/**
+ * @brief Tests that the topology is built once and space refreshed every time
+ *
+ * This test validates:
+ * 1. Repeated collections reuse one topology
+ * 2. Mounted volumes get their size from the filesystem
+ * 3. Entries without a readable volume keep the topology values
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_refresh_reuses_topology(void)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        StorageList *list = collectStorageSpace(&g_cache, NULL);
+        assert(list && list->count == 3);
+        assert(strcmp(list->disks[1].model, "Disk 1") == 0);
+
+        assert(list->disks[0].totalSize > 0.0 && list->disks[0].totalSize != 100.0);
+        assert(list->disks[0].freeSpace <= list->disks[0].totalSize);
+        assert(list->disks[1].totalSize == 101.0 && list->disks[1].freeSpace == 1.0);
+        assert(list->disks[2].totalSize == 102.0 && list->disks[2].freeSpace == 1.0);
+        freeTestList(list);
+    }
+
+    StorageTopologyStats stats;
+    getStorageTopologyCacheStats(&g_cache, &stats);
+    assert(g_builds == 1 && stats.builds == 1);
+    assert(stats.refreshes == 3);
+    assert(stats.spaceFailures == 3);
+    assert(stats.invalidations == 0);
+
+    printf("Refresh reuses topology test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests invalidation on mount changes
+ *
+ * This test validates:
+ * 1. A changed mount signature rebuilds the topology once
+ * 2. Explicit invalidation rebuilds it on the next collection
+ * 3. A failed build returns NULL and is retried
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_mount_change_invalidates(void)
+{
+    g_mountSignature++;
+    freeTestList(collectStorageSpace(&g_cache, NULL));
+    freeTestList(collectStorageSpace(&g_cache, NULL));
+    assert(g_builds == 2);
+
+    invalidateStorageTopologyCache(&g_cache);
+    freeTestList(collectStorageSpace(&g_cache, NULL));
+    assert(g_builds == 3);
+
+    StorageTopologyStats stats;
+    getStorageTopologyCacheStats(&g_cache, &stats);
+    assert(stats.invalidations == 2);
+
+    g_mountSignature++;
+    g_buildFails = TRUE;
+    assert(collectStorageSpace(&g_cache, NULL) == NULL);
+    g_buildFails = FALSE;
+    StorageList *list = collectStorageSpace(&g_cache, NULL);
+    assert(list && list->count == 3);
+    freeTestList(list);
+    assert(g_builds == 5);
+
+    printf("Mount change invalidates test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests that a build failing once leaves nothing cached
+ *
+ * This test validates:
+ * 1. The partial topology of a failed build is freed, not kept
+ * 2. The next collection rebuilds instead of serving the partial topology
+ * 3. Only the successful build is counted and reused afterwards
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_failed_build_not_cached(void)
+{
+    StorageTopologyCache cache = STORAGE_TOPOLOGY_CACHE_INIT(buildPartialOnceTopology);
+    UINT buildsBefore = g_builds;
+
+    AllocStats before, after;
+    getAllocStats(&before);
+    assert(collectStorageSpace(&cache, NULL) == NULL);
+    getAllocStats(&after);
+    assert(after.currentBytes == before.currentBytes);
+    assert(!cache.valid && cache.topology.entries == NULL && cache.topology.count == 0);
+
+    StorageList *list = collectStorageSpace(&cache, NULL);
+    assert(list && list->count == 3);
+    freeTestList(list);
+    list = collectStorageSpace(&cache, NULL);
+    assert(list && list->count == 3);
+    freeTestList(list);
+    assert(g_builds == buildsBefore + 2);
+
+    StorageTopologyStats stats;
+    getStorageTopologyCacheStats(&cache, &stats);
+    assert(stats.builds == 1 && stats.refreshes == 2);
+    releaseStorageTopologyCache(&cache);
+
+    printf("Failed build not cached test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests that steady-state collection into an arena does not allocate
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_arena_refresh(void)
+{
+    SnapshotArena arena;
+    assert(initSnapshotArena(&arena, 4096));
+
+    UINT buildsBefore = g_builds;
+    AllocStats before, after;
+    getAllocStats(&before);
+    for (int i = 0; i < 10; i++)
+    {
+        StorageList *list = collectStorageSpace(&g_cache, &arena);
+        assert(list && list->count == 3);
+        resetSnapshotArena(&arena);
+    }
+    getAllocStats(&after);
+    assert(after.allocCount == before.allocCount);
+    assert(g_builds == buildsBefore);
+
+    releaseSnapshotArena(&arena);
+    printf("Arena refresh test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests the platform mount signature and volume query
+ *
+ * This test validates:
+ * 1. The signature is stable while nothing is mounted
+ * 2. The filesystem root reports a size
+ * 3. Missing mount points are rejected
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_platform_sources(void)
+{
+    UINT64 first = getMountSignature();
+    assert(getMountSignature() == first);
+
+    UINT64 totalBytes = 0, freeBytes = 0;
+    assert(queryVolumeSpace(TEST_MOUNT_POINT, &totalBytes, &freeBytes));
+    assert(totalBytes > 0 && freeBytes <= totalBytes);
+    assert(!queryVolumeSpace("/nonexistent/fest/volume", &totalBytes, &freeBytes));
+    assert(!queryVolumeSpace("", &totalBytes, &freeBytes));
+
+    printf("Platform sources test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Main test runner
+ *
+ * @return int 0 if all tests passed, 1 if any test failed
+ */
+int main(void)
+{
+    int testsPassed = 0;
+    int totalTests = 5;
+
+    setMountSignatureSource(readTestSignature);
+
+    if (test_refresh_reuses_topology())
+        testsPassed++;
+    if (test_mount_change_invalidates())
+        testsPassed++;
+    if (test_arena_refresh())
+        testsPassed++;
+    if (test_failed_build_not_cached())
+        testsPassed++;
+
+    setMountSignatureSource(NULL);
+    releaseStorageTopologyCache(&g_cache);
+
+    if (test_platform_sources())
+        testsPassed++;
+
+    printf("Tests passed: %d/%d\n", testsPassed, totalTests);
+    return testsPassed == totalTests ? 0 : 1;
+}
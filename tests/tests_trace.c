@@ -0,0 +1,153 @@
+#include "system_info_dll.h"
+#include "fest_alloc.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#define TRACE_FILE "fest_trace.json"
+#define TRACE_BUFFER_BYTES (256 * 1024) // Lower bound of one thread's event buffer
+
+/**
+ * @brief Callback that discards system information
+ *
+ * The trace test only needs ticks to run, the JSON
+ * content is validated by the component tests
+ *
+ * @param jsonData JSON-formatted system information string
+ */
+void ignore_json(const char *jsonData)
+{
+    assert(jsonData != NULL);
+}
+
+/**
+ * @brief Tests Chrome trace-event export
+ *
+ * This test validates:
+ * 1. Trace file integrity
+ *    - File can be written and read back
+ *    - Contains "traceEvents" array
+ *
+ * 2. Required spans
+ *    - Whole tick
+ *    - Dynamic collectors (memory, storage, battery, network)
+ *    - JSON generation and callback delivery
+ *
+ * @return BOOL TRUE if all spans were found
+ */
+BOOL test_trace_file(void)
+{
+    static char content[1024 * 1024];
+    FILE *file = NULL;
+    if (fopen_s(&file, TRACE_FILE, "r") != 0 || !file)
+        return FALSE;
+
+    size_t length = fread(content, 1, sizeof(content) - 1, file);
+    content[length] = '\0';
+    fclose(file);
+
+    assert(strstr(content, "\"traceEvents\"") != NULL);
+
+    /**
+     * Validate important spans
+     *  check if tick spans are present
+     *  check if collector spans are present
+     *  check if json and callback spans are present
+     *  check if begin and end phases are present
+     */
+    assert(strstr(content, "\"name\": \"tick\"") != NULL);
+    assert(strstr(content, "\"name\": \"memory\"") != NULL);
+    assert(strstr(content, "\"name\": \"storage\"") != NULL);
+    assert(strstr(content, "\"name\": \"battery\"") != NULL);
+    assert(strstr(content, "\"name\": \"network\"") != NULL);
+    assert(strstr(content, "\"name\": \"json\"") != NULL);
+    assert(strstr(content, "\"name\": \"callback\"") != NULL);
+    assert(strstr(content, "\"ph\": \"B\"") != NULL);
+    assert(strstr(content, "\"ph\": \"E\"") != NULL);
+
+    printf("Trace test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests that a new capture reuses the buffer of an exited thread
+ *
+ * This test validates:
+ * 1. Buffer recycling
+ *    - A second capture runs on a new monitoring thread
+ *    - The thread takes over the buffer released by the previous one
+ *    - Live heap does not grow by another event buffer
+ *
+ * 2. Export of the recycled buffer
+ *    - The second capture still exports the tick spans
+ *
+ * @return BOOL TRUE if the buffer was reused
+ */
+BOOL test_buffer_reuse(void)
+{
+    AllocStats before, after;
+    getAllocStats(&before);
+
+    setTracingEnabled(TRUE);
+    if (!startSystemMonitoring(100))
+        return FALSE;
+    Sleep(300);
+    stopSystemMonitoring();
+    setTracingEnabled(FALSE);
+
+    getAllocStats(&after);
+    assert(after.currentBytes < before.currentBytes + TRACE_BUFFER_BYTES);
+
+    if (!writeTraceFile(TRACE_FILE) || !test_trace_file())
+        return FALSE;
+
+    printf("Buffer reuse test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Test runner for trace export tests
+ *
+ * This function:
+ * 1. Sets up the test environment
+ *    - Enables tracing
+ *    - Starts system monitoring
+ *
+ * 2. Executes test sequence
+ *    - Waits for data collection (300ms)
+ *    - Stops monitoring and exports the trace
+ *    - Validates the exported file
+ *    - Repeats the capture on a new thread to check buffer reuse
+ *
+ * 3. Cleans up
+ *    - Disables tracing
+ *    - Reports test results
+ *
+ * @return int 0 if all tests passed, 1 if any failed
+ */
+int main()
+{
+    int testsPassed = 0;
+    int totalTests = 3;
+
+    setTracingEnabled(TRUE);
+    setSystemInfoCallback(ignore_json);
+
+    if (startSystemMonitoring(100))
+    {
+        Sleep(300);
+        testsPassed++;
+    }
+
+    stopSystemMonitoring();
+    setTracingEnabled(FALSE);
+
+    if (writeTraceFile(TRACE_FILE) && test_trace_file())
+        testsPassed++;
+
+    if (test_buffer_reuse())
+        testsPassed++;
+
+    printf("Tests passed: %d/%d\n", testsPassed, totalTests);
+    return (testsPassed == totalTests) ? 0 : 1;
+}
@@ -0,0 +1,294 @@
+#include "utf8_transcode.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#define FUZZ_LENGTH 80   // Code units per generated string
+#define FUZZ_ROUNDS 2000 // Generated strings compared against the reference
+
+/**
+ * @brief Straightforward UTF-16 to UTF-8 reference without fast path
+ *
+ * @return size_t Bytes written, terminator excluded
+ */
+static size_t referenceUtf16ToUtf8(const WORD *src, size_t srcLength, char *dst, size_t dstSize)
+{
+    size_t out = 0;
+    for (size_t in = 0; in < srcLength; in++)
+    {
+        UINT codePoint = src[in];
+        if (codePoint >= 0xD800 && codePoint <= 0xDBFF && in + 1 < srcLength &&
+            src[in + 1] >= 0xDC00 && src[in + 1] <= 0xDFFF)
+        {
+            codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (src[in + 1] - 0xDC00);
+            in++;
+        }
+        else if (codePoint >= 0xD800 && codePoint <= 0xDFFF)
+        {
+            codePoint = 0xFFFD;
+        }
+
+        BYTE bytes[4];
+        size_t length;
+        if (codePoint < 0x80)
+        {
+            bytes[0] = (BYTE)codePoint;
+            length = 1;
+        }
+        else if (codePoint < 0x800)
+        {
+            bytes[0] = (BYTE)(0xC0 | (codePoint >> 6));
+            bytes[1] = (BYTE)(0x80 | (codePoint & 0x3F));
+            length = 2;
+        }
+        else if (codePoint < 0x10000)
+        {
+            bytes[0] = (BYTE)(0xE0 | (codePoint >> 12));
+            bytes[1] = (BYTE)(0x80 | ((codePoint >> 6) & 0x3F));
+            bytes[2] = (BYTE)(0x80 | (codePoint & 0x3F));
+            length = 3;
+        }
+        else
+        {
+            bytes[0] = (BYTE)(0xF0 | (codePoint >> 18));
+            bytes[1] = (BYTE)(0x80 | ((codePoint >> 12) & 0x3F));
+            bytes[2] = (BYTE)(0x80 | ((codePoint >> 6) & 0x3F));
+            bytes[3] = (BYTE)(0x80 | (codePoint & 0x3F));
+            length = 4;
+        }
+
+        if (out + length > dstSize - 1)
+            break;
+        memcpy(dst + out, bytes, length);
+        out += length;
+    }
+    dst[out] = '\0';
+    return out;
+}
+
+/**
+ * @brief Converts and checks the result against an expected byte string
+ */
+static void expectUtf16(const WORD *src, size_t srcLength, size_t dstSize, const char *expected)
+{
+    char dst[256];
+    memset(dst, 0x55, sizeof(dst));
+    size_t written = utf16ToUtf8(src, srcLength, dst, dstSize);
+    assert(written == strlen(expected));
+    assert(strcmp(dst, expected) == 0);
+    assert(dst[written + 1] == 0x55 || written + 1 >= dstSize);
+}
+
+/**
+ * @brief Tests the ASCII fast path at every length and alignment
+ *
+ * This test validates:
+ * 1. Runs shorter than, equal to and longer than a SIMD block
+ * 2. Unaligned source and destination pointers
+ * 3. A non-ASCII unit at every position of a block
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_ascii_blocks(void)
+{
+    WORD source[FUZZ_LENGTH + 8];
+    char dst[FUZZ_LENGTH * 3 + 16];
+    char expected[FUZZ_LENGTH * 3 + 16];
+
+    for (size_t offset = 0; offset < 3; offset++)
+    {
+        for (size_t length = 0; length <= FUZZ_LENGTH; length++)
+        {
+            for (size_t i = 0; i < length; i++)
+                source[offset + i] = (WORD)(' ' + (i % 90));
+
+            size_t written = utf16ToUtf8(source + offset, length, dst + offset, sizeof(dst) - offset);
+            assert(written == length);
+            for (size_t i = 0; i < length; i++)
+                assert(dst[offset + i] == (char)source[offset + i]);
+            assert(dst[offset + length] == '\0');
+
+            // One non-ASCII unit anywhere must leave the run before it intact
+            for (size_t at = 0; at < length; at++)
+            {
+                WORD saved = source[offset + at];
+                source[offset + at] = 0x00E9;
+                size_t got = utf16ToUtf8(source + offset, length, dst, sizeof(dst));
+                size_t want = referenceUtf16ToUtf8(source + offset, length, expected, sizeof(expected));
+                assert(got == want && memcmp(dst, expected, want + 1) == 0);
+                source[offset + at] = saved;
+            }
+        }
+    }
+
+    printf("ASCII blocks test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests multi-byte sequences and surrogate handling
+ *
+ * This test validates:
+ * 1. Two, three and four byte sequences
+ * 2. Surrogate pairs are combined
+ * 3. Unpaired surrogates become U+FFFD
+ * 4. Non-ASCII vendor names survive a round trip to UTF-8
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_sequences(void)
+{
+    static const WORD twoByte[] = {'C', 'a', 'f', 0x00E9};
+    static const WORD threeByte[] = {0x20AC, '1', '0'};
+    static const WORD pair[] = {'x', 0xD83D, 0xDE00, 'y'};
+    static const WORD loneHigh[] = {0xD83D, 'a'};
+    static const WORD loneLow[] = {'a', 0xDE00};
+    static const WORD highAtEnd[] = {'a', 0xD83D};
+    static const WORD swapped[] = {0xDE00, 0xD83D};
+    static const WORD vendor[] = {0x682A, 0x5F0F, 0x4F1A, 0x793E, ' ', 'B', 'u', 'f', 'f', 'a', 'l', 'o'};
+
+    expectUtf16(twoByte, 4, 256, "Caf\xC3\xA9");
+    expectUtf16(threeByte, 3, 256, "\xE2\x82\xAC" "10");
+    expectUtf16(pair, 4, 256, "x\xF0\x9F\x98\x80y");
+    expectUtf16(loneHigh, 2, 256, "\xEF\xBF\xBD" "a");
+    expectUtf16(loneLow, 2, 256, "a\xEF\xBF\xBD");
+    expectUtf16(highAtEnd, 2, 256, "a\xEF\xBF\xBD");
+    expectUtf16(swapped, 2, 256, "\xEF\xBF\xBD\xEF\xBF\xBD");
+    expectUtf16(vendor, 12, 256, "\xE6\xA0\xAA\xE5\xBC\x8F\xE4\xBC\x9A\xE7\xA4\xBE Buffalo");
+
+    printf("Sequences test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests truncation at the end of the buffer
+ *
+ * This test validates:
+ * 1. Sequences are never split
+ * 2. The output is always terminated
+ * 3. Empty and missing buffers are handled
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_truncation(void)
+{
+    static const WORD text[] = {'a', 0x00E9, 0x20AC, 0xD83D, 0xDE00};
+
+    expectUtf16(text, 5, 11, "a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80");
+    expectUtf16(text, 5, 10, "a\xC3\xA9\xE2\x82\xAC");
+    expectUtf16(text, 5, 7, "a\xC3\xA9\xE2\x82\xAC");
+    expectUtf16(text, 5, 6, "a\xC3\xA9");
+    expectUtf16(text, 5, 3, "a");
+    expectUtf16(text, 5, 1, "");
+    expectUtf16(text, 0, 8, "");
+    expectUtf16(NULL, 5, 8, "");
+
+    char untouched = 'x';
+    assert(utf16ToUtf8(text, 5, &untouched, 0) == 0 && untouched == 'x');
+    assert(utf16ToUtf8(text, 5, NULL, 8) == 0);
+
+    // Truncating inside an ASCII run stops exactly at the buffer end
+    WORD ascii[40];
+    for (int i = 0; i < 40; i++)
+        ascii[i] = (WORD)('A' + i % 26);
+    char dst[40];
+    assert(utf16ToUtf8(ascii, 40, dst, 20) == 19);
+    assert(strncmp(dst, "ABCDEFGHIJKLMNOPQRS", 20) == 0);
+
+    printf("Truncation test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests generated strings against the reference converter
+ *
+ * Strings mix ASCII runs, BMP characters and surrogates,
+ * paired or not, so every path meets every other path.
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_against_reference(void)
+{
+    static const WORD samples[] = {0x00E9, 0x07FF, 0x0800, 0x4E2D, 0xFFFD, 0xFFFF, 0xD800, 0xDBFF, 0xDC00, 0xDFFF};
+    UINT seed = 12345;
+    WORD source[FUZZ_LENGTH];
+    char dst[FUZZ_LENGTH * 3 + 1];
+    char expected[FUZZ_LENGTH * 3 + 1];
+
+    for (int round = 0; round < FUZZ_ROUNDS; round++)
+    {
+        for (int i = 0; i < FUZZ_LENGTH; i++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            UINT pick = (seed >> 16) % 32;
+            source[i] = (pick < 30) ? (WORD)('a' + pick % 26) : samples[(seed >> 8) % 10];
+        }
+
+        size_t dstSize = 1 + (seed >> 4) % sizeof(dst);
+        size_t got = utf16ToUtf8(source, FUZZ_LENGTH, dst, dstSize);
+        size_t want = referenceUtf16ToUtf8(source, FUZZ_LENGTH, expected, dstSize);
+        assert(got == want);
+        assert(memcmp(dst, expected, want + 1) == 0);
+    }
+
+    printf("Reference comparison test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests conversion of native wide strings
+ *
+ * This test validates:
+ * 1. Terminated wide strings convert like UTF-16
+ * 2. NULL converts as an empty string
+ * 3. Long ASCII strings cross the fast path intact
+ * 4. Out of range UTF-32 values become U+FFFD where wchar_t is 32-bit
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_wide(void)
+{
+    char dst[128];
+
+    assert(wideToUtf8(L"Samsung SSD 980 PRO 1TB (NVMe) controller", dst, sizeof(dst)) == 41);
+    assert(strcmp(dst, "Samsung SSD 980 PRO 1TB (NVMe) controller") == 0);
+
+    assert(wideToUtf8(L"Caf\x00E9 \x20AC", dst, sizeof(dst)) == 9);
+    assert(strcmp(dst, "Caf\xC3\xA9 \xE2\x82\xAC") == 0);
+
+    assert(wideToUtf8(NULL, dst, sizeof(dst)) == 0 && dst[0] == '\0');
+
+#if WCHAR_MAX > 0xFFFF
+    const wchar_t utf32[] = {'a', (wchar_t)0x1F600, (wchar_t)0xD800, (wchar_t)0x110000, 'b', 0};
+    assert(wideToUtf8(utf32, dst, sizeof(dst)) == 12);
+    assert(strcmp(dst, "a\xF0\x9F\x98\x80\xEF\xBF\xBD\xEF\xBF\xBD" "b") == 0);
+#endif
+
+    printf("Wide string test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Main test runner
+ *
+ * @return int 0 if all tests passed, 1 if any test failed
+ */
+int main(void)
+{
+    int testsPassed = 0;
+    int totalTests = 5;
+
+    if (test_ascii_blocks())
+        testsPassed++;
+    if (test_sequences())
+        testsPassed++;
+    if (test_truncation())
+        testsPassed++;
+    if (test_against_reference())
+        testsPassed++;
+    if (test_wide())
+        testsPassed++;
+
+    printf("Tests passed: %d/%d\n", testsPassed, totalTests);
+    return testsPassed == totalTests ? 0 : 1;
+}
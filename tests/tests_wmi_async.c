@@ -0,0 +1,285 @@
+#include "wmi_helper.h"
+#include "fake_wbem.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#define ROW_COUNT 40           // Objects returned by every fake query
+#define QUERY_DELAY_MS 150     // Delay of a slow provider
+#define STALLED_DELAY_MS 60000 // Delay of a provider that never answers in time
+
+typedef struct
+{
+    char name[32]; // Name property of the object
+} TestRow;
+
+static const WMIPropertySpec g_properties[] = {
+    WMI_STRING_PROPERTY(L"Name", TestRow, name)};
+
+static const WMIQuerySpec g_query = {
+    L"Win32_Test", g_properties, WMI_PROPERTY_COUNT(g_properties), NULL};
+
+static wchar_t g_names[ROW_COUNT][32];
+static FakeWbemProperty g_fakeProperties[ROW_COUNT];
+static FakeWbemRow g_rows[ROW_COUNT];
+
+/**
+ * @brief Decodes the Name property
+ */
+static BOOL decodeTestRow(IWbemClassObject *pclsObj, void *row, void *context)
+{
+    return getWMIPropertyString(pclsObj, L"Name", ((TestRow *)row)->name, sizeof(((TestRow *)row)->name));
+}
+
+/**
+ * @brief Decoder cancelling every query once the first row arrived
+ */
+static BOOL decodeAndCancel(IWbemClassObject *pclsObj, void *row, void *context)
+{
+    if (*(UINT *)context == 0)
+        cancelWMIQueries();
+    (*(UINT *)context)++;
+    return decodeTestRow(pclsObj, row, NULL);
+}
+
+/**
+ * @brief Returns the fake objects still alive
+ */
+static LONG liveObjects(void)
+{
+    FakeWbemStats stats;
+    fakeWbemTakeStats(&stats);
+    return stats.liveObjects;
+}
+
+/**
+ * @brief Tests that started queries wait for the provider together
+ *
+ * This test validates:
+ * 1. Three slow queries finish in about one delay, not three
+ * 2. Every query receives all of its rows
+ * 3. The waits were bounded polls rather than infinite ones
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_concurrent_queries(WMISession *session)
+{
+    WMIAsyncQuery queries[3];
+    WMIRowVector rows[3];
+    LONG baseline = liveObjects();
+
+    fakeWbemSetQueryDelay(QUERY_DELAY_MS);
+    UINT64 start = GetTickCount64();
+    for (int i = 0; i < 3; i++)
+    {
+        initWMIRowVector(&rows[i], NULL, sizeof(TestRow), 0);
+        assert(startWMIProjectedQuery(session, &g_query, &rows[i], NULL, NULL, 5000, &queries[i]));
+        assert(queries[i].state == WMI_QUERY_PENDING);
+    }
+
+    assert(waitWMIQueries(queries, 3) == 3);
+    UINT64 elapsed = GetTickCount64() - start;
+    assert(elapsed >= QUERY_DELAY_MS - 10 && elapsed < QUERY_DELAY_MS * 2);
+
+    FakeWbemStats stats;
+    fakeWbemTakeStats(&stats);
+    assert(stats.timeouts > 0);
+
+    for (int i = 0; i < 3; i++)
+    {
+        assert(queries[i].state == WMI_QUERY_COMPLETE && queries[i].result == S_OK);
+        assert(rows[i].count == ROW_COUNT);
+        assert(strcmp(((TestRow *)rows[i].rows)[ROW_COUNT - 1].name, "Row 39") == 0);
+        releaseWMIRowVector(&rows[i]);
+    }
+
+    fakeWbemSetQueryDelay(0);
+    assert(liveObjects() == baseline);
+    printf("Concurrent queries test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests query deadlines
+ *
+ * This test validates:
+ * 1. A stalled query ends as timed out shortly after its deadline
+ * 2. A fast query in the same group still completes
+ * 3. The synchronous functions honour setWMIQueryTimeout()
+ * 4. Timed out enumerators are released
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_timeouts(WMISession *session)
+{
+    WMIAsyncQuery queries[2];
+    WMIRowVector fast, stalled;
+    LONG baseline = liveObjects();
+
+    initWMIRowVector(&fast, NULL, sizeof(TestRow), 0);
+    initWMIRowVector(&stalled, NULL, sizeof(TestRow), 0);
+
+    fakeWbemSetQueryDelay(STALLED_DELAY_MS);
+    assert(startWMIQuery(session, L"SELECT Name FROM Win32_Stalled", &stalled, decodeTestRow, NULL, 80, &queries[0]));
+    fakeWbemSetQueryDelay(0);
+    assert(startWMIQuery(session, L"SELECT Name FROM Win32_Fast", &fast, decodeTestRow, NULL, 5000, &queries[1]));
+
+    UINT64 start = GetTickCount64();
+    assert(waitWMIQueries(queries, 2) == 1);
+    UINT64 elapsed = GetTickCount64() - start;
+    assert(elapsed >= 70 && elapsed < 80 + WMI_POLL_SLICE_MS * 5);
+
+    assert(queries[0].state == WMI_QUERY_TIMED_OUT && queries[0].pEnumerator == NULL);
+    assert(stalled.count == 0);
+    assert(queries[1].state == WMI_QUERY_COMPLETE && fast.count == ROW_COUNT);
+    releaseWMIRowVector(&fast);
+
+    setWMIQueryTimeout(60);
+    assert(getWMIQueryTimeout() == 60);
+    fakeWbemSetQueryDelay(STALLED_DELAY_MS);
+    start = GetTickCount64();
+    assert(!queryWMIRows(session, L"SELECT Name FROM Win32_Stalled", &stalled, decodeTestRow, NULL));
+    TestRow row = {"untouched"};
+    WMIQueryState state;
+    assert(!queryWMIObject(session, &g_query, &row, &state));
+    assert(strcmp(row.name, "untouched") == 0 && state == WMI_QUERY_TIMED_OUT);
+    elapsed = GetTickCount64() - start;
+    assert(elapsed < 2 * (60 + WMI_POLL_SLICE_MS * 5));
+
+    fakeWbemSetQueryDelay(0);
+    setWMIQueryTimeout(0);
+    assert(getWMIQueryTimeout() == WMI_DEFAULT_QUERY_TIMEOUT_MS);
+    assert(queryWMIObject(session, &g_query, &row, &state));
+    assert(strcmp(row.name, "Row 0") == 0 && state == WMI_QUERY_COMPLETE);
+
+    assert(liveObjects() == baseline);
+    printf("Timeouts test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests cancellation
+ *
+ * This test validates:
+ * 1. cancelWMIQuery() ends one pending query and releases it
+ * 2. cancelWMIQueries() ends every query started before it, keeping their rows
+ * 3. Queries started after the cancellation run normally
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_cancellation(WMISession *session)
+{
+    WMIAsyncQuery queries[2];
+    WMIRowVector first, second;
+    LONG baseline = liveObjects();
+
+    initWMIRowVector(&first, NULL, sizeof(TestRow), 0);
+    fakeWbemSetQueryDelay(STALLED_DELAY_MS);
+    assert(startWMIQuery(session, L"SELECT Name FROM Win32_Test", &first, decodeTestRow, NULL, 0, &queries[0]));
+    cancelWMIQuery(&queries[0]);
+    assert(queries[0].state == WMI_QUERY_CANCELLED && queries[0].result == WBEM_E_CALL_CANCELLED);
+    assert(waitWMIQueries(queries, 1) == 0);
+    assert(liveObjects() == baseline);
+
+    // The fast query cancels both from its decoder while the other one stalls
+    UINT decoded = 0;
+    initWMIRowVector(&second, NULL, sizeof(TestRow), 0);
+    assert(startWMIQuery(session, L"SELECT Name FROM Win32_Test", &first, decodeTestRow, NULL, 0, &queries[0]));
+    fakeWbemSetQueryDelay(0);
+    setWMIBatchSize(4);
+    assert(startWMIQuery(session, L"SELECT Name FROM Win32_Test", &second, decodeAndCancel, &decoded, 0, &queries[1]));
+
+    UINT64 start = GetTickCount64();
+    assert(waitWMIQueries(queries, 2) == 0);
+    assert(GetTickCount64() - start < 1000);
+    assert(queries[0].state == WMI_QUERY_CANCELLED && queries[1].state == WMI_QUERY_CANCELLED);
+    assert(first.count == 0);
+    assert(second.count == 4 && decoded == 4);
+    assert(liveObjects() == baseline);
+
+    releaseWMIRowVector(&second);
+    assert(queryWMIRows(session, L"SELECT Name FROM Win32_Test", &second, decodeTestRow, NULL));
+    assert(second.count == ROW_COUNT);
+    releaseWMIRowVector(&second);
+    setWMIBatchSize(WMI_DEFAULT_BATCH_SIZE);
+
+    printf("Cancellation test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests rejected queries and enumeration errors
+ *
+ * This test validates:
+ * 1. A rejected query fails to start and is skipped by the wait
+ * 2. An enumeration error completes the query with the rows read before it
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_failures(WMISession *session)
+{
+    WMIAsyncQuery queries[2];
+    WMIRowVector rejected, failing;
+
+    initWMIRowVector(&rejected, NULL, sizeof(TestRow), 0);
+    initWMIRowVector(&failing, NULL, sizeof(TestRow), 0);
+
+    fakeWbemFailQueries(1, WBEM_E_INVALID_QUERY);
+    assert(!startWMIQuery(session, L"SELECT Name FROM Win32_Test", &rejected, decodeTestRow, NULL, 0, &queries[0]));
+    assert(queries[0].state == WMI_QUERY_FAILED);
+
+    // Full batches up to the failure, so the error is what ends the enumeration
+    fakeWbemFailEnumAfter(20, WBEM_E_FAILED);
+    setWMIBatchSize(4);
+    assert(startWMIQuery(session, L"SELECT Name FROM Win32_Test", &failing, decodeTestRow, NULL, 0, &queries[1]));
+    assert(waitWMIQueries(queries, 2) == 1);
+    assert(queries[0].state == WMI_QUERY_FAILED && rejected.count == 0);
+    assert(queries[1].state == WMI_QUERY_COMPLETE && queries[1].result == WBEM_E_FAILED);
+    assert(failing.count == 20);
+    releaseWMIRowVector(&failing);
+    setWMIBatchSize(WMI_DEFAULT_BATCH_SIZE);
+    fakeWbemFailEnumAfter(0, S_OK);
+
+    printf("Failures test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Main test runner
+ *
+ * Runs against the in-process fake provider, whose query
+ * delays stand in for a busy WMI service
+ *
+ * @return int 0 if all tests passed, 1 if any failed
+ */
+int main()
+{
+    int testsPassed = 0;
+    int totalTests = 4;
+
+    for (UINT i = 0; i < ROW_COUNT; i++)
+    {
+        swprintf(g_names[i], 32, L"Row %u", i);
+        g_fakeProperties[i].name = L"Name";
+        g_fakeProperties[i].value = g_names[i];
+        g_rows[i].properties = &g_fakeProperties[i];
+        g_rows[i].count = 1;
+    }
+
+    setWMIConnector(connectFakeWbem);
+    fakeWbemSetRows(g_rows, ROW_COUNT);
+
+    WMISession *session = acquireWMISession();
+    assert(session != NULL);
+
+    testsPassed += test_concurrent_queries(session);
+    testsPassed += test_timeouts(session);
+    testsPassed += test_cancellation(session);
+    testsPassed += test_failures(session);
+
+    releaseWMISession(session);
+    setWMIConnector(NULL);
+
+    printf("Tests passed: %d/%d\n", testsPassed, totalTests);
+    return (testsPassed == totalTests) ? 0 : 1;
+}
@@ -0,0 +1,300 @@
+#include "wmi_cache.h"
+#include "fest_alloc.h"
+#include "fake_wbem.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#define ROW_COUNT 10 // Objects returned by every fake query
+
+typedef struct
+{
+    char name[32]; // Name property of the object
+} TestRow;
+
+static const WMIPropertySpec g_properties[] = {
+    WMI_STRING_PROPERTY(L"Name", TestRow, name)};
+
+static const WMIQuerySpec g_query = {
+    L"Win32_Test", g_properties, WMI_PROPERTY_COUNT(g_properties), NULL};
+
+static const WMIQuerySpec g_otherQuery = {
+    L"Win32_Other", g_properties, WMI_PROPERTY_COUNT(g_properties), NULL};
+
+static wchar_t g_names[ROW_COUNT][32];
+static FakeWbemProperty g_fakeProperties[ROW_COUNT];
+static FakeWbemRow g_rows[ROW_COUNT];
+static UINT64 g_now = 1000; // Value of the fake clock
+
+/**
+ * @brief Fake clock controlled by the tests
+ */
+static UINT64 readTestClock(void)
+{
+    return g_now;
+}
+
+/**
+ * @brief Decodes the Name property
+ */
+static BOOL decodeTestRow(IWbemClassObject *pclsObj, void *row, void *context)
+{
+    return getWMIPropertyString(pclsObj, L"Name", ((TestRow *)row)->name, sizeof(((TestRow *)row)->name));
+}
+
+/**
+ * @brief Runs one cached raw query into a fresh heap vector
+ *
+ * @return UINT Number of provider queries it caused
+ */
+static UINT runCachedQuery(WMISession *session, const wchar_t *query, UINT ttlMs, UINT expectedRows)
+{
+    FakeWbemStats fake;
+    fakeWbemTakeStats(&fake);
+
+    WMIRowVector rows;
+    initWMIRowVector(&rows, NULL, sizeof(TestRow), 0);
+    assert(queryWMIRowsCached(session, query, &rows, decodeTestRow, NULL, ttlMs));
+    assert(rows.count == expectedRows);
+    for (UINT i = 0; i < rows.count; i++)
+    {
+        char expected[32];
+        _snprintf_s(expected, sizeof(expected), _TRUNCATE, "Row %u", i);
+        assert(strcmp(((TestRow *)rows.rows)[i].name, expected) == 0);
+    }
+    releaseWMIRowVector(&rows);
+
+    fakeWbemTakeStats(&fake);
+    return fake.queries;
+}
+
+/**
+ * @brief Tests query text normalization
+ *
+ * This test validates:
+ * 1. Whitespace is trimmed and collapsed
+ * 2. Keywords and names are case-folded
+ * 3. Quoted literals keep case and spacing
+ * 4. Keys that do not fit are rejected
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_normalize(void)
+{
+    wchar_t key[WMI_QUERY_MAX_LENGTH];
+
+    assert(normalizeWMIQuery(L"  select\tName,  Speed\r\nfrom win32_test  ", key, WMI_QUERY_MAX_LENGTH));
+    assert(wcscmp(key, L"SELECT NAME, SPEED FROM WIN32_TEST") == 0);
+
+    assert(normalizeWMIQuery(L"select * from Win32_Test where Name = 'Disk  #0'", key, WMI_QUERY_MAX_LENGTH));
+    assert(wcscmp(key, L"SELECT * FROM WIN32_TEST WHERE NAME = 'Disk  #0'") == 0);
+
+    assert(normalizeWMIQuery(L"SELECT *", key, 9));
+    assert(!normalizeWMIQuery(L"SELECT *", key, 8));
+
+    printf("Normalize test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests hits, misses and TTL expiry
+ *
+ * This test validates:
+ * 1. A repeated query is answered without the provider
+ * 2. Differently spelled queries share an entry
+ * 3. Expired entries run the query again, reusing their memory
+ * 4. A TTL of zero bypasses the cache
+ * 5. Failed queries are not cached
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_hit_miss_ttl(WMISession *session)
+{
+    clearWMICache();
+    WMICacheStats before, after;
+    getWMICacheStats(&before);
+
+    assert(runCachedQuery(session, L"SELECT Name FROM Win32_Test", 500, ROW_COUNT) == 1);
+    assert(runCachedQuery(session, L"SELECT Name FROM Win32_Test", 500, ROW_COUNT) == 0);
+    assert(runCachedQuery(session, L"select  name from WIN32_TEST", 500, ROW_COUNT) == 0);
+
+    getWMICacheStats(&after);
+    assert(after.hits - before.hits == 2);
+    assert(after.misses - before.misses == 1);
+    assert(after.entries == 1 && after.bytes == sizeof(TestRow) * ROW_COUNT);
+
+    // Refreshing an expired entry of the same size does not allocate
+    g_now += 500;
+    AllocStats allocBefore, allocAfter;
+    SnapshotArena arena;
+    assert(initSnapshotArena(&arena, 4096));
+    WMIRowVector rows;
+    initWMIRowVector(&rows, &arena, sizeof(TestRow), ROW_COUNT);
+    getAllocStats(&allocBefore);
+    assert(queryWMIRowsCached(session, L"SELECT Name FROM Win32_Test", &rows, decodeTestRow, NULL, 500));
+    getAllocStats(&allocAfter);
+    assert(rows.count == ROW_COUNT);
+    assert(allocAfter.allocCount == allocBefore.allocCount);
+    releaseSnapshotArena(&arena);
+
+    getWMICacheStats(&after);
+    assert(after.expirations - before.expirations == 1);
+    assert(after.misses - before.misses == 2);
+
+    assert(runCachedQuery(session, L"SELECT Name FROM Win32_Test", 0, ROW_COUNT) == 1);
+
+    fakeWbemFailQueries(1, WBEM_E_FAILED);
+    initWMIRowVector(&rows, NULL, sizeof(TestRow), 0);
+    assert(!queryWMIRowsCached(session, L"SELECT Name FROM Win32_Failing", &rows, decodeTestRow, NULL, 500));
+    assert(runCachedQuery(session, L"SELECT Name FROM Win32_Failing", 500, ROW_COUNT) == 1);
+
+    printf("Hit, miss and TTL test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests the entry and byte limits
+ *
+ * This test validates:
+ * 1. The least recently used entry is evicted first
+ * 2. Results larger than the byte limit are not stored
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_limits(WMISession *session)
+{
+    clearWMICache();
+    setWMICacheLimits(2, WMI_CACHE_DEFAULT_MAX_BYTES);
+    WMICacheStats before, after;
+    getWMICacheStats(&before);
+
+    assert(runCachedQuery(session, L"SELECT Name FROM Win32_A", 60000, ROW_COUNT) == 1);
+    assert(runCachedQuery(session, L"SELECT Name FROM Win32_B", 60000, ROW_COUNT) == 1);
+    assert(runCachedQuery(session, L"SELECT Name FROM Win32_A", 60000, ROW_COUNT) == 0);
+    assert(runCachedQuery(session, L"SELECT Name FROM Win32_C", 60000, ROW_COUNT) == 1);
+
+    // B was the least recently used
+    assert(runCachedQuery(session, L"SELECT Name FROM Win32_A", 60000, ROW_COUNT) == 0);
+    assert(runCachedQuery(session, L"SELECT Name FROM Win32_B", 60000, ROW_COUNT) == 1);
+
+    getWMICacheStats(&after);
+    assert(after.evictions - before.evictions == 2);
+    assert(after.entries == 2);
+
+    setWMICacheLimits(WMI_CACHE_MAX_ENTRIES, sizeof(TestRow) * (ROW_COUNT - 1));
+    getWMICacheStats(&after);
+    assert(after.entries == 0 && after.bytes == 0);
+    assert(runCachedQuery(session, L"SELECT Name FROM Win32_A", 60000, ROW_COUNT) == 1);
+    assert(runCachedQuery(session, L"SELECT Name FROM Win32_A", 60000, ROW_COUNT) == 1);
+
+    setWMICacheLimits(WMI_CACHE_MAX_ENTRIES, WMI_CACHE_DEFAULT_MAX_BYTES);
+    printf("Limits test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests the projected and single-object variants
+ *
+ * This test validates:
+ * 1. Projected results are keyed by their specification
+ * 2. Single objects are cached, missing ones as empty results
+ * 3. A query that fails once is not cached and succeeds on the next call
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_projected_and_object(WMISession *session)
+{
+    clearWMICache();
+    FakeWbemStats fake;
+    fakeWbemTakeStats(&fake);
+
+    for (int i = 0; i < 3; i++)
+    {
+        WMIRowVector rows;
+        initWMIRowVector(&rows, NULL, sizeof(TestRow), 0);
+        assert(queryWMIProjectedCached(session, &g_query, &rows, NULL, NULL, 60000));
+        assert(rows.count == ROW_COUNT && strcmp(((TestRow *)rows.rows)[3].name, "Row 3") == 0);
+        releaseWMIRowVector(&rows);
+
+        TestRow row = {{0}};
+        assert(queryWMIObjectCached(session, &g_otherQuery, &row, sizeof(row), 60000));
+        assert(strcmp(row.name, "Row 0") == 0);
+    }
+
+    fakeWbemTakeStats(&fake);
+    assert(fake.queries == 2);
+
+    fakeWbemSetRows(NULL, 0);
+    clearWMICache();
+    for (int i = 0; i < 2; i++)
+    {
+        TestRow row = {"untouched"};
+        assert(!queryWMIObjectCached(session, &g_otherQuery, &row, sizeof(row), 60000));
+        assert(strcmp(row.name, "untouched") == 0);
+    }
+    fakeWbemTakeStats(&fake);
+    assert(fake.queries == 1);
+    fakeWbemSetRows(g_rows, ROW_COUNT);
+
+    // A rejected query, then an enumeration error, are retried rather than cached as empty
+    clearWMICache();
+    fakeWbemFailQueries(1, WBEM_E_FAILED);
+    TestRow row = {"untouched"};
+    assert(!queryWMIObjectCached(session, &g_otherQuery, &row, sizeof(row), 60000));
+    assert(strcmp(row.name, "untouched") == 0);
+    fakeWbemFailEnumAfter(0, WBEM_E_TRANSPORT_FAILURE);
+    assert(!queryWMIObjectCached(session, &g_otherQuery, &row, sizeof(row), 60000));
+    fakeWbemFailEnumAfter(0, S_OK);
+    for (int i = 0; i < 2; i++)
+    {
+        assert(queryWMIObjectCached(session, &g_otherQuery, &row, sizeof(row), 60000));
+        assert(strcmp(row.name, "Row 0") == 0);
+    }
+    fakeWbemTakeStats(&fake);
+    assert(fake.queries == 3);
+
+    printf("Projected and object test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Main test runner
+ *
+ * Runs against the in-process fake provider with a fake clock
+ *
+ * @return int 0 if all tests passed, 1 if any failed
+ */
+int main()
+{
+    int testsPassed = 0;
+    int totalTests = 4;
+
+    for (UINT i = 0; i < ROW_COUNT; i++)
+    {
+        swprintf(g_names[i], 32, L"Row %u", i);
+        g_fakeProperties[i].name = L"Name";
+        g_fakeProperties[i].value = g_names[i];
+        g_rows[i].properties = &g_fakeProperties[i];
+        g_rows[i].count = 1;
+    }
+
+    setWMIConnector(connectFakeWbem);
+    setWMICacheClock(readTestClock);
+    fakeWbemSetRows(g_rows, ROW_COUNT);
+
+    WMISession *session = acquireWMISession();
+    assert(session != NULL);
+
+    testsPassed += test_normalize();
+    testsPassed += test_hit_miss_ttl(session);
+    testsPassed += test_limits(session);
+    testsPassed += test_projected_and_object(session);
+
+    clearWMICache();
+    releaseWMISession(session);
+    setWMICacheClock(NULL);
+    setWMIConnector(NULL);
+
+    printf("Tests passed: %d/%d\n", testsPassed, totalTests);
+    return (testsPassed == totalTests) ? 0 : 1;
+}
@@ -0,0 +1,270 @@
+#include "wmi_helper.h"
+#include "fake_wbem.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+static const FakeWbemProperty g_cpuProperties[] = {
+    {L"Name", L"Fake CPU @ 3.00GHz"},
+    {L"Manufacturer", L"FakeVendor"},
+    {L"SerialNumber", NULL}};
+
+static const FakeWbemRow g_rows[] = {
+    {g_cpuProperties, 3},
+    {g_cpuProperties, 3}};
+
+/**
+ * @brief Counts the objects returned by a query on a leased session
+ *
+ * @param session Leased session
+ * @return int Number of objects, -1 if the query failed
+ */
+static int countQueryRows(WMISession *session)
+{
+    IEnumWbemClassObject *pEnumerator = NULL;
+    if (!executeWQLQuery(session, L"SELECT * FROM Win32_Processor", &pEnumerator))
+        return -1;
+
+    IWbemClassObject *pclsObj = NULL;
+    ULONG uReturn = 0;
+    int rows = 0;
+    while (SUCCEEDED(pEnumerator->lpVtbl->Next(pEnumerator, WBEM_INFINITE, 1, &pclsObj, &uReturn)) && uReturn != 0)
+    {
+        rows++;
+        pclsObj->lpVtbl->Release(pclsObj);
+    }
+    pEnumerator->lpVtbl->Release(pEnumerator);
+    return rows;
+}
+
+/**
+ * @brief Tests that a pinned thread reuses one connection
+ *
+ * This test validates:
+ * 1. Many leases on a pinned thread open a single connection
+ * 2. Every lease can query through the shared connection
+ * 3. Unpinning closes the connection and releases every object
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_pinned_reuse(void)
+{
+    FakeWbemStats fake;
+    fakeWbemTakeStats(&fake);
+
+    pinWMISession();
+    for (int i = 0; i < 10; i++)
+    {
+        WMISession *session = acquireWMISession();
+        assert(session != NULL);
+        assert(countQueryRows(session) == 2);
+        releaseWMISession(session);
+    }
+
+    fakeWbemTakeStats(&fake);
+    assert(fake.connects == 1);
+    assert(fake.queries == 10);
+    assert(fake.liveObjects > 0);
+
+    unpinWMISession();
+    fakeWbemTakeStats(&fake);
+    assert(fake.liveObjects == 0);
+
+    printf("Pinned session reuse test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests leases on a thread without a pin
+ *
+ * This test validates:
+ * 1. Nested leases share one session
+ * 2. The connection stays open until the last lease returns
+ * 3. A later lease opens a new connection
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_unpinned_leases(void)
+{
+    FakeWbemStats fake;
+    fakeWbemTakeStats(&fake);
+
+    WMISession *outer = acquireWMISession();
+    WMISession *inner = acquireWMISession();
+    assert(outer != NULL && outer == inner);
+    assert(outer->leases == 2);
+
+    releaseWMISession(inner);
+    assert(outer->initialized);
+    assert(countQueryRows(outer) == 2);
+
+    releaseWMISession(outer);
+    fakeWbemTakeStats(&fake);
+    assert(fake.connects == 1);
+    assert(fake.liveObjects == 0);
+
+    WMISession *session = acquireWMISession();
+    assert(session != NULL);
+    releaseWMISession(session);
+    fakeWbemTakeStats(&fake);
+    assert(fake.connects == 1);
+    assert(fake.liveObjects == 0);
+
+    printf("Unpinned lease test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests reconnecting after the provider went away
+ *
+ * This test validates:
+ * 1. A transport failure replaces the connection and retries once
+ * 2. Other query failures are reported without reconnecting
+ * 3. A failed reconnect leaves the session to reconnect on the next lease
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_reconnect(void)
+{
+    FakeWbemStats fake;
+    WMIPoolStats before, after;
+    fakeWbemTakeStats(&fake);
+    getWMIPoolStats(&before);
+
+    pinWMISession();
+    WMISession *session = acquireWMISession();
+    assert(session != NULL);
+
+    fakeWbemFailQueries(1, RPC_E_DISCONNECTED);
+    assert(countQueryRows(session) == 2);
+
+    fakeWbemFailQueries(1, WBEM_E_INVALID_QUERY);
+    assert(countQueryRows(session) == -1);
+
+    getWMIPoolStats(&after);
+    fakeWbemTakeStats(&fake);
+    assert(after.reconnects == before.reconnects + 1);
+    assert(fake.connects == 2);
+    assert(fake.queries == 3);
+
+    // Provider stays away: the query fails and the lease is kept
+    fakeWbemFailQueries(1, RPC_E_SERVER_DIED);
+    fakeWbemFailConnects(1);
+    assert(countQueryRows(session) == -1);
+    assert(!session->initialized);
+    releaseWMISession(session);
+
+    // The next lease reconnects
+    session = acquireWMISession();
+    assert(session != NULL);
+    assert(countQueryRows(session) == 2);
+    releaseWMISession(session);
+    unpinWMISession();
+
+    fakeWbemTakeStats(&fake);
+    assert(fake.liveObjects == 0);
+
+    printf("Reconnect test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests a connection failure on lease
+ *
+ * This test validates:
+ * 1. A failed connection yields no lease
+ * 2. The pool counts the failure
+ * 3. The next lease connects again
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_connect_failure(void)
+{
+    WMIPoolStats before, after;
+    getWMIPoolStats(&before);
+
+    fakeWbemFailConnects(1);
+    assert(acquireWMISession() == NULL);
+
+    getWMIPoolStats(&after);
+    assert(after.failures == before.failures + 1);
+
+    WMISession *session = acquireWMISession();
+    assert(session != NULL);
+    assert(session->leases == 1);
+    releaseWMISession(session);
+
+    printf("Connect failure test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests reading string properties through the pooled session
+ *
+ * This test validates:
+ * 1. String properties are converted to narrow strings
+ * 2. Long values are truncated to the buffer
+ * 3. NULL and missing properties yield empty strings
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_property_string(void)
+{
+    WMISession *session = acquireWMISession();
+    assert(session != NULL);
+
+    IEnumWbemClassObject *pEnumerator = NULL;
+    assert(executeWQLQuery(session, L"SELECT * FROM Win32_Processor", &pEnumerator));
+
+    IWbemClassObject *pclsObj = NULL;
+    ULONG uReturn = 0;
+    assert(pEnumerator->lpVtbl->Next(pEnumerator, WBEM_INFINITE, 1, &pclsObj, &uReturn) == WBEM_S_NO_ERROR);
+    assert(uReturn == 1);
+
+    char buffer[64];
+    assert(getWMIPropertyString(pclsObj, L"Name", buffer, sizeof(buffer)));
+    assert(strcmp(buffer, "Fake CPU @ 3.00GHz") == 0);
+
+    char shortBuffer[5];
+    assert(getWMIPropertyString(pclsObj, L"Manufacturer", shortBuffer, sizeof(shortBuffer)));
+    assert(strcmp(shortBuffer, "Fake") == 0);
+
+    assert(!getWMIPropertyString(pclsObj, L"SerialNumber", buffer, sizeof(buffer)));
+    assert(buffer[0] == '\0');
+    assert(!getWMIPropertyString(pclsObj, L"Missing", buffer, sizeof(buffer)));
+
+    pclsObj->lpVtbl->Release(pclsObj);
+    pEnumerator->lpVtbl->Release(pEnumerator);
+    releaseWMISession(session);
+
+    printf("Property string test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Test runner for the WMI session pool
+ *
+ * Runs against the in-process fake provider, so no WMI
+ * service is needed
+ *
+ * @return int 0 if all tests passed, 1 if any failed
+ */
+int main()
+{
+    int testsPassed = 0;
+    int totalTests = 5;
+
+    setWMIConnector(connectFakeWbem);
+    fakeWbemSetRows(g_rows, 2);
+
+    testsPassed += test_pinned_reuse();
+    testsPassed += test_unpinned_leases();
+    testsPassed += test_reconnect();
+    testsPassed += test_connect_failure();
+    testsPassed += test_property_string();
+
+    setWMIConnector(NULL);
+
+    printf("Tests passed: %d/%d\n", testsPassed, totalTests);
+    return (testsPassed == totalTests) ? 0 : 1;
+}
@@ -0,0 +1,204 @@
+#include "wmi_helper.h"
+#include "fake_wbem.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+typedef struct
+{
+    char name[8];    // Truncated on purpose
+    UINT cores;      // From VT_I4
+    UINT64 capacity; // From a uint64 string
+    UINT speed;      // From VT_UI4
+    UINT missing;    // Property reported as NULL
+    BOOL sawExtra;   // Unselected property was readable
+} TestRow;
+
+static const WMIPropertySpec g_properties[] = {
+    WMI_STRING_PROPERTY(L"Name", TestRow, name),
+    WMI_UINT32_PROPERTY(L"Cores", TestRow, cores),
+    WMI_UINT64_PROPERTY(L"Capacity", TestRow, capacity),
+    WMI_UINT32_PROPERTY(L"Speed", TestRow, speed),
+    WMI_UINT32_PROPERTY(L"Missing", TestRow, missing),
+    WMI_COLUMN(L"DeviceID")};
+
+static const WMIQuerySpec g_query = {
+    L"Win32_Test", g_properties, WMI_PROPERTY_COUNT(g_properties), NULL};
+
+static const FakeWbemProperty g_fakeProperties[] = {
+    {L"Name", L"Processor"},
+    {L"Cores", NULL, VT_I4, 8},
+    {L"Capacity", L"17179869184"},
+    {L"Speed", NULL, VT_UI4, 3200},
+    {L"Missing", NULL},
+    {L"DeviceID", L"Disk0"},
+    {L"Extra", L"not selected"}};
+
+static const FakeWbemRow g_rows[] = {
+    {g_fakeProperties, 7},
+    {g_fakeProperties, 7},
+    {g_fakeProperties, 7}};
+
+/**
+ * @brief Tests WQL generation from property lists
+ *
+ * This test validates:
+ * 1. Properties are selected in declaration order
+ * 2. WHERE conditions are appended
+ * 3. Statements that do not fit are rejected
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_build_query(void)
+{
+    wchar_t query[WMI_QUERY_MAX_LENGTH];
+
+    assert(buildWMIQuery(&g_query, query, WMI_QUERY_MAX_LENGTH));
+    assert(wcscmp(query, L"SELECT Name, Cores, Capacity, Speed, Missing, DeviceID FROM Win32_Test") == 0);
+
+    WMIQuerySpec filtered = g_query;
+    filtered.propertyCount = 1;
+    filtered.where = L"DriveType = 3";
+    assert(buildWMIQuery(&filtered, query, WMI_QUERY_MAX_LENGTH));
+    assert(wcscmp(query, L"SELECT Name FROM Win32_Test WHERE DriveType = 3") == 0);
+
+    wchar_t shortQuery[24];
+    assert(!buildWMIQuery(&g_query, shortQuery, 24));
+    assert(shortQuery[0] == L'\0');
+
+    WMIQuerySpec empty = {L"Win32_Test", NULL, 0, NULL};
+    assert(!buildWMIQuery(&empty, query, WMI_QUERY_MAX_LENGTH));
+
+    printf("Build query test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Reads an unselected property to check the projection
+ *
+ * @param pclsObj Fake class object
+ * @param row TestRow with declared properties stored
+ * @param context Unused
+ * @return BOOL TRUE, every row is kept
+ */
+static BOOL checkProjection(IWbemClassObject *pclsObj, void *row, void *context)
+{
+    char buffer[32];
+    ((TestRow *)row)->sawExtra = getWMIPropertyString(pclsObj, L"Extra", buffer, sizeof(buffer));
+    return TRUE;
+}
+
+/**
+ * @brief Tests typed decoding of a projected query
+ *
+ * This test validates:
+ * 1. The generated statement is what reaches the provider
+ * 2. Strings are truncated to their field, integers converted from
+ *    VT_I4, VT_UI4 and uint64 strings
+ * 3. NULL properties leave their fields untouched
+ * 4. Unselected properties are not available to the decoder
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_projected_rows(WMISession *session)
+{
+    WMIRowVector rows;
+    initWMIRowVector(&rows, NULL, sizeof(TestRow), 0);
+    assert(queryWMIProjected(session, &g_query, &rows, checkProjection, NULL));
+    assert(wcscmp(fakeWbemLastQuery(), L"SELECT Name, Cores, Capacity, Speed, Missing, DeviceID FROM Win32_Test") == 0);
+    assert(rows.count == 3);
+
+    for (UINT i = 0; i < rows.count; i++)
+    {
+        const TestRow *row = &((TestRow *)rows.rows)[i];
+        assert(strcmp(row->name, "Process") == 0);
+        assert(row->cores == 8);
+        assert(row->capacity == 17179869184ULL);
+        assert(row->speed == 3200);
+        assert(row->missing == 0);
+        assert(!row->sawExtra);
+    }
+    releaseWMIRowVector(&rows);
+
+    printf("Projected rows test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests decoding of singleton objects
+ *
+ * This test validates:
+ * 1. The first object is decoded into the row
+ * 2. An empty result leaves the row untouched
+ * 3. The number of stored fields is reported
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_query_object(WMISession *session)
+{
+    TestRow row;
+    memset(&row, 0, sizeof(row));
+    row.missing = 42;
+
+    assert(queryWMIObject(session, &g_query, &row, NULL));
+    assert(strcmp(row.name, "Process") == 0);
+    assert(row.capacity == 17179869184ULL);
+    assert(row.missing == 42);
+
+    fakeWbemSetRows(g_rows, 0);
+    TestRow untouched;
+    memset(&untouched, 0x5A, sizeof(untouched));
+    TestRow expected = untouched;
+    WMIQueryState state;
+    assert(!queryWMIObject(session, &g_query, &untouched, &state));
+    assert(state == WMI_QUERY_COMPLETE);
+    assert(memcmp(&untouched, &expected, sizeof(TestRow)) == 0);
+    fakeWbemSetRows(g_rows, 3);
+
+    IEnumWbemClassObject *pEnumerator = NULL;
+    IWbemClassObject *pclsObj = NULL;
+    ULONG uReturn = 0;
+    assert(executeWQLQuery(session, L"SELECT * FROM Win32_Test", &pEnumerator));
+    assert(pEnumerator->lpVtbl->Next(pEnumerator, WBEM_INFINITE, 1, &pclsObj, &uReturn) == WBEM_S_NO_ERROR);
+    memset(&row, 0, sizeof(row));
+    assert(decodeWMIProperties(pclsObj, g_properties, WMI_PROPERTY_COUNT(g_properties), &row) == 4);
+    pclsObj->lpVtbl->Release(pclsObj);
+    pEnumerator->lpVtbl->Release(pEnumerator);
+
+    printf("Query object test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Test runner for projected WMI queries
+ *
+ * Runs against the in-process fake provider, so no WMI
+ * service is needed
+ *
+ * @return int 0 if all tests passed, 1 if any failed
+ */
+int main()
+{
+    int testsPassed = 0;
+    int totalTests = 3;
+
+    setWMIConnector(connectFakeWbem);
+    fakeWbemSetRows(g_rows, 3);
+
+    WMISession *session = acquireWMISession();
+    assert(session != NULL);
+
+    testsPassed += test_build_query();
+    testsPassed += test_projected_rows(session);
+    testsPassed += test_query_object(session);
+
+    releaseWMISession(session);
+    setWMIConnector(NULL);
+
+    FakeWbemStats fake;
+    fakeWbemTakeStats(&fake);
+    assert(fake.liveObjects == 0);
+
+    printf("Tests passed: %d/%d\n", testsPassed, totalTests);
+    return (testsPassed == totalTests) ? 0 : 1;
+}
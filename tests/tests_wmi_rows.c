@@ -0,0 +1,260 @@
+#include "wmi_helper.h"
+#include "fest_alloc.h"
+#include "fake_wbem.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#define ROW_COUNT 100 // Objects returned by every fake query
+
+typedef struct
+{
+    char name[32]; // Name property of the object
+    UINT order;    // Position in the result
+} TestRow;
+
+static wchar_t g_names[ROW_COUNT][32];
+static FakeWbemProperty g_properties[ROW_COUNT];
+static FakeWbemRow g_rows[ROW_COUNT];
+
+/**
+ * @brief Decodes the Name property and the result position
+ *
+ * @param pclsObj Fake class object
+ * @param row TestRow to fill
+ * @param context Counter of decoded objects
+ * @return BOOL TRUE, every object is kept
+ */
+static BOOL decodeTestRow(IWbemClassObject *pclsObj, void *row, void *context)
+{
+    TestRow *testRow = (TestRow *)row;
+    UINT *decoded = (UINT *)context;
+
+    assert(testRow->name[0] == '\0' && testRow->order == 0);
+    getWMIPropertyString(pclsObj, L"Name", testRow->name, sizeof(testRow->name));
+    testRow->order = (*decoded)++;
+    return TRUE;
+}
+
+/**
+ * @brief Decoder keeping only objects at even positions
+ *
+ * @param pclsObj Fake class object
+ * @param row TestRow to fill
+ * @param context Counter of decoded objects
+ * @return BOOL TRUE for even positions
+ */
+static BOOL decodeEvenRows(IWbemClassObject *pclsObj, void *row, void *context)
+{
+    decodeTestRow(pclsObj, row, context);
+    return ((TestRow *)row)->order % 2 == 0;
+}
+
+/**
+ * @brief Checks that rows hold the fake objects in result order
+ *
+ * @param rows Decoded rows
+ * @param count Number of rows
+ * @param stride Result positions between consecutive rows
+ */
+static void checkRows(const TestRow *rows, UINT count, UINT stride)
+{
+    for (UINT i = 0; i < count; i++)
+    {
+        char expected[32];
+        _snprintf_s(expected, sizeof(expected), _TRUNCATE, "Row %u", i * stride);
+        assert(strcmp(rows[i].name, expected) == 0);
+        assert(rows[i].order == i * stride);
+    }
+}
+
+/**
+ * @brief Tests single-pass decoding into a heap vector
+ *
+ * This test validates:
+ * 1. One query, and one Next call per batch of objects
+ * 2. Capacity grows by doubling from the initial hint
+ * 3. Rows arrive zeroed and in result order for every batch size
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_single_pass(WMISession *session)
+{
+    static const UINT batchSizes[] = {1, 3, 16, 100, WMI_MAX_BATCH_SIZE};
+    FakeWbemStats fake;
+
+    for (UINT b = 0; b < sizeof(batchSizes) / sizeof(batchSizes[0]); b++)
+    {
+        UINT batchSize = batchSizes[b];
+        setWMIBatchSize(batchSize);
+        fakeWbemTakeStats(&fake);
+
+        WMIRowVector rows;
+        UINT decoded = 0;
+        initWMIRowVector(&rows, NULL, sizeof(TestRow), 1);
+        assert(queryWMIRows(session, L"SELECT * FROM Test", &rows, decodeTestRow, &decoded));
+
+        // Full batches, then one short batch (possibly empty) ends the result
+        UINT effectiveBatch = getWMIBatchSize();
+        fakeWbemTakeStats(&fake);
+        assert(effectiveBatch == (batchSize < WMI_MAX_BATCH_SIZE ? batchSize : WMI_MAX_BATCH_SIZE));
+        assert(rows.count == ROW_COUNT);
+        assert(rows.capacity == 128);
+        assert(fake.queries == 1);
+        assert(fake.nextCalls == ROW_COUNT / effectiveBatch + 1);
+        checkRows((TestRow *)rows.rows, rows.count, 1);
+
+        releaseWMIRowVector(&rows);
+        assert(rows.rows == NULL && rows.count == 0);
+    }
+    setWMIBatchSize(WMI_DEFAULT_BATCH_SIZE);
+
+    printf("Single pass test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests decoding into a snapshot arena
+ *
+ * This test validates:
+ * 1. Arena rows hold the same data as heap rows
+ * 2. Once the arena has grown, repeated collection does not touch the heap
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_arena_rows(WMISession *session)
+{
+    SnapshotArena arena;
+    assert(initSnapshotArena(&arena, 1024));
+
+    AllocStats before, after;
+    for (int pass = 0; pass < 3; pass++)
+    {
+        if (pass == 2)
+            getAllocStats(&before);
+
+        resetSnapshotArena(&arena);
+        WMIRowVector rows;
+        UINT decoded = 0;
+        initWMIRowVector(&rows, &arena, sizeof(TestRow), 4);
+        assert(queryWMIRows(session, L"SELECT * FROM Test", &rows, decodeTestRow, &decoded));
+        assert(rows.count == ROW_COUNT);
+        checkRows((TestRow *)rows.rows, rows.count, 1);
+    }
+    getAllocStats(&after);
+    assert(after.allocCount == before.allocCount);
+
+    releaseSnapshotArena(&arena);
+
+    printf("Arena rows test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests rows discarded by the decoder
+ *
+ * This test validates:
+ * 1. Discarded rows are not counted
+ * 2. Kept rows stay contiguous and zeroed for the decoder
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_decoder_skip(WMISession *session)
+{
+    WMIRowVector rows;
+    UINT decoded = 0;
+    initWMIRowVector(&rows, NULL, sizeof(TestRow), 0);
+    assert(queryWMIRows(session, L"SELECT * FROM Test", &rows, decodeEvenRows, &decoded));
+
+    assert(decoded == ROW_COUNT);
+    assert(rows.count == ROW_COUNT / 2);
+    checkRows((TestRow *)rows.rows, rows.count, 2);
+    releaseWMIRowVector(&rows);
+
+    printf("Decoder skip test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Tests failures of the query and of the enumeration
+ *
+ * This test validates:
+ * 1. A failed query reports failure and allocates nothing
+ * 2. An enumeration error keeps the rows read before it, whatever the batch size
+ * 3. An empty result allocates nothing
+ *
+ * @return BOOL TRUE if the test passed
+ */
+static BOOL test_failures(WMISession *session)
+{
+    WMIRowVector rows;
+    UINT decoded = 0;
+
+    initWMIRowVector(&rows, NULL, sizeof(TestRow), 0);
+    fakeWbemFailQueries(1, WBEM_E_INVALID_QUERY);
+    assert(!queryWMIRows(session, L"SELECT * FROM Test", &rows, decodeTestRow, &decoded));
+    assert(rows.rows == NULL && rows.count == 0);
+
+    fakeWbemFailEnumAfter(3, WBEM_E_FAILED);
+    for (UINT batchSize = 1; batchSize <= 4; batchSize++)
+    {
+        setWMIBatchSize(batchSize);
+        initWMIRowVector(&rows, NULL, sizeof(TestRow), 0);
+        decoded = 0;
+        assert(queryWMIRows(session, L"SELECT * FROM Test", &rows, decodeTestRow, &decoded));
+        assert(rows.count == 3);
+        checkRows((TestRow *)rows.rows, rows.count, 1);
+        releaseWMIRowVector(&rows);
+    }
+    setWMIBatchSize(WMI_DEFAULT_BATCH_SIZE);
+    fakeWbemFailEnumAfter(0, S_OK);
+
+    fakeWbemSetRows(g_rows, 0);
+    initWMIRowVector(&rows, NULL, sizeof(TestRow), 0);
+    assert(queryWMIRows(session, L"SELECT * FROM Test", &rows, decodeTestRow, &decoded));
+    assert(rows.rows == NULL && rows.count == 0);
+    fakeWbemSetRows(g_rows, ROW_COUNT);
+
+    printf("Failure test passed\n");
+    return TRUE;
+}
+
+/**
+ * @brief Test runner for single-pass WMI enumeration
+ *
+ * Runs against the in-process fake provider, so no WMI
+ * service is needed
+ *
+ * @return int 0 if all tests passed, 1 if any failed
+ */
+int main()
+{
+    int testsPassed = 0;
+    int totalTests = 4;
+
+    for (UINT i = 0; i < ROW_COUNT; i++)
+    {
+        swprintf(g_names[i], 32, L"Row %u", i);
+        g_properties[i].name = L"Name";
+        g_properties[i].value = g_names[i];
+        g_rows[i].properties = &g_properties[i];
+        g_rows[i].count = 1;
+    }
+
+    setWMIConnector(connectFakeWbem);
+    fakeWbemSetRows(g_rows, ROW_COUNT);
+
+    WMISession *session = acquireWMISession();
+    assert(session != NULL);
+
+    testsPassed += test_single_pass(session);
+    testsPassed += test_arena_rows(session);
+    testsPassed += test_decoder_skip(session);
+    testsPassed += test_failures(session);
+
+    releaseWMISession(session);
+    setWMIConnector(NULL);
+
+    printf("Tests passed: %d/%d\n", testsPassed, totalTests);
+    return (testsPassed == totalTests) ? 0 : 1;
+}